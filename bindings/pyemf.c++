@@ -13,6 +13,7 @@
 #include "core/emf/propagators/propagator.h"
 #include "core/emf/propagators/fdtd2.h"
 #include "core/emf/propagators/fdtd2_pml.h"
+#include "core/emf/propagators/fdtd2_blocked.h"
 #include "core/emf/propagators/fdtd4.h"
 #include "core/emf/propagators/fdtd_general.h"
 
@@ -22,6 +23,7 @@
 #include "core/emf/filters/strided_binomial.h"
 #include "core/emf/filters/general_binomial.h"
 #include "core/emf/filters/sweeping_binomial.h"
+#include "core/emf/filters/fused_binomial.h"
 
 
 #include "core/emf/boundaries/damping_tile.h"
@@ -31,6 +33,7 @@
 #include "io/writers/fields.h"
 #include "io/snapshots/fields.h"
 #include "io/snapshots/master_only_fields.h"
+#include "io/snapshots/parallel_fields.h"
 #include "io/snapshots/field_slices.h"
 #include "io/tasker.h"
 
@@ -63,6 +66,15 @@ auto declare_tile(
     .def("update_boundaries",   &emf::Tile<D>::update_boundaries,
             py::arg("grid"),
             py::arg("iarr")=iarr)
+    .def("halo_slab_size",      &emf::Tile<D>::halo_slab_size)
+    .def("pack_halo_slab",      [](emf::Tile<D>& s, int mode, std::array<int,3> dir)
+        {
+          std::vector<float> buf;
+          s.pack_halo_slab(mode, dir, buf);
+          return buf;
+        })
+    .def("unpack_halo_slab",    &emf::Tile<D>::unpack_halo_slab,
+            py::arg("mode"), py::arg("dir"), py::arg("buf"), py::arg("offs")=0)
     .def("get_grids",             &emf::Tile<D>::get_grids,
         py::arg("i")=0,
         py::return_value_policy::reference,
@@ -430,6 +442,14 @@ void bind_emf(py::module& m_sub)
     .def(py::init<>())
     .def_readwrite("corr",     &emf::FDTD2<3>::corr);
 
+  // cache-blocked fdtd2 propagator
+  py::class_<emf::FDTD2Blocked<3>>(m_3d, "FDTD2Blocked", emfpropag3d)
+    .def(py::init<>())
+    .def_readwrite("corr",     &emf::FDTD2Blocked<3>::corr)
+    .def_readwrite("brick_y",  &emf::FDTD2Blocked<3>::brick_y)
+    .def_readwrite("brick_z",  &emf::FDTD2Blocked<3>::brick_z)
+    .def("push_half_b_e",      &emf::FDTD2Blocked<3>::push_half_b_e);
+
   // fdtd2 propagator with perfectly matched ouer layer
   py::class_<emf::FDTD2_pml<3>> pml3d(m_3d, "FDTD2_pml", emfpropag3d);
   pml3d
@@ -480,6 +500,12 @@ void bind_emf(py::module& m_sub)
   py::class_<emf::Binomial2<1>>(m_1d, "Binomial2", emffilter1d)
     .def(py::init<int, int, int>())
     .def("solve",      &emf::Binomial2<1>::solve);
+
+  // fused multi-pass digital filter
+  py::class_<emf::FusedBinomial2<1>>(m_1d, "FusedBinomial2", emffilter1d)
+    .def(py::init<int, int, int>())
+    .def_readwrite("npasses",  &emf::FusedBinomial2<1>::npasses)
+    .def("solve",              &emf::FusedBinomial2<1>::solve);
   
   // 2D Filter bindings
   py::class_< emf::Filter<2>, PyFilter<2> > emffilter2d(m_2d, "Filter");
@@ -514,6 +540,12 @@ void bind_emf(py::module& m_sub)
     .def(py::init<int, int, int>())
     .def("solve",              &emf::Compensator2<2>::solve);
 
+  py::class_<emf::FusedBinomial2<2>>(m_2d, "FusedBinomial2", emffilter2d)
+    .def(py::init<int, int, int>())
+    .def_readwrite("npasses",    &emf::FusedBinomial2<2>::npasses)
+    .def_readwrite("compensate", &emf::FusedBinomial2<2>::compensate)
+    .def("solve",                &emf::FusedBinomial2<2>::solve);
+
 
 
   // 3D filters
@@ -527,6 +559,12 @@ void bind_emf(py::module& m_sub)
     .def(py::init<int, int, int>())
     .def("solve",      &emf::Binomial2<3>::solve);
 
+  // fused multi-pass digital filter
+  py::class_<emf::FusedBinomial2<3>>(m_3d, "FusedBinomial2", emffilter3d)
+    .def(py::init<int, int, int>())
+    .def_readwrite("npasses",  &emf::FusedBinomial2<3>::npasses)
+    .def("solve",              &emf::FusedBinomial2<3>::solve);
+
 
 
   //--------------------------------------------------
@@ -586,12 +624,14 @@ void bind_emf(py::module& m_sub)
   // 1D 
   py::class_<h5io::FieldsWriter<1>>(m_1d, "FieldsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write",   &h5io::FieldsWriter<1>::write);
+    .def("write",   &h5io::FieldsWriter<1>::write)
+    .def("write_async", &h5io::FieldsWriter<1>::write_async);
 
   // 2D 
   py::class_<h5io::FieldsWriter<2>>(m_2d, "FieldsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write",   &h5io::FieldsWriter<2>::write) 
+    .def("write",   &h5io::FieldsWriter<2>::write)
+    .def("write_async", &h5io::FieldsWriter<2>::write_async) 
     .def("get_slice", [](h5io::FieldsWriter<2> &s, int k)
             {
                 //const auto N = static_cast<pybind11::ssize_t>(s.arrs[k].size());
@@ -604,18 +644,40 @@ void bind_emf(py::module& m_sub)
   // 3D 
   py::class_<h5io::FieldsWriter<3>>(m_3d, "FieldsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write",   &h5io::FieldsWriter<3>::write);
+    .def("write",   &h5io::FieldsWriter<3>::write)
+    .def("write_async", &h5io::FieldsWriter<3>::write_async);
+
+  // collective parallel-hdf5 writers; same file layout as FieldsWriter
+  py::class_<h5io::ParallelFieldsWriter<1>>(m_1d, "ParallelFieldsWriter")
+    .def(py::init<const std::string&, int, int, int, int, int, int, int>())
+    .def("write",   &h5io::ParallelFieldsWriter<1>::write)
+    .def("write_async", &h5io::ParallelFieldsWriter<1>::write_async)
+    .def_static("is_available", &h5io::ParallelFieldsWriter<1>::is_available);
+
+  py::class_<h5io::ParallelFieldsWriter<2>>(m_2d, "ParallelFieldsWriter")
+    .def(py::init<const std::string&, int, int, int, int, int, int, int>())
+    .def("write",   &h5io::ParallelFieldsWriter<2>::write)
+    .def("write_async", &h5io::ParallelFieldsWriter<2>::write_async)
+    .def_static("is_available", &h5io::ParallelFieldsWriter<2>::is_available);
+
+  py::class_<h5io::ParallelFieldsWriter<3>>(m_3d, "ParallelFieldsWriter")
+    .def(py::init<const std::string&, int, int, int, int, int, int, int>())
+    .def("write",   &h5io::ParallelFieldsWriter<3>::write)
+    .def("write_async", &h5io::ParallelFieldsWriter<3>::write_async)
+    .def_static("is_available", &h5io::ParallelFieldsWriter<3>::is_available);
 
   // 3D; root only field storage
   py::class_<h5io::MasterFieldsWriter<3>>(m_3d, "MasterFieldsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write",   &h5io::MasterFieldsWriter<3>::write);
+    .def("write",   &h5io::MasterFieldsWriter<3>::write)
+    .def("write_async", &h5io::MasterFieldsWriter<3>::write_async);
 
   // slice writer; only in 3D
   py::class_<h5io::FieldSliceWriter>(m_3d, "FieldSliceWriter")
     .def_readwrite("ind",  &h5io::FieldSliceWriter::ind)
     .def(py::init<const std::string&, int, int, int, int, int, int, int, int, int>())
     .def("write",        &h5io::FieldSliceWriter::write)
+    .def("write_async",  &h5io::FieldSliceWriter::write_async)
     .def("get_slice", [](h5io::FieldSliceWriter &s, int k)
             {
                 //const auto N = static_cast<pybind11::ssize_t>(s.arrs[k].size());
@@ -631,15 +693,18 @@ void bind_emf(py::module& m_sub)
   // 1D
   m_1d.def("read_grids",        &emf::read_grids<1>);
   m_1d.def("write_grids",       &emf::write_grids<1>);
+  m_1d.def("write_grids_async", &emf::write_grids_async<1>);
 
 
   // 2D
   m_2d.def("write_grids",        &emf::write_grids<2>);
+  m_2d.def("write_grids_async",  &emf::write_grids_async<2>);
   m_2d.def("read_grids",         &emf::read_grids<2>);
 
 
   // 3D
   m_3d.def("write_grids",        &emf::write_grids<3>);
+  m_3d.def("write_grids_async",  &emf::write_grids_async<3>);
   m_3d.def("read_grids",         &emf::read_grids<3>);
 
 
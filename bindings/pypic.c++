@@ -1,6 +1,7 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <pybind11/functional.h>
 
 namespace py = pybind11;
 
@@ -19,6 +20,7 @@ namespace py = pybind11;
 #include "core/pic/pushers/rgca.h"
 #include "core/pic/pushers/pulsar.h"
 #include "core/pic/pushers/photon.h"
+#include "core/pic/pushers/simd.h"
 
 #include "core/pic/interpolators/interpolator.h"
 #include "core/pic/interpolators/linear_1st.h"
@@ -34,7 +36,14 @@ namespace py = pybind11;
 #include "core/pic/depositers/esikerpov_2nd.h"
 #include "core/pic/depositers/esikerpov_4th.h"
 
+#include "core/pic/fused/fused.h"
+
 #include "core/pic/communicate.h"
+#include "core/pic/step_pipeline.h"
+#include "core/pic/rank_exchange.h"
+#include "core/pic/tile_migration.h"
+#include "core/pic/plasma_loader.h"
+#include "core/pic/resampler.h"
 
 #include "core/pic/boundaries/wall.h"
 #include "core/pic/boundaries/piston.h"
@@ -47,6 +56,7 @@ namespace py = pybind11;
 #include "io/snapshots/pic_moments.h"
 #include "io/snapshots/master_only_moments.h"
 #include "io/tasker.h"
+#include "io/checkpoint.h"
 
 
 
@@ -55,6 +65,15 @@ namespace py = pybind11;
 namespace pic {
 
 
+/// numpy array of N elements at ptr without copying; owner is kept alive by the array
+template<typename T>
+py::array_t<T> prtcl_view(py::object owner, T* ptr, size_t N)
+{
+  if(N == 0) return py::array_t<T>(0);
+  return py::array_t<T>({N}, {sizeof(T)}, ptr, owner);
+}
+
+
 //--------------------------------------------------
 template<size_t D>
 auto declare_tile(
@@ -73,13 +92,21 @@ auto declare_tile(
                )
     .def(py::init<int, int, int>())
     .def_readwrite("cfl",       &pic::Tile<D>::cfl)
+    .def_readwrite("cost",      &pic::Tile<D>::cost)
     .def("get_container",       &pic::Tile<D>::get_container, 
         py::return_value_policy::reference, py::keep_alive<1,0>())
     .def("set_container",       &pic::Tile<D>::set_container)
+    .def("num_particles",       [](pic::Tile<D>& s)
+        {
+          size_t n = 0;
+          for(auto&& con : s.containers) n += con.size();
+          return n;
+        })
 
     .def("check_outgoing_particles",     &pic::Tile<D>::check_outgoing_particles)
     .def("get_incoming_particles",       &pic::Tile<D>::get_incoming_particles)
     .def("delete_transferred_particles", &pic::Tile<D>::delete_transferred_particles)
+    .def("sort_particles",               &pic::Tile<D>::sort_particles)
     .def("pack_outgoing_particles",      &pic::Tile<D>::pack_outgoing_particles)
     .def("pack_all_particles",           &pic::Tile<D>::pack_all_particles)
     .def("unpack_incoming_particles",    &pic::Tile<D>::unpack_incoming_particles)
@@ -99,16 +126,47 @@ auto declare_prtcl_container(
     .def_readwrite("q",   &pic::ParticleContainer<D>::q)
     .def_readwrite("m",   &pic::ParticleContainer<D>::m)
     .def_readwrite("type",&pic::ParticleContainer<D>::type)
+    .def_property("store_fields", 
+        [](pic::ParticleContainer<D>& s){ return s.store_fields; },
+        [](pic::ParticleContainer<D>& s, bool v){ s.set_store_fields(v); })
     .def("reserve",       &pic::ParticleContainer<D>::reserve)
     .def("size",          &pic::ParticleContainer<D>::size)
     .def("add_particle",  &pic::ParticleContainer<D>::add_particle)
+    .def("delete_particles", &pic::ParticleContainer<D>::delete_particles)
     .def("add_particle2", [](pic::ParticleContainer<D>& s, 
                             float xx, float yy, float zz,
                             float vx, float vy, float vz, float wgt)
         {
           s.add_particle({xx,yy,zz}, {vx,vy,vz}, wgt);
         })
+    // float32 c-contiguous arrays are used in place; others are converted once
+    .def("add_particles_bulk", [](pic::ParticleContainer<D>& s,
+          py::array_t<float, py::array::c_style | py::array::forcecast> x,
+          py::array_t<float, py::array::c_style | py::array::forcecast> y,
+          py::array_t<float, py::array::c_style | py::array::forcecast> z,
+          py::array_t<float, py::array::c_style | py::array::forcecast> vx,
+          py::array_t<float, py::array::c_style | py::array::forcecast> vy,
+          py::array_t<float, py::array::c_style | py::array::forcecast> vz,
+          py::array_t<float, py::array::c_style | py::array::forcecast> wgt)
+        {
+          const size_t N = x.size();
+          for(auto* a : {&y, &z, &vx, &vy, &vz}) {
+            if((size_t)a->size() != N) throw py::value_error("add_particles_bulk: arrays differ in length");
+          }
+
+          // scalar weight is shared by all particles
+          const bool wscalar = wgt.size() == 1 && N != 1;
+          if(!wscalar && (size_t)wgt.size() != N) throw py::value_error("add_particles_bulk: wrong wgt length");
+
+          s.add_particles_bulk(N, 
+              x.data(),  y.data(),  z.data(),
+              vx.data(), vy.data(), vz.data(),
+              wscalar ? nullptr : wgt.data(), 
+              wscalar ? *wgt.data() : 1.0f);
+        }, py::arg("x"), py::arg("y"), py::arg("z"), 
+           py::arg("vx"), py::arg("vy"), py::arg("vz"), py::arg("wgt")=1.0f)
     .def("set_keygen_state", &pic::ParticleContainer<D>::set_keygen_state)
+    .def("sort_in_cells",    &pic::ParticleContainer<D>::sort_in_cells)
     .def("loc",          [](pic::ParticleContainer<D>& s, size_t idim) 
         {
           return s.loc(idim); 
@@ -126,6 +184,31 @@ auto declare_prtcl_container(
           return s.id(idim); 
         }, py::return_value_policy::reference)
 
+    // zero-copy views; valid until particles are added, removed or sorted
+    .def("loc_view",     [](py::object self, size_t idim)
+        {
+          auto& s = self.cast<pic::ParticleContainer<D>&>();
+          if(idim > 2) throw py::index_error();
+          return prtcl_view<float>(self, s.size() ? &s.loc(idim, 0) : nullptr, s.size());
+        })
+    .def("vel_view",     [](py::object self, size_t idim)
+        {
+          auto& s = self.cast<pic::ParticleContainer<D>&>();
+          if(idim > 2) throw py::index_error();
+          return prtcl_view<float>(self, s.size() ? &s.vel(idim, 0) : nullptr, s.size());
+        })
+    .def("wgt_view",     [](py::object self)
+        {
+          auto& s = self.cast<pic::ParticleContainer<D>&>();
+          return prtcl_view<float>(self, s.size() ? &s.wgt(0) : nullptr, s.size());
+        })
+    .def("id_view",      [](py::object self, size_t idim)
+        {
+          auto& s = self.cast<pic::ParticleContainer<D>&>();
+          if(idim > 1) throw py::index_error();
+          return prtcl_view<int>(self, s.size() ? &s.id(idim, 0) : nullptr, s.size());
+        })
+
     //temporary binding; only needed for unit tests
     .def("ex",          [](pic::ParticleContainer<D>& s, int i) 
         {
@@ -180,6 +263,9 @@ auto declare_prtcl_container(
         if(v == 4) return s.vel(1, ip);
         if(v == 5) return s.vel(2, ip);
 
+        // particle fields are not stored by fused solvers
+        if(v >= 6 && (!s.store_fields || s.Epart.size() < 3*s.size())) throw py::index_error();
+
         if(v == 6) return s.Epart[ip + 0*nparts];
         if(v == 7) return s.Epart[ip + 1*nparts];
         if(v == 8) return s.Epart[ip + 2*nparts];
@@ -223,6 +309,265 @@ auto declare_prtcl_container(
 }
 
 
+//--------------------------------------------------
+template<size_t D, class Scheme, typename T, class Parent>
+void declare_simd_pusher(
+    py::module& m,
+    Parent& parent,
+    const std::string& pyclass_name) 
+{
+  using SP = pic::SimdPusher<D,3,Scheme,T>;
+  py::class_<SP>(m, pyclass_name.c_str(), parent)
+    .def(py::init<>())
+    .def_property_readonly_static("lanes", [](py::object){ return SP::lanes; });
+}
+
+/// vectorized pushers in double (default) and single precision
+template<size_t D, class Parent>
+void declare_simd_pushers(
+    py::module& m,
+    Parent& parent) 
+{
+  declare_simd_pusher<D, pic::simd::Boris,       double>(m, parent, "SimdBorisPusher");
+  declare_simd_pusher<D, pic::simd::Vay,         double>(m, parent, "SimdVayPusher");
+  declare_simd_pusher<D, pic::simd::HigueraCary, double>(m, parent, "SimdHigueraCaryPusher");
+
+  declare_simd_pusher<D, pic::simd::Boris,       float >(m, parent, "SimdBorisPusherF32");
+  declare_simd_pusher<D, pic::simd::Vay,         float >(m, parent, "SimdVayPusherF32");
+  declare_simd_pusher<D, pic::simd::HigueraCary, float >(m, parent, "SimdHigueraCaryPusherF32");
+}
+
+
+//--------------------------------------------------
+template<size_t D>
+auto declare_fused_solver(
+    py::module& m,
+    const std::string& pyclass_name) 
+{
+  return py::class_<pic::FusedSolver<D>>(m, pyclass_name.c_str())
+    .def_readwrite("bx_ext",  &pic::FusedSolver<D>::bx_ext)
+    .def_readwrite("by_ext",  &pic::FusedSolver<D>::by_ext)
+    .def_readwrite("bz_ext",  &pic::FusedSolver<D>::bz_ext)
+    .def_readwrite("ex_ext",  &pic::FusedSolver<D>::ex_ext)
+    .def_readwrite("ey_ext",  &pic::FusedSolver<D>::ey_ext)
+    .def_readwrite("ez_ext",  &pic::FusedSolver<D>::ez_ext)
+    .def("solve", &pic::FusedSolver<D>::solve);
+}
+
+
+//--------------------------------------------------
+template<size_t D>
+auto declare_step_pipeline(
+    py::module& m,
+    const std::string& pyclass_name) 
+{
+  using SP = pic::StepPipeline<D>;
+
+  // solvers are stored as raw pointers; keep_alive ties their lifetime to the pipeline
+  return py::class_<SP>(m, pyclass_name.c_str())
+    .def(py::init<>())
+    .def_property("fldpropE", [](SP& s){ return s.fldpropE; },
+        py::cpp_function([](SP& s, emf::Propagator<D>* v){ s.fldpropE = v; }, py::keep_alive<1,2>()))
+    .def_property("fldpropB", [](SP& s){ return s.fldpropB; },
+        py::cpp_function([](SP& s, emf::Propagator<D>* v){ s.fldpropB = v; }, py::keep_alive<1,2>()))
+    .def_property("pusher",   [](SP& s){ return s.pusher; },
+        py::cpp_function([](SP& s, pic::Pusher<D,3>* v){ s.pusher = v; }, py::keep_alive<1,2>()))
+    .def_property("fintp",    [](SP& s){ return s.fintp; },
+        py::cpp_function([](SP& s, pic::Interpolator<D,3>* v){ s.fintp = v; }, py::keep_alive<1,2>()))
+    .def_property("currint",  [](SP& s){ return s.currint; },
+        py::cpp_function([](SP& s, pic::Depositer<D,3>* v){ s.currint = v; }, py::keep_alive<1,2>()))
+    .def_property("fused",    [](SP& s){ return s.fused; },
+        py::cpp_function([](SP& s, pic::FusedSolver<D>* v){ s.fused = v; }, py::keep_alive<1,2>()))
+    .def_property("flt",      [](SP& s){ return s.flt; },
+        py::cpp_function([](SP& s, emf::Filter<D>* v){ s.flt = v; }, py::keep_alive<1,2>()))
+    .def_property("exchanger",[](SP& s){ return s.exchanger; },
+        py::cpp_function([](SP& s, pic::RankExchanger<D>* v){ s.exchanger = v; }, py::keep_alive<1,2>()))
+    // same op dictionaries as in pytools.Scheduler.operate
+    .def("add_stage", [](SP& s, py::dict op)
+        {
+          auto name   = op["name"].cast<std::string>();
+          auto solver = op["solver"].cast<std::string>();
+          auto method = op["method"].cast<std::string>();
+          std::string nhood = op.contains("nhood") ? op["nhood"].cast<std::string>() : "all";
+
+          // keep only integer arguments; grid is given to run()
+          std::vector<int> args;
+          if(op.contains("args")) {
+            for(auto a : op["args"]) {
+              if(py::isinstance<py::int_>(a)) {
+                args.push_back(a.cast<int>());
+              } else if(py::isinstance<py::list>(a) || py::isinstance<py::tuple>(a)) {
+                for(auto b : a) args.push_back(b.cast<int>());
+              }
+            }
+          }
+
+          if(!s.add_stage(name, solver, method, nhood, args)) 
+            throw py::value_error("StepPipeline: unknown stage " + name);
+        })
+    .def_readwrite("threaded", &SP::threaded)
+    .def_property_readonly("counters", [](SP& s) -> toolbox::PerfCounters& { return s.counters; },
+        py::return_value_policy::reference_internal)
+    .def("clear",             &SP::clear)
+    .def("update_tile_lists", &SP::update_tile_lists)
+    .def("run_stage",         &SP::run_stage)
+    .def("__len__",           [](SP& s) { return s.stages.size(); })
+    .def("stage_names",       [](SP& s) 
+        {
+          std::vector<std::string> names;
+          for(auto& st : s.stages) names.push_back(st.name);
+          return names;
+        })
+    // timer is a pytools.Timer; each stage is reported with start_comp/stop_comp
+    .def("run", [](SP& s, corgi::Grid<D>& grid, py::object timer)
+        {
+          // stages overlap in threaded mode so they are timed as one component
+          // GIL is released so that python-side solvers can be called from worker threads
+          if(s.threaded) {
+            py::object t1;
+            if(!timer.is_none()) t1 = timer.attr("start_comp")("pipeline_tasks");
+            {
+              py::gil_scoped_release release;
+              s.run(grid);
+            }
+            if(!timer.is_none()) timer.attr("stop_comp")(t1);
+            return;
+          }
+
+          s.update_tile_lists(grid);
+          for(size_t i=0; i<s.stages.size(); i++) {
+            if(timer.is_none()) {
+              s.run_stage(grid, i);
+            } else {
+              auto t1 = timer.attr("start_comp")(s.stages[i].name);
+              s.run_stage(grid, i);
+              timer.attr("stop_comp")(t1);
+            }
+          }
+        }, py::arg("grid"), py::arg("timer") = py::none());
+}
+//--------------------------------------------------
+template<size_t D>
+auto declare_rank_exchanger(
+    py::module& m,
+    const std::string& pyclass_name) 
+{
+  return py::class_<pic::RankExchanger<D>>(m, pyclass_name.c_str())
+    .def(py::init<>())
+    .def_readwrite("halo_only",  &pic::RankExchanger<D>::halo_only)
+    .def("invalidate",           &pic::RankExchanger<D>::invalidate)
+    .def("update",               &pic::RankExchanger<D>::update)
+    .def("send_data",            &pic::RankExchanger<D>::send_data)
+    .def("recv_data",            &pic::RankExchanger<D>::recv_data)
+    .def("wait_data",            &pic::RankExchanger<D>::wait_data)
+    .def("number_of_neighbors",  &pic::RankExchanger<D>::number_of_neighbors);
+}
+
+//--------------------------------------------------
+template<size_t D>
+auto declare_tile_migrator(
+    py::module& m,
+    const std::string& pyclass_name) 
+{
+  return py::class_<pic::TileMigrator<D>>(m, pyclass_name.c_str())
+    .def(py::init<>())
+    .def("send_tile",     &pic::TileMigrator<D>::send_tile)
+    .def("recv_tile",     &pic::TileMigrator<D>::recv_tile)
+    .def("wait",          &pic::TileMigrator<D>::wait)
+    .def("remove_virtual_tile", &pic::TileMigrator<D>::remove_virtual_tile)
+    .def("remove_stale_tiles", &pic::TileMigrator<D>::remove_stale_tiles)
+    .def("num_outgoing",  &pic::TileMigrator<D>::num_outgoing)
+    .def("num_incoming",  &pic::TileMigrator<D>::num_incoming);
+}
+
+
+//--------------------------------------------------
+template<size_t D>
+auto declare_plasma_loader(
+    py::module& m,
+    const std::string& pyclass_name)
+{
+  using L = pic::PlasmaLoader<D>;
+
+  return py::class_<L>(m, pyclass_name.c_str())
+    .def(py::init<>())
+    .def_readwrite("seed",         &L::seed)
+    .def_readwrite("ppc",          &L::ppc)
+    .def_readwrite("theta",        &L::theta)
+    .def_readwrite("gamma",        &L::gamma)
+    .def_readwrite("wgt",          &L::wgt)
+    .def_readwrite("direction",    &L::direction)
+    .def_readwrite("dims",         &L::dims)
+    .def_readwrite("distribution", &L::distribution)
+    // python callables f(x,y,z); called with the GIL from the loader threads
+    .def_readwrite("density",      &L::density)
+    .def_readwrite("temperature",  &L::temperature)
+    .def_readwrite("drift",        &L::drift)
+    .def_readwrite("weight",       &L::weight)
+    // tabulated profile on the global cell grid; arr[i,j,k] with cell (0,0,0) at origin
+    .def("set_table", [](L& s, const std::string& name,
+          py::array_t<float, py::array::c_style | py::array::forcecast> arr,
+          std::array<float,3> origin)
+        {
+          if(arr.ndim() < 1 || arr.ndim() > 3) throw py::value_error("set_table: array must be 1-3 dimensional");
+
+          pic::TabulatedProfile tab;
+          tab.nx = arr.shape(0);
+          tab.ny = arr.ndim() > 1 ? arr.shape(1) : 1;
+          tab.nz = arr.ndim() > 2 ? arr.shape(2) : 1;
+          tab.x0 = origin[0];
+          tab.y0 = origin[1];
+          tab.z0 = origin[2];
+
+          // to x-fastest order
+          const float* a = arr.data();
+          tab.data.resize(tab.nx*tab.ny*tab.nz);
+          for(size_t i=0; i<tab.nx; i++)
+          for(size_t j=0; j<tab.ny; j++)
+          for(size_t k=0; k<tab.nz; k++)
+            tab.data[i + tab.nx*(j + tab.ny*k)] = a[k + tab.nz*(j + tab.ny*i)];
+
+          if     (name == "density")     s.density     = tab;
+          else if(name == "temperature") s.temperature = tab;
+          else if(name == "drift")       s.drift       = tab;
+          else if(name == "weight")      s.weight      = tab;
+          else throw py::value_error("set_table: unknown profile " + name);
+        },
+        py::arg("name"), py::arg("arr"), py::arg("origin") = std::array<float,3>{{0.0f, 0.0f, 0.0f}})
+    .def("load", &L::load,
+        py::arg("grid"), py::arg("ispcs"), py::arg("ref_species")=-1, py::arg("key0")=0,
+        py::call_guard<py::gil_scoped_release>())
+    .def("load_tile", &L::load_tile,
+        py::arg("tile"), py::arg("ispcs"), py::arg("ref_species")=-1, py::arg("key0")=0,
+        py::call_guard<py::gil_scoped_release>());
+}
+
+
+//--------------------------------------------------
+template<size_t D>
+auto declare_resampler(
+    py::module& m,
+    const std::string& pyclass_name)
+{
+  using R = pic::Resampler<D>;
+
+  return py::class_<R>(m, pyclass_name.c_str())
+    .def(py::init<>())
+    .def_readwrite("seed",         &R::seed)
+    .def_readwrite("max_ppc",      &R::max_ppc)
+    .def_readwrite("min_ppc",      &R::min_ppc)
+    .def_readwrite("n_ene",        &R::n_ene)
+    .def_readwrite("n_theta",      &R::n_theta)
+    .def_readwrite("n_phi",        &R::n_phi)
+    .def_readwrite("split_jitter", &R::split_jitter)
+    .def("merge", &R::merge, py::arg("tile"), py::arg("ispcs"), py::arg("max_ppc"), py::arg("lap")=0)
+    .def("split", &R::split, py::arg("tile"), py::arg("ispcs"), py::arg("min_ppc"), py::arg("lap")=0)
+    .def("solve", py::overload_cast<pic::Tile<D>&, int>(&R::solve), py::arg("tile"), py::arg("lap")=0)
+    .def("solve", py::overload_cast<corgi::Grid<D>&, int>(&R::solve), py::arg("grid"), py::arg("lap")=0,
+        py::call_guard<py::gil_scoped_release>());
+}
+
+
 namespace wall {
   // generator for wall tile
   template<size_t D, int S>
@@ -519,6 +864,12 @@ void bind_pic(py::module& m_sub)
   py::class_<pic::PhotonPusher<3,3>>(m_3d, "PhotonPusher", picpusher3d)
     .def(py::init<>());
 
+  //--------------------------------------------------
+  // vectorized pushers over SoA particle arrays
+  pic::declare_simd_pushers<1>(m_1d, picpusher1d);
+  pic::declare_simd_pushers<2>(m_2d, picpusher2d);
+  pic::declare_simd_pushers<3>(m_3d, picpusher3d);
+
   //--------------------------------------------------
 
   // General interpolator interface
@@ -580,6 +931,10 @@ void bind_pic(py::module& m_sub)
   py::class_< pic::Depositer<1,3>, PyDepositer<1> > picdeposit1d(m_1d, "Depositer");
   picdeposit1d
     .def(py::init<>())
+    .def_property("num_threads",
+        [](pic::Depositer<1,3>& s){ return s.engine.num_threads; },
+        [](pic::Depositer<1,3>& s, int v){ s.engine.num_threads = v; })
+    .def_property_readonly("last_num_threads", [](pic::Depositer<1,3>& s){ return s.engine.last_num_threads; })
     .def("solve", &pic::Depositer<1,3>::solve);
 
   // zigzag depositer
@@ -591,6 +946,10 @@ void bind_pic(py::module& m_sub)
   py::class_< pic::Depositer<2,3>, PyDepositer<2> > picdeposit2d(m_2d, "Depositer");
   picdeposit2d
     .def(py::init<>())
+    .def_property("num_threads",
+        [](pic::Depositer<2,3>& s){ return s.engine.num_threads; },
+        [](pic::Depositer<2,3>& s, int v){ s.engine.num_threads = v; })
+    .def_property_readonly("last_num_threads", [](pic::Depositer<2,3>& s){ return s.engine.last_num_threads; })
     .def("solve", &pic::Depositer<2,3>::solve);
 
   // zigzag depositer
@@ -612,6 +971,10 @@ void bind_pic(py::module& m_sub)
   py::class_< pic::Depositer<3,3>, PyDepositer<3> > picdeposit3d(m_3d, "Depositer");
   picdeposit3d
     .def(py::init<>())
+    .def_property("num_threads",
+        [](pic::Depositer<3,3>& s){ return s.engine.num_threads; },
+        [](pic::Depositer<3,3>& s, int v){ s.engine.num_threads = v; })
+    .def_property_readonly("last_num_threads", [](pic::Depositer<3,3>& s){ return s.engine.last_num_threads; })
     .def("solve", &pic::Depositer<3,3>::solve);
 
   // zigzag depositer
@@ -633,6 +996,61 @@ void bind_pic(py::module& m_sub)
   py::class_<pic::Esikerpov_4th<3,3>>(m_3d, "Esikerpov_4th", picdeposit3d)
     .def(py::init<>());
 
+  //--------------------------------------------------
+  // fused interpolate-push-deposit solvers
+  namespace pf = pic::fused;
+
+  auto picfused1d = pic::declare_fused_solver<1>(m_1d, "FusedSolver");
+  py::class_<pic::FusedKernel<1, pf::Linear, pf::Boris, pf::ZigZag>>(m_1d, "FusedLinearBorisZigZag", picfused1d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<1, pf::Linear, pf::Vay, pf::ZigZag>>(m_1d, "FusedLinearVayZigZag", picfused1d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<1, pf::Linear, pf::HigueraCary, pf::ZigZag>>(m_1d, "FusedLinearHigueraCaryZigZag", picfused1d)
+    .def(py::init<>());
+
+  auto picfused2d = pic::declare_fused_solver<2>(m_2d, "FusedSolver");
+  py::class_<pic::FusedKernel<2, pf::Linear, pf::Boris, pf::ZigZag>>(m_2d, "FusedLinearBorisZigZag", picfused2d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<2, pf::Linear, pf::Vay, pf::ZigZag>>(m_2d, "FusedLinearVayZigZag", picfused2d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<2, pf::Linear, pf::HigueraCary, pf::ZigZag>>(m_2d, "FusedLinearHigueraCaryZigZag", picfused2d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<2, pf::Quadratic, pf::Boris, pf::ZigZag>>(m_2d, "FusedQuadraticBorisZigZag", picfused2d)
+    .def(py::init<>());
+
+  auto picfused3d = pic::declare_fused_solver<3>(m_3d, "FusedSolver");
+  py::class_<pic::FusedKernel<3, pf::Linear, pf::Boris, pf::ZigZag>>(m_3d, "FusedLinearBorisZigZag", picfused3d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<3, pf::Linear, pf::Vay, pf::ZigZag>>(m_3d, "FusedLinearVayZigZag", picfused3d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<3, pf::Linear, pf::HigueraCary, pf::ZigZag>>(m_3d, "FusedLinearHigueraCaryZigZag", picfused3d)
+    .def(py::init<>());
+  py::class_<pic::FusedKernel<3, pf::Quadratic, pf::Boris, pf::ZigZag>>(m_3d, "FusedQuadraticBorisZigZag", picfused3d)
+    .def(py::init<>());
+
+  //--------------------------------------------------
+  // native time-step pipeline
+  auto sp1 = pic::declare_step_pipeline<1>(m_1d, "StepPipeline");
+  auto sp2 = pic::declare_step_pipeline<2>(m_2d, "StepPipeline");
+  auto sp3 = pic::declare_step_pipeline<3>(m_3d, "StepPipeline");
+
+  // rank-aggregated mpi communication
+  auto rx1 = pic::declare_rank_exchanger<1>(m_1d, "RankExchanger");
+  auto rx2 = pic::declare_rank_exchanger<2>(m_2d, "RankExchanger");
+  auto rx3 = pic::declare_rank_exchanger<3>(m_3d, "RankExchanger");
+
+  auto tm1 = pic::declare_tile_migrator<1>(m_1d, "TileMigrator");
+  auto tm2 = pic::declare_tile_migrator<2>(m_2d, "TileMigrator");
+  auto tm3 = pic::declare_tile_migrator<3>(m_3d, "TileMigrator");
+
+  auto pl1 = pic::declare_plasma_loader<1>(m_1d, "PlasmaLoader");
+  auto pl2 = pic::declare_plasma_loader<2>(m_2d, "PlasmaLoader");
+  auto pl3 = pic::declare_plasma_loader<3>(m_3d, "PlasmaLoader");
+
+  auto rs1 = pic::declare_resampler<1>(m_1d, "Resampler");
+  auto rs2 = pic::declare_resampler<2>(m_2d, "Resampler");
+  auto rs3 = pic::declare_resampler<3>(m_3d, "Resampler");
+
   //--------------------------------------------------
   //2 D piston
   py::class_<pic::Piston<2>>(m_2d, "Piston")
@@ -677,18 +1095,21 @@ void bind_pic(py::module& m_sub)
   py::class_<h5io::TestPrtclWriter<1>>(m_1d, "TestPrtclWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int, int, int>())
     .def("write",   &h5io::TestPrtclWriter<1>::write)
+    .def("write_async", &h5io::TestPrtclWriter<1>::write_async)
     .def_readwrite("ispc", &h5io::TestPrtclWriter<1>::ispc);
   
   // 2D test particles
   py::class_<h5io::TestPrtclWriter<2>>(m_2d, "TestPrtclWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int, int, int>())
     .def("write",   &h5io::TestPrtclWriter<2>::write)
+    .def("write_async", &h5io::TestPrtclWriter<2>::write_async)
     .def_readwrite("ispc", &h5io::TestPrtclWriter<2>::ispc);
 
   // 3D test particles
   py::class_<h5io::TestPrtclWriter<3>>(m_3d, "TestPrtclWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int, int, int>())
     .def("write",   &h5io::TestPrtclWriter<3>::write)
+    .def("write_async", &h5io::TestPrtclWriter<3>::write_async)
     .def_readwrite("ispc", &h5io::TestPrtclWriter<3>::ispc);
 
   //--------------------------------------------------
@@ -697,12 +1118,14 @@ void bind_pic(py::module& m_sub)
   // 1D
   py::class_<h5io::PicMomentsWriter<1>>(m_1d, "PicMomentsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write", &h5io::PicMomentsWriter<1>::write);
+    .def("write", &h5io::PicMomentsWriter<1>::write)
+    .def("write_async", &h5io::PicMomentsWriter<1>::write_async);
   
   // 2D
   py::class_<h5io::PicMomentsWriter<2>>(m_2d, "PicMomentsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
     .def("write",       &h5io::PicMomentsWriter<2>::write)
+    .def("write_async", &h5io::PicMomentsWriter<2>::write_async)
     .def("get_slice", [](h5io::PicMomentsWriter<2> &s, int k)
             {
                 const auto nx = static_cast<pybind11::ssize_t>( s.nx );
@@ -714,12 +1137,14 @@ void bind_pic(py::module& m_sub)
   // 3D
   py::class_<h5io::PicMomentsWriter<3>>(m_3d, "PicMomentsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write", &h5io::PicMomentsWriter<3>::write);
+    .def("write", &h5io::PicMomentsWriter<3>::write)
+    .def("write_async", &h5io::PicMomentsWriter<3>::write_async);
 
   // 3D
   py::class_<h5io::MasterPicMomentsWriter<3>>(m_3d, "MasterPicMomentsWriter")
     .def(py::init<const std::string&, int, int, int, int, int, int, int>())
-    .def("write", &h5io::MasterPicMomentsWriter<3>::write);
+    .def("write", &h5io::MasterPicMomentsWriter<3>::write)
+    .def("write_async", &h5io::MasterPicMomentsWriter<3>::write_async);
 
 
   //--------------------------------------------------
@@ -727,16 +1152,44 @@ void bind_pic(py::module& m_sub)
 
   // 1D
   m_1d.def("write_particles",  &pic::write_particles<1>);
+  m_1d.def("write_particles_async",  &pic::write_particles_async<1>);
   m_1d.def("read_particles",   &pic::read_particles<1>);
   
   // 2D
   m_2d.def("write_particles",  &pic::write_particles<2>);
+  m_2d.def("write_particles_async",  &pic::write_particles_async<2>);
   m_2d.def("read_particles",   &pic::read_particles<2>);
 
   // 3D
   m_3d.def("write_particles",  &pic::write_particles<3>);
+  m_3d.def("write_particles_async",  &pic::write_particles_async<3>);
   m_3d.def("read_particles",   &pic::read_particles<3>);
 
+  // single-file checkpoints of fields and particles; can be read with any number of ranks
+  py::class_<h5io::Checkpoint<1>>(m_1d, "Checkpoint")
+    .def(py::init<std::string, int>(), py::arg("dir"), py::arg("compression")=0)
+    .def_readwrite("compression", &h5io::Checkpoint<1>::compression)
+    .def_readwrite("chunk_size",  &h5io::Checkpoint<1>::chunk_size)
+    .def("file_name", &h5io::Checkpoint<1>::file_name)
+    .def("write",     &h5io::Checkpoint<1>::write)
+    .def("read",      &h5io::Checkpoint<1>::read);
+
+  py::class_<h5io::Checkpoint<2>>(m_2d, "Checkpoint")
+    .def(py::init<std::string, int>(), py::arg("dir"), py::arg("compression")=0)
+    .def_readwrite("compression", &h5io::Checkpoint<2>::compression)
+    .def_readwrite("chunk_size",  &h5io::Checkpoint<2>::chunk_size)
+    .def("file_name", &h5io::Checkpoint<2>::file_name)
+    .def("write",     &h5io::Checkpoint<2>::write)
+    .def("read",      &h5io::Checkpoint<2>::read);
+
+  py::class_<h5io::Checkpoint<3>>(m_3d, "Checkpoint")
+    .def(py::init<std::string, int>(), py::arg("dir"), py::arg("compression")=0)
+    .def_readwrite("compression", &h5io::Checkpoint<3>::compression)
+    .def_readwrite("chunk_size",  &h5io::Checkpoint<3>::chunk_size)
+    .def("file_name", &h5io::Checkpoint<3>::file_name)
+    .def("write",     &h5io::Checkpoint<3>::write)
+    .def("read",      &h5io::Checkpoint<3>::read);
+
   //--------------------------------------------------
   // wall
   auto tw13d = pic::wall::declare_tile<3, -1>(m_3d, "Tile_wall_LX");
@@ -775,10 +1228,11 @@ void bind_pic(py::module& m_sub)
     .def_readwrite("ninj_phots",     &pic::Star<2>::ninj_phots)
     .def_readwrite("ninj_min_pairs", &pic::Star<2>::ninj_min_pairs)
     .def_readwrite("ninj_min_phots", &pic::Star<2>::ninj_min_phots)
+    .def_readwrite("seed",           &pic::Star<2>::seed)
     .def("insert_em",                &pic::Star<2>::insert_em)
     .def("update_b",                 &pic::Star<2>::update_b)
     .def("update_e",                 &pic::Star<2>::update_e)
-    .def("solve",                    &pic::Star<2>::solve);
+    .def("solve",                    &pic::Star<2>::solve, py::arg("tile"), py::arg("lap")=0);
 
 
   // 3D rotating conductor
@@ -806,10 +1260,11 @@ void bind_pic(py::module& m_sub)
     .def_readwrite("ninj_phots",     &pic::Star<3>::ninj_phots)
     .def_readwrite("ninj_min_pairs", &pic::Star<3>::ninj_min_pairs)
     .def_readwrite("ninj_min_phots", &pic::Star<3>::ninj_min_phots)
+    .def_readwrite("seed",           &pic::Star<3>::seed)
     .def("insert_em",                &pic::Star<3>::insert_em)
     .def("update_b",                 &pic::Star<3>::update_b)
     .def("update_e",                 &pic::Star<3>::update_e)
-    .def("solve",                    &pic::Star<3>::solve);
+    .def("solve",                    &pic::Star<3>::solve, py::arg("tile"), py::arg("lap")=0);
 
 
 }
@@ -53,22 +53,25 @@ public:
 
 
   // trampoline for each  virtual function
+  //
+  // species ids are converted back to container type strings (species_name)
+  // so that python overrides see the same types as the python-side methods
  
   using tuple_pair = std::tuple<float, float>; // following macro does not accept commas so we define this
 
-  tuple_pair get_minmax_ene( string t1, string t2, double ene) override { 
+  tuple_pair get_minmax_ene( int t1, int t2, double ene) override { 
     PYBIND11_OVERLOAD_PURE(
         tuple_pair, // return type
         Interaction,                // parent class
         get_minmax_ene,             // name of function in C++
-        t1, // arguments
-        t2,
+        species_name(t1), // arguments
+        species_name(t2),
         ene
         );
   }
 
   float comp_optical_depth( 
-    string t1, 
+    int t1, 
     float ux1, float uy1, float uz1,
     float ex,  float ey,  float ez,
     float bx,  float by,  float bz
@@ -77,18 +80,18 @@ public:
         float, // return type
         Interaction,                  // parent class
         comp_optical_depth,           // name of function in C++
-        t1, ux1, uy1, uz1, ex,ey,ez,bx,by,bz
+        species_name(t1), ux1, uy1, uz1, ex,ey,ez,bx,by,bz
         );
   }
 
   tuple_pair comp_cross_section( 
-    string t1, float ux1, float uy1, float uz1,
-    string t2, float ux2, float uy2, float uz2) override {
+    int t1, float ux1, float uy1, float uz1,
+    int t2, float ux2, float uy2, float uz2) override {
     PYBIND11_OVERLOAD_PURE(
         tuple_pair, // return type
         Interaction,                  // parent class
         comp_cross_section,           // name of function in C++
-        t1, ux1, uy1, uz1, t2, ux2, uy2, uz2
+        species_name(t1), ux1, uy1, uz1, species_name(t2), ux2, uy2, uz2
         );
   }
 
@@ -109,26 +112,26 @@ public:
   //      );
   //  }
 
-  tuple_pair accumulate( string t1, float e1, string t2, float e2) override { 
+  tuple_pair accumulate( int t1, float e1, int t2, float e2) override { 
     PYBIND11_OVERLOAD_PURE(
         tuple_pair, // return type
         Interaction,               // parent class
         accumulate,                // name of function in C++
-        t1, // arguments
+        species_name(t1), // arguments
         e1,
-        t2,
+        species_name(t2),
         e2
         );
   }
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override {
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override {
     PYBIND11_OVERLOAD_PURE(
         void,                       // return type
         Interaction,                // parent class
         interact,                   // name of function in C++
-        t1, ux1, uy1, uz1, t2, ux2, uy2, uz2
+        species_name(t1), ux1, uy1, uz1, species_name(t2), ux2, uy2, uz2
         );
     }
 
@@ -168,17 +171,41 @@ void bind_qed(py::module& m_sub)
   py::class_< qed::Interaction, std::shared_ptr<qed::Interaction>, PyInteraction > qedinter(m_sub, "Interaction");
   qedinter
     .def_readwrite("do_accumulate", &qed::Interaction::do_accumulate)
+    .def_readwrite("use_tables",    &qed::Interaction::use_tables)
     .def(py::init<string, string>())
-    .def("get_minmax_ene",      &qed::Interaction::get_minmax_ene)
-    .def("comp_cross_section",  &qed::Interaction::comp_cross_section)
-    .def("comp_optical_depth",  &qed::Interaction::comp_optical_depth)
-    .def("accumulate",          &qed::Interaction::accumulate)
+    .def("build_tables",   &qed::Interaction::build_tables)
+    .def("table_accuracy", &qed::Interaction::table_accuracy)
+    // species are given as container type strings on the python side
+    .def("get_minmax_ene", [](qed::Interaction &self, string t1, string t2, double ene) 
+        {
+          return self.get_minmax_ene(species_id(t1), species_id(t2), ene);
+        })
+    .def("comp_cross_section", [](qed::Interaction &self, 
+          string t1, float ux1, float uy1, float uz1,
+          string t2, float ux2, float uy2, float uz2) 
+        {
+          return self.comp_cross_section(species_id(t1), ux1, uy1, uz1,  species_id(t2), ux2, uy2, uz2);
+        })
+    .def("comp_optical_depth", [](qed::Interaction &self, 
+          string t1, 
+          float ux1, float uy1, float uz1,
+          float ex,  float ey,  float ez,
+          float bx,  float by,  float bz)
+        {
+          return self.comp_optical_depth(species_id(t1), ux1, uy1, uz1, ex, ey, ez, bx, by, bz);
+        })
+    .def("accumulate", [](qed::Interaction &self, string t1, float e1, string t2, float e2) 
+        {
+          return self.accumulate(species_id(t1), e1, species_id(t2), e2);
+        })
     .def("interact", [](qed::Interaction &self, 
           std::string t1, float ux1, float uy1, float uz1,
           std::string t2, float ux2, float uy2, float uz2) 
         {
-          self.interact(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2); 
-          return std::make_tuple(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2);
+          int s1 = species_id(t1);
+          int s2 = species_id(t2);
+          self.interact(s1, ux1, uy1, uz1,  s2, ux2, uy2, uz2); 
+          return std::make_tuple(species_name(s1), ux1, uy1, uz1,  species_name(s2), ux2, uy2, uz2);
         });
 
   // Pair annihilation 
@@ -230,14 +257,25 @@ void bind_qed(py::module& m_sub)
     .def_readwrite("inj_ene_ph",  &qed::Pairing<2>::inj_ene_ph)
     .def_readwrite("inj_ene_ep",  &qed::Pairing<2>::inj_ene_ep)
     .def_readwrite("tau_global",  &qed::Pairing<2>::tau_global)
+    .def_readwrite("seed",        &qed::Pairing<2>::seed)
+    .def_readwrite("cell_bin",    &qed::Pairing<2>::cell_bin)
     .def("comp_tau",           &qed::Pairing<2>::comp_tau)
-    .def("leak_photons",       &qed::Pairing<2>::leak_photons)
+    .def("leak_photons",       &qed::Pairing<2>::leak_photons, py::arg("tile"), py::arg("tc_per_dt"), py::arg("tau_ext"), py::arg("lap"))
     .def("update_hist_lims",   &qed::Pairing<2>::update_hist_lims)
     .def("clear_hist",         &qed::Pairing<2>::clear_hist)
-    .def("solve_onebody",      &qed::Pairing<2>::solve_onebody)
-    .def("solve_twobody",      &qed::Pairing<2>::solve_twobody)
+    .def("solve_onebody",      &qed::Pairing<2>::solve_onebody, py::arg("tile"), py::arg("lap"))
+    .def("solve_twobody",      &qed::Pairing<2>::solve_twobody, py::arg("tile"), py::arg("lap"))
+    // solve all local tiles of the grid concurrently
+    .def("solve_tiles", [](qed::Pairing<2>& s, corgi::Grid<2>& grid, int lap, double tc_per_dt, double tau_ext)
+        {
+          std::vector<pic::Tile<2>*> tiles;
+          for(auto cid : grid.get_local_tiles()) tiles.push_back( &dynamic_cast<pic::Tile<2>&>(grid.get_tile(cid)) );
+
+          py::gil_scoped_release release;
+          s.solve_tiles(tiles, lap, tc_per_dt, tau_ext);
+        }, py::arg("grid"), py::arg("lap"), py::arg("tc_per_dt")=0.0, py::arg("tau_ext")=0.0)
     .def("add_interaction",    &qed::Pairing<2>::add_interaction, py::keep_alive<1,2>() )
-    .def("rescale",            &qed::Pairing<2>::rescale)
+    .def("rescale",            &qed::Pairing<2>::rescale, py::arg("tile"), py::arg("t1"), py::arg("f_kill"), py::arg("lap"))
     .def("get_hist_edges",   [](qed::Pairing<2>& s)
         {
           const auto N = static_cast<pybind11::ssize_t>(s.hist_nbin);
@@ -250,8 +288,10 @@ void bind_qed(py::module& m_sub)
           auto v = pybind11::array_t<double>( {N}, s.hist.data() );
           return v;
         })
-    .def("timer_stats",    [](qed::Pairing<2>& s) { s.timer.comp_stats(); })
-    .def("timer_clear",    [](qed::Pairing<2>& s) { s.timer.clear(); });
+    .def_property_readonly("counters", [](qed::Pairing<2>& s) -> toolbox::PerfCounters& { return s.counters; },
+        py::return_value_policy::reference_internal)
+    .def("timer_stats",    [](qed::Pairing<2>& s) { s.counters.print("qed pairing"); })
+    .def("timer_clear",    [](qed::Pairing<2>& s) { s.counters.clear(); });
 
 
     //-------------------------------------------------- 
@@ -266,16 +306,27 @@ void bind_qed(py::module& m_sub)
     .def_readwrite("inj_ene_ph",  &qed::Pairing<3>::inj_ene_ph)
     .def_readwrite("inj_ene_ep",  &qed::Pairing<3>::inj_ene_ep)
     .def_readwrite("tau_global",  &qed::Pairing<3>::tau_global)
+    .def_readwrite("seed",        &qed::Pairing<3>::seed)
+    .def_readwrite("cell_bin",    &qed::Pairing<3>::cell_bin)
     .def("add_interaction",    &qed::Pairing<3>::add_interaction, py::keep_alive<1,2>() )
-    .def("rescale",            &qed::Pairing<3>::rescale)
-    .def("inject_photons",     &qed::Pairing<3>::inject_photons)
-    .def("inject_plaw_pairs",  &qed::Pairing<3>::inject_plaw_pairs)
+    .def("rescale",            &qed::Pairing<3>::rescale, py::arg("tile"), py::arg("t1"), py::arg("f_kill"), py::arg("lap"))
+    .def("inject_photons",     &qed::Pairing<3>::inject_photons, py::arg("tile"), py::arg("temp_inj"), py::arg("wph_inj"), py::arg("Nph_inj"), py::arg("lap"))
+    .def("inject_plaw_pairs",  &qed::Pairing<3>::inject_plaw_pairs, py::arg("tile"), py::arg("slope"), py::arg("pmin"), py::arg("pmax"), py::arg("w_inj"), py::arg("N_inj"), py::arg("lap"))
     .def("comp_tau",           &qed::Pairing<3>::comp_tau)
-    .def("leak_photons",       &qed::Pairing<3>::leak_photons)
+    .def("leak_photons",       &qed::Pairing<3>::leak_photons, py::arg("tile"), py::arg("tc_per_dt"), py::arg("tau_ext"), py::arg("lap"))
     .def("update_hist_lims",   &qed::Pairing<3>::update_hist_lims)
     .def("clear_hist",         &qed::Pairing<3>::clear_hist)
-    .def("solve_onebody",      &qed::Pairing<3>::solve_onebody)
-    .def("solve_twobody",      &qed::Pairing<3>::solve_twobody)
+    .def("solve_onebody",      &qed::Pairing<3>::solve_onebody, py::arg("tile"), py::arg("lap"))
+    .def("solve_twobody",      &qed::Pairing<3>::solve_twobody, py::arg("tile"), py::arg("lap"))
+    // solve all local tiles of the grid concurrently
+    .def("solve_tiles", [](qed::Pairing<3>& s, corgi::Grid<3>& grid, int lap, double tc_per_dt, double tau_ext)
+        {
+          std::vector<pic::Tile<3>*> tiles;
+          for(auto cid : grid.get_local_tiles()) tiles.push_back( &dynamic_cast<pic::Tile<3>&>(grid.get_tile(cid)) );
+
+          py::gil_scoped_release release;
+          s.solve_tiles(tiles, lap, tc_per_dt, tau_ext);
+        }, py::arg("grid"), py::arg("lap"), py::arg("tc_per_dt")=0.0, py::arg("tau_ext")=0.0)
     .def("get_hist_edges",   [](qed::Pairing<3>& s)
         {
           const auto N = static_cast<pybind11::ssize_t>(s.hist_nbin);
@@ -288,8 +339,10 @@ void bind_qed(py::module& m_sub)
           auto v = pybind11::array_t<double>( {N}, s.hist.data() );
           return v;
         })
-    .def("timer_stats",    [](qed::Pairing<3>& s) { s.timer.comp_stats(); })
-    .def("timer_clear",    [](qed::Pairing<3>& s) { s.timer.clear(); });
+    .def_property_readonly("counters", [](qed::Pairing<3>& s) -> toolbox::PerfCounters& { return s.counters; },
+        py::return_value_policy::reference_internal)
+    .def("timer_stats",    [](qed::Pairing<3>& s) { s.counters.print("qed pairing"); })
+    .def("timer_clear",    [](qed::Pairing<3>& s) { s.counters.clear(); });
 
 
   //--------------------------------------------------
@@ -303,15 +356,17 @@ void bind_qed(py::module& m_sub)
     .def_readwrite("inj_ene_ph",  &qed::PairingAll2All<3>::inj_ene_ph)
     .def_readwrite("inj_ene_ep",  &qed::PairingAll2All<3>::inj_ene_ep)
     .def_readwrite("tau_global",  &qed::PairingAll2All<3>::tau_global)
+    .def_readwrite("seed",        &qed::PairingAll2All<3>::seed)
+    .def_readwrite("cell_bin",    &qed::PairingAll2All<3>::cell_bin)
     .def("add_interaction",       &qed::PairingAll2All<3>::add_interaction, py::keep_alive<1,2>() )
-    .def("rescale",               &qed::PairingAll2All<3>::rescale)
-    .def("inject_photons",        &qed::PairingAll2All<3>::inject_photons)
-    .def("inject_plaw_pairs",     &qed::PairingAll2All<3>::inject_plaw_pairs)
+    .def("rescale",               &qed::PairingAll2All<3>::rescale, py::arg("tile"), py::arg("t1"), py::arg("f_kill"), py::arg("lap"))
+    .def("inject_photons",        &qed::PairingAll2All<3>::inject_photons, py::arg("tile"), py::arg("temp_inj"), py::arg("wph_inj"), py::arg("Nph_inj"), py::arg("lap"))
+    .def("inject_plaw_pairs",     &qed::PairingAll2All<3>::inject_plaw_pairs, py::arg("tile"), py::arg("slope"), py::arg("pmin"), py::arg("pmax"), py::arg("w_inj"), py::arg("N_inj"), py::arg("lap"))
     .def("comp_tau",              &qed::PairingAll2All<3>::comp_tau)
-    .def("leak_photons",          &qed::PairingAll2All<3>::leak_photons)
+    .def("leak_photons",          &qed::PairingAll2All<3>::leak_photons, py::arg("tile"), py::arg("tc_per_dt"), py::arg("tau_ext"), py::arg("lap"))
     .def("update_hist_lims",      &qed::PairingAll2All<3>::update_hist_lims)
     .def("clear_hist",            &qed::PairingAll2All<3>::clear_hist)
-    .def("solve_twobody",         &qed::PairingAll2All<3>::solve_twobody)
+    .def("solve_twobody",         &qed::PairingAll2All<3>::solve_twobody, py::arg("tile"), py::arg("lap"))
     .def("get_hist_edges",   [](   qed::PairingAll2All<3>& s)
         {
           const auto N = static_cast<pybind11::ssize_t>(s.hist_nbin);
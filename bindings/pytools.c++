@@ -1,10 +1,13 @@
 #include "py_submodules.h"
+#include <pybind11/numpy.h>
 
 #include "external/corgi/pybind11/include/pybind11/operators.h"
 #include "definitions.h"
 #include "tools/mesh.h"
 #include "core/vlv/amr/mesh.h"
 #include "tools/hilbert.h"
+#include "tools/perf_counters.h"
+#include "io/async_writer.h"
 
 #include <exception>
 
@@ -33,8 +36,29 @@ void declare_mesh(
       toolbox::Mesh<T,H>,
       std::shared_ptr<toolbox::Mesh<T,H>>
       //std::unique_ptr<toolbox::Mesh<T,H>,py::nodelete>
-            >(m, pyclass_name.c_str())
+            >(m, pyclass_name.c_str(), py::buffer_protocol())
     .def(py::init<int, int, int>())
+    // numpy.asarray(mesh) gives the full storage including halos; x-fastest
+    .def_buffer([](Class &s) -> py::buffer_info
+      {
+        const size_t nx = s.Nx + 2*H, ny = s.Ny + 2*H, nz = s.Nz + 2*H;
+        return py::buffer_info(
+            s.data(), sizeof(T), py::format_descriptor<T>::format(), 3,
+            { nx, ny, nz },
+            { sizeof(T), sizeof(T)*nx, sizeof(T)*nx*ny });
+      })
+    // zero-copy view indexed as [i,j,k]; halo=True starts from -H
+    .def("view", [](py::object self, bool halo)
+      {
+        auto& s = self.cast<Class&>();
+        const int h = halo ? 0 : H;
+        const size_t nx = s.Nx + 2*H, ny = s.Ny + 2*H;
+        return py::array_t<T>(
+            { (size_t)(s.Nx + 2*H - 2*h), (size_t)(s.Ny + 2*H - 2*h), (size_t)(s.Nz + 2*H - 2*h) },
+            { sizeof(T), sizeof(T)*nx, sizeof(T)*nx*ny },
+            s.data() + h + nx*(h + ny*h),
+            self); // array keeps the mesh (and its tile) alive
+      }, py::arg("halo")=false)
     //.def("Nx", &Class::Nx)
     //.def("Ny", &Class::Ny)
     //.def("Nz", &Class::Nz)
@@ -165,6 +189,47 @@ void bind_tools(pybind11::module& m)
     .def("get_level_0_cell_length", &AM3d::get_level_0_cell_length);
 
 
+  //--------------------------------------------------
+  // performance counters; totals are returned as a list of dicts for pytools.counters
+  py::class_<toolbox::PerfCounters>(m, "PerfCounters")
+    .def(py::init<>())
+    .def_readwrite("enabled",  &toolbox::PerfCounters::enabled)
+    .def("add_counter",        &toolbox::PerfCounters::add_counter)
+    .def("get_id",             &toolbox::PerfCounters::get_id)
+    .def("start",              &toolbox::PerfCounters::start)
+    .def("stop",               &toolbox::PerfCounters::stop, py::arg("id"), py::arg("items")=0, py::arg("bytes")=0)
+    .def("count",              &toolbox::PerfCounters::count, py::arg("id"), py::arg("items"), py::arg("bytes")=0)
+    .def("clear",              &toolbox::PerfCounters::clear)
+    .def("report",             &toolbox::PerfCounters::report, py::arg("title")="")
+    .def("print",              &toolbox::PerfCounters::print,  py::arg("title")="")
+    .def("__len__",            &toolbox::PerfCounters::size)
+    .def("totals", [](toolbox::PerfCounters& s)
+        {
+          py::list ret;
+          for(auto& tot : s.totals()) {
+            py::dict d;
+            d["name"]               = tot.name;
+            d["seconds"]            = tot.seconds;
+            d["max_thread_seconds"] = tot.max_thread_seconds;
+            d["calls"]              = tot.calls;
+            d["items"]              = tot.items;
+            d["bytes"]              = tot.bytes;
+            ret.append(d);
+          }
+          return ret;
+        });
+
+  //--------------------------------------------------
+  // background hdf5 writer thread shared by the snapshot and checkpoint writers
+  py::class_<h5io::AsyncWriter>(m, "AsyncWriter")
+    .def(py::init<size_t>(), py::arg("max_in_flight")=2)
+    .def_readwrite("max_in_flight", &h5io::AsyncWriter::max_in_flight)
+    .def_property_readonly("num_written", [](h5io::AsyncWriter& s){ return s.num_written.load(); })
+    .def_property_readonly("num_failed",  [](h5io::AsyncWriter& s){ return s.num_failed.load(); })
+    .def("wait",                    &h5io::AsyncWriter::wait, py::call_guard<py::gil_scoped_release>())
+    .def("num_in_flight",           &h5io::AsyncWriter::num_in_flight);
+
+
 
 
 
@@ -22,6 +22,7 @@ void emf::Binomial2<1>::solve(
   const float C1[3] = {1./4., 2./4., 1./4.};
 
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
 
   // halo width
   const int H = 2; 
@@ -94,6 +95,7 @@ void emf::Binomial2<2>::solve(
           {1./16., 2./16., 1./16.} };
 
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
 
   const int H = 2; 
 
@@ -181,6 +183,7 @@ void emf::Binomial2<3>::solve(
           { {1./64., 2./64., 1./64.}, {2./64., 4./64., 2./64.}, {1./64., 2./64., 1./64.} } };
 
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
   const int H = 2; 
 
 
@@ -31,6 +31,7 @@ void emf::Compensator2<2>::solve(
 
 
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
   const int H = 2; 
   const int k = 0;
 
@@ -1,5 +1,13 @@
 #pragma once
 
+#include <vector>
+#include <memory>
+#include <cassert>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "definitions.h"
 #include "core/emf/tile.h"
 #include "tools/mesh.h"
@@ -26,10 +34,35 @@ class Filter: public ManagedParent
   ///internal scratch container (size equal to jx/jy/jz)
   toolbox::Mesh<float, 3> tmp;
 
+  /// scratch containers of threads > 0; allocated on first use by each thread
+  std::vector<std::unique_ptr<toolbox::Mesh<float, 3>>> thread_tmps;
+
   Filter(int Nx, int Ny, int Nz) : 
     Nx{Nx}, Ny{Ny}, Nz{Nz},
     tmp{Nx,Ny,Nz}
-  {}
+  { }
+
+  /// scratch container of the calling thread
+  toolbox::Mesh<float, 3>& get_tmp()
+  {
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+    if(tid > 0) {
+      toolbox::Mesh<float, 3>* ptr = nullptr;
+
+      // other threads may grow thread_tmps at the same time
+      #pragma omp critical(emf_filter_get_tmp)
+      {
+        if((size_t)tid > thread_tmps.size()) thread_tmps.resize(tid);
+        auto& slot = thread_tmps[tid-1];
+        if(!slot) slot = std::make_unique<toolbox::Mesh<float, 3>>(Nx, Ny, Nz);
+        ptr = slot.get();
+      }
+      return *ptr;
+    }
+#endif
+    return tmp;
+  }
 
   virtual ~Filter() = default;
 
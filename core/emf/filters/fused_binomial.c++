@@ -0,0 +1,194 @@
+#include <cmath>
+#include <array>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+
+#include "core/emf/filters/fused_binomial.h"
+
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+namespace {
+
+/// weights of P merged 3-point binomial passes: C(2P, m)/4^P for m = 0..2P
+std::vector<float> binomial_weights(int P)
+{
+  std::vector<double> c(2*P+1, 0.0);
+  c[0] = 1.0;
+  for(int n=1; n<=2*P; n++) {
+    for(int m=n; m>0; m--) c[m] += c[m-1]; // Pascal's triangle
+  }
+
+  const double norm = std::pow(4.0, P);
+  std::vector<float> w(2*P+1);
+  for(int m=0; m<=2*P; m++) w[m] = static_cast<float>(c[m]/norm);
+  return w;
+}
+
+
+/// filter one component of the mesh in place
+//
+// Each input plane k is filtered along x into xb (all rows of the plane
+// halo) and then along y into a ring of 2Pz+1 planes. Output plane k-Pz is
+// the weighted sum of the ring planes along z. All work arrays are a few
+// planes large so they stay in cache; inner loops run along contiguous x.
+template<size_t D>
+void filter_component(
+    toolbox::Mesh<float, 3>& jj,
+    float* buf,
+    size_t buf_size,
+    const std::array<int, 3>& lens,
+    const std::vector<float>& w,
+    int P,
+    bool compensate)
+{
+  const int H = 3; // halo width of the mesh
+
+  // halo depth of input (h) and kernel half-width (p) per dimension;
+  // dimensions that are not filtered have none
+  int h[3], p[3], r[3], W[3];
+  for(int d=0; d<3; d++) {
+    h[d] = d < (int)D ? H : 0;
+    p[d] = d < (int)D ? P : 0;
+    r[d] = h[d] - p[d];         // halo depth of the output
+    W[d] = lens[d] + 2*r[d];    // output width
+  }
+
+  const int Wx  = W[0];
+  const int Nyi = lens[1] + 2*h[1]; // input rows per plane
+  const int Wy  = W[1];
+  const int nring = 2*p[2] + 1;
+
+  const size_t plane = size_t(Wx)*Wy;
+  float* xb   = buf;                    // x-filtered rows of the current input plane
+  float* ring = buf + size_t(Wx)*Nyi;   // y-filtered planes for the z sum
+  assert(size_t(Wx)*Nyi + nring*plane <= buf_size);
+
+  // weights along y and z; identity for dimensions that are not filtered
+  const float one = 1.0f;
+  const float* wy = D >= 2 ? w.data() : &one;
+  const float* wz = D >= 3 ? w.data() : &one;
+
+  for(int kk=-h[2]; kk<lens[2]+h[2]; kk++) {
+
+    //--------------------------------------------------
+    // x pass
+    for(int j=-h[1]; j<lens[1]+h[1]; j++) {
+      float* out = xb + size_t(j + h[1])*Wx;
+      const float* in = &jj(-r[0]-p[0], j, kk);
+
+      #pragma omp simd
+      for(int i=0; i<Wx; i++) out[i] = w[0]*in[i];
+
+      for(int m=1; m<=2*p[0]; m++) {
+        const float wm = w[m];
+        #pragma omp simd
+        for(int i=0; i<Wx; i++) out[i] += wm*in[i+m];
+      }
+    }
+
+    //--------------------------------------------------
+    // y pass into the ring
+    float* rp = ring + size_t((kk + h[2]) % nring)*plane;
+    for(int j=0; j<Wy; j++) {
+      float* out = rp + size_t(j)*Wx;
+      const float* in = xb + size_t(j)*Wx; // row j - r - p of the input
+
+      #pragma omp simd
+      for(int i=0; i<Wx; i++) out[i] = wy[0]*in[i];
+
+      for(int m=1; m<=2*p[1]; m++) {
+        const float wm = wy[m];
+        const float* inm = in + size_t(m)*Wx;
+        #pragma omp simd
+        for(int i=0; i<Wx; i++) out[i] += wm*inm[i];
+      }
+    }
+
+    //--------------------------------------------------
+    // z sum of planes k-p..k+p into the mesh; input planes <= kk are not read anymore
+    const int k = kk - p[2];
+    if(k < -r[2]) continue;
+
+    if(compensate && D == 2) {
+      // 3-point compensator from Birdsall & Langdon; (20,-1,-1)/12 with corners
+      const float wtm = 20.0f/12.0f, wts = -1.0f/12.0f, wtc = -1.0f/12.0f;
+
+      for(int j=1; j<Wy-1; j++) {
+        const float* c = rp + size_t(j)*Wx;
+        const float* d = c - Wx;
+        const float* u = c + Wx;
+        float* out = &jj(-r[0]+1, -r[1]+j, k);
+
+        #pragma omp simd
+        for(int i=1; i<Wx-1; i++) {
+          out[i-1] =
+            wtc*d[i-1] + wts*d[i] + wtc*d[i+1] +
+            wts*c[i-1] + wtm*c[i] + wts*c[i+1] +
+            wtc*u[i-1] + wts*u[i] + wtc*u[i+1];
+        }
+      }
+      continue;
+    }
+
+    for(int j=0; j<Wy; j++) {
+      float* out = &jj(-r[0], -r[1]+j, k);
+
+      const float* in0 = ring + size_t((k - p[2] + h[2] + nring) % nring)*plane + size_t(j)*Wx;
+      #pragma omp simd
+      for(int i=0; i<Wx; i++) out[i] = wz[0]*in0[i];
+
+      for(int m=1; m<=2*p[2]; m++) {
+        const float wm = wz[m];
+        const float* inm = ring + size_t((k - p[2] + m + h[2] + nring) % nring)*plane + size_t(j)*Wx;
+        #pragma omp simd
+        for(int i=0; i<Wx; i++) out[i] += wm*inm[i];
+      }
+    }
+  }
+}
+
+} // end of anonymous namespace
+
+
+template<size_t D>
+void emf::FusedBinomial2<D>::solve(
+    emf::Tile<D>& tile)
+{
+  // stencil has to fit into the halo of the mesh; npasses is set from python
+  if(npasses < 1) 
+    throw std::invalid_argument("FusedBinomial2: npasses has to be at least 1");
+  if(npasses + (compensate ? 1 : 0) > 3) 
+    throw std::invalid_argument("FusedBinomial2: npasses (+1 with compensate) has to be at most 3");
+  if(compensate && D != 2) 
+    throw std::invalid_argument("FusedBinomial2: compensate is only available in 2D");
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch; only used as storage for a few planes
+
+  const auto w = binomial_weights(npasses);
+
+  float* buf = &tmp(-3, -3, -3);
+  const size_t buf_size = size_t(tmp.Nx + 6)*(tmp.Ny + 6)*(tmp.Nz + 6);
+
+  filter_component<D>(mesh.jx, buf, buf_size, tile.mesh_lengths, w, npasses, compensate);
+  filter_component<D>(mesh.jy, buf, buf_size, tile.mesh_lengths, w, npasses, compensate);
+  filter_component<D>(mesh.jz, buf, buf_size, tile.mesh_lengths, w, npasses, compensate);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+template class emf::FusedBinomial2<1>; // 1D
+template class emf::FusedBinomial2<2>; // 2D
+template class emf::FusedBinomial2<3>; // 3D
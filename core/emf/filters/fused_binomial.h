@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/emf/filters/filter.h"
+
+namespace emf {
+
+/// Fused multi-pass digital filter
+//
+// Applies npasses 3-point binomial passes (same as calling Binomial2 npasses
+// times) and optionally the Compensator2 stencil in a single traversal of
+// each current component. The passes are merged into one separable
+// (2 npasses + 1)-point binomial kernel that is applied along x and y one
+// z-plane at a time; filtered planes are kept in a small ring buffer for the
+// z direction and the result is written back in place. The thread-private
+// scratch mesh only provides the memory of a few planes, so nothing is
+// cleared or swapped.
+//
+// The stencil reaches npasses (+1 with the compensator) cells into the halo,
+// so one halo update serves all passes as long as this fits into the halo of
+// the mesh (3 cells). Values are updated on the interior and on the part of
+// the halo that can still be computed from the halo data.
+//
+// NOTE: the compensator is only available in 2D (as Compensator2).
+// solve throws std::invalid_argument if npasses or compensate are out of
+// these limits.
+template<size_t D>
+class FusedBinomial2 :
+  public virtual Filter<D>
+{
+  public:
+
+  using Filter<D>::Filter;
+
+  /// number of binomial passes
+  int npasses = 1;
+
+  /// apply Compensator2 after the passes
+  bool compensate = false;
+
+  void solve(emf::Tile<D>& tile) override;
+
+};
+
+} // end of namespace emf
@@ -24,6 +24,7 @@ void emf::General3p<2>::solve(
                wtc=winv*(1.0-alpha)*(1.0-alpha); //corner
 
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
   const int H = 2; 
   const int k = 0;
 
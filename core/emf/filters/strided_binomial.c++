@@ -23,6 +23,7 @@ void emf::General3pStrided<2>::solve(
                wtc=winv * (1.0-alpha)*(1.0-alpha); //corner
     
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
 
   const int H = 0; 
   const int k = 0;
@@ -113,6 +114,7 @@ void emf::Binomial2Strided2<2>::solve(
   const double wn=1./16.0/16.0;  //normalization
     
   auto& mesh = tile.get_grids();
+  auto& tmp  = this->get_tmp(); // thread-private scratch
   const int H = 0; 
   const int k = 0;
     
@@ -0,0 +1,157 @@
+#include <algorithm>
+
+#include "core/emf/propagators/fdtd2_blocked.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+namespace {
+
+/// B half step of row (j,k) for i in [i0, i1[; same update as FDTD2<3>::push_half_b
+inline void b_row(emf::Grids& m, int j, int k, int i0, int i1, const float C)
+{
+  float* bx = &m.bx(0,j,k);
+  float* by = &m.by(0,j,k);
+  float* bz = &m.bz(0,j,k);
+
+  const float* ex  = &m.ex(0,j,  k  );
+  const float* exj = &m.ex(0,j+1,k  );
+  const float* exk = &m.ex(0,j,  k+1);
+  const float* ey  = &m.ey(0,j,  k  );
+  const float* eyk = &m.ey(0,j,  k+1);
+  const float* ez  = &m.ez(0,j,  k  );
+  const float* ezj = &m.ez(0,j+1,k  );
+
+  #pragma omp simd
+  for(int i=i0; i<i1; i++) {
+    bx[i] += + C*( eyk[i]  - ey[i])
+             + C*(-ezj[i]  + ez[i]);
+    by[i] += + C*( ez[i+1] - ez[i])
+             + C*(-exk[i]  + ex[i]);
+    bz[i] += + C*( exj[i]  - ex[i])
+             + C*(-ey[i+1] + ey[i]);
+  }
+}
+
+/// E step of row (j,k) for i in [i0, i1[; same update as FDTD2<3>::push_e
+inline void e_row(emf::Grids& m, int j, int k, int i0, int i1, const float C)
+{
+  float* ex = &m.ex(0,j,k);
+  float* ey = &m.ey(0,j,k);
+  float* ez = &m.ez(0,j,k);
+
+  const float* bx  = &m.bx(0,j,  k  );
+  const float* bxj = &m.bx(0,j-1,k  );
+  const float* bxk = &m.bx(0,j,  k-1);
+  const float* by  = &m.by(0,j,  k  );
+  const float* byk = &m.by(0,j,  k-1);
+  const float* bz  = &m.bz(0,j,  k  );
+  const float* bzj = &m.bz(0,j-1,k  );
+
+  #pragma omp simd
+  for(int i=i0; i<i1; i++) {
+    ex[i] += + C*( byk[i]  - by[i])
+             + C*(-bzj[i]  + bz[i]);
+    ey[i] += + C*( bz[i-1] - bz[i])
+             + C*(-bxk[i]  + bx[i]);
+    ez[i] += + C*( bxj[i]  - bx[i])
+             + C*(-by[i-1] + by[i]);
+  }
+}
+
+/// call f(j,k) for rows j in [j0,j1[ and k in [k0,k1[ brick by brick
+//
+// Bricks are visited with z outermost and rows inside a brick in (k,j)
+// order, so every row (j,k) comes after rows (j-1,k) and (j,k-1).
+template<typename F>
+inline void for_each_row(int j0, int j1, int k0, int k1, int by, int bz, F&& f)
+{
+  for(int kb=k0; kb<k1; kb+=bz)
+  for(int jb=j0; jb<j1; jb+=by) {
+    const int ke = std::min(kb+bz, k1);
+    const int je = std::min(jb+by, j1);
+    for(int k=kb; k<ke; k++)
+    for(int j=jb; j<je; j++) f(j, k);
+  }
+}
+
+} // end of anonymous namespace
+
+
+/// 3D E pusher
+template<>
+void emf::FDTD2Blocked<3>::push_e(emf::Tile<3>& tile)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  Grids& mesh = tile.get_grids();
+  const float C = 1.0 * tile.cfl * dt * corr;
+  const int Nx = tile.mesh_lengths[0];
+
+  for_each_row(0, tile.mesh_lengths[1], 0, tile.mesh_lengths[2], brick_y, brick_z,
+      [&](int j, int k) { e_row(mesh, j, k, 0, Nx, C); });
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+/// 3D B pusher
+template<>
+void emf::FDTD2Blocked<3>::push_half_b(emf::Tile<3>& tile)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  Grids& mesh = tile.get_grids();
+  const float C = 0.5 * tile.cfl * dt * corr;
+  const int Nx = tile.mesh_lengths[0];
+
+  for_each_row(0, tile.mesh_lengths[1], 0, tile.mesh_lengths[2], brick_y, brick_z,
+      [&](int j, int k) { b_row(mesh, j, k, 0, Nx, C); });
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+/// 3D fused B half step + E step
+//
+// E of row (j,k) reads B of rows (j,k), (j-1,k), and (j,k-1), and cell i-1;
+// B of row (j,k) reads E of rows (j,k), (j+1,k), and (j,k+1), and cell i+1.
+// Rows are visited so that (j-1,k) and (j,k-1) come before (j,k), so B
+// is always new and E is always old where it is read. B is computed on the
+// extra lower halo row/plane/cell (-1) that E reads.
+template<>
+void emf::FDTD2Blocked<3>::push_half_b_e(emf::Tile<3>& tile)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  Grids& mesh = tile.get_grids();
+  const float Cb = 0.5 * tile.cfl * dt * corr;
+  const float Ce = 1.0 * tile.cfl * dt * corr;
+  const int Nx = tile.mesh_lengths[0];
+
+  for_each_row(-1, tile.mesh_lengths[1], -1, tile.mesh_lengths[2], brick_y, brick_z,
+      [&](int j, int k)
+      {
+        b_row(mesh, j, k, -1, Nx, Cb);
+        if(j >= 0 && k >= 0) e_row(mesh, j, k, 0, Nx, Ce);
+      });
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+template class emf::FDTD2Blocked<3>;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "core/emf/propagators/propagator.h"
+
+namespace emf {
+
+/// Cache-blocked second order FDTD Maxwell's field equation solver
+//
+// Same scheme as FDTD2 but the mesh is swept in bricks of brick_y x brick_z
+// rows; each row is updated along x with vectorized loops.
+//
+// push_half_b_e does push_half_b followed by push_e in one sweep: B of a row
+// is updated right before E of the same row is, so both fields are touched
+// only once. B is also updated on the lower halo layer (-1) so that the B
+// halo update in between is not needed; this requires up-to-date E and B
+// halos. The B halos are left stale afterwards.
+//
+// NOTE: only implemented in 3D.
+template<size_t D>
+class FDTD2Blocked :
+  public virtual Propagator<D>
+{
+  public:
+
+  /// numerical correction factor to speed of light
+  double corr = 1.0;
+
+  /// brick size in rows along y and z
+  int brick_y = 8;
+  int brick_z = 8;
+
+  void push_e(Tile<D>& tile) override;
+
+  void push_half_b(Tile<D>& tile) override;
+
+  /// push_half_b and push_e in one sweep (temporal blocking)
+  void push_half_b_e(Tile<D>& tile);
+};
+
+
+} // end of namespace emf
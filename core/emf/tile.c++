@@ -1360,6 +1360,99 @@ std::vector<mpi::request> Tile<D>::recv_data(
   return reqs;
 }
 
+//--------------------------------------------------
+// halo-only communication
+//
+// Neighbor tile in direction d reads only a slab of this tile:
+//   update_boundaries copies the 3 outermost interior cells and
+//   exchange_currents adds the 3 halo cells. Along the axes where d=0
+//   the slab spans the interior. Currents (mode 0) need both.
+
+namespace {
+
+/// cell range [beg, end) along one axis of length N for direction d
+inline void halo_slab_range(int d, int N, int mode, int& beg, int& end)
+{
+  const int halo = 3;
+
+  if(d == 0) { 
+    beg = 0; 
+    end = N; 
+  } else if(d == +1) { 
+    beg = N - halo; 
+    end = mode == 0 ? N + halo : N; 
+  } else { 
+    beg = mode == 0 ? -halo : 0; 
+    end = halo; 
+  }
+}
+
+inline std::array<toolbox::Mesh<float,3>*, 3> mode_components(Grids& gs, int mode)
+{
+  if(mode == 0) return {{ &gs.jx, &gs.jy, &gs.jz }};
+  if(mode == 1) return {{ &gs.ex, &gs.ey, &gs.ez }};
+  assert(mode == 2);
+  return {{ &gs.bx, &gs.by, &gs.bz }};
+}
+
+} // end of anonymous namespace
+
+
+template<std::size_t D>
+size_t Tile<D>::halo_slab_size(int mode, const std::array<int,3>& dir)
+{
+  auto& gs = get_grids(); 
+  int ib, ie, jb, je, kb, ke;
+  halo_slab_range(dir[0], gs.Nx, mode, ib, ie);
+  halo_slab_range(dir[1], gs.Ny, mode, jb, je);
+  halo_slab_range(dir[2], gs.Nz, mode, kb, ke);
+
+  return 3*size_t(ie-ib)*size_t(je-jb)*size_t(ke-kb);
+}
+
+
+template<std::size_t D>
+void Tile<D>::pack_halo_slab(int mode, const std::array<int,3>& dir, std::vector<float>& buf)
+{
+  auto& gs = get_grids(); 
+  int ib, ie, jb, je, kb, ke;
+  halo_slab_range(dir[0], gs.Nx, mode, ib, ie);
+  halo_slab_range(dir[1], gs.Ny, mode, jb, je);
+  halo_slab_range(dir[2], gs.Nz, mode, kb, ke);
+
+  for(auto* m : mode_components(gs, mode)) {
+    for(int k=kb; k<ke; k++) 
+    for(int j=jb; j<je; j++) 
+    for(int i=ib; i<ie; i++) buf.push_back( (*m)(i,j,k) );
+  }
+}
+
+
+template<std::size_t D>
+size_t Tile<D>::unpack_halo_slab(
+    int mode, 
+    const std::array<int,3>& dir, 
+    const std::vector<float>& buf, 
+    size_t offs)
+{
+  auto& gs = get_grids(); 
+  int ib, ie, jb, je, kb, ke;
+  halo_slab_range(dir[0], gs.Nx, mode, ib, ie);
+  halo_slab_range(dir[1], gs.Ny, mode, jb, je);
+  halo_slab_range(dir[2], gs.Nz, mode, kb, ke);
+
+  assert(offs + halo_slab_size(mode, dir) <= buf.size());
+
+  for(auto* m : mode_components(gs, mode)) {
+    for(int k=kb; k<ke; k++) 
+    for(int j=jb; j<je; j++) 
+    for(int i=ib; i<ie; i++) (*m)(i,j,k) = buf[offs++];
+  }
+
+  return offs;
+}
+
+
 //--------------------------------------------------
 // explicit template instantiation
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <mpi4cpp/mpi.h>
 
 #include "external/corgi/tile.h"
@@ -188,6 +189,18 @@ class Tile :
   std::vector<mpi::request> 
   recv_data( mpi::communicator& /*comm*/, int orig, int mode, int tag) override;
 
+  //--------------------------------------------------
+  // halo-only communication
+
+  /// number of values of mode's components that a neighbor in direction dir reads
+  size_t halo_slab_size(int mode, const std::array<int,3>& dir);
+
+  /// append halo slab that the neighbor in direction dir reads to buf
+  void pack_halo_slab(int mode, const std::array<int,3>& dir, std::vector<float>& buf);
+
+  /// copy halo slab of direction dir from buf starting at offs; returns offset after the slab
+  size_t unpack_halo_slab(int mode, const std::array<int,3>& dir, const std::vector<float>& buf, size_t offs);
+
 };
 
 
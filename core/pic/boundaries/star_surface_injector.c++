@@ -30,7 +30,7 @@ using emf::StaggeredSphericalCoordinates;
 // simple pseudo-random floats with C library rand() (outputting int's).
 // note that we do not call srand( seed ) so it is set to seed(1). 
 //
-// NOTE: we now use the full Mersenne Twister from std
+// NOTE: we now use the counter-based streams of tools/rng.h
 //
 //inline float rand_uni(float a, float b) {
 //  return ((b - a) * ((float)rand() / RAND_MAX)) + a;
@@ -39,8 +39,11 @@ using emf::StaggeredSphericalCoordinates;
 
 template<size_t D>
 void pic::Star<D>::solve(
-    pic::Tile<D>& tile)
+    pic::Tile<D>& tile,
+    int lap)
 {
+  // random stream of this tile and lap
+  toolbox::thread_stream().reset(seed, toolbox::stream_id(tile.cid, 0, lap));
 
   // Tile limits
   auto mins = tile.mins;
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <random>
+#include <cstdint>
 
 #include "core/emf/boundaries/conductor.h"
 #include "core/pic/tile.h"
+#include "tools/rng.h"
 
 namespace pic {
 
@@ -15,10 +16,6 @@ class Star :
 
 private:
 
-  std::random_device rd;
-  std::mt19937 gen;
-  std::uniform_real_distribution<float> uni_dis;
-
   // using raw pointer instead of smart ptrs; it does not take ownership of the object
   // so the container is not deleted when the temporary storage goes out of scope.
   using ConPtr = pic::ParticleContainer<D>* ;
@@ -59,15 +56,15 @@ public:
   double ninj_min_pairs = 0.01; // minimum pairs per cell per step to inject
   double ninj_min_phots = 0.0;  // minimum photons per cell per step to inject
 
-  Star() :
-    gen(42), // gen(rd() ) 
-    uni_dis(0.0, 1.0)
-  { }
+  // seed of the random streams; streams are keyed by (seed, tile, lap)
+  uint64_t seed = 42;
+
+  Star() { }
 
   // random numbers between [0, 1[
-  float rand() { return uni_dis(gen); };
+  float rand() { return toolbox::thread_stream().uniform(); };
 
-  void solve(pic::Tile<D>&  tile);
+  void solve(pic::Tile<D>&  tile, int lap = 0);
 
 };
 
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "definitions.h"
+#include "core/pic/tile.h"
+#include "external/iter/iter.h"
+
+
+namespace pic {
+
+/// Current arrays that depositer kernels add to
+//
+// Points either to the tile currents or to a thread-private copy with the
+// same halo-padded layout, so kernels index both identically.
+struct CurrentAccumulator
+{
+  /// halo width of emf::Grids meshes
+  static constexpr int H = 3;
+
+  float* jx_ptr = nullptr;
+  float* jy_ptr = nullptr;
+  float* jz_ptr = nullptr;
+
+  int Nx = 0;
+  int Ny = 0;
+  int Nz = 0;
+
+  CurrentAccumulator() = default;
+
+  CurrentAccumulator(float* jx, float* jy, float* jz, int Nx, int Ny, int Nz) :
+    jx_ptr{jx}, jy_ptr{jy}, jz_ptr{jz}, Nx{Nx}, Ny{Ny}, Nz{Nz}
+  {}
+
+  /// 1D index with the same layout as toolbox::Mesh<float,3>
+  DEVCALLABLE inline size_t indx(int i, int j, int k) const {
+    return i + H + (Nx + 2*H)*( (j + H) + (Ny + 2*H)*(k + H));
+  }
+
+  DEVCALLABLE inline float& jx(size_t ind) { return jx_ptr[ind]; }
+  DEVCALLABLE inline float& jy(size_t ind) { return jy_ptr[ind]; }
+  DEVCALLABLE inline float& jz(size_t ind) { return jz_ptr[ind]; }
+
+  DEVCALLABLE inline float& jx(int i, int j, int k) { return jx_ptr[indx(i,j,k)]; }
+  DEVCALLABLE inline float& jy(int i, int j, int k) { return jy_ptr[indx(i,j,k)]; }
+  DEVCALLABLE inline float& jz(int i, int j, int k) { return jz_ptr[indx(i,j,k)]; }
+
+  /// add to current; targets are never shared between CPU threads so no atomics are needed
+  template<typename S>
+  DEVCALLABLE static inline void add(float& lhs, S rhs) {
+#ifdef GPU
+    atomic_add(lhs, rhs);
+#else
+    lhs += rhs;
+#endif
+  }
+};
+
+
+/*! \brief Particle loop and current reduction shared by the depositers
+ *
+ * Depositers supply a per-particle kernel
+ *   kernel(size_t n, CurrentAccumulator& acc, ParticleContainer<D>& con)
+ * that adds its stencil to acc; species with zero charge are skipped.
+ *
+ * Threading is opt-in through num_threads. With one thread (the default,
+ * or when called inside a parallel region, e.g., from StepPipeline tasks)
+ * the kernel adds straight to the tile currents without atomics.
+ * Otherwise every thread deposits its share of particles
+ * to a private current tile and the private tiles are summed to the tile
+ * currents after the particle loop. Private tiles are kept between calls.
+ *
+ * On GPU the kernel is run with UniIter and atomic adds.
+ */
+template<size_t D>
+class DepositEngine
+{
+  public:
+
+  /// maximum number of threads; 1 (default) is serial, 0 uses omp_get_max_threads()
+  int num_threads = 1;
+
+  /// number of threads used in the last deposit
+  int last_num_threads = 1;
+
+  /// thread-private current tiles (jx, jy, jz stacked)
+  std::vector<std::vector<float>> thread_currents;
+
+  /// number of threads used for a tile with nprtcls charged particles and Nmesh cells
+  int get_num_threads(size_t nprtcls, size_t Nmesh) const
+  {
+#ifdef _OPENMP
+    if(omp_in_parallel()) return 1;
+
+    int nthr = num_threads > 0 ? num_threads : omp_get_max_threads();
+
+    // every thread needs to deposit at least as many particles as it reduces cells
+    nthr = std::min<size_t>(nthr, std::max<size_t>(1, nprtcls/std::max<size_t>(1, Nmesh)));
+    return nthr;
+#else
+    return 1;
+#endif
+  }
+
+  template<class Kernel>
+  void deposit(pic::Tile<D>& tile, Kernel kernel)
+  {
+    auto& gs = tile.get_grids();
+    CurrentAccumulator acc(gs.jx.data(), gs.jy.data(), gs.jz.data(), gs.jx.Nx, gs.jx.Ny, gs.jx.Nz);
+
+#ifdef GPU
+    for(auto&& con : tile.containers) {
+      if(con.q == 0.0) continue;
+      UniIter::iterate(kernel, con.size(), acc, con);
+      UniIter::sync();
+    }
+#else
+
+    size_t nprtcls = 0;
+    for(auto&& con : tile.containers) if(con.q != 0.0) nprtcls += con.size();
+
+    const size_t Nmesh = gs.jx.size();
+    const int nthr = get_num_threads(nprtcls, Nmesh);
+    last_num_threads = std::max(nthr, 1);
+
+    //--------------------------------------------------
+    // serial; direct adds to tile currents
+    if(nthr <= 1) {
+      for(auto&& con : tile.containers) {
+        if(con.q == 0.0) continue;
+        for(size_t n=0; n<con.size(); n++) kernel(n, acc, con);
+      }
+      return;
+    }
+
+    //--------------------------------------------------
+    // threaded; private current tiles + reduction
+    if(thread_currents.size() < (size_t)nthr) thread_currents.resize(nthr);
+
+    #pragma omp parallel num_threads(nthr)
+    {
+#ifdef _OPENMP
+      const int tid = omp_get_thread_num();
+#else
+      const int tid = 0;
+#endif
+      auto& buf = thread_currents[tid];
+      buf.assign(3*Nmesh, 0.0f);
+
+      CurrentAccumulator pacc(buf.data(), buf.data() + Nmesh, buf.data() + 2*Nmesh, gs.jx.Nx, gs.jx.Ny, gs.jx.Nz);
+
+      for(auto&& con : tile.containers) {
+        if(con.q == 0.0) continue;
+
+        #pragma omp for schedule(static)
+        for(size_t n=0; n<con.size(); n++) kernel(n, pacc, con);
+      }
+      // implicit barrier of omp for; all private tiles are complete
+
+      #pragma omp for schedule(static)
+      for(size_t i=0; i<Nmesh; i++) {
+        for(int t=0; t<nthr; t++) {
+          const auto& tb = thread_currents[t];
+          acc.jx(i) += tb[i];
+          acc.jy(i) += tb[i +   Nmesh];
+          acc.jz(i) += tb[i + 2*Nmesh];
+        }
+      }
+    }
+#endif
+  }
+
+};
+
+} // end of namespace pic
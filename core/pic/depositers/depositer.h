@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/pic/tile.h"
+#include "core/pic/depositers/deposit_engine.h"
 #include "definitions.h"
 
 
@@ -17,6 +18,9 @@ class Depositer
 
   virtual ~Depositer() = default;
 
+  /// particle loop and thread-private current reduction
+  DepositEngine<D> engine;
+
   /// \brief deposit current to grid
   virtual void solve(pic::Tile<D>& ) = 0;
 
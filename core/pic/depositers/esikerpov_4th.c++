@@ -43,20 +43,16 @@ void pic::Esikerpov_4th<D,V>::solve( pic::Tile<D>& tile )
   const auto Nz = gs.Nz;
 
 
-  for(auto&& con : tile.containers) {
+  const double c = tile.cfl;    // speed of light
 
-    const double c = tile.cfl;    // speed of light
-    const double q = con.q; // charge
-                            //
-    // skip particle species if zero charge
-    if (q == 0.0) continue;
+  // species with zero charge are skipped by the engine
+  this->engine.deposit(tile, [=] DEVCALLABLE (
+                size_t n, 
+                pic::CurrentAccumulator& acc,
+                pic::ParticleContainer<D>& con
+                ){
 
-    //UniIter::iterate([=] DEVCALLABLE (
-    //            size_t n, 
-    //            emf::Grids &gs,
-    //            pic::ParticleContainer<D>& con
-    //            ){
-    for(size_t n=0; n<con.size(); n++) {
+      const double q = con.q; // charge
 
       // shape arrays
       double 
@@ -159,7 +155,7 @@ void pic::Esikerpov_4th<D,V>::solve( pic::Tile<D>& tile )
                            + DSy[j]*DSz[k]/3.);
 
             // TODO: 1d indexing
-            atomic_add( gs.jx(iloc, jloc, kloc), tmpJx[j][k] );
+            acc.add( acc.jx(iloc, jloc, kloc), tmpJx[j][k] );
             //atomic_add( gs.jx(i2p+i-offset, j2p+j-offset, k2p+k-offset), tmpJx[j][k] );
       }}}
 
@@ -184,7 +180,7 @@ void pic::Esikerpov_4th<D,V>::solve( pic::Tile<D>& tile )
                            + DSz[k]*DSx[i]/3.);
 
 
-            atomic_add( gs.jy(iloc, jloc, kloc), tmpJy[i][k] );
+            acc.add( acc.jy(iloc, jloc, kloc), tmpJy[i][k] );
             //atomic_add( gs.jy(i2p+i-offset, j2p+j-offset, k2p+k-offset), tmpJy[i][k] );
       }}}
 
@@ -210,7 +206,7 @@ void pic::Esikerpov_4th<D,V>::solve( pic::Tile<D>& tile )
                            + DSx[i]*DSy[j]/3.);
 
 
-            atomic_add( gs.jz(iloc, jloc, kloc), tmpJz[i][j] );
+            acc.add( acc.jz(iloc, jloc, kloc), tmpJz[i][j] );
             //atomic_add( gs.jz(i2p+i-offset, j2p+j-offset, k2p+k-offset), tmpJz[i][j] );
       }}}
 
@@ -249,10 +245,7 @@ void pic::Esikerpov_4th<D,V>::solve( pic::Tile<D>& tile )
       }
 
 
-    }
-    //}, con.size(), gs, con);
-
-  }//end of loop over species
+  });
 
 }
 
@@ -32,20 +32,16 @@ void pic::ZigZag_2nd<D,V>::solve( pic::Tile<D>& tile )
   gs.jz.clear();
 
 
-  for(auto&& con : tile.containers) {
+  const double c = tile.cfl;    // speed of light
 
-    const double c = tile.cfl;    // speed of light
-    const double q = con.q; // charge
-                            //
-    // skip particle species if zero charge
-    if (q == 0.0) continue;
+  // species with zero charge are skipped by the engine
+  this->engine.deposit(tile, [=] DEVCALLABLE (
+                size_t n, 
+                pic::CurrentAccumulator& acc,
+                pic::ParticleContainer<D>& con
+                ){
 
-    //UniIter::iterate([=] DEVCALLABLE (
-    //            size_t n, 
-    //            emf::Grids &gs,
-    //            pic::ParticleContainer<D>& con
-    //            ){
-    for(size_t n=0; n<con.size(); n++) {
+      const double q = con.q; // charge
 
       //--------------------------------------------------
       double u = con.vel(0,n);
@@ -274,10 +270,10 @@ void pic::ZigZag_2nd<D,V>::solve( pic::Tile<D>& tile )
         //if(D >= 1) atomic_add( gs.jx(i2d  , j2p+yi, k2p+zi), qvx2* Wx2[1]* Wyy2[yi+1]*Wzz2[zi+1] );
         //if(D >= 1) atomic_add( gs.jx(i2d+1, j2p+yi, k2p+zi), qvx2* Wx2[2]* Wyy2[yi+1]*Wzz2[zi+1] );
 
-        if(D >= 1) atomic_add( gs.jx(i1d-1, j1p+yi, k1p+zi), qvx1* Wx1[1]* Wyy1[yi+1]*Wzz1[zi+1] );
-        if(D >= 1) atomic_add( gs.jx(i1d  , j1p+yi, k1p+zi), qvx1* Wx1[2]* Wyy1[yi+1]*Wzz1[zi+1] );
-        if(D >= 1) atomic_add( gs.jx(i2d-1, j2p+yi, k2p+zi), qvx2* Wx2[1]* Wyy2[yi+1]*Wzz2[zi+1] );
-        if(D >= 1) atomic_add( gs.jx(i2d  , j2p+yi, k2p+zi), qvx2* Wx2[2]* Wyy2[yi+1]*Wzz2[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i1d-1, j1p+yi, k1p+zi), qvx1* Wx1[1]* Wyy1[yi+1]*Wzz1[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i1d  , j1p+yi, k1p+zi), qvx1* Wx1[2]* Wyy1[yi+1]*Wzz1[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i2d-1, j2p+yi, k2p+zi), qvx2* Wx2[1]* Wyy2[yi+1]*Wzz2[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i2d  , j2p+yi, k2p+zi), qvx2* Wx2[2]* Wyy2[yi+1]*Wzz2[zi+1] );
 
       }
 
@@ -295,10 +291,10 @@ void pic::ZigZag_2nd<D,V>::solve( pic::Tile<D>& tile )
         //if(D >= 2) atomic_add( gs.jy(i2p+xi, j2d  , k2p+zi), qvy2* Wy2[1] *Wxx2[xi+1]*Wzz2[zi+1] );
         //if(D >= 1) atomic_add( gs.jy(i2p+xi, j2d+1, k2p+zi), qvy2* Wy2[2] *Wxx2[xi+1]*Wzz2[zi+1] );
 
-        if(D >= 2) atomic_add( gs.jy(i1p+xi, j1d-1, k1p+zi), qvy1* Wy1[1] *Wxx1[xi+1]*Wzz1[zi+1] );
-        if(D >= 1) atomic_add( gs.jy(i1p+xi, j1d  , k1p+zi), qvy1* Wy1[2] *Wxx1[xi+1]*Wzz1[zi+1] );
-        if(D >= 2) atomic_add( gs.jy(i2p+xi, j2d-1, k2p+zi), qvy2* Wy2[1] *Wxx2[xi+1]*Wzz2[zi+1] );
-        if(D >= 1) atomic_add( gs.jy(i2p+xi, j2d  , k2p+zi), qvy2* Wy2[2] *Wxx2[xi+1]*Wzz2[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i1p+xi, j1d-1, k1p+zi), qvy1* Wy1[1] *Wxx1[xi+1]*Wzz1[zi+1] );
+        if(D >= 1) acc.add( acc.jy(i1p+xi, j1d  , k1p+zi), qvy1* Wy1[2] *Wxx1[xi+1]*Wzz1[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i2p+xi, j2d-1, k2p+zi), qvy2* Wy2[1] *Wxx2[xi+1]*Wzz2[zi+1] );
+        if(D >= 1) acc.add( acc.jy(i2p+xi, j2d  , k2p+zi), qvy2* Wy2[2] *Wxx2[xi+1]*Wzz2[zi+1] );
       }                                                                                
                                                                                        
       //jz                                                                             
@@ -315,16 +311,13 @@ void pic::ZigZag_2nd<D,V>::solve( pic::Tile<D>& tile )
         //if(D >= 3) atomic_add( gs.jz(i2p+xi, j2p+yi, k2d  ), qvz2* Wz2[1] *Wxx2[xi+1]*Wyy2[yi+1] );
         //if(D >= 1) atomic_add( gs.jz(i2p+xi, j2p+yi, k2d+1), qvz2* Wz2[2] *Wxx2[xi+1]*Wyy2[yi+1] );
 
-        if(D >= 3) atomic_add( gs.jz(i1p+xi, j1p+yi, k1d-1), qvz1* Wz1[1] *Wxx1[xi+1]*Wyy1[yi+1] );
-        if(D >= 1) atomic_add( gs.jz(i1p+xi, j1p+yi, k1d  ), qvz1* Wz1[2] *Wxx1[xi+1]*Wyy1[yi+1] );
-        if(D >= 3) atomic_add( gs.jz(i2p+xi, j2p+yi, k2d-1), qvz2* Wz2[1] *Wxx2[xi+1]*Wyy2[yi+1] );
-        if(D >= 1) atomic_add( gs.jz(i2p+xi, j2p+yi, k2d  ), qvz2* Wz2[2] *Wxx2[xi+1]*Wyy2[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i1p+xi, j1p+yi, k1d-1), qvz1* Wz1[1] *Wxx1[xi+1]*Wyy1[yi+1] );
+        if(D >= 1) acc.add( acc.jz(i1p+xi, j1p+yi, k1d  ), qvz1* Wz1[2] *Wxx1[xi+1]*Wyy1[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i2p+xi, j2p+yi, k2d-1), qvz2* Wz2[1] *Wxx2[xi+1]*Wyy2[yi+1] );
+        if(D >= 1) acc.add( acc.jz(i2p+xi, j2p+yi, k2d  ), qvz2* Wz2[2] *Wxx2[xi+1]*Wyy2[yi+1] );
       }
 
-    }
-    //}, con.size(), gs, con);
-
-  }//end of loop over species
+  });
 
 }
 
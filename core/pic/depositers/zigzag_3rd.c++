@@ -32,20 +32,16 @@ void pic::ZigZag_3rd<D,V>::solve( pic::Tile<D>& tile )
   gs.jz.clear();
 
 
-  for(auto&& con : tile.containers) {
+  const double c = tile.cfl;    // speed of light
 
-    const double c = tile.cfl;    // speed of light
-    const double q = con.q; // charge
-                            //
-    // skip particle species if zero charge
-    if (q == 0.0) continue;
+  // species with zero charge are skipped by the engine
+  this->engine.deposit(tile, [=] DEVCALLABLE (
+                size_t n, 
+                pic::CurrentAccumulator& acc,
+                pic::ParticleContainer<D>& con
+                ){
 
-    //UniIter::iterate([=] DEVCALLABLE (
-    //            size_t n, 
-    //            emf::Grids &gs,
-    //            pic::ParticleContainer<D>& con
-    //            ){
-    for(size_t n=0; n<con.size(); n++) {
+      const double q = con.q; // charge
 
       //--------------------------------------------------
       double u = con.vel(0,n);
@@ -187,14 +183,14 @@ void pic::ZigZag_3rd<D,V>::solve( pic::Tile<D>& tile )
         //"(" << i2-1 <<","<< j2+yi <<","<< k2+zi <<") " <<
         //"(" << i2   <<","<< j2+yi <<","<< k2+zi <<") " << "\n";
 
-        if(D >= 2) atomic_add( gs.jx(i1-1, j1+yi, k1+zi), qvx1* Wx1[0]* Wyy1[yi+1]*Wzz1[zi+1] );
-        if(D >= 1) atomic_add( gs.jx(i1  , j1+yi, k1+zi), qvx1* Wx1[1]* Wyy1[yi+1]*Wzz1[zi+1] );
-        if(D >= 2) atomic_add( gs.jx(i1+1, j1+yi, k1+zi), qvx1* Wx1[2]* Wyy1[yi+1]*Wzz1[zi+1] );
+        if(D >= 2) acc.add( acc.jx(i1-1, j1+yi, k1+zi), qvx1* Wx1[0]* Wyy1[yi+1]*Wzz1[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i1  , j1+yi, k1+zi), qvx1* Wx1[1]* Wyy1[yi+1]*Wzz1[zi+1] );
+        if(D >= 2) acc.add( acc.jx(i1+1, j1+yi, k1+zi), qvx1* Wx1[2]* Wyy1[yi+1]*Wzz1[zi+1] );
 
 
-        if(D >= 2) atomic_add( gs.jx(i2-1, j2+yi, k2+zi), qvx2* Wx2[0]* Wyy2[yi+1]*Wzz2[zi+1] );
-        if(D >= 1) atomic_add( gs.jx(i2,   j2+yi, k2+zi), qvx2* Wx2[1]* Wyy2[yi+1]*Wzz2[zi+1] );
-        if(D >= 2) atomic_add( gs.jx(i2+1, j2+yi, k2+zi), qvx2* Wx2[2]* Wyy2[yi+1]*Wzz2[zi+1] );
+        if(D >= 2) acc.add( acc.jx(i2-1, j2+yi, k2+zi), qvx2* Wx2[0]* Wyy2[yi+1]*Wzz2[zi+1] );
+        if(D >= 1) acc.add( acc.jx(i2,   j2+yi, k2+zi), qvx2* Wx2[1]* Wyy2[yi+1]*Wzz2[zi+1] );
+        if(D >= 2) acc.add( acc.jx(i2+1, j2+yi, k2+zi), qvx2* Wx2[2]* Wyy2[yi+1]*Wzz2[zi+1] );
       }
 
 
@@ -207,14 +203,14 @@ void pic::ZigZag_3rd<D,V>::solve( pic::Tile<D>& tile )
         //"(" << i2+xi <<","<< j2-1 <<","<< k2+zi <<") " <<
         //"(" << i2+xi <<","<< j2   <<","<< k2+zi <<") " << "\n";
 
-        if(D >= 2) atomic_add( gs.jy(i1+xi, j1-1, k1+zi), qvy1* Wy1[0] *Wxx1[xi+1]*Wzz1[zi+1] );
-        if(D >= 1) atomic_add( gs.jy(i1+xi, j1,   k1+zi), qvy1* Wy1[1] *Wxx1[xi+1]*Wzz1[zi+1] );
-        if(D >= 2) atomic_add( gs.jy(i1+xi, j1+1, k1+zi), qvy1* Wy1[2] *Wxx1[xi+1]*Wzz1[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i1+xi, j1-1, k1+zi), qvy1* Wy1[0] *Wxx1[xi+1]*Wzz1[zi+1] );
+        if(D >= 1) acc.add( acc.jy(i1+xi, j1,   k1+zi), qvy1* Wy1[1] *Wxx1[xi+1]*Wzz1[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i1+xi, j1+1, k1+zi), qvy1* Wy1[2] *Wxx1[xi+1]*Wzz1[zi+1] );
 
 
-        if(D >= 2) atomic_add( gs.jy(i2+xi, j2-1, k2+zi), qvy2* Wy2[0] *Wxx2[xi+1]*Wzz2[zi+1] );
-        if(D >= 1) atomic_add( gs.jy(i2+xi, j2,   k2+zi), qvy2* Wy2[1] *Wxx2[xi+1]*Wzz2[zi+1] );
-        if(D >= 2) atomic_add( gs.jy(i2+xi, j2+1, k2+zi), qvy2* Wy2[2] *Wxx2[xi+1]*Wzz2[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i2+xi, j2-1, k2+zi), qvy2* Wy2[0] *Wxx2[xi+1]*Wzz2[zi+1] );
+        if(D >= 1) acc.add( acc.jy(i2+xi, j2,   k2+zi), qvy2* Wy2[1] *Wxx2[xi+1]*Wzz2[zi+1] );
+        if(D >= 2) acc.add( acc.jy(i2+xi, j2+1, k2+zi), qvy2* Wy2[2] *Wxx2[xi+1]*Wzz2[zi+1] );
       }
                                                                                        
       //jz                                                                             
@@ -226,19 +222,16 @@ void pic::ZigZag_3rd<D,V>::solve( pic::Tile<D>& tile )
         //"(" << i2+xi <<","<< j2+yi <<","<< k2-1 <<") " <<                            
         //"(" << i2+xi <<","<< j2+yi <<","<< k2   <<") " << "\n";                      
                                                                                        
-        if(D >= 3) atomic_add( gs.jz(i1+xi, j1+yi, k1-1), qvz1* Wz1[0] *Wxx1[xi+1]*Wyy1[yi+1] );
-        if(D >= 1) atomic_add( gs.jz(i1+xi, j1+yi, k1  ), qvz1* Wz1[1] *Wxx1[xi+1]*Wyy1[yi+1] );
-        if(D >= 3) atomic_add( gs.jz(i1+xi, j1+yi, k1+1), qvz1* Wz1[2] *Wxx1[xi+1]*Wyy1[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i1+xi, j1+yi, k1-1), qvz1* Wz1[0] *Wxx1[xi+1]*Wyy1[yi+1] );
+        if(D >= 1) acc.add( acc.jz(i1+xi, j1+yi, k1  ), qvz1* Wz1[1] *Wxx1[xi+1]*Wyy1[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i1+xi, j1+yi, k1+1), qvz1* Wz1[2] *Wxx1[xi+1]*Wyy1[yi+1] );
 
-        if(D >= 3) atomic_add( gs.jz(i2+xi, j2+yi, k2-1), qvz2* Wz2[0] *Wxx2[xi+1]*Wyy2[yi+1] );
-        if(D >= 1) atomic_add( gs.jz(i2+xi, j2+yi, k2  ), qvz2* Wz2[1] *Wxx2[xi+1]*Wyy2[yi+1] );
-        if(D >= 3) atomic_add( gs.jz(i2+xi, j2+yi, k2+1), qvz2* Wz2[2] *Wxx2[xi+1]*Wyy2[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i2+xi, j2+yi, k2-1), qvz2* Wz2[0] *Wxx2[xi+1]*Wyy2[yi+1] );
+        if(D >= 1) acc.add( acc.jz(i2+xi, j2+yi, k2  ), qvz2* Wz2[1] *Wxx2[xi+1]*Wyy2[yi+1] );
+        if(D >= 3) acc.add( acc.jz(i2+xi, j2+yi, k2+1), qvz2* Wz2[2] *Wxx2[xi+1]*Wyy2[yi+1] );
       }
 
-    }
-    //}, con.size(), gs, con);
-
-  }//end of loop over species
+  });
 
 }
 
@@ -31,22 +31,17 @@ void pic::ZigZag_4th<D,V>::solve( pic::Tile<D>& tile )
   gs.jy.clear();
   gs.jz.clear();
 
-  for(auto&& con : tile.containers) {
+  const double c = tile.cfl;    // speed of light
 
-    const double c = tile.cfl;    // speed of light
-    const double q = con.q; // charge
-                            //
-    // skip particle species if zero charge
-    if (q == 0.0) continue;
-
-    //for(size_t n=0; n<con.size(); n++) {
-      
-    UniIter::iterate([=] DEVCALLABLE (
+  // species with zero charge are skipped by the engine
+  this->engine.deposit(tile, [=] DEVCALLABLE (
                 size_t n, 
-                emf::Grids &gs,
+                pic::CurrentAccumulator& acc,
                 pic::ParticleContainer<D>& con
                 ){
 
+      const double q = con.q; // charge
+
       //--------------------------------------------------
       double u = con.vel(0,n);
       double v = con.vel(1,n);
@@ -254,8 +249,8 @@ void pic::ZigZag_4th<D,V>::solve( pic::Tile<D>& tile )
       for(int zi=-zlim; zi <=zlim; ++zi)
       for(int yi=-ylim; yi <=ylim; ++yi){
         for(int is=-1; is<=2; is++) {
-          atomic_add( gs.jx(i1d+is, j1p+yi, k1p+zi), qvx1* Wx1[is+2]* Wyy1[yi+2]*Wzz1[zi+2] );
-          atomic_add( gs.jx(i2d+is, j2p+yi, k2p+zi), qvx2* Wx2[is+2]* Wyy2[yi+2]*Wzz2[zi+2] );
+          acc.add( acc.jx(i1d+is, j1p+yi, k1p+zi), qvx1* Wx1[is+2]* Wyy1[yi+2]*Wzz1[zi+2] );
+          acc.add( acc.jx(i2d+is, j2p+yi, k2p+zi), qvx2* Wx2[is+2]* Wyy2[yi+2]*Wzz2[zi+2] );
         }
       }
 
@@ -263,8 +258,8 @@ void pic::ZigZag_4th<D,V>::solve( pic::Tile<D>& tile )
       for(int zi=-zlim; zi <=zlim; ++zi)
       for(int xi=-xlim; xi <=xlim; ++xi){
         for(int is=-1; is<=2; is++) {
-          atomic_add( gs.jy(i1p+xi, j1d+is, k1p+zi), qvy1* Wy1[is+2] *Wxx1[xi+2]*Wzz1[zi+2] );
-          atomic_add( gs.jy(i2p+xi, j2d+is, k2p+zi), qvy2* Wy2[is+2] *Wxx2[xi+2]*Wzz2[zi+2] );
+          acc.add( acc.jy(i1p+xi, j1d+is, k1p+zi), qvy1* Wy1[is+2] *Wxx1[xi+2]*Wzz1[zi+2] );
+          acc.add( acc.jy(i2p+xi, j2d+is, k2p+zi), qvy2* Wy2[is+2] *Wxx2[xi+2]*Wzz2[zi+2] );
         }
       }
                                                                                        
@@ -272,14 +267,12 @@ void pic::ZigZag_4th<D,V>::solve( pic::Tile<D>& tile )
       for(int yi=-ylim; yi <=ylim; ++yi)                                                     
       for(int xi=-xlim; xi <=xlim; ++xi){                                                    
         for(int is=-1; is<=2; is++) {
-          atomic_add( gs.jz(i1p+xi, j1p+yi, k1d+is), qvz1* Wz1[is+2] *Wxx1[xi+2]*Wyy1[yi+2] );
-          atomic_add( gs.jz(i2p+xi, j2p+yi, k2d+is), qvz2* Wz2[is+2] *Wxx2[xi+2]*Wyy2[yi+2] );
+          acc.add( acc.jz(i1p+xi, j1p+yi, k1d+is), qvz1* Wz1[is+2] *Wxx1[xi+2]*Wyy1[yi+2] );
+          acc.add( acc.jz(i2p+xi, j2p+yi, k2d+is), qvz2* Wz2[is+2] *Wxx2[xi+2]*Wyy2[yi+2] );
         }
       }
 
-    }, con.size(), gs, con);
-
-  }//end of loop over species
+  });
 
 }
 
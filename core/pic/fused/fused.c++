@@ -0,0 +1,113 @@
+#include <cmath> 
+#include <cassert>
+
+#include "core/pic/fused/fused.h"
+#include "tools/signum.h"
+#include "external/iter/iter.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h> 
+#endif
+
+using toolbox::sign;
+
+
+template<size_t D, class Intp, class Push, class Dep>
+void pic::FusedKernel<D,Intp,Push,Dep>::solve(
+    pic::Tile<D>& tile)
+{
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  auto& gs = tile.get_grids();
+  const auto mins = tile.mins;
+  const double c = tile.cfl;    // speed of light
+
+  // external fields in the order of fused::FieldsAtPrtcl
+  const double ext[6] = {this->ex_ext, this->ey_ext, this->ez_ext, 
+                         this->bx_ext, this->by_ext, this->bz_ext};
+
+  // mesh sizes for 1D indexing
+  const size_t iy = D >= 2 ? gs.ex.indx(0,1,0) - gs.ex.indx(0,0,0) : 0;
+  const size_t iz = D >= 3 ? gs.ex.indx(0,0,1) - gs.ex.indx(0,0,0) : 0;
+
+  //clear arrays before new update
+  gs.jx.clear();
+  gs.jy.clear();
+  gs.jz.clear();
+
+  for(auto&& con : tile.containers) {
+
+    // only charged massive species feel the Lorentz force (photons etc. are pushed elsewhere)
+    if(con.m == 0.0 || con.q == 0.0) continue;
+
+    // fields stay in registers; free the particle field buffers so that no stale values are kept
+    if(con.store_fields) con.set_store_fields(false);
+
+    const double q  = con.q; // charge
+    const double qm = sign(con.q)/con.m; // q_s/m_s (sign only because fields are in units of q)
+
+    UniIter::iterate([=] DEVCALLABLE (
+                size_t n, 
+                emf::Grids& gs,
+                pic::ParticleContainer<D>& con){
+
+      // normalize to tile units
+      double x1 = D >= 1 ? con.loc(0,n) - mins[0] : con.loc(0,n);
+      double y1 = D >= 2 ? con.loc(1,n) - mins[1] : con.loc(1,n);
+      double z1 = D >= 3 ? con.loc(2,n) - mins[2] : con.loc(2,n);
+
+      const fused::FieldsAtPrtcl f = Intp::template interpolate<D>(gs, x1, y1, z1, iy, iz);
+
+      float vel[3] = { con.vel(0,n), con.vel(1,n), con.vel(2,n) };
+      const double g = Push::push(vel, f, ext, qm, c);
+
+      for(size_t i=0; i<3; i++) con.vel(i,n) = vel[i];
+      for(size_t i=0; i<D; i++) con.loc(i,n) += con.vel(i,n)*g*c;
+
+      // previous location is reconstructed from the stored (float) values 
+      // in the same way as in the depositers
+      double u = con.vel(0,n);
+      double v = con.vel(1,n);
+      double w = con.vel(2,n);
+      double invgam = 1.0/sqrt(1.0 + u*u + v*v + w*w);
+
+      double x2 = D >= 1 ? con.loc(0,n) - mins[0] : con.loc(0,n);
+      double y2 = D >= 2 ? con.loc(1,n) - mins[1] : con.loc(1,n);
+      double z2 = D >= 3 ? con.loc(2,n) - mins[2] : con.loc(2,n);
+
+      Dep::template deposit<D>(gs, 
+          x2 - u*invgam*c, y2 - v*invgam*c, z2 - w*invgam*c,
+          x2, y2, z2, q, iy, iz);
+
+    }, con.size(), gs, con);
+
+    UniIter::sync();
+  } // end of loop over species
+
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+
+template class pic::FusedKernel<1, pic::fused::Linear,    pic::fused::Boris, pic::fused::ZigZag>;
+template class pic::FusedKernel<2, pic::fused::Linear,    pic::fused::Boris, pic::fused::ZigZag>;
+template class pic::FusedKernel<3, pic::fused::Linear,    pic::fused::Boris, pic::fused::ZigZag>;
+
+template class pic::FusedKernel<1, pic::fused::Linear,    pic::fused::Vay,   pic::fused::ZigZag>;
+template class pic::FusedKernel<2, pic::fused::Linear,    pic::fused::Vay,   pic::fused::ZigZag>;
+template class pic::FusedKernel<3, pic::fused::Linear,    pic::fused::Vay,   pic::fused::ZigZag>;
+
+template class pic::FusedKernel<1, pic::fused::Linear,    pic::fused::HigueraCary, pic::fused::ZigZag>;
+template class pic::FusedKernel<2, pic::fused::Linear,    pic::fused::HigueraCary, pic::fused::ZigZag>;
+template class pic::FusedKernel<3, pic::fused::Linear,    pic::fused::HigueraCary, pic::fused::ZigZag>;
+
+template class pic::FusedKernel<2, pic::fused::Quadratic, pic::fused::Boris, pic::fused::ZigZag>;
+template class pic::FusedKernel<3, pic::fused::Quadratic, pic::fused::Boris, pic::fused::ZigZag>;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/pic/tile.h"
+#include "core/pic/fused/kernels.h"
+#include "definitions.h"
+
+
+namespace pic {
+
+/// General interface for fused interpolate-push-deposit solvers
+//
+// Replaces the interpolator, pusher, and depositer calls of a lap with one
+// pass over the particles. Interpolated fields stay in registers; the
+// containers it pushes are switched to store_fields = false, which frees
+// their Epart/Bpart buffers.
+template<size_t D>
+class FusedSolver
+{
+  public:
+
+  FusedSolver() = default;
+
+  virtual ~FusedSolver() = default;
+
+  // external emf that are added to the pusher Lorentz force
+  double bx_ext = 0.0;
+  double by_ext = 0.0;
+  double bz_ext = 0.0;
+
+  double ex_ext = 0.0;
+  double ey_ext = 0.0;
+  double ez_ext = 0.0;
+
+  /// interpolate, push, and deposit all charged massive containers in tile
+  virtual void solve(pic::Tile<D>& ) = 0;
+
+};
+
+
+/// Fused kernel templated on interpolator, pusher, and depositer
+//
+// Intp, Push, and Dep are the per-particle kernels in pic::fused;
+// results are identical to calling the corresponding separate solvers.
+template<size_t D, class Intp, class Push, class Dep>
+class FusedKernel :
+  public FusedSolver<D>
+{
+  public:
+  void solve(pic::Tile<D>& tile) override;
+
+};
+
+} // end of namespace pic
@@ -0,0 +1,458 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include "core/emf/tile.h"
+#include "core/pic/shapes.h"
+#include "external/iter/devcall.h"
+#include "external/iter/iter.h"
+
+
+namespace pic {
+namespace fused {
+
+/// Electromagnetic fields at particle location
+//
+// stored as floats so that the fused kernel is bit-identical to
+// the interpolator writing into Epart/Bpart and the pusher reading them back.
+struct FieldsAtPrtcl {
+  float ex, ey, ez, bx, by, bz;
+};
+
+
+DEVCALLABLE inline double lerp8(
+      double c000, double c100, double c010, double c110,
+      double c001, double c101, double c011, double c111,
+      double dx, double dy, double dz)
+{
+      double c00 = c000 * (1.0-dx) + c100 * dx;
+      double c10 = c010 * (1.0-dx) + c110 * dx;
+      double c0  = c00  * (1.0-dy) + c10  * dy;
+      double c01 = c001 * (1.0-dx) + c101 * dx;
+      double c11 = c011 * (1.0-dx) + c111 * dx;
+      double c1  = c01  * (1.0-dy) + c11  * dy;
+      double c   = c0   * (1.0-dz) + c1   * dz;
+      return c;
+}
+
+
+//--------------------------------------------------
+// interpolators
+
+/// 1st order interpolation; same stencil as LinearInterpolator
+struct Linear
+{
+  template<size_t D>
+  DEVCALLABLE static inline FieldsAtPrtcl interpolate(
+      emf::Grids& gs,
+      double loc0n, double loc1n, double loc2n,
+      const size_t iy, const size_t iz)
+  {
+    int i=0, j=0, k=0;
+    double dx=0.0, dy=0.0, dz=0.0;
+
+    if(D >= 1) i = floor(loc0n);
+    if(D >= 2) j = floor(loc1n);
+    if(D >= 3) k = floor(loc2n);
+
+    if(D >= 1) dx = loc0n - i;
+    if(D >= 2) dy = loc1n - j;
+    if(D >= 3) dz = loc2n - k;
+
+    const size_t ind = gs.ex.indx(i,j,k);
+    double c000, c100, c010, c110, c001, c101, c011, c111;
+    FieldsAtPrtcl f;
+
+    //ex
+    c000 = 0.5*(gs.ex(ind       ) +gs.ex(ind-1      ));
+    c100 = 0.5*(gs.ex(ind       ) +gs.ex(ind+1      ));
+    c010 = 0.5*(gs.ex(ind+iy    ) +gs.ex(ind-1+iy   ));
+    c110 = 0.5*(gs.ex(ind+iy    ) +gs.ex(ind+1+iy   ));
+    c001 = 0.5*(gs.ex(ind+iz    ) +gs.ex(ind-1+iz   ));
+    c101 = 0.5*(gs.ex(ind+iz    ) +gs.ex(ind+1+iz   ));
+    c011 = 0.5*(gs.ex(ind+iy+iz ) +gs.ex(ind-1+iy+iz));
+    c111 = 0.5*(gs.ex(ind+iy+iz ) +gs.ex(ind+1+iy+iz));
+    f.ex = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    //ey
+    c000 = 0.5*(gs.ey(ind       ) +gs.ey(ind-iy     ));
+    c100 = 0.5*(gs.ey(ind+1     ) +gs.ey(ind+1-iy   ));
+    c010 = 0.5*(gs.ey(ind       ) +gs.ey(ind+iy     ));
+    c110 = 0.5*(gs.ey(ind+1     ) +gs.ey(ind+1+iy   ));
+    c001 = 0.5*(gs.ey(ind+iz    ) +gs.ey(ind-iy+iz  ));
+    c101 = 0.5*(gs.ey(ind+1+iz  ) +gs.ey(ind+1-iy+iz));
+    c011 = 0.5*(gs.ey(ind+iz    ) +gs.ey(ind+iy+iz  ));
+    c111 = 0.5*(gs.ey(ind+1+iz  ) +gs.ey(ind+1+iy+iz));
+    f.ey = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    //ez
+    c000 = 0.5*(gs.ez(ind       ) + gs.ez(ind-iz     ));
+    c100 = 0.5*(gs.ez(ind+1     ) + gs.ez(ind+1-iz   ));
+    c010 = 0.5*(gs.ez(ind+iy    ) + gs.ez(ind+iy-iz  ));
+    c110 = 0.5*(gs.ez(ind+1+iy  ) + gs.ez(ind+1+iy-iz));
+    c001 = 0.5*(gs.ez(ind       ) + gs.ez(ind+iz     ));
+    c101 = 0.5*(gs.ez(ind+1     ) + gs.ez(ind+1+iz   ));
+    c011 = 0.5*(gs.ez(ind+iy    ) + gs.ez(ind+iy+iz  ));
+    c111 = 0.5*(gs.ez(ind+1+iy  ) + gs.ez(ind+1+iy+iz));
+    f.ez = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    // bx
+    c000 = 0.25*( gs.bx(ind)+   gs.bx(ind-iy)+   gs.bx(ind-iz)+      gs.bx(ind-iy-iz));
+    c100 = 0.25*( gs.bx(ind+1)+ gs.bx(ind+1-iy)+ gs.bx(ind+1-iz)+    gs.bx(ind+1-iy-iz));
+    c001 = 0.25*( gs.bx(ind)+   gs.bx(ind+iz)+   gs.bx(ind-iy)+      gs.bx(ind-iy+iz));
+    c101 = 0.25*( gs.bx(ind+1)+ gs.bx(ind+1+iz)+ gs.bx(ind+1-iy)+    gs.bx(ind+1-iy+iz));
+    c010 = 0.25*( gs.bx(ind)+   gs.bx(ind+iy)+   gs.bx(ind-iz)+      gs.bx(ind+iy-iz));
+    c110 = 0.25*( gs.bx(ind+1)+ gs.bx(ind+1-iz)+ gs.bx(ind+1+iy-iz)+ gs.bx(ind+1+iy));
+    c011 = 0.25*( gs.bx(ind)+   gs.bx(ind+iy)+   gs.bx(ind+iy+iz)+   gs.bx(ind+iz));
+    c111 = 0.25*( gs.bx(ind+1)+ gs.bx(ind+1+iy)+ gs.bx(ind+1+iy+iz)+ gs.bx(ind+1+iz));
+    f.bx = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    // by
+    c000 = 0.25*( gs.by(ind-1-iz)+    gs.by(ind-1)+       gs.by(ind-iz)+      gs.by(ind));
+    c100 = 0.25*( gs.by(ind-iz)+      gs.by(ind)+         gs.by(ind+1-iz)+    gs.by(ind+1));
+    c001 = 0.25*( gs.by(ind-1)+       gs.by(ind-1+iz)+    gs.by(ind)+         gs.by(ind+iz));
+    c101 = 0.25*( gs.by(ind)+         gs.by(ind+iz)+      gs.by(ind+1)+       gs.by(ind+1+iz));
+    c010 = 0.25*( gs.by(ind-1+iy-iz)+ gs.by(ind-1+iy)+    gs.by(ind+iy-iz)+   gs.by(ind+iy));
+    c110 = 0.25*( gs.by(ind+iy-iz)+   gs.by(ind+iy)+      gs.by(ind+1+iy-iz)+ gs.by(ind+1+iy));
+    c011 = 0.25*( gs.by(ind-1+iy)+    gs.by(ind-1+iy+iz)+ gs.by(ind+iy)+      gs.by(ind+iy+iz));
+    c111 = 0.25*( gs.by(ind+iy)+      gs.by(ind+iy+iz)+   gs.by(ind+1+iy)+    gs.by(ind+1+iy+iz));
+    f.by = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    // bz
+    c000 = 0.25*( gs.bz(ind-1-iy)+    gs.bz(ind-1)+       gs.bz(ind-iy)+      gs.bz(ind));
+    c100 = 0.25*( gs.bz(ind-iy)+      gs.bz(ind)+         gs.bz(ind+1-iy)+    gs.bz(ind+1));
+    c001 = 0.25*( gs.bz(ind-1-iy+iz)+ gs.bz(ind-1+iz)+    gs.bz(ind-iy+iz)+   gs.bz(ind+iz));
+    c101 = 0.25*( gs.bz(ind-iy+iz)+   gs.bz(ind+iz)+      gs.bz(ind+1-iy+iz)+ gs.bz(ind+1+iz));
+    c010 = 0.25*( gs.bz(ind-1)+       gs.bz(ind-1+iy)+    gs.bz(ind)+         gs.bz(ind+iy));
+    c110 = 0.25*( gs.bz(ind)+         gs.bz(ind+iy)+      gs.bz(ind+1)+       gs.bz(ind+1+iy));
+    c011 = 0.25*( gs.bz(ind-1+iz)+    gs.bz(ind-1+iy+iz)+ gs.bz(ind+iz)+      gs.bz(ind+iy+iz));
+    c111 = 0.25*( gs.bz(ind+iz)+      gs.bz(ind+iy+iz)+   gs.bz(ind+1+iz)+    gs.bz(ind+1+iy+iz));
+    f.bz = lerp8(c000, c100, c010, c110, c001, c101, c011, c111, dx, dy, dz);
+
+    return f;
+  }
+};
+
+
+/// 2nd order interpolation; same stencil as QuadraticInterpolator (D >= 2)
+struct Quadratic
+{
+  template<size_t D>
+  DEVCALLABLE static inline double compute(
+      const double* cx, const double* cy, const double* cz,
+      const toolbox::Mesh<float,3>& f,
+      int i, int j, int k)
+  {
+    double res = 0.0;
+    const int kr = D >= 3 ? 1 : 0;
+
+    for( int kl=-kr ; kl<=kr ; kl++ ){
+    for( int jl=-1  ; jl<=1  ; jl++ ){
+    for( int il=-1  ; il<=1  ; il++ ){
+      if(D >= 3) res += cx[il]*cy[jl]*cz[kl] * f(i+il, j+jl, k+kl);
+      else       res += cx[il]*cy[jl]        * f(i+il, j+jl, 0);
+    }}}
+    return res;
+  }
+
+  template<size_t D>
+  DEVCALLABLE static inline FieldsAtPrtcl interpolate(
+      emf::Grids& gs,
+      double xpn, double ypn, double zpn,
+      const size_t /*iy*/, const size_t /*iz*/)
+  {
+    static_assert(D >= 2, "quadratic interpolation is only defined for D >= 2");
+
+    // primary and dual (1/2-shifted) grid indices
+    int ip = round(xpn);
+    int jp = round(ypn);
+    int kp = round(zpn);
+    int id = round(xpn-0.5);
+    int jd = round(ypn-0.5);
+    int kd = round(zpn-0.5);
+
+    double cxd[3] = {0.0}, cxp[3] = {0.0},
+           cyd[3] = {0.0}, cyp[3] = {0.0},
+           czd[3] = {0.0}, czp[3] = {0.0};
+
+    if(D >= 1) W2nd(xpn-ip,     &cxp[0] );
+    if(D >= 2) W2nd(ypn-jp,     &cyp[0] );
+    if(D >= 3) W2nd(zpn-kp,     &czp[0] );
+    if(D >= 1) W2nd(xpn-id-0.5, &cxd[0] );
+    if(D >= 2) W2nd(ypn-jd-0.5, &cyd[0] );
+    if(D >= 3) W2nd(zpn-kd-0.5, &czd[0] );
+
+    FieldsAtPrtcl f;
+    f.ex = compute<D>( &cxd[1], &cyp[1], &czp[1], gs.ex, id,jp,kp); // Ex(d,p,p)
+    f.ey = compute<D>( &cxp[1], &cyd[1], &czp[1], gs.ey, ip,jd,kp); // Ey(p,d,p)
+    f.ez = compute<D>( &cxp[1], &cyp[1], &czd[1], gs.ez, ip,jp,kd); // Ez(p,p,d)
+    f.bx = compute<D>( &cxp[1], &cyd[1], &czd[1], gs.bx, ip,jd,kd); // Bx(p,d,d)
+    f.by = compute<D>( &cxd[1], &cyp[1], &czd[1], gs.by, id,jp,kd); // By(d,p,d)
+    f.bz = compute<D>( &cxd[1], &cyd[1], &czp[1], gs.bz, id,jd,kp); // Bz(d,d,p)
+
+    return f;
+  }
+};
+
+
+//--------------------------------------------------
+// pushers
+//
+// vel is the normalized 4-velocity (updated in place);
+// returns the factor g so that the position advance is vel*g*c.
+
+/// Boris pusher; same algorithm as BorisPusher
+struct Boris
+{
+  DEVCALLABLE static inline double push(
+      float* vel,
+      const FieldsAtPrtcl& f,
+      const double* ext,
+      const double qm,
+      const double c)
+  {
+    double vel0n = vel[0]*c;
+    double vel1n = vel[1]*c;
+    double vel2n = vel[2]*c;
+
+    double ex0 = ( f.ex + ext[0] )*0.5*qm;
+    double ey0 = ( f.ey + ext[1] )*0.5*qm;
+    double ez0 = ( f.ez + ext[2] )*0.5*qm;
+
+    double bx0 = ( f.bx + ext[3] )*0.5*qm/c;
+    double by0 = ( f.by + ext[4] )*0.5*qm/c;
+    double bz0 = ( f.bz + ext[5] )*0.5*qm/c;
+
+    // first half electric acceleration
+    double u0 = vel0n + ex0;
+    double v0 = vel1n + ey0;
+    double w0 = vel2n + ez0;
+
+    // first half magnetic rotation
+    double ginv = c/sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+    bx0 *= ginv;
+    by0 *= ginv;
+    bz0 *= ginv;
+
+    double f2 = 2.0/(1.0 + bx0*bx0 + by0*by0 + bz0*bz0);
+    double u1 = (u0 + v0*bz0 - w0*by0)*f2;
+    double v1 = (v0 + w0*bx0 - u0*bz0)*f2;
+    double w1 = (w0 + u0*by0 - v0*bx0)*f2;
+
+    // second half of magnetic rotation & electric acceleration
+    u0 = u0 + v1*bz0 - w1*by0 + ex0;
+    v0 = v0 + w1*bx0 - u1*bz0 + ey0;
+    w0 = w0 + u1*by0 - v1*bx0 + ez0;
+
+    vel[0] = u0/c;
+    vel[1] = v0/c;
+    vel[2] = w0/c;
+
+    return c / sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+
+/// Vay pusher; same algorithm as VayPusher
+struct Vay
+{
+  DEVCALLABLE static inline double push(
+      float* vel,
+      const FieldsAtPrtcl& f,
+      const double* ext,
+      const double qm,
+      const double c)
+  {
+    const double cinv = 1.0/c;
+
+    double vel0n = vel[0];
+    double vel1n = vel[1];
+    double vel2n = vel[2];
+
+    double ex0 = ( f.ex + ext[0] )*0.5*qm;
+    double ey0 = ( f.ey + ext[1] )*0.5*qm;
+    double ez0 = ( f.ez + ext[2] )*0.5*qm;
+
+    double bx0 = ( f.bx + ext[3] )*0.5*qm/c;
+    double by0 = ( f.by + ext[4] )*0.5*qm/c;
+    double bz0 = ( f.bz + ext[5] )*0.5*qm/c;
+
+    // gamma^-1
+    double g = 1.0/sqrt(1.0 + vel0n*vel0n + vel1n*vel1n + vel2n*vel2n);
+    double vx0 = c*vel0n*g;
+    double vy0 = c*vel1n*g;
+    double vz0 = c*vel2n*g;
+
+    // u' (cinv is already multiplied into B)
+    double u1 = c*vel0n + 2.0*ex0 + vy0*bz0 - vz0*by0;
+    double v1 = c*vel1n + 2.0*ey0 + vz0*bx0 - vx0*bz0;
+    double w1 = c*vel2n + 2.0*ez0 + vx0*by0 - vy0*bx0;
+
+    // gamma(u')
+    double ustar = cinv*(u1*bx0+v1*by0+w1*bz0);
+    double sig = cinv*cinv*( c*c + u1*u1+ v1*v1+ w1*w1) - (bx0*bx0+ by0*by0+ bz0*bz0);
+    g = 1.0/sqrt( 0.5*(sig + sqrt(sig*sig + 4.0*(bx0*bx0 + by0*by0 + bz0*bz0 + ustar*ustar))));
+
+    double tx = bx0*g;
+    double ty = by0*g;
+    double tz = bz0*g;
+    double f2 = 1.0/(1.0+ tx*tx+ ty*ty+ tz*tz);
+
+    double u0 = f2*(u1 + (u1*tx + v1*ty + w1*tz)*tx + v1*tz - w1*ty);
+    double v0 = f2*(v1 + (u1*tx + v1*ty + w1*tz)*ty + w1*tx - u1*tz);
+    double w0 = f2*(w1 + (u1*tx + v1*ty + w1*tz)*tz + u1*ty - v1*tx);
+
+    vel[0] = u0/c;
+    vel[1] = v0/c;
+    vel[2] = w0/c;
+
+    return c / sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+
+/// Higuera-Cary pusher; same algorithm as HigueraCaryPusher
+struct HigueraCary
+{
+  DEVCALLABLE static inline double push(
+      float* vel,
+      const FieldsAtPrtcl& f,
+      const double* ext,
+      const double qm,
+      const double c)
+  {
+    double vel0n = vel[0];
+    double vel1n = vel[1];
+    double vel2n = vel[2];
+
+    double ex0 = ( f.ex + ext[0] )*0.5*qm;
+    double ey0 = ( f.ey + ext[1] )*0.5*qm;
+    double ez0 = ( f.ez + ext[2] )*0.5*qm;
+
+    double bx0 = ( f.bx + ext[3] )*0.5*qm;
+    double by0 = ( f.by + ext[4] )*0.5*qm;
+    double bz0 = ( f.bz + ext[5] )*0.5*qm;
+
+    // first half electric acceleration
+    double u0 = c*vel0n + ex0;
+    double v0 = c*vel1n + ey0;
+    double w0 = c*vel2n + ez0;
+
+    // intermediate gamma
+    double g2 = (c*c + u0*u0 + v0*v0 + w0*w0)/(c*c);
+    double b2 = bx0*bx0 + by0*by0 + bz0*bz0;
+    double ginv = 1./sqrt( 0.5*(g2-b2 + sqrt( (g2-b2)*(g2-b2) + 4.0*(b2 + (bx0*u0 + by0*v0 + bz0*w0)*(bx0*u0 + by0*v0 + bz0*w0)))));
+
+    // first half magnetic rotation; cinv is multiplied to B field only here
+    bx0 *= ginv/c;
+    by0 *= ginv/c;
+    bz0 *= ginv/c;
+
+    double f2 = 2.0/(1.0 + bx0*bx0 + by0*by0 + bz0*bz0);
+    double u1 = (u0 + v0*bz0 - w0*by0)*f2;
+    double v1 = (v0 + w0*bx0 - u0*bz0)*f2;
+    double w1 = (w0 + u0*by0 - v0*bx0)*f2;
+
+    // second half of magnetic rotation & electric acceleration
+    u0 = u0 + v1*bz0 - w1*by0 + ex0;
+    v0 = v0 + w1*bx0 - u1*bz0 + ey0;
+    w0 = w0 + u1*by0 - v1*bx0 + ez0;
+
+    vel[0] = u0/c;
+    vel[1] = v0/c;
+    vel[2] = w0/c;
+
+    return c / sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+
+//--------------------------------------------------
+// depositers
+
+/// 1st order zigzag current deposition; same scheme as ZigZag
+//
+// x1 is the location before and x2 after the push (in tile units).
+struct ZigZag
+{
+  template<size_t D>
+  DEVCALLABLE static inline void deposit(
+      emf::Grids& gs,
+      double x1, double y1, double z1,
+      double x2, double y2, double z2,
+      const double q,
+      const size_t iy, const size_t iz)
+  {
+    using std::min;
+    using std::max;
+
+    int i1  = D >= 1 ? floor(x1) : 0;
+    int i2  = D >= 1 ? floor(x2) : 0;
+    int j1  = D >= 2 ? floor(y1) : 0;
+    int j2  = D >= 2 ? floor(y2) : 0;
+    int k1  = D >= 3 ? floor(z1) : 0;
+    int k2  = D >= 3 ? floor(z2) : 0;
+
+    // relay point; +1 is equal to +\Delta x
+    double xr = min( double(min(i1,i2)+1), max( double(max(i1,i2)), double(0.5*(x1+x2)) ) );
+    double yr = min( double(min(j1,j2)+1), max( double(max(j1,j2)), double(0.5*(y1+y2)) ) );
+    double zr = min( double(min(k1,k2)+1), max( double(max(k1,k2)), double(0.5*(z1+z2)) ) );
+
+    // +q since - sign is already included in the Ampere's equation
+    double Fx1 = +q*(xr - x1);
+    double Fy1 = +q*(yr - y1);
+    double Fz1 = +q*(zr - z1);
+
+    double Fx2 = +q*(x2 - xr);
+    double Fy2 = +q*(y2 - yr);
+    double Fz2 = +q*(z2 - zr);
+
+    double Wx1 = D >= 1 ? 0.5*(x1 + xr) - i1 : 0.0;
+    double Wy1 = D >= 2 ? 0.5*(y1 + yr) - j1 : 0.0;
+    double Wz1 = D >= 3 ? 0.5*(z1 + zr) - k1 : 0.0;
+
+    double Wx2 = D >= 1 ? 0.5*(x2 + xr) - i2 : 0.0;
+    double Wy2 = D >= 2 ? 0.5*(y2 + yr) - j2 : 0.0;
+    double Wz2 = D >= 3 ? 0.5*(z2 + zr) - k2 : 0.0;
+
+    const size_t ind1 = gs.jx.indx(i1,j1,k1);
+    const size_t ind2 = gs.jx.indx(i2,j2,k2);
+
+    if(D>=1) atomic_add( gs.jx(ind1            ), Fx1*(1.0-Wy1)*(1.0-Wz1) );
+    if(D>=2) atomic_add( gs.jx(ind1    +iy     ), Fx1*Wy1      *(1.0-Wz1) );
+    if(D>=3) atomic_add( gs.jx(ind1        +iz ), Fx1*(1.0-Wy1)*Wz1       );
+    if(D>=3) atomic_add( gs.jx(ind1    +iy +iz ), Fx1*Wy1      *Wz1       );
+
+    if(D>=1) atomic_add( gs.jx(ind2            ), Fx2*(1.0-Wy2)*(1.0-Wz2) );
+    if(D>=2) atomic_add( gs.jx(ind2    +iy     ), Fx2*Wy2      *(1.0-Wz2) );
+    if(D>=3) atomic_add( gs.jx(ind2        +iz ), Fx2*(1.0-Wy2)*Wz2       );
+    if(D>=3) atomic_add( gs.jx(ind2    +iy +iz ), Fx2*Wy2      *Wz2       );
+
+    // jy
+    if(D>=1) atomic_add( gs.jy(ind1            ), Fy1*(1.0-Wx1)*(1.0-Wz1) );
+    if(D>=1) atomic_add( gs.jy(ind1 +1         ), Fy1*Wx1      *(1.0-Wz1) );
+    if(D>=3) atomic_add( gs.jy(ind1        +iz ), Fy1*(1.0-Wx1)*Wz1       );
+    if(D>=3) atomic_add( gs.jy(ind1 +1     +iz ), Fy1*Wx1      *Wz1       );
+
+    if(D>=1) atomic_add( gs.jy(ind2            ), Fy2*(1.0-Wx2)*(1.0-Wz2) );
+    if(D>=1) atomic_add( gs.jy(ind2 +1         ), Fy2*Wx2      *(1.0-Wz2) );
+    if(D>=3) atomic_add( gs.jy(ind2        +iz ), Fy2*(1.0-Wx2)*Wz2       );
+    if(D>=3) atomic_add( gs.jy(ind2 +1     +iz ), Fy2*Wx2      *Wz2       );
+
+    // jz
+    if(D>=1) atomic_add( gs.jz(ind1            ), Fz1*(1.0-Wx1)*(1.0-Wy1) );
+    if(D>=1) atomic_add( gs.jz(ind1 +1         ), Fz1*Wx1      *(1.0-Wy1) );
+    if(D>=2) atomic_add( gs.jz(ind1    +iy     ), Fz1*(1.0-Wx1)*Wy1       );
+    if(D>=2) atomic_add( gs.jz(ind1 +1 +iy     ), Fz1*Wx1      *Wy1       );
+
+    if(D>=1) atomic_add( gs.jz(ind2            ), Fz2*(1.0-Wx2)*(1.0-Wy2) );
+    if(D>=1) atomic_add( gs.jz(ind2 +1         ), Fz2*Wx2      *(1.0-Wy2) );
+    if(D>=2) atomic_add( gs.jz(ind2    +iy     ), Fz2*(1.0-Wx2)*Wy2       );
+    if(D>=2) atomic_add( gs.jz(ind2 +1 +iy     ), Fz2*Wx2      *Wy2       );
+  }
+};
+
+
+} // end of namespace fused
+} // end of namespace pic
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <utility>
 #include <mpi.h>
@@ -83,14 +84,32 @@ void ParticleContainer<D>::reserve(size_t N) {
   wgtArr.reserve(N);
     
   // reserve 1d N x D array for particle-specific emf
-  Epart.reserve(N*3);
-  Bpart.reserve(N*3);
+  if(store_fields) {
+    Epart.reserve(N*3);
+    Bpart.reserve(N*3);
+  }
 
 #ifdef GPU
   nvtxRangePop();
 #endif
 }
 
+template<std::size_t D>
+void ParticleContainer<D>::set_store_fields(bool store)
+{
+  store_fields = store;
+
+  if(store_fields) {
+    Epart.resize(size()*3);
+    Bpart.resize(size()*3);
+  } else {
+    Epart.clear();
+    Bpart.clear();
+    Epart.shrink_to_fit();
+    Bpart.shrink_to_fit();
+  }
+}
+
 template<std::size_t D>
 void ParticleContainer<D>::resize(size_t N)
 {
@@ -104,8 +123,10 @@ void ParticleContainer<D>::resize(size_t N)
   for(size_t i=0; i<2; i++) indArr[i].resize(N);
   wgtArr.resize(N);
 
-  Epart.resize(N*3);
-  Bpart.resize(N*3);
+  if(store_fields) {
+    Epart.resize(N*3);
+    Bpart.resize(N*3);
+  }
 
   //std::cout << " INFO: " << cid << " resizing container from " << Nprtcls << " to  " << N << std::endl;
 
@@ -180,6 +201,54 @@ void ParticleContainer<D>::add_particle (
 }
 
 
+template<std::size_t D>
+void ParticleContainer<D>::add_particles_bulk(
+    size_t N,
+    const float* x,  const float* y,  const float* z,
+    const float* vx, const float* vy, const float* vz,
+    const float* wgt, float wgt0)
+{
+  if(N == 0) return;
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  const size_t N0 = size();
+  resize(N0 + N); // one allocation per array
+
+  std::memcpy(locArr[0].data() + N0, x,  N*sizeof(float));
+  std::memcpy(locArr[1].data() + N0, y,  N*sizeof(float));
+  std::memcpy(locArr[2].data() + N0, z,  N*sizeof(float));
+
+  std::memcpy(velArr[0].data() + N0, vx, N*sizeof(float));
+  std::memcpy(velArr[1].data() + N0, vy, N*sizeof(float));
+  std::memcpy(velArr[2].data() + N0, vz, N*sizeof(float));
+
+  float* w = wgtArr.data() + N0;
+  if(wgt != nullptr) {
+    std::memcpy(w, wgt, N*sizeof(float));
+  } else {
+    std::fill(w, w + N, wgt0);
+  }
+
+  // same keys as N consecutive keygen() calls
+  int* ids   = indArr[0].data() + N0;
+  int* procs = indArr[1].data() + N0;
+  for(size_t n=0; n<N; n++) {
+    ids[n]   = _key + static_cast<int>(n);
+    procs[n] = _rank;
+  }
+  _key += static_cast<int>(N);
+
+  Nprtcls += N;
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
 template<std::size_t D>
 void ParticleContainer<D>::add_identified_particle (
     std::vector<float> prtcl_loc,
@@ -576,6 +645,31 @@ void ParticleContainer<D>::sort_in_rev_energy()
 
 
 
+template<std::size_t D>
+void ParticleContainer<D>::pair_deleted(
+    const std::vector<int>& dels, 
+    ManVec<int>& holes, 
+    ManVec<int>& others)
+{
+  const int Ndel = dels.size();
+  const int last = size() - Ndel;
+
+  // deletions at or beyond last come first in the sorted list; the rest are 
+  // holes. There are as many holes as kept particles beyond last.
+  int idel = 0;
+  for(int n=(int)size()-1; n>=last; n--) {
+    if(idel < Ndel && dels[idel] == n) {
+      idel++;
+      continue;
+    }
+    others.push_back(n);
+  }
+  for(int ii=idel; ii<Ndel; ii++) holes.push_back(dels[ii]);
+
+  assert(holes.size() == others.size());
+}
+
+
 template<std::size_t D>
 void ParticleContainer<D>::delete_particles(std::vector<int> to_be_deleted) 
 {
@@ -596,28 +690,27 @@ void ParticleContainer<D>::delete_particles(std::vector<int> to_be_deleted)
   for(int i=0; i<2; i++) idn[i] = &( id(i,0) );
 
 
-  // overwrite particles with the last one on the array and 
-  // then resize the array
+  // overwrite deleted particles in [0,last) with the kept ones beyond
+  // last and then resize the array
   int last = size()-to_be_deleted.size();
 
+  ManVec<int> holes, others;
+  pair_deleted(to_be_deleted, holes, others);
 
   UniIter::iterate([=] DEVCALLABLE (
         int ii, 
-        std::vector<int>& to_be_deleted){
+        ManVec<int>& holes,
+        ManVec<int>& others){
 
-    int other = last+ii; //size() - 1 - i;
-    int indx = to_be_deleted[ii];
+    int indx  = holes[ii];
+    int other = others[ii];
 
-    //if(indx >= last) return;
-    //std::cout << " sw " << indx << " to " << other << " while last " << last << std::endl;
-      
-    //std::cout << "deleting " << indx << " by putting it to " << last << '\n';
     for(int i=0; i<3; i++) locn[i][indx] = locn[i][other];
     for(int i=0; i<3; i++) veln[i][indx] = veln[i][other];
     for(int i=0; i<2; i++) idn[ i][indx] = idn[ i][other];
     wgtArr[indx] = wgtArr[other];
 
-  }, to_be_deleted.size(), to_be_deleted);
+  }, holes.size(), holes, others);
   
   UniIter::sync();
   
@@ -674,25 +767,29 @@ void ParticleContainer<D>::delete_transferred_particles()
   for(int i=0; i<2; i++) idn[i] = &( id(i,0) );
   
   
-  // overwrite particles with the last one on the array and 
-  // then resize the array
-  int last = size()-to_other_tiles.size();
+  // overwrite deleted particles in [0,last) with the kept ones beyond
+  // last and then resize the array
+  const int Ndel = to_other_tiles.size();
+  int last = size() - Ndel;
   //std::cout << "del: " << size() << " to be deleted: " << to_other_tiles.size() << std::endl;
+
+  std::vector<int> dels(Ndel);
+  for(int ii=0; ii<Ndel; ii++) dels[ii] = to_other_tiles[ii].n;
+
+  ManVec<int> holes, others;
+  pair_deleted(dels, holes, others);
   
-  UniIter::iterate([=] DEVCALLABLE (int ii, ManVec<to_other_tiles_struct> &to_other_tiles){
-    int other = last+ii; //size() - 1 - i;
-    int indx = to_other_tiles[ii].n;
+  UniIter::iterate([=] DEVCALLABLE (int ii, ManVec<int>& holes, ManVec<int>& others){
+    int indx  = holes[ii];
+    int other = others[ii];
 
-    //if(indx >= last) return;
-    //std::cout << " sw " << indx << " to " << other << " while last " << last << std::endl;
-      
-    //std::cout << "deleting " << indx << " by putting it to " << last << '\n';
+    //std::cout << "deleting " << indx << " by putting " << other << " to it\n";
     for(int i=0; i<3; i++) locn[i][indx] = locn[i][other];
     for(int i=0; i<3; i++) veln[i][indx] = veln[i][other];
     for(int i=0; i<2; i++) idn[ i][indx] = idn[ i][other];
     wgtArr[indx] = wgtArr[other];
 
-  }, to_other_tiles.size(), to_other_tiles);
+  }, holes.size(), holes, others);
   
   UniIter::sync();
   
@@ -1095,6 +1192,9 @@ void ParticleContainer<D>::apply_permutation( ManVec<size_t>& indices )
   // check that sizes match
   assert( indices.size() == size() );
 
+  // energies exist only if sort_in_rev_energy has been called
+  const bool has_ene = eneArr.size() == indices.size();
+
   // https://stackoverflow.com/questions/67751784/how-to-do-in-place-sorting-a-list-according-to-a-given-index-in-c
   // and
   // https://devblogs.microsoft.com/oldnewthing/20170102-00/?p=95095
@@ -1119,7 +1219,7 @@ void ParticleContainer<D>::apply_permutation( ManVec<size_t>& indices )
 
       std::swap( wgtArr[current], wgtArr[next] ); 
 
-      std::swap( eneArr[current], eneArr[next] ); 
+      if(has_ene) std::swap( eneArr[current], eneArr[next] ); 
 
       // NOTE: these can be omitted if interpolator is called *after* sort
       //std::swap( ex[current], ex[next] ); 
@@ -1141,6 +1241,60 @@ void ParticleContainer<D>::apply_permutation( ManVec<size_t>& indices )
 }
 
 
+template<size_t D>
+void ParticleContainer<D>::sort_in_cells(
+    std::array<double,3>& mins,
+    std::array<double,3>& maxs)
+{
+  const size_t N = size(); // number of prtcls
+  if(N < 2) return;
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  UniIter::sync();
+
+  // tile size in cells; particles outside (not yet transferred) are clamped to the edge cells
+  int nl[3] = {1,1,1};
+  for(size_t i=0; i<D; i++) nl[i] = std::max(1, static_cast<int>(maxs[i] - mins[i]));
+
+  auto cell_index = [&](size_t n) 
+  {
+    int ijk[3] = {0,0,0};
+    for(size_t i=0; i<D; i++) {
+      int c = static_cast<int>( std::floor(loc(i,n) - mins[i]) );
+      ijk[i] = std::min(std::max(c, 0), nl[i]-1);
+    }
+    return ijk[0] + nl[0]*( ijk[1] + nl[1]*ijk[2] ); // same order as in toolbox::Mesh
+  };
+
+  //--------------------------------------------------
+  // counting sort; stable so particles keep their order inside a cell
+  const size_t Ncells = size_t(nl[0])*nl[1]*nl[2];
+  std::vector<size_t> offs(Ncells + 1, 0);
+  std::vector<int> cells(N);
+
+  for(size_t n=0; n<N; n++) {
+    cells[n] = cell_index(n);
+    offs[cells[n] + 1]++;
+  }
+
+  for(size_t c=0; c<Ncells; c++) offs[c+1] += offs[c];
+
+  // indices[new location] = old location
+  ManVec<size_t> indices;
+  indices.resize(N);
+  for(size_t n=0; n<N; n++) indices[ offs[cells[n]]++ ] = n;
+
+  apply_permutation(indices);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
 template<size_t D>
 void ParticleContainer<D>::update_cumulative_arrays()
 {
@@ -71,6 +71,11 @@ class ParticleContainer{
   /// unique key generator
   std::pair<int,int> keygen();
 
+  /// pair deleted particles before the new end with kept particles after it
+  //
+  // dels are sorted in descending order; holes[i] is overwritten by others[i].
+  void pair_deleted(const std::vector<int>& dels, ManVec<int>& holes, ManVec<int>& others);
+
   protected:
 
   std::array<ManVec<float>, 3 > locArr; // x y z location
@@ -133,6 +138,10 @@ class ParticleContainer{
   //! particle specific magnetic field components
   ManVec<float> Bpart;
 
+  //! allocate Epart/Bpart; turned off by fused solvers that keep the fields in registers
+  //  (use set_store_fields to change)
+  bool store_fields = true;
+
   //! multimap of particles going to other tiles
   using mapType = ManVec<to_other_tiles_struct>;
   mapType to_other_tiles;
@@ -164,6 +173,9 @@ class ParticleContainer{
   // "shrink to fit" all internal main containers
   virtual void shrink_to_fit();
 
+  // switch storage of particle fields on/off; off frees Epart/Bpart
+  void set_store_fields(bool store);
+
   /// size of the container (in terms of particles)
   //DEVCALLABLE size_t size() const { return Nprtcls; }
   //DEVCALLABLE size_t size() const { return locArr[0].size(); } // FIXME defaul
@@ -353,6 +365,15 @@ class ParticleContainer{
   //  float ux, float uy, float uz,
   //  float prtcl_wgt);
 
+  /// append N particles from contiguous arrays; ids from the running key generator
+  //
+  // wgt == nullptr gives all particles weight wgt0.
+  void add_particles_bulk(
+      size_t N,
+      const float* x,  const float* y,  const float* z,
+      const float* vx, const float* vy, const float* vz,
+      const float* wgt, float wgt0 = 1.0f);
+
   // particle creation
   virtual void add_identified_particle (
       std::vector<float> prtcl_loc,
@@ -398,6 +419,15 @@ class ParticleContainer{
   // sort particles in reverse (ascending) energy order
   void sort_in_rev_energy();
 
+  /// counting sort of particles by cell index inside tile limits
+  //
+  // makes field interpolation and current deposition access the meshes
+  // in memory order; E/B particle arrays are not permuted so this needs
+  // to be called before the interpolator.
+  void sort_in_cells(
+      std::array<double,3>& mins,
+      std::array<double,3>& maxs);
+
   // update internal cumulative weight arrays of particles
   void update_cumulative_arrays();
 };
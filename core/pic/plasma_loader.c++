@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+#include "core/pic/plasma_loader.h"
+#include "core/pic/samplers.h"
+#include "tools/rng.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+float pic::TabulatedProfile::operator()(float x, float y, float z) const
+{
+  auto cell = [](float v, float v0, size_t n) {
+    long i = (long)std::floor(v - v0);
+    return (size_t)std::min<long>(std::max<long>(i, 0), (long)n - 1);
+  };
+
+  const size_t i = cell(x, x0, nx);
+  const size_t j = cell(y, y0, ny);
+  const size_t k = cell(z, z0, nz);
+  return data[i + nx*(j + ny*k)];
+}
+
+
+// separate random stream for each tile and species
+inline toolbox::CounterRNG tile_stream(uint64_t seed, uint64_t cid, int ispcs)
+{
+  return toolbox::CounterRNG(seed, (cid << 16) + (uint64_t)ispcs);
+}
+
+// random blocks of one particle/cell
+//   0: position + flip of the boosted sample
+//   1: direction + non-relativistic |u|
+//   2+a: a:th Sobol attempt or blackbody energy
+//   last: rounding of fractional ppc (cell index)
+static constexpr uint32_t BLK_POS  = 0;
+static constexpr uint32_t BLK_DIR  = 1;
+static constexpr uint32_t BLK_U    = 2;
+static constexpr uint32_t BLK_CELL = 0xFFFFFFFFu;
+
+
+template<size_t D>
+void pic::PlasmaLoader<D>::count(
+    pic::Tile<D>& tile, int ispcs, int ref_species, TileWork& work)
+{
+  if(ref_species >= 0) {
+    work.N = tile.get_container(ref_species).size();
+    return;
+  }
+
+  const int nx = tile.mesh_lengths[0];
+  const int ny = tile.mesh_lengths[1];
+  const int nz = tile.mesh_lengths[2];
+
+  const float xmin = tile.mins[0];
+  const float ymin = D >= 2 ? tile.mins[1] : 0.0f;
+  const float zmin = D >= 3 ? tile.mins[2] : 0.0f;
+
+  auto rng = tile_stream(seed, tile.cid, ispcs);
+
+  work.cell_counts.resize(nx*ny*nz);
+  work.N = 0;
+
+  for(int k=0; k<nz; k++)
+  for(int j=0; j<ny; j++)
+  for(int i=0; i<nx; i++) {
+    const size_t c = i + nx*(j + ny*k);
+    const float p = density ? density(xmin + i, ymin + j, zmin + k) : ppc;
+    assert(p >= 0.0f);
+
+    int n = (int)std::floor(p);
+    if(toolbox::u01(rng.raw4(c, BLK_CELL)[0]) < p - n) n++;
+
+    work.cell_counts[c] = n;
+    work.N += n;
+  }
+}
+
+
+template<size_t D>
+void pic::PlasmaLoader<D>::fill(
+    pic::Tile<D>& tile, int ispcs, int ref_species, int key0, const TileWork& work)
+{
+  const size_t N = work.N;
+  auto& con = tile.get_container(ispcs);
+  con.set_keygen_state(key0, tile.communication.owner);
+  if(N == 0) return;
+
+  const bool photons = distribution == "blackbody";
+  auto rng = tile_stream(seed, tile.cid, ispcs);
+
+  std::vector<float> x(N), y(N), z(N), ux(N), uy(N), uz(N), w(N);
+
+  // cell corners of the particles
+  std::vector<float> xc(N), yc(N), zc(N);
+
+  if(ref_species >= 0) {
+    auto& ref = tile.get_container(ref_species);
+    for(size_t n=0; n<N; n++) {
+      x[n] = ref.loc(0, n);
+      y[n] = ref.loc(1, n);
+      z[n] = ref.loc(2, n);
+      xc[n] = std::floor(x[n]);
+      yc[n] = D >= 2 ? std::floor(y[n]) : 0.0f;
+      zc[n] = D >= 3 ? std::floor(z[n]) : 0.0f;
+    }
+  } else {
+    const int nx = tile.mesh_lengths[0];
+    const int ny = tile.mesh_lengths[1];
+    const int nz = tile.mesh_lengths[2];
+
+    const float xmin = tile.mins[0];
+    const float ymin = D >= 2 ? tile.mins[1] : 0.0f;
+    const float zmin = D >= 3 ? tile.mins[2] : 0.0f;
+
+    size_t n = 0;
+    for(int k=0; k<nz; k++)
+    for(int j=0; j<ny; j++)
+    for(int i=0; i<nx; i++) {
+      const int cnt = work.cell_counts[i + nx*(j + ny*k)];
+      for(int ip=0; ip<cnt; ip++, n++) {
+        xc[n] = xmin + i;
+        yc[n] = ymin + j;
+        zc[n] = zmin + k;
+      }
+    }
+    assert(n == N);
+
+    // uniformly inside the cell (also in collapsed dimensions; same as inject)
+    #pragma omp simd
+    for(size_t n=0; n<N; n++) {
+      auto r = rng.raw4(n, BLK_POS);
+      x[n] = xc[n] + toolbox::u01(r[0]);
+      y[n] = yc[n] + toolbox::u01(r[1]);
+      z[n] = zc[n] + toolbox::u01(r[2]);
+    }
+  }
+
+  //--------------------------------------------------
+  // local plasma parameters; profiles are evaluated once per cell
+  std::vector<float> th(N), gm(N);
+  {
+    float lx = NAN, ly = NAN, lz = NAN;
+    float t0 = theta, g0 = gamma, w0 = wgt;
+    for(size_t n=0; n<N; n++) {
+      if(xc[n] != lx || yc[n] != ly || zc[n] != lz) {
+        lx = xc[n]; ly = yc[n]; lz = zc[n];
+        if(temperature) t0 = temperature(lx, ly, lz);
+        if(drift)       g0 = drift(lx, ly, lz);
+        if(weight)      w0 = weight(lx, ly, lz);
+      }
+      th[n] = t0;
+      gm[n] = g0;
+      w[n]  = w0;
+    }
+  }
+
+  //--------------------------------------------------
+  // |u|; first attempt for all particles, rejected Sobol samples are redrawn after
+  std::vector<float> u(N);
+  std::vector<char> rejected(N);
+
+  #pragma omp simd
+  for(size_t n=0; n<N; n++) {
+    auto r = rng.uniform4(n, BLK_U);
+    bool ok = true;
+    if(photons) {
+      u[n] = sampling::blackbody(th[n], r[0], r[1], r[2], r[3]);
+    } else if(th[n] > 0.2f) {
+      ok = sampling::sobol_try(th[n], r[0], r[1], r[2], r[3], u[n]);
+    } else {
+      u[n] = sampling::box_muller(th[n], rng.uniform4(n, BLK_DIR)[2]);
+    }
+    rejected[n] = !ok;
+  }
+
+  for(size_t n=0; n<N; n++) {
+    for(uint32_t a=1; rejected[n]; a++) {
+      auto r = rng.uniform4(n, BLK_U + a);
+      rejected[n] = !sampling::sobol_try(th[n], r[0], r[1], r[2], r[3], u[n]);
+    }
+  }
+
+  //--------------------------------------------------
+  // direction and boost
+  const int dim = photons ? 3 : dims;
+
+  #pragma omp simd
+  for(size_t n=0; n<N; n++) {
+    auto r = rng.uniform4(n, BLK_DIR);
+    if(dim == 3) {
+      sampling::iso3(u[n], r[0], r[1], ux[n], uy[n], uz[n]);
+    } else {
+      sampling::iso2(u[n], r[1], ux[n], uy[n], uz[n]);
+    }
+
+    if(!photons && gm[n] != 0.0f) {
+      auto rp = rng.uniform4(n, BLK_POS);
+      sampling::boost_x(gm[n], rp[3], ux[n], uy[n], uz[n]);
+      sampling::rotate(direction, ux[n], uy[n], uz[n]);
+    }
+  }
+
+  con.add_particles_bulk(N,
+      x.data(), y.data(), z.data(),
+      ux.data(), uy.data(), uz.data(),
+      w.data());
+}
+
+
+template<size_t D>
+size_t pic::PlasmaLoader<D>::load_tile(
+    pic::Tile<D>& tile, int ispcs, int ref_species, int key0)
+{
+  assert(ispcs < tile.Nspecies());
+  assert(ref_species < tile.Nspecies());
+
+  TileWork work;
+  count(tile, ispcs, ref_species, work);
+  fill(tile, ispcs, ref_species, key0, work);
+  return work.N;
+}
+
+
+template<size_t D>
+size_t pic::PlasmaLoader<D>::load(
+    corgi::Grid<D>& grid, int ispcs, int ref_species, int key0)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  if(distribution != "maxwell_juttner" && distribution != "blackbody") {
+    std::cerr << "PlasmaLoader: unknown distribution " << distribution << std::endl;
+    assert(false);
+  }
+
+  auto cids = grid.get_local_tiles();
+  std::sort(cids.begin(), cids.end());
+
+  std::vector<pic::Tile<D>*> tiles;
+  for(auto cid : cids) tiles.push_back( &dynamic_cast<pic::Tile<D>&>(grid.get_tile(cid)) );
+
+  const int Ntiles = tiles.size();
+  std::vector<TileWork> works(Ntiles);
+
+  // particle counts
+  #pragma omp parallel for schedule(dynamic)
+  for(int t=0; t<Ntiles; t++) count(*tiles[t], ispcs, ref_species, works[t]);
+
+  // ids continue over the tiles in cid order
+  std::vector<int> keys(Ntiles);
+  size_t Ntot = 0;
+  for(int t=0; t<Ntiles; t++) {
+    keys[t] = key0 + (int)Ntot;
+    Ntot += works[t].N;
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for(int t=0; t<Ntiles; t++) fill(*tiles[t], ispcs, ref_species, keys[t], works[t]);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+
+  return Ntot;
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+template class pic::PlasmaLoader<1>;
+template class pic::PlasmaLoader<2>;
+template class pic::PlasmaLoader<3>;
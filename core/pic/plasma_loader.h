@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "external/corgi/corgi.h"
+#include "core/pic/tile.h"
+
+
+namespace pic {
+
+
+/// profile tabulated on the global cell grid; nearest cell, clamped at the edges
+struct TabulatedProfile {
+  size_t nx = 1, ny = 1, nz = 1;
+
+  /// location of the first cell
+  float x0 = 0.0f, y0 = 0.0f, z0 = 0.0f;
+
+  /// x-fastest values
+  std::vector<float> data;
+
+  float operator()(float x, float y, float z) const;
+};
+
+
+/*! \brief Native plasma loader
+ *
+ * Fills the local tiles with particles of one species in parallel. The
+ * number of particles per cell, temperature, bulk drift and weight are
+ * given as constants or as profiles f(x,y,z) evaluated at the cell corner
+ * (as in pytools.pic.inject). Fractional particles per cell are rounded
+ * stochastically.
+ *
+ * Velocities are sampled from a (boosted) Maxwell-Juttner distribution
+ * (Sobol method for theta > 0.2) or a blackbody photon distribution,
+ * with the same algorithms as pytools/sampling.py.
+ *
+ * Random numbers come from counter-based streams keyed by (seed, tile,
+ * species) and addressed by particle index, so the result does not depend
+ * on the number of threads or ranks.
+ */
+template<size_t D>
+class PlasmaLoader
+{
+
+  public:
+
+  using Profile = std::function<float(float, float, float)>;
+
+  /// global seed
+  uint64_t seed = 0;
+
+  /// particles per cell; used if density is not set
+  float ppc = 1.0f;
+
+  /// temperature kT/mc^2; used if temperature is not set
+  float theta = 0.0f;
+
+  /// bulk Lorentz factor (or beta if < 1; 0 for none); used if drift is not set
+  float gamma = 0.0f;
+
+  /// particle weight; used if weight is not set
+  float wgt = 1.0f;
+
+  /// drift direction; -1/+1 for -/+x; -2/+2 for -/+y; -3/+3 for -/+z
+  int direction = 1;
+
+  /// 2 for velocities in the xy plane; 3 for xyz
+  int dims = 3;
+
+  /// "maxwell_juttner" or "blackbody"
+  std::string distribution = "maxwell_juttner";
+
+  /// optional profiles; must be thread-safe
+  Profile density;
+  Profile temperature;
+  Profile drift;
+  Profile weight;
+
+  /// inject species ispcs to all local tiles; returns number of particles added
+  //
+  // If ref_species >= 0 the particles are placed on top of the particles of
+  // that species (one per reference particle) and density is not used.
+  // Particle ids continue from key0 over the local tiles in cid order.
+  size_t load(corgi::Grid<D>& grid, int ispcs, int ref_species = -1, int key0 = 0);
+
+  /// inject to one tile; ids start at key0
+  size_t load_tile(pic::Tile<D>& tile, int ispcs, int ref_species = -1, int key0 = 0);
+
+  private:
+
+  struct TileWork {
+    std::vector<int> cell_counts;
+    size_t N = 0;
+  };
+
+  void count(pic::Tile<D>& tile, int ispcs, int ref_species, TileWork& work);
+  void fill(pic::Tile<D>& tile, int ispcs, int ref_species, int key0, const TileWork& work);
+};
+
+
+} // end of namespace pic
@@ -0,0 +1,112 @@
+#include <cmath> 
+
+#include "core/pic/pushers/simd.h"
+#include "tools/signum.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h> 
+#endif
+
+using toolbox::sign;
+
+template<size_t D, size_t V, class Scheme, typename T>
+void pic::SimdPusher<D,V,Scheme,T>::push_container(
+    pic::ParticleContainer<D>& con, 
+    pic::Tile<D>& tile)
+{
+  const size_t N = con.size();
+  if(N == 0) return;
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  const T c  = tile.cfl;
+  const T qm = sign(con.q)/con.m; // q_s/m_s (sign only because emf are in units of q)
+
+  // external fields hoisted out of the particle loop
+  const T ex_ext = this->get_ex_ext(0,0,0);
+  const T ey_ext = this->get_ey_ext(0,0,0);
+  const T ez_ext = this->get_ez_ext(0,0,0);
+  const T bx_ext = this->get_bx_ext(0,0,0);
+  const T by_ext = this->get_by_ext(0,0,0);
+  const T bz_ext = this->get_bz_ext(0,0,0);
+
+  // raw SoA arrays
+  float* loc[3];
+  float* vel[3];
+  for(int i=0; i<3; i++) {
+    loc[i] = &( con.loc(i,0) );
+    vel[i] = &( con.vel(i,0) );
+  }
+
+  const float* ex = &( con.ex(0) );
+  const float* ey = &( con.ey(0) );
+  const float* ez = &( con.ez(0) );
+  const float* bx = &( con.bx(0) );
+  const float* by = &( con.by(0) );
+  const float* bz = &( con.bz(0) );
+
+  auto push = [&](size_t n) 
+  {
+    T u = vel[0][n];
+    T v = vel[1][n];
+    T w = vel[2][n];
+
+    const T g = Scheme::push(u, v, w,
+        ex[n] + ex_ext, ey[n] + ey_ext, ez[n] + ez_ext,
+        bx[n] + bx_ext, by[n] + by_ext, bz[n] + bz_ext,
+        c, qm);
+
+    vel[0][n] = u;
+    vel[1][n] = v;
+    vel[2][n] = w;
+
+    // position advance with the stored (single precision) velocity as in the scalar pushers
+    for(size_t i=0; i<D; i++) loc[i][n] += T(vel[i][n])*g*c;
+  };
+
+  // full vector blocks
+  constexpr size_t W = lanes;
+  const size_t Nblocks = N/W;
+
+  for(size_t b=0; b<Nblocks; b++) {
+    const size_t n0 = b*W;
+
+    #pragma omp simd simdlen(W)
+    for(size_t l=0; l<W; l++) push(n0 + l);
+  }
+
+  // scalar remainder
+  for(size_t n=Nblocks*W; n<N; n++) push(n);
+
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+
+template class pic::SimdPusher<1,3,pic::simd::Boris,double>;
+template class pic::SimdPusher<2,3,pic::simd::Boris,double>;
+template class pic::SimdPusher<3,3,pic::simd::Boris,double>;
+template class pic::SimdPusher<1,3,pic::simd::Vay,double>;
+template class pic::SimdPusher<2,3,pic::simd::Vay,double>;
+template class pic::SimdPusher<3,3,pic::simd::Vay,double>;
+template class pic::SimdPusher<1,3,pic::simd::HigueraCary,double>;
+template class pic::SimdPusher<2,3,pic::simd::HigueraCary,double>;
+template class pic::SimdPusher<3,3,pic::simd::HigueraCary,double>;
+
+// single precision
+template class pic::SimdPusher<1,3,pic::simd::Boris,float>;
+template class pic::SimdPusher<2,3,pic::simd::Boris,float>;
+template class pic::SimdPusher<3,3,pic::simd::Boris,float>;
+template class pic::SimdPusher<1,3,pic::simd::Vay,float>;
+template class pic::SimdPusher<2,3,pic::simd::Vay,float>;
+template class pic::SimdPusher<3,3,pic::simd::Vay,float>;
+template class pic::SimdPusher<1,3,pic::simd::HigueraCary,float>;
+template class pic::SimdPusher<2,3,pic::simd::HigueraCary,float>;
+template class pic::SimdPusher<3,3,pic::simd::HigueraCary,float>;
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cmath>
+
+#include "core/pic/pushers/pusher.h"
+
+namespace pic {
+namespace simd {
+
+/// number of particles processed per vector block;
+//  one 512 bit register (AVX-512) or two 256 bit registers (AVX2)
+template<typename T>
+constexpr size_t lanes = 64/sizeof(T);
+
+
+/// Boris scheme; same arithmetic as pic::BorisPusher
+//
+// u, v, w are the normalized four-velocity components; fields include the
+// external contribution. Returns c/gamma for the position advance, x += u*g*c.
+struct Boris
+{
+  template<typename T>
+  static inline T push(T& u, T& v, T& w,
+      T ex, T ey, T ez, T bx, T by, T bz,
+      const T c, const T qm)
+  {
+    const T ex0 = ex*T(0.5)*qm;
+    const T ey0 = ey*T(0.5)*qm;
+    const T ez0 = ez*T(0.5)*qm;
+
+    T bx0 = bx*T(0.5)*qm/c;
+    T by0 = by*T(0.5)*qm/c;
+    T bz0 = bz*T(0.5)*qm/c;
+
+    // first half electric acceleration
+    T u0 = u*c + ex0;
+    T v0 = v*c + ey0;
+    T w0 = w*c + ez0;
+
+    // first half magnetic rotation
+    T ginv = c/std::sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+    bx0 *= ginv;
+    by0 *= ginv;
+    bz0 *= ginv;
+
+    const T f = T(2.0)/(T(1.0) + bx0*bx0 + by0*by0 + bz0*bz0);
+    const T u1 = (u0 + v0*bz0 - w0*by0)*f;
+    const T v1 = (v0 + w0*bx0 - u0*bz0)*f;
+    const T w1 = (w0 + u0*by0 - v0*bx0)*f;
+
+    // second half of magnetic rotation & electric acceleration
+    u0 = u0 + v1*bz0 - w1*by0 + ex0;
+    v0 = v0 + w1*bx0 - u1*bz0 + ey0;
+    w0 = w0 + u1*by0 - v1*bx0 + ez0;
+
+    u = u0/c;
+    v = v0/c;
+    w = w0/c;
+
+    return c/std::sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+
+/// Vay scheme; same arithmetic as pic::VayPusher
+struct Vay
+{
+  template<typename T>
+  static inline T push(T& u, T& v, T& w,
+      T ex, T ey, T ez, T bx, T by, T bz,
+      const T c, const T qm)
+  {
+    const T cinv = T(1.0)/c;
+
+    const T ex0 = ex*T(0.5)*qm;
+    const T ey0 = ey*T(0.5)*qm;
+    const T ez0 = ez*T(0.5)*qm;
+
+    const T bx0 = bx*T(0.5)*qm/c;
+    const T by0 = by*T(0.5)*qm/c;
+    const T bz0 = bz*T(0.5)*qm/c;
+
+    // gamma^-1
+    T g = T(1.0)/std::sqrt(T(1.0) + u*u + v*v + w*w);
+    const T vx0 = c*u*g;
+    const T vy0 = c*v*g;
+    const T vz0 = c*w*g;
+
+    // u' (cinv is already multiplied into B)
+    const T u1 = c*u + T(2.0)*ex0 + vy0*bz0 - vz0*by0;
+    const T v1 = c*v + T(2.0)*ey0 + vz0*bx0 - vx0*bz0;
+    const T w1 = c*w + T(2.0)*ez0 + vx0*by0 - vy0*bx0;
+
+    // gamma(u')
+    const T ustar = cinv*(u1*bx0 + v1*by0 + w1*bz0);
+    const T sig = cinv*cinv*(c*c + u1*u1 + v1*v1 + w1*w1) - (bx0*bx0 + by0*by0 + bz0*bz0);
+    g = T(1.0)/std::sqrt( T(0.5)*(sig + std::sqrt(sig*sig + T(4.0)*(bx0*bx0 + by0*by0 + bz0*bz0 + ustar*ustar))));
+
+    const T tx = bx0*g;
+    const T ty = by0*g;
+    const T tz = bz0*g;
+    const T f = T(1.0)/(T(1.0) + tx*tx + ty*ty + tz*tz);
+
+    const T ut = u1*tx + v1*ty + w1*tz;
+    const T u0 = f*(u1 + ut*tx + v1*tz - w1*ty);
+    const T v0 = f*(v1 + ut*ty + w1*tx - u1*tz);
+    const T w0 = f*(w1 + ut*tz + u1*ty - v1*tx);
+
+    u = u0/c;
+    v = v0/c;
+    w = w0/c;
+
+    return c/std::sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+
+/// Higuera-Cary scheme; same arithmetic as pic::HigueraCaryPusher
+struct HigueraCary
+{
+  template<typename T>
+  static inline T push(T& u, T& v, T& w,
+      T ex, T ey, T ez, T bx, T by, T bz,
+      const T c, const T qm)
+  {
+    const T ex0 = ex*T(0.5)*qm;
+    const T ey0 = ey*T(0.5)*qm;
+    const T ez0 = ez*T(0.5)*qm;
+
+    T bx0 = bx*T(0.5)*qm;
+    T by0 = by*T(0.5)*qm;
+    T bz0 = bz*T(0.5)*qm;
+
+    // first half electric acceleration
+    T u0 = c*u + ex0;
+    T v0 = c*v + ey0;
+    T w0 = c*w + ez0;
+
+    // intermediate gamma
+    const T g2 = (c*c + u0*u0 + v0*v0 + w0*w0)/(c*c);
+    const T b2 = bx0*bx0 + by0*by0 + bz0*bz0;
+    const T bu = bx0*u0 + by0*v0 + bz0*w0;
+    T ginv = T(1.)/std::sqrt( T(0.5)*(g2-b2 + std::sqrt( (g2-b2)*(g2-b2) + T(4.0)*(b2 + bu*bu))));
+
+    // first half magnetic rotation; cinv is multiplied to B field only here
+    bx0 *= ginv/c;
+    by0 *= ginv/c;
+    bz0 *= ginv/c;
+
+    const T f = T(2.0)/(T(1.0) + bx0*bx0 + by0*by0 + bz0*bz0);
+    const T u1 = (u0 + v0*bz0 - w0*by0)*f;
+    const T v1 = (v0 + w0*bx0 - u0*bz0)*f;
+    const T w1 = (w0 + u0*by0 - v0*bx0)*f;
+
+    // second half of magnetic rotation & electric acceleration
+    u0 = u0 + v1*bz0 - w1*by0 + ex0;
+    v0 = v0 + w1*bx0 - u1*bz0 + ey0;
+    w0 = w0 + u1*by0 - v1*bx0 + ez0;
+
+    u = u0/c;
+    v = v0/c;
+    w = w0/c;
+
+    return c/std::sqrt(c*c + u0*u0 + v0*v0 + w0*w0);
+  }
+};
+
+} // end of namespace simd
+
+
+/*! \brief Vectorized pusher over the SoA particle arrays
+ *
+ * Processes particles in blocks of simd::lanes<T> straight from the
+ * loc/vel/Epart/Bpart arrays; remainder particles are pushed with the
+ * same (scalar) kernel. External fields are read once per container,
+ * so position-dependent get_*_ext overrides are not supported.
+ *
+ * T=double follows the scalar pushers; T=float runs the whole update
+ * in single precision.
+ */
+template<size_t D, size_t V, class Scheme, typename T=double>
+class SimdPusher :
+  public Pusher<D,V>
+{
+  public:
+
+  /// particles per vector block
+  static constexpr size_t lanes = simd::lanes<T>;
+
+  void push_container(
+          pic::ParticleContainer<D>& container,
+          pic::Tile<D>& tile) override;
+
+};
+
+} // end of namespace pic
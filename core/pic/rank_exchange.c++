@@ -0,0 +1,416 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <cstring>
+#include <cassert>
+
+#include "core/pic/rank_exchange.h"
+#include "core/pic/communicate.h"
+#include "external/iter/iter.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+namespace {
+
+/// neighbor tile at offset (i,j,k); empty pointer if it does not exist
+template<size_t D>
+std::shared_ptr<corgi::Tile<D>> get_neighbor(
+    corgi::Grid<D>& grid, corgi::Tile<D>& tile, int i, int j, int k);
+
+template<>
+std::shared_ptr<corgi::Tile<1>> get_neighbor(
+    corgi::Grid<1>& grid, corgi::Tile<1>& tile, int i, int /*j*/, int /*k*/)
+{ return grid.get_tileptr( tile.neighs(i) ); }
+
+template<>
+std::shared_ptr<corgi::Tile<2>> get_neighbor(
+    corgi::Grid<2>& grid, corgi::Tile<2>& tile, int i, int j, int /*k*/)
+{ return grid.get_tileptr( tile.neighs(i, j) ); }
+
+template<>
+std::shared_ptr<corgi::Tile<3>> get_neighbor(
+    corgi::Grid<3>& grid, corgi::Tile<3>& tile, int i, int j, int k)
+{ return grid.get_tileptr( tile.neighs(i, j, k) ); }
+
+
+/// field components communicated in each mode
+inline std::array<toolbox::Mesh<float,3>*, 3> get_components(emf::Grids& gs, int mode)
+{
+  if(mode == 0) return { &gs.jx, &gs.jy, &gs.jz };
+  if(mode == 1) return { &gs.ex, &gs.ey, &gs.ez };
+  assert(mode == 2);
+  return { &gs.bx, &gs.by, &gs.bz };
+}
+
+} // end of anonymous namespace
+
+
+template<size_t D>
+std::vector<uint64_t> pic::RankExchanger<D>::ownership_signature(corgi::Grid<D>& grid)
+{
+  std::vector<uint64_t> sig = grid.get_local_tiles();
+  std::sort(sig.begin(), sig.end());
+
+  std::vector<uint64_t> virs = grid.get_virtual_tiles();
+  std::sort(virs.begin(), virs.end());
+  for(auto cid : virs) {
+    sig.push_back(cid);
+    sig.push_back( grid.get_tile(cid).communication.owner );
+  }
+
+  return sig;
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::build_map(corgi::Grid<D>& grid)
+{
+  const int my_rank = grid.comm.rank();
+
+  using Dirs = std::vector<std::array<int,3>>;
+
+  // rank -> (tile, directions); std::map keeps neighbors and tiles in rank/cid order
+  std::map<int, std::map<uint64_t, Dirs>> send_cids, recv_cids;
+
+  // directions around tile whose neighbor tile is owned by rank (or by anyone other if rank < 0)
+  auto for_neighbors = [&](corgi::Tile<D>& tile, auto func)
+  {
+    for(int k=-1; k<=1; k++)
+    for(int j=-1; j<=1; j++)
+    for(int i=-1; i<=1; i++) {
+      if(D < 3 && k != 0) continue;
+      if(D < 2 && j != 0) continue;
+      if(i == 0 && j == 0 && k == 0) continue;
+
+      auto tpr = get_neighbor<D>(grid, tile, i, j, k);
+      if(!tpr) continue;
+
+      func(tpr->communication.owner, std::array<int,3>{{i, j, k}});
+    }
+  };
+
+  //--------------------------------------------------
+  // boundary tiles are sent to every rank that owns one of their neighbors
+  for(auto cid : grid.get_boundary_tiles()) {
+    for_neighbors(grid.get_tile(cid), [&](int owner, std::array<int,3> dir) {
+      if(owner != my_rank) send_cids[owner][cid].push_back(dir);
+    });
+  }
+
+  //--------------------------------------------------
+  // virtual tiles are received from their owner; 
+  // directions are the ones pointing to our local tiles
+  for(auto cid : grid.get_virtual_tiles()) {
+    auto& tile = grid.get_tile(cid);
+    const int owner = tile.communication.owner;
+
+    auto& dirs = recv_cids[owner][cid];
+    for_neighbors(tile, [&](int nowner, std::array<int,3> dir) {
+      if(nowner == my_rank) dirs.push_back(dir);
+    });
+  }
+
+  //--------------------------------------------------
+  // same ordering (by cid) on both sides
+  std::vector<int> ranks;
+  for(auto& it : send_cids) ranks.push_back(it.first);
+  for(auto& it : recv_cids) {
+    if(std::find(ranks.begin(), ranks.end(), it.first) == ranks.end()) ranks.push_back(it.first);
+  }
+  std::sort(ranks.begin(), ranks.end());
+
+  neighbors.clear();
+  neighbors.resize(ranks.size());
+
+  for(size_t n=0; n<ranks.size(); n++) {
+    auto& nb = neighbors[n];
+    nb.rank = ranks[n];
+
+    for(auto& it : send_cids[nb.rank]) {
+      nb.send_tiles.push_back( &dynamic_cast<pic::Tile<D>&>(grid.get_tile(it.first)) );
+      nb.send_dirs.push_back( it.second );
+    }
+
+    for(auto& it : recv_cids[nb.rank]) {
+      nb.recv_tiles.push_back( &dynamic_cast<pic::Tile<D>&>(grid.get_tile(it.first)) );
+      nb.recv_dirs.push_back( it.second );
+    }
+  }
+
+  map_valid = true;
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::update(corgi::Grid<D>& grid)
+{
+  auto sig = ownership_signature(grid);
+  if(map_valid && sig == map_signature) return;
+
+  // buffers and tile pointers of pending messages would be invalidated
+  assert(!in_flight());
+
+  map_signature = sig;
+  build_map(grid);
+}
+
+
+template<size_t D>
+bool pic::RankExchanger<D>::in_flight() const
+{
+  for(auto& r : reqs) if(!r.empty()) return true;
+  return false;
+}
+
+
+//--------------------------------------------------
+// fields
+
+template<size_t D>
+void pic::RankExchanger<D>::pack_fields(Neighbor& nb, int mode)
+{
+  auto& buf = nb.send_fbuf[mode];
+
+  if(halo_only) {
+    buf.clear();
+    for(size_t n=0; n<nb.send_tiles.size(); n++) {
+      for(auto& dir : nb.send_dirs[n]) nb.send_tiles[n]->pack_halo_slab(mode, dir, buf);
+    }
+    return;
+  }
+
+  size_t len = 0;
+  for(auto* tile : nb.send_tiles) {
+    for(auto* m : get_components(tile->get_grids(), mode)) len += m->size();
+  }
+  buf.resize(len);
+
+  size_t offs = 0;
+  for(auto* tile : nb.send_tiles) {
+    for(auto* m : get_components(tile->get_grids(), mode)) {
+      std::memcpy(buf.data() + offs, m->data(), m->size()*sizeof(float));
+      offs += m->size();
+    }
+  }
+}
+
+
+template<size_t D>
+size_t pic::RankExchanger<D>::recv_fields_size(Neighbor& nb, int mode)
+{
+  // virtual tiles have the same mesh sizes as the sender
+  size_t len = 0;
+  for(size_t n=0; n<nb.recv_tiles.size(); n++) {
+    auto* tile = nb.recv_tiles[n];
+
+    if(halo_only) {
+      for(auto& dir : nb.recv_dirs[n]) len += tile->halo_slab_size(mode, dir);
+    } else {
+      for(auto* m : get_components(tile->get_grids(), mode)) len += m->size();
+    }
+  }
+  return len;
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::unpack_fields(Neighbor& nb, int mode)
+{
+  const auto& buf = nb.recv_fbuf[mode];
+  size_t offs = 0;
+
+  if(halo_only) {
+    for(size_t n=0; n<nb.recv_tiles.size(); n++) {
+      for(auto& dir : nb.recv_dirs[n]) {
+        offs = nb.recv_tiles[n]->unpack_halo_slab(mode, dir, buf, offs);
+      }
+    }
+    assert(offs == buf.size());
+    return;
+  }
+
+  for(auto* tile : nb.recv_tiles) {
+    for(auto* m : get_components(tile->get_grids(), mode)) {
+      std::memcpy(m->data(), buf.data() + offs, m->size()*sizeof(float));
+      offs += m->size();
+    }
+  }
+  assert(offs == buf.size());
+}
+
+
+//--------------------------------------------------
+// particles
+
+template<size_t D>
+void pic::RankExchanger<D>::pack_particles(Neighbor& nb)
+{
+  // each container is packed as in pack_outgoing_particles:
+  // info particle (number in id slot) followed by primary and extra particles
+  size_t len = 0;
+  for(auto* tile : nb.send_tiles) {
+    for(int ispc=0; ispc<tile->Nspecies(); ispc++) {
+      auto& con = tile->get_container(ispc);
+      len += con.outgoing_particles.size() + con.outgoing_extra_particles.size();
+    }
+  }
+  nb.send_pbuf.resize(len);
+
+  size_t offs = 0;
+  for(auto* tile : nb.send_tiles) {
+    for(int ispc=0; ispc<tile->Nspecies(); ispc++) {
+      auto& con = tile->get_container(ispc);
+
+      std::copy(con.outgoing_particles.begin(), con.outgoing_particles.end(),
+                nb.send_pbuf.begin() + offs);
+      offs += con.outgoing_particles.size();
+
+      std::copy(con.outgoing_extra_particles.begin(), con.outgoing_extra_particles.end(),
+                nb.send_pbuf.begin() + offs);
+      offs += con.outgoing_extra_particles.size();
+    }
+  }
+
+  nb.send_np = static_cast<int>(len);
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::unpack_particles(Neighbor& nb)
+{
+  // split back to primary/extra messages so that
+  // Tile::unpack_incoming_particles works unchanged
+  size_t offs = 0;
+  for(auto* tile : nb.recv_tiles) {
+    for(int ispc=0; ispc<tile->Nspecies(); ispc++) {
+      auto& con = tile->get_container(ispc);
+
+      assert(offs < nb.recv_pbuf.size());
+      const int np = nb.recv_pbuf[offs].id; // number stored in id slot
+      const int np1 = std::min(np, con.first_message_size);
+      const int np2 = np - np1;
+
+      con.incoming_particles.resize(np1);
+      std::copy(nb.recv_pbuf.begin() + offs, nb.recv_pbuf.begin() + offs + np1,
+                con.incoming_particles.begin());
+      offs += np1;
+
+      if(np2 > 0) {
+        con.incoming_extra_particles.resize(np2);
+        std::copy(nb.recv_pbuf.begin() + offs, nb.recv_pbuf.begin() + offs + np2,
+                  con.incoming_extra_particles.begin());
+        offs += np2;
+      } else {
+        con.incoming_extra_particles.clear();
+      }
+    }
+  }
+  assert(offs == nb.recv_pbuf.size());
+}
+
+
+//--------------------------------------------------
+// communication
+
+template<size_t D>
+void pic::RankExchanger<D>::send_data(corgi::Grid<D>& grid, int mode)
+{
+  if(mode == 4) return; // extra particles are included in mode 3
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  update(grid);
+  UniIter::sync();
+
+  for(auto& nb : neighbors) {
+    if(nb.send_tiles.empty()) continue;
+
+    if(mode <= 2) {
+      pack_fields(nb, mode);
+      auto& buf = nb.send_fbuf[mode];
+      reqs[mode].emplace_back( grid.comm.isend(nb.rank, get_rank_tag(mode, 0), buf.data(), buf.size()) );
+    } else if(mode == 3) {
+      pack_particles(nb);
+      reqs[mode].emplace_back( grid.comm.isend(nb.rank, get_rank_tag(mode, 0), &nb.send_np, 1) );
+      reqs[mode].emplace_back( grid.comm.isend(nb.rank, get_rank_tag(mode, 1),
+                                               nb.send_pbuf.data(), nb.send_pbuf.size()) );
+    }
+  }
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::recv_data(corgi::Grid<D>& grid, int mode)
+{
+  if(mode == 4) return;
+
+  update(grid);
+
+  for(auto& nb : neighbors) {
+    if(nb.recv_tiles.empty()) continue;
+
+    if(mode <= 2) {
+      auto& buf = nb.recv_fbuf[mode];
+      buf.resize( recv_fields_size(nb, mode) );
+      reqs[mode].emplace_back( grid.comm.irecv(nb.rank, get_rank_tag(mode, 0), buf.data(), buf.size()) );
+    } else if(mode == 3) {
+      // payload size is received first; payload itself is posted in wait_data
+      reqs[mode].emplace_back( grid.comm.irecv(nb.rank, get_rank_tag(mode, 0), &nb.recv_np, 1) );
+    }
+  }
+}
+
+
+template<size_t D>
+void pic::RankExchanger<D>::wait_data(corgi::Grid<D>& grid, int mode)
+{
+  if(mode == 4) return;
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  auto& mreqs = reqs[mode];
+  mpi::wait_all(mreqs.begin(), mreqs.end());
+  mreqs.clear();
+
+  if(mode <= 2) {
+    for(auto& nb : neighbors) {
+      if(!nb.recv_tiles.empty()) unpack_fields(nb, mode);
+    }
+  } else if(mode == 3) {
+    for(auto& nb : neighbors) {
+      if(nb.recv_tiles.empty()) continue;
+      nb.recv_pbuf.resize(nb.recv_np);
+      mreqs.emplace_back( grid.comm.irecv(nb.rank, get_rank_tag(mode, 1),
+                                          nb.recv_pbuf.data(), nb.recv_pbuf.size()) );
+    }
+    mpi::wait_all(mreqs.begin(), mreqs.end());
+    mreqs.clear();
+
+    for(auto& nb : neighbors) {
+      if(!nb.recv_tiles.empty()) unpack_particles(nb);
+    }
+  }
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+
+template class pic::RankExchanger<1>;
+template class pic::RankExchanger<2>;
+template class pic::RankExchanger<3>;
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <mpi4cpp/mpi.h>
+
+#include "definitions.h"
+#include "external/corgi/corgi.h"
+#include "core/emf/tile.h"
+#include "core/pic/tile.h"
+
+
+namespace pic {
+
+using namespace mpi4cpp;
+
+/*! \brief Rank-level aggregated halo communication
+ *
+ * Replaces the per-tile messages of grid.send_data/recv_data/wait_data
+ * with one message per neighbor rank and direction. All boundary-tile
+ * data destined for the same rank is packed into one contiguous buffer.
+ *
+ * The index map (which tiles go to which rank, in which order) is
+ * computed once and rebuilt only when the tile ownership changes.
+ * Sender and receiver both order tiles by cid so no map needs to be
+ * exchanged.
+ *
+ * Modes follow Tile::send_data: 0=j, 1=e, 2=b, 3=particles.
+ * Particles are sent in one message (primary and extra packets
+ * combined); mode 4 is therefore a no-op.
+ *
+ * With halo_only=true only the face, edge, and corner slabs that the
+ * neighboring tiles of the receiving rank read are sent, instead of
+ * the full padded meshes. Interiors of virtual tiles are then not kept
+ * up to date.
+ *
+ * Requests and buffers are kept per mode, so exchanges of different
+ * modes may overlap (e.g., posting e while j is in flight). The same
+ * mode must be waited for before it is posted again.
+ */
+template<size_t D>
+class RankExchanger
+{
+  /// all tiles shared with one neighbor rank
+  struct Neighbor {
+    int rank;
+
+    /// local tiles that the neighbor holds as virtual tiles
+    std::vector<pic::Tile<D>*> send_tiles;
+
+    /// virtual tiles owned by the neighbor
+    std::vector<pic::Tile<D>*> recv_tiles;
+
+    /// directions of the tiles (per send/recv tile) that are across the rank boundary
+    std::vector<std::vector<std::array<int,3>>> send_dirs, recv_dirs;
+
+    /// field buffers of modes 0-2; kept separate so that modes can be in flight at the same time
+    std::array<std::vector<float>, 3> send_fbuf, recv_fbuf;
+
+    std::vector<Particle> send_pbuf, recv_pbuf;
+
+    /// particle message sizes
+    int send_np = 0, recv_np = 0;
+  };
+
+  std::vector<Neighbor> neighbors;
+
+  /// pending requests of modes 0-3
+  std::array<std::vector<mpi::request>, 4> reqs;
+
+  /// tile ownership when the index map was built
+  std::vector<uint64_t> map_signature;
+
+  bool map_valid = false;
+
+  /// message tag; separate from per-tile tags that are below 2^16*(9+8+Nspecies)
+  static int get_rank_tag(int mode, int part) { return (1 << 21) + 2*mode + part; }
+
+  std::vector<uint64_t> ownership_signature(corgi::Grid<D>& grid);
+
+  void build_map(corgi::Grid<D>& grid);
+
+  void pack_fields(Neighbor& nb, int mode);
+
+  void unpack_fields(Neighbor& nb, int mode);
+
+  size_t recv_fields_size(Neighbor& nb, int mode);
+
+  /// true if any mode has requests in flight
+  bool in_flight() const;
+
+  void pack_particles(Neighbor& nb);
+
+  void unpack_particles(Neighbor& nb);
+
+  public:
+
+  /// send only the halo slabs needed by the neighbors
+  bool halo_only = false;
+
+  RankExchanger() = default;
+
+  /// force recomputation of the index map (e.g., after load balancing)
+  void invalidate() { map_valid = false; }
+
+  /// rebuild index map if tile ownership has changed
+  void update(corgi::Grid<D>& grid);
+
+  /// pack and post sends to all neighbor ranks
+  void send_data(corgi::Grid<D>& grid, int mode);
+
+  /// post receives from all neighbor ranks
+  void recv_data(corgi::Grid<D>& grid, int mode);
+
+  /// complete communication and unpack into virtual tiles
+  void wait_data(corgi::Grid<D>& grid, int mode);
+
+  /// number of neighbor ranks
+  size_t number_of_neighbors() const { return neighbors.size(); }
+
+};
+
+} // end of namespace pic
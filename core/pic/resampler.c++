@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cmath>
+
+#include "core/pic/resampler.h"
+#include "definitions.h"
+#include "tools/rng.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+template<size_t D>
+void pic::Resampler<D>::bin_cells(
+    pic::Tile<D>& tile, int ispcs,
+    std::vector<size_t>& offsets,
+    std::vector<size_t>& order)
+{
+  auto& con = tile.get_container(ispcs);
+  const size_t N = con.size();
+
+  const int nx = tile.mesh_lengths[0];
+  const int ny = tile.mesh_lengths[1];
+  const int nz = tile.mesh_lengths[2];
+
+  auto cell_of = [&](size_t n) {
+    int i = (int)std::floor(con.loc(0, n) - tile.mins[0]);
+    int j = D >= 2 ? (int)std::floor(con.loc(1, n) - tile.mins[1]) : 0;
+    int k = D >= 3 ? (int)std::floor(con.loc(2, n) - tile.mins[2]) : 0;
+    i = std::min(std::max(i, 0), nx-1);
+    j = std::min(std::max(j, 0), ny-1);
+    k = std::min(std::max(k, 0), nz-1);
+    return (size_t)(i + nx*(j + ny*k));
+  };
+
+  std::vector<size_t> cells(N);
+  offsets.assign(nx*ny*nz + 1, 0);
+  for(size_t n=0; n<N; n++) {
+    cells[n] = cell_of(n);
+    offsets[cells[n]+1]++;
+  }
+  for(size_t c=1; c<offsets.size(); c++) offsets[c] += offsets[c-1];
+
+  order.resize(N);
+  std::vector<size_t> pos(offsets.begin(), offsets.end()-1);
+  for(size_t n=0; n<N; n++) order[pos[cells[n]]++] = n;
+}
+
+
+template<size_t D>
+size_t pic::Resampler<D>::merge(
+    pic::Tile<D>& tile, int ispcs, int target, int lap)
+{
+  auto& con = tile.get_container(ispcs);
+  if(target <= 0 || con.size() == 0) return 0;
+
+  // every merged bin leaves two particles
+  target = std::max(target, 2);
+
+  const bool photons = con.m == 0.0;
+  toolbox::CounterRNG rng(seed, ((uint64_t)tile.cid << 16) + (uint64_t)ispcs);
+  const uint32_t blk = 2*(uint32_t)lap;
+
+  std::vector<size_t> offsets, order;
+  bin_cells(tile, ispcs, offsets, order);
+
+  con.to_other_tiles.clear(); // used as the deletion list
+
+  auto uabs = [&](size_t n) {
+    const float ux = con.vel(0,n), uy = con.vel(1,n), uz = con.vel(2,n);
+    return std::sqrt(ux*ux + uy*uy + uz*uz);
+  };
+
+  // replace particles grp by two with the same weight, momentum and energy
+  auto merge_group = [&](const size_t* grp, size_t g)
+  {
+    double W = 0.0, E = 0.0, P[3] = {0,0,0}, X[3] = {0,0,0};
+    for(size_t m=0; m<g; m++) {
+      const size_t n = grp[m];
+      const double w = con.wgt(n);
+      const double u = uabs(n);
+      W += w;
+      E += w*(photons ? u : std::sqrt(1.0 + u*u));
+      for(int i=0; i<3; i++) {
+        P[i] += w*con.vel(i,n);
+        X[i] += w*con.loc(i,n);
+      }
+    }
+
+    for(size_t m=2; m<g; m++) {
+      con.to_other_tiles.push_back( {1,1,1,grp[m]} );
+      con.wgt(grp[m]) = 0.0f;
+    }
+    if(W <= 0.0) return;
+
+    const double eps = E/W;
+    const double pa  = photons ? eps : std::sqrt(std::max(eps*eps - 1.0, 0.0));
+    const double Pn  = std::sqrt(P[0]*P[0] + P[1]*P[1] + P[2]*P[2]);
+
+    const double cost = pa > 0.0 ? std::min(Pn/(W*pa), 1.0) : 1.0;
+    const double sint = std::sqrt(1.0 - cost*cost);
+
+    double e1[3] = {0.0, 0.0, 1.0};
+    if(Pn > 0.0) for(int i=0; i<3; i++) e1[i] = P[i]/Pn;
+
+    // plane of the two particles has a random orientation around P
+    auto r = rng.uniform4(grp[0], blk);
+    const double ct = 2.0*r[0] - 1.0, st = std::sqrt(std::max(1.0 - ct*ct, 0.0));
+    double e2[3] = {st*std::cos(2.0*PI*r[1]), st*std::sin(2.0*PI*r[1]), ct};
+    double d = e2[0]*e1[0] + e2[1]*e1[1] + e2[2]*e1[2];
+    for(int i=0; i<3; i++) e2[i] -= d*e1[i];
+    double e2n = std::sqrt(e2[0]*e2[0] + e2[1]*e2[1] + e2[2]*e2[2]);
+    if(e2n < 1e-6) { // random vector was parallel to P; take any normal
+      e2[0] = -e1[1]; e2[1] = e1[0]; e2[2] = 0.0;
+      if(std::abs(e1[2]) > 0.9) { e2[0] = 0.0; e2[1] = -e1[2]; e2[2] = e1[1]; }
+      e2n = std::sqrt(e2[0]*e2[0] + e2[1]*e2[1] + e2[2]*e2[2]);
+    }
+    for(int i=0; i<3; i++) e2[i] /= e2n;
+
+    for(int s=0; s<2; s++) {
+      const size_t n = grp[s];
+      const double sgn = s == 0 ? 1.0 : -1.0;
+      for(int i=0; i<3; i++) {
+        con.vel(i,n) = (float)(pa*(cost*e1[i] + sgn*sint*e2[i]));
+        con.loc(i,n) = (float)(X[i]/W);
+      }
+      con.wgt(n) = (float)(0.5*W);
+    }
+  };
+
+  std::vector<size_t> alive, next;
+  std::vector<std::pair<int, size_t>> keys; // (momentum bin, particle)
+  std::vector<size_t> grp;
+
+  for(size_t c=0; c+1<offsets.size(); c++) {
+    if(offsets[c+1] - offsets[c] <= (size_t)target) continue;
+    alive.assign(order.begin() + offsets[c], order.begin() + offsets[c+1]);
+
+    for(int pass=0; pass<16 && alive.size() > (size_t)target; pass++) {
+      const int ne = std::max(1, n_ene   >> pass);
+      const int nt = std::max(1, n_theta >> pass);
+      const int np = std::max(1, n_phi   >> pass);
+
+      float lmin = INF, lmax = -INF;
+      for(auto n : alive) {
+        const float l = std::log(uabs(n) + EPS);
+        lmin = std::min(lmin, l);
+        lmax = std::max(lmax, l);
+      }
+      const float dl = lmax > lmin ? (lmax - lmin) : 1.0f;
+
+      keys.clear();
+      for(auto n : alive) {
+        const float u  = uabs(n) + EPS;
+        const float ct = con.vel(2,n)/u;
+        const float ph = std::atan2(con.vel(1,n), con.vel(0,n));
+
+        const int ie = std::min((int)(ne*(std::log(u) - lmin)/dl), ne-1);
+        const int it = std::min(std::max((int)(nt*0.5f*(ct + 1.0f)), 0), nt-1);
+        const int ip = std::min(std::max((int)(np*(ph + PI)/(2.0*PI)), 0), np-1);
+        keys.push_back({ie + ne*(it + nt*ip), n});
+      }
+      std::sort(keys.begin(), keys.end());
+
+      size_t excess = alive.size() - target;
+      next.clear();
+      for(size_t g0=0; g0<keys.size(); ) {
+        size_t g1 = g0;
+        while(g1 < keys.size() && keys[g1].first == keys[g0].first) g1++;
+
+        // merge only as many as needed to reach the target
+        const size_t gm = excess > 0 && g1 - g0 >= 3 ? std::min(g1 - g0, excess + 2) : 0;
+        if(gm >= 3) {
+          grp.clear();
+          for(size_t m=g0; m<g0+gm; m++) grp.push_back(keys[m].second);
+          merge_group(grp.data(), gm);
+          excess -= gm - 2;
+          next.push_back(grp[0]);
+          next.push_back(grp[1]);
+          for(size_t m=g0+gm; m<g1; m++) next.push_back(keys[m].second);
+        } else {
+          for(size_t m=g0; m<g1; m++) next.push_back(keys[m].second);
+        }
+        g0 = g1;
+      }
+      alive.swap(next);
+
+      if(ne == 1 && nt == 1 && np == 1) break;
+    }
+  }
+
+  const size_t removed = con.to_other_tiles.size();
+  con.delete_transferred_particles();
+  con.to_other_tiles.clear();
+
+  return removed;
+}
+
+
+template<size_t D>
+size_t pic::Resampler<D>::split(
+    pic::Tile<D>& tile, int ispcs, int target, int lap)
+{
+  auto& con = tile.get_container(ispcs);
+  if(target <= 0 || con.size() == 0) return 0;
+
+  toolbox::CounterRNG rng(seed, ((uint64_t)tile.cid << 16) + (uint64_t)ispcs);
+  const uint32_t blk = 2*(uint32_t)lap + 1;
+
+  std::vector<size_t> offsets, order;
+  bin_cells(tile, ispcs, offsets, order);
+
+  std::vector<float> x, y, z, ux, uy, uz, w;
+  std::vector<size_t> cell;
+
+  for(size_t c=0; c+1<offsets.size(); c++) {
+    const size_t cnt = offsets[c+1] - offsets[c];
+    if(cnt == 0 || cnt >= (size_t)target) continue;
+
+    // heaviest first
+    cell.assign(order.begin() + offsets[c], order.begin() + offsets[c+1]);
+    std::stable_sort(cell.begin(), cell.end(),
+        [&](size_t a, size_t b){ return con.wgt(a) > con.wgt(b); });
+
+    const size_t need = std::min(target - cnt, cnt);
+    for(size_t m=0; m<need; m++) {
+      const size_t n = cell[m];
+      auto r = rng.uniform4(n, blk);
+
+      // random direction in the active dimensions
+      float dir[3] = {0.0f, 0.0f, 0.0f};
+      if(D == 1) {
+        dir[0] = r[0] < 0.5f ? -1.0f : 1.0f;
+      } else if(D == 2) {
+        dir[0] = std::cos(2.0f*PI*r[0]);
+        dir[1] = std::sin(2.0f*PI*r[0]);
+      } else {
+        const float ct = 2.0f*r[0] - 1.0f, st = std::sqrt(std::max(1.0f - ct*ct, 0.0f));
+        dir[0] = st*std::cos(2.0f*PI*r[1]);
+        dir[1] = st*std::sin(2.0f*PI*r[1]);
+        dir[2] = ct;
+      }
+
+      // both halves have to stay inside the tile
+      float d = split_jitter*r[2];
+      for(size_t i=0; i<D; i++) {
+        if(std::abs(dir[i]) < EPS) continue;
+        const float xi = con.loc(i,n);
+        const float room = std::min(xi - (float)tile.mins[i], (float)tile.maxs[i] - xi - EPS);
+        d = std::min(d, std::max(room, 0.0f)/std::abs(dir[i]));
+      }
+
+      // rounding at the tile edge; split in place
+      for(size_t i=0; i<D; i++) {
+        const float xa = con.loc(i,n) + d*dir[i], xb = con.loc(i,n) - d*dir[i];
+        if(std::min(xa, xb) < tile.mins[i] || std::max(xa, xb) >= tile.maxs[i]) d = 0.0f;
+      }
+
+      const float wh = 0.5f*con.wgt(n);
+      con.wgt(n) = wh;
+
+      x.push_back(con.loc(0,n) - d*dir[0]);
+      y.push_back(con.loc(1,n) - d*dir[1]);
+      z.push_back(con.loc(2,n) - d*dir[2]);
+      for(int i=0; i<3; i++) con.loc(i,n) += d*dir[i];
+
+      ux.push_back(con.vel(0,n));
+      uy.push_back(con.vel(1,n));
+      uz.push_back(con.vel(2,n));
+      w.push_back(wh);
+    }
+  }
+
+  const size_t added = x.size();
+  if(added > 0) {
+    con.add_particles_bulk(added,
+        x.data(), y.data(), z.data(),
+        ux.data(), uy.data(), uz.data(),
+        w.data());
+  }
+
+  return added;
+}
+
+
+template<size_t D>
+void pic::Resampler<D>::solve(
+    pic::Tile<D>& tile, int lap)
+{
+  for(int ispcs=0; ispcs<tile.Nspecies(); ispcs++) {
+    if(ispcs < (int)max_ppc.size() && max_ppc[ispcs] > 0) merge(tile, ispcs, max_ppc[ispcs], lap);
+    if(ispcs < (int)min_ppc.size() && min_ppc[ispcs] > 0) split(tile, ispcs, min_ppc[ispcs], lap);
+  }
+}
+
+
+template<size_t D>
+void pic::Resampler<D>::solve(
+    corgi::Grid<D>& grid, int lap)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  auto cids = grid.get_local_tiles();
+  const int Ntiles = cids.size();
+
+  std::vector<pic::Tile<D>*> tiles;
+  for(auto cid : cids) tiles.push_back( &dynamic_cast<pic::Tile<D>&>(grid.get_tile(cid)) );
+
+  // tiles are independent; random streams are per tile
+  #pragma omp parallel for schedule(dynamic)
+  for(int t=0; t<Ntiles; t++) solve(*tiles[t], lap);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+template class pic::Resampler<1>;
+template class pic::Resampler<2>;
+template class pic::Resampler<3>;
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "external/corgi/corgi.h"
+#include "core/pic/tile.h"
+
+
+namespace pic {
+
+
+/*! \brief Particle merging and splitting to keep per-cell counts in a range
+ *
+ * Merging (Vranic et al. 2015, CPC 191): particles of a cell are binned in
+ * momentum space (log |u|, polar and azimuthal angle) and every bin with
+ * more than two particles is replaced by two particles of half the total
+ * weight that have the total energy and momentum of the bin. They are
+ * placed at the weight center of the bin. If the cell is still above the
+ * target, bins are coarsened by 2 and the merge is repeated.
+ *
+ * Splitting: the heaviest particles of under-resolved cells are split into
+ * two halves displaced symmetrically from the parent position by at most
+ * split_jitter cells. Weight, charge center, momentum and energy are
+ * conserved.
+ *
+ * Containers with m = 0 are treated as photons (energy |u|).
+ */
+template<size_t D>
+class Resampler
+{
+
+  public:
+
+  /// seed of the random streams (merge plane orientation and split offsets)
+  uint64_t seed = 0;
+
+  /// max particles per cell for each species; 0 (or missing) disables merging
+  std::vector<int> max_ppc;
+
+  /// min particles per cell for each species; 0 (or missing) disables splitting
+  std::vector<int> min_ppc;
+
+  /// momentum-space bins used for merging
+  int n_ene   = 8;
+  int n_theta = 4;
+  int n_phi   = 8;
+
+  /// max displacement of split particles in units of cells
+  float split_jitter = 0.25f;
+
+  /// merge particles of cells above max_ppc; returns number of removed particles
+  size_t merge(pic::Tile<D>& tile, int ispcs, int max_ppc, int lap = 0);
+
+  /// split particles of cells below min_ppc; returns number of added particles
+  //
+  // every particle is split at most once per call.
+  size_t split(pic::Tile<D>& tile, int ispcs, int min_ppc, int lap = 0);
+
+  /// merge and split all species of the tile with the per-species targets
+  void solve(pic::Tile<D>& tile, int lap = 0);
+
+  /// solve all local tiles in parallel
+  void solve(corgi::Grid<D>& grid, int lap = 0);
+
+  private:
+
+  /// particle indices of each cell (counting sort by cell)
+  void bin_cells(
+      pic::Tile<D>& tile, int ispcs,
+      std::vector<size_t>& offsets,
+      std::vector<size_t>& order);
+};
+
+
+} // end of namespace pic
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cmath>
+
+#include "definitions.h"
+
+// Velocity samplers of pytools/sampling.py as pure functions of the given
+// uniform random numbers (in (0,1]) so that they can be evaluated for whole
+// particle arrays in vectorized loops.
+
+namespace pic {
+namespace sampling {
+
+constexpr float twopi = 2.0f*(float)PI;
+
+
+/// Sobol method for Maxwell-Juttner 4-velocity |u|; returns false if rejected
+inline bool sobol_try(float theta, float x4, float x5, float x6, float x7, float& u)
+{
+  u       = -theta*std::log(x4*x5*x6);
+  float n = -theta*std::log(x4*x5*x6*x7);
+  return n*n - u*u >= 1.0f;
+}
+
+/// non-relativistic |u| used for theta <= 0.2 (BoxMuller_method)
+inline float box_muller(float theta, float r)
+{
+  const float vth = std::sqrt(2.0f*theta);
+  return std::sqrt(-2.0f*std::log(r))*vth;
+}
+
+/// isotropic 3D direction (velxyz)
+inline void iso3(float u, float x1, float x2, float& ux, float& uy, float& uz)
+{
+  const float s = 2.0f*u*std::sqrt(x1*(1.0f-x1));
+  ux = u*(2.0f*x1 - 1.0f);
+  uy = s*std::cos(twopi*x2);
+  uz = s*std::sin(twopi*x2);
+}
+
+/// isotropic direction in the xy plane (velxy)
+inline void iso2(float u, float x2, float& ux, float& uy, float& uz)
+{
+  ux = u*std::cos(twopi*x2);
+  uy = u*std::sin(twopi*x2);
+  uz = 0.0f;
+}
+
+/// Lorentz boost along x of an isotropic sample (Zenitani 2015)
+//
+// gam is the bulk Lorentz factor or, if < 1, the bulk velocity beta;
+// gam = 0 means no boost. x8 flips the sample to get the correct flux.
+inline void boost_x(float gam, float x8, float& ux, float uy, float uz)
+{
+  if(gam == 0.0f) return;
+
+  float beta, Gamma;
+  if(gam < 1.0f) {
+    beta  = gam;
+    Gamma = 1.0f/std::sqrt(1.0f - beta*beta);
+  } else {
+    Gamma = gam;
+    beta  = std::sqrt(1.0f - 1.0f/(Gamma*Gamma));
+  }
+
+  const float g = std::sqrt(1.0f + ux*ux + uy*uy + uz*uz);
+  if(-beta*ux/g > x8) ux = -ux;
+  ux = Gamma*(ux + beta*g);
+}
+
+/// rotate x-boosted sample into direction -1/+1 for -/+x; -2/+2 for -/+y; -3/+3 for -/+z
+inline void rotate(int direction, float& ux, float& uy, float& uz)
+{
+  float tmp;
+  switch(direction) {
+    case -1: ux = -ux; break;
+    case -2: tmp = -ux; ux = uy; uy = tmp; break;
+    case +2: tmp = +ux; ux = uy; uy = tmp; break;
+    case -3: tmp = -ux; ux = uz; uz = tmp; break;
+    case +3: tmp = +ux; ux = uz; uz = tmp; break;
+    default: break;
+  }
+}
+
+/// photon energy from blackbody of temperature theta (draw_bbody)
+inline float blackbody(float theta, float xi1, float xi2, float xi3, float xi4)
+{
+  double xi = 1.0;
+  if(1.202*xi1 >= 1.0) {
+    double jj = 1.0, fsum = 1.0;
+
+    // partial sums of zeta(3); bounded since 1.202 < zeta(3)
+    while(1.202*xi1 > fsum + 1.0/((jj+1.0)*(jj+1.0)*(jj+1.0)) && jj < 1000.0) {
+      jj += 1.0;
+      fsum += 1.0/(jj*jj*jj);
+    }
+    xi = jj + 1.0;
+  }
+  return -theta*std::log(xi2*xi3*xi4)/(float)xi;
+}
+
+
+} // end of namespace sampling
+} // end of namespace pic
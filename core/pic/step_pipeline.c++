@@ -0,0 +1,461 @@
+#include <iostream>
+#include <cassert>
+#include <unordered_set>
+#include <chrono>
+
+#include "core/pic/step_pipeline.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+template<size_t D>
+bool pic::StepPipeline<D>::add_stage(
+    const std::string& name,
+    const std::string& solver,
+    const std::string& method,
+    const std::string& nhood,
+    std::vector<int> args)
+{
+  Stage st;
+  st.name = name;
+  st.args = args;
+
+  //--------------------------------------------------
+  // neighborhood
+  if(      nhood == "all"      ) st.nhood = Nhood::all;
+  else if( nhood == "local"    ) st.nhood = Nhood::local;
+  else if( nhood == "virtual"  ) st.nhood = Nhood::virt;
+  else if( nhood == "boundary" ) st.nhood = Nhood::boundary;
+  else if( nhood == "interior" ) st.nhood = Nhood::interior;
+  else {
+    std::cerr << "StepPipeline: unknown nhood " << nhood << " in stage " << name << std::endl;
+    return false;
+  }
+
+  bool ok = true;
+
+  //--------------------------------------------------
+  // tile methods
+  if(solver == "tile") {
+    st.solver = StageSolver::tile;
+
+    if(      method == "update_boundaries"           ) st.op = StageOp::update_boundaries;
+    else if( method == "exchange_currents"           ) st.op = StageOp::exchange_currents;
+    else if( method == "clear_current"               ) st.op = StageOp::clear_current;
+    else if( method == "deposit_current"             ) st.op = StageOp::deposit_current;
+    else if( method == "check_outgoing_particles"    ) st.op = StageOp::check_outgoing_particles;
+    else if( method == "get_incoming_particles"      ) st.op = StageOp::get_incoming_particles;
+    else if( method == "delete_transferred_particles") st.op = StageOp::delete_transferred_particles;
+    else if( method == "pack_outgoing_particles"     ) st.op = StageOp::pack_outgoing_particles;
+    else if( method == "pack_all_particles"          ) st.op = StageOp::pack_all_particles;
+    else if( method == "unpack_incoming_particles"   ) st.op = StageOp::unpack_incoming_particles;
+    else if( method == "delete_all_particles"        ) st.op = StageOp::delete_all_particles;
+    else if( method == "shrink_to_fit_all_particles" ) st.op = StageOp::shrink_to_fit_all_particles;
+    else if( method == "sort_particles"              ) st.op = StageOp::sort_particles;
+    else ok = false;
+
+    // default update_boundaries components as in emf::Tile
+    if(st.op == StageOp::update_boundaries && st.args.empty()) st.args = {0,1,2};
+
+  //--------------------------------------------------
+  // mpi communication; same mode numbering as in Scheduler
+  } else if(solver == "mpi" || solver == "mpi_post" || solver == "mpi_wait") {
+    if(solver == "mpi"     ) st.solver = StageSolver::mpi;
+    if(solver == "mpi_post") st.solver = StageSolver::mpi_post;
+    if(solver == "mpi_wait") st.solver = StageSolver::mpi_wait;
+    st.op = StageOp::mpi;
+
+    if(      method == "j" ) st.args = {0};
+    else if( method == "e" ) st.args = {1};
+    else if( method == "b" ) st.args = {2};
+    else if( method == "p1") st.args = {3};
+    else if( method == "p2") st.args = {4};
+    else ok = false;
+
+  //--------------------------------------------------
+  // field propagators
+  } else if(solver == "fldpropE" || solver == "fldpropB") {
+    st.solver = solver == "fldpropE" ? StageSolver::fldpropE : StageSolver::fldpropB;
+
+    if(      method == "push_e"      ) st.op = StageOp::push_e;
+    else if( method == "push_half_b" ) st.op = StageOp::push_half_b;
+    else ok = false;
+
+  //--------------------------------------------------
+  // solvers with a single solve(tile) method
+  } else if(solver == "pusher" || solver == "fintp" || solver == "currint" || solver == "flt" || solver == "fused") {
+    if(solver == "pusher" ) st.solver = StageSolver::pusher;
+    if(solver == "fintp"  ) st.solver = StageSolver::fintp;
+    if(solver == "currint") st.solver = StageSolver::currint;
+    if(solver == "flt"    ) st.solver = StageSolver::flt;
+    if(solver == "fused"  ) st.solver = StageSolver::fused;
+
+    st.op = StageOp::solve;
+    if(method != "solve") ok = false;
+
+  } else {
+    ok = false;
+  }
+
+  if(!ok) {
+    std::cerr << "StepPipeline: unknown solver/method "
+              << solver << "/" << method << " in stage " << name << std::endl;
+    return false;
+  }
+
+  st.counter = counters.add_counter(name);
+
+  stages.push_back(st);
+  return true;
+}
+
+
+template<size_t D>
+void pic::StepPipeline<D>::update_tile_lists(corgi::Grid<D>& grid)
+{
+  auto fill = [&](std::vector<pic::Tile<D>*>& arr, const std::vector<uint64_t>& cids)
+  {
+    arr.clear();
+    arr.reserve(cids.size());
+    for(auto cid : cids) {
+      arr.push_back( &dynamic_cast<pic::Tile<D>&>(grid.get_tile(cid)) );
+    }
+  };
+
+  fill(tiles_all,      grid.get_tile_ids()      );
+  fill(tiles_local,    grid.get_local_tiles()   );
+  fill(tiles_virtual,  grid.get_virtual_tiles() );
+  fill(tiles_boundary, grid.get_boundary_tiles());
+
+  // interior = local - boundary
+  std::unordered_set<pic::Tile<D>*> bset(tiles_boundary.begin(), tiles_boundary.end());
+  tiles_interior.clear();
+  for(auto* tile : tiles_local) {
+    if(bset.count(tile) == 0) tiles_interior.push_back(tile);
+  }
+}
+
+
+template<size_t D>
+std::vector<pic::Tile<D>*>& pic::StepPipeline<D>::get_tiles(Nhood nhood)
+{
+  switch(nhood) {
+    case Nhood::local:    return tiles_local;
+    case Nhood::virt:     return tiles_virtual;
+    case Nhood::boundary: return tiles_boundary;
+    case Nhood::interior: return tiles_interior;
+    default:              return tiles_all;
+  }
+}
+
+
+/// number of particles in tile; all containers or only species ispc
+template<size_t D>
+static inline uint64_t num_prtcls(pic::Tile<D>& tile, int ispc=-1)
+{
+  if(ispc >= 0) return tile.containers[ispc].size();
+
+  uint64_t n = 0;
+  for(auto&& con : tile.containers) n += con.size();
+  return n;
+}
+
+
+/// processed items (particles or cells) and nominal memory traffic of a stage in one tile
+//
+// bytes count the particle/field arrays streamed once per item; 
+// mesh reads of particle stages are assumed to hit the cache.
+template<size_t D>
+static inline void stage_work(
+    const pic::Stage& st, 
+    pic::Tile<D>& tile, 
+    uint64_t& items, 
+    uint64_t& bytes)
+{
+  using pic::StageSolver;
+  using pic::StageOp;
+
+  auto& gs = tile.get_grids();
+  const uint64_t ncells = gs.ex.Nx*gs.ex.Ny*gs.ex.Nz;
+  constexpr uint64_t f = sizeof(float);
+
+  items = 0;
+  bytes = 0;
+
+  switch(st.solver) {
+    case StageSolver::pusher:
+      items = num_prtcls(tile, st.args.empty() ? -1 : st.args[0]);
+      bytes = items*18*f; // loc, vel read+write; E, B read
+      break;
+    case StageSolver::fintp:
+      items = num_prtcls(tile);
+      bytes = items*9*f;  // loc read; E, B write
+      break;
+    case StageSolver::currint:
+      items = num_prtcls(tile);
+      bytes = items*6*f;  // loc, vel read
+      break;
+    case StageSolver::fused:
+      items = num_prtcls(tile);
+      bytes = items*12*f; // loc, vel read+write
+      break;
+    case StageSolver::fldpropE:
+    case StageSolver::fldpropB:
+      items = ncells;
+      if(st.op == StageOp::push_e) bytes = items*12*f; // E read+write; B, J read
+      else                         bytes = items*9*f;  // B read+write; E read
+      break;
+    case StageSolver::flt:
+      items = ncells;
+      bytes = items*6*f; // J read+write
+      break;
+    case StageSolver::tile:
+      switch(st.op) {
+        case StageOp::clear_current: 
+          items = ncells;
+          bytes = items*3*f;
+          break;
+        case StageOp::deposit_current: 
+          items = ncells;
+          bytes = items*9*f; // J read; E read+write
+          break;
+        case StageOp::update_boundaries:
+        case StageOp::exchange_currents:
+          items = ncells;
+          break;
+        default:
+          items = num_prtcls(tile);
+          break;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+
+/// stages that read or write data of neighboring tiles
+static inline bool is_halo_stage(const pic::Stage& st)
+{
+  if(st.solver != pic::StageSolver::tile) return false;
+
+  return st.op == pic::StageOp::update_boundaries ||
+         st.op == pic::StageOp::exchange_currents ||
+         st.op == pic::StageOp::get_incoming_particles;
+}
+
+
+template<size_t D>
+void pic::StepPipeline<D>::apply(
+    const Stage& st, 
+    pic::Tile<D>& tile, 
+    corgi::Grid<D>& grid)
+{
+  // particle solvers are timed per tile; used as tile cost by the load balancer
+  const bool timed = 
+    st.solver == StageSolver::pusher || st.solver == StageSolver::fintp || 
+    st.solver == StageSolver::currint || st.solver == StageSolver::fused;
+
+  std::chrono::steady_clock::time_point t0;
+  if(timed) t0 = std::chrono::steady_clock::now();
+
+  switch(st.solver) {
+
+    case StageSolver::tile:
+      switch(st.op) {
+        case StageOp::update_boundaries:            tile.update_boundaries(grid, st.args); break;
+        case StageOp::exchange_currents:            tile.exchange_currents(grid);          break;
+        case StageOp::clear_current:                tile.clear_current();                  break;
+        case StageOp::deposit_current:              tile.deposit_current();                break;
+        case StageOp::check_outgoing_particles:     tile.check_outgoing_particles();       break;
+        case StageOp::get_incoming_particles:       tile.get_incoming_particles(grid);     break;
+        case StageOp::delete_transferred_particles: tile.delete_transferred_particles();   break;
+        case StageOp::pack_outgoing_particles:      tile.pack_outgoing_particles();        break;
+        case StageOp::pack_all_particles:           tile.pack_all_particles();             break;
+        case StageOp::unpack_incoming_particles:    tile.unpack_incoming_particles();      break;
+        case StageOp::delete_all_particles:         tile.delete_all_particles();           break;
+        case StageOp::shrink_to_fit_all_particles:  tile.shrink_to_fit_all_particles();    break;
+        case StageOp::sort_particles:               tile.sort_particles();                 break;
+        default: break;
+      }
+      break;
+
+    case StageSolver::fldpropE:
+    case StageSolver::fldpropB: {
+      auto* prop = st.solver == StageSolver::fldpropE ? fldpropE : fldpropB;
+      assert(prop != nullptr);
+      if(st.op == StageOp::push_e) prop->push_e(tile);
+      else                         prop->push_half_b(tile);
+      break;
+    }
+
+    case StageSolver::pusher:
+      assert(pusher != nullptr);
+      if(st.args.empty()) pusher->solve(tile);
+      else                pusher->solve(tile, st.args[0]);
+      break;
+
+    case StageSolver::fintp:
+      assert(fintp != nullptr);
+      fintp->solve(tile);
+      break;
+
+    case StageSolver::currint:
+      assert(currint != nullptr);
+      currint->solve(tile);
+      break;
+
+    case StageSolver::flt:
+      assert(flt != nullptr);
+      flt->solve(tile);
+      break;
+
+    case StageSolver::fused:
+      assert(fused != nullptr);
+      fused->solve(tile);
+      break;
+
+    default:
+      break;
+  }
+
+  if(timed) tile.cost += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+
+template<size_t D>
+void pic::StepPipeline<D>::run_stage(corgi::Grid<D>& grid, size_t i)
+{
+  assert(i < stages.size());
+  const Stage& st = stages[i];
+
+#ifdef GPU
+  nvtxRangePush(st.name.c_str());
+#endif
+
+  // mpi communication is done once per grid, not per tile
+  if(st.op == StageOp::mpi) {
+    const int mode = st.args[0];
+    counters.start(st.counter);
+
+    if(exchanger != nullptr) {
+      if(st.solver != StageSolver::mpi_wait) {
+        exchanger->send_data(grid, mode);
+        exchanger->recv_data(grid, mode);
+      }
+      if(st.solver != StageSolver::mpi_post) {
+        exchanger->wait_data(grid, mode);
+      }
+    } else {
+      if(st.solver != StageSolver::mpi_wait) {
+        grid.send_data(mode);
+        grid.recv_data(mode);
+      }
+      if(st.solver != StageSolver::mpi_post) {
+        grid.wait_data(mode);
+      }
+    }
+    counters.stop(st.counter);
+  } else {
+    uint64_t items = 0, bytes = 0;
+    counters.start(st.counter);
+    for(auto* tile : get_tiles(st.nhood)) {
+      uint64_t n, b;
+      stage_work(st, *tile, n, b);
+      items += n;
+      bytes += b;
+      apply(st, *tile, grid);
+    }
+    counters.stop(st.counter, items, bytes);
+  }
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+template<size_t D>
+void pic::StepPipeline<D>::run(corgi::Grid<D>& grid)
+{
+  if(threaded) {
+    run_tasks(grid);
+    return;
+  }
+
+  update_tile_lists(grid);
+  for(size_t i=0; i<stages.size(); i++) run_stage(grid, i);
+}
+
+
+template<size_t D>
+void pic::StepPipeline<D>::run_tasks(corgi::Grid<D>& grid)
+{
+  update_tile_lists(grid);
+
+#ifdef _OPENMP
+  counters.reserve_threads(omp_get_max_threads());
+#endif
+
+  const size_t Nstages = stages.size();
+  size_t i0 = 0;
+
+  while(i0 < Nstages) {
+
+    // mpi is called outside of the parallel region by the master thread
+    if(stages[i0].op == StageOp::mpi) {
+      run_stage(grid, i0);
+      i0++;
+      continue;
+    }
+
+    // segment of stages until next mpi call
+    size_t i1 = i0;
+    while(i1 < Nstages && stages[i1].op != StageOp::mpi) i1++;
+
+    #pragma omp parallel
+    {
+      #pragma omp single
+      {
+        for(size_t i=i0; i<i1; i++) {
+          const bool halo = is_halo_stage(stages[i]);
+
+          // neighbors need to be up-to-date before halo stage starts
+          if(halo) {
+            #pragma omp taskwait
+          }
+
+          // tasks of the same tile are serialized via the tile id
+          for(auto* tile : get_tiles(stages[i].nhood)) {
+            #pragma omp task firstprivate(tile, i) depend(inout: tile->cid)
+            {
+              uint64_t items, bytes;
+              stage_work(stages[i], *tile, items, bytes);
+
+              counters.start(stages[i].counter);
+              apply(stages[i], *tile, grid);
+              counters.stop(stages[i].counter, items, bytes);
+            }
+          }
+
+          // neighbors can not be modified before halo stage is done
+          if(halo) {
+            #pragma omp taskwait
+          }
+        }
+      }// end of omp single
+    }// end of omp parallel
+
+    i0 = i1;
+  }
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+
+template class pic::StepPipeline<1>;
+template class pic::StepPipeline<2>;
+template class pic::StepPipeline<3>;
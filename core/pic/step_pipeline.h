@@ -0,0 +1,157 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "definitions.h"
+#include "external/corgi/corgi.h"
+#include "core/emf/propagators/propagator.h"
+#include "core/emf/filters/filter.h"
+#include "core/pic/tile.h"
+#include "core/pic/pushers/pusher.h"
+#include "core/pic/interpolators/interpolator.h"
+#include "core/pic/depositers/depositer.h"
+#include "core/pic/fused/fused.h"
+#include "core/pic/rank_exchange.h"
+#include "tools/perf_counters.h"
+
+
+namespace pic {
+
+/// Tile neighborhood that a pipeline stage operates on
+//
+// interior tiles are the local tiles that are not boundary tiles;
+// they do not depend on data of virtual tiles.
+enum class Nhood { all, local, virt, boundary, interior };
+
+/// Solver that a pipeline stage is dispatched to
+//
+// mpi_post only posts the non-blocking sends and receives and
+// mpi_wait completes them; stages in between overlap with the communication.
+enum class StageSolver { tile, mpi, mpi_post, mpi_wait, fldpropE, fldpropB, pusher, fintp, currint, flt, fused };
+
+/// Tile method or solver call that a pipeline stage executes
+enum class StageOp {
+  update_boundaries,
+  exchange_currents,
+  clear_current,
+  deposit_current,
+  check_outgoing_particles,
+  get_incoming_particles,
+  delete_transferred_particles,
+  pack_outgoing_particles,
+  pack_all_particles,
+  unpack_incoming_particles,
+  delete_all_particles,
+  shrink_to_fit_all_particles,
+  sort_particles,
+  push_e,
+  push_half_b,
+  solve,
+  mpi,
+};
+
+
+/// Single declarative step of the time-step pipeline
+//
+// Mirrors the op dictionaries of pytools.Scheduler.operate;
+// strings are parsed once into op codes when the stage is added.
+struct Stage
+{
+  std::string name;
+
+  Nhood nhood = Nhood::all;
+  StageSolver solver = StageSolver::tile;
+  StageOp op = StageOp::solve;
+
+  /// integer arguments (update_boundaries components, pusher species, mpi mode)
+  std::vector<int> args;
+
+  /// id in StepPipeline::counters; stages with the same name share the counter
+  int counter = -1;
+};
+
+
+/*! \brief Native PIC time-step driver
+ *
+ * Runs a list of declarative stages (the same ones that a
+ * Python lap passes to Scheduler.operate) over local, virtual and
+ * boundary tiles without crossing back to Python for every tile.
+ *
+ * Solvers are owned by the caller; pipeline only stores pointers.
+ *
+ * With threaded=true the per-tile stages are run as OpenMP tasks that
+ * depend only on earlier stages of the same tile. Stages that touch
+ * neighboring tiles (update_boundaries, exchange_currents,
+ * get_incoming_particles) wait for all earlier tasks and finish before
+ * later tasks start. MPI stages are run by the master thread between
+ * parallel regions.
+ *
+ * Split-phase communication: a lap can post the messages with an
+ * mpi_post stage, work on interior tiles, and call mpi_wait only before
+ * the boundary tiles that need the halo data.
+ */
+template<size_t D>
+class StepPipeline
+{
+  public:
+
+  emf::Propagator<D>* fldpropE = nullptr;
+  emf::Propagator<D>* fldpropB = nullptr;
+  Pusher<D,3>* pusher          = nullptr;
+  Interpolator<D,3>* fintp     = nullptr;
+  Depositer<D,3>* currint      = nullptr;
+  emf::Filter<D>* flt          = nullptr;
+  FusedSolver<D>* fused        = nullptr;
+
+  /// optional rank-aggregated communication; per-tile grid messages are used if not set
+  RankExchanger<D>* exchanger  = nullptr;
+
+  /// ordered list of stages executed by run()
+  std::vector<Stage> stages;
+
+  /// run tiles concurrently as OpenMP tasks
+  bool threaded = false;
+
+  /// per-stage time, calls, and processed particles/cells and nominal bytes;
+  //  serial stages are timed as a whole, threaded stages per tile task
+  toolbox::PerfCounters counters;
+
+  StepPipeline() = default;
+
+  /// parse and append stage; returns false if the combination is not known
+  bool add_stage(
+      const std::string& name,
+      const std::string& solver,
+      const std::string& method,
+      const std::string& nhood,
+      std::vector<int> args);
+
+  /// remove all stages
+  void clear() { stages.clear(); }
+
+  /// cache tile pointers of each neighborhood; needs to be called after tile ownership changes
+  void update_tile_lists(corgi::Grid<D>& grid);
+
+  /// execute i:th stage
+  void run_stage(corgi::Grid<D>& grid, size_t i);
+
+  /// execute all stages in order
+  void run(corgi::Grid<D>& grid);
+
+  /// execute all stages as dependent OpenMP tasks
+  void run_tasks(corgi::Grid<D>& grid);
+
+  private:
+
+  /// apply non-mpi stage to one tile
+  void apply(const Stage& st, pic::Tile<D>& tile, corgi::Grid<D>& grid);
+
+  std::vector<pic::Tile<D>*> tiles_all, tiles_local, tiles_virtual, tiles_boundary, tiles_interior;
+
+  std::vector<pic::Tile<D>*>& get_tiles(Nhood nhood);
+
+};
+
+
+} // end of namespace pic
@@ -58,6 +58,20 @@ void Tile<D>::delete_transferred_particles()
     container.delete_transferred_particles();
 }
 
+template<std::size_t D>
+void Tile<D>::sort_particles()
+{
+  std::array<double,3> 
+    tile_mins = {{0,0,0}},
+    tile_maxs = {{1,1,1}};
+
+  for(size_t i=0; i<D; i++) tile_mins[i] = corgi::Tile<D>::mins[i];
+  for(size_t i=0; i<D; i++) tile_maxs[i] = corgi::Tile<D>::maxs[i];
+
+  for(auto&& container : containers)
+    container.sort_in_cells(tile_mins, tile_maxs);
+}
+
 //--------------------------------------------------
 
 template<>
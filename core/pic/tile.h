@@ -43,6 +43,9 @@ public:
 
   std::vector<ParticleContainer<D> , ManagedAlloc<ParticleContainer<D> >> containers;
 
+  /// measured particle solver time (s) since the last load balancing
+  double cost = 0.0;
+
   //--------------------------------------------------
   // normal container methods
      
@@ -108,6 +111,9 @@ public:
   // the boundaries
   void delete_transferred_particles();
 
+  /// sort particles of each container by cell for cache-friendly mesh access
+  void sort_particles();
+
   /// get particles flowing into this tile
   void get_incoming_particles(corgi::Grid<D>& grid);
 
@@ -0,0 +1,144 @@
+#include <cassert>
+#include <unordered_set>
+
+#include "core/pic/tile_migration.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+template<size_t D>
+void pic::TileMigrator<D>::send_tile(
+    corgi::Grid<D>& grid, 
+    uint64_t cid, 
+    int dest)
+{
+  auto& tile = dynamic_cast<pic::Tile<D>&>(grid.get_tile(cid));
+  assert(tile.communication.local);
+
+  tile.pack_all_particles();
+
+  for(int mode=0; mode<4; mode++) {
+    for(auto& r : tile.send_data(grid.comm, dest, mode, tile.cid)) reqs.push_back(r);
+  }
+
+  // extra packet is empty if all particles fit to the first message
+  for(auto& r : tile.send_data(grid.comm, dest, 4, tile.cid)) reqs.push_back(r);
+
+  // tile is now a virtual copy of the new owner's tile
+  tile.communication.owner = dest;
+  tile.communication.local = false;
+
+  outgoing.push_back({&tile, dest});
+}
+
+
+template<size_t D>
+void pic::TileMigrator<D>::recv_tile(
+    corgi::Grid<D>& grid, 
+    uint64_t cid, 
+    int orig)
+{
+  auto& tile = dynamic_cast<pic::Tile<D>&>(grid.get_tile(cid));
+
+  // posted in the same mode order as in send_tile; particle and current 
+  // messages can share a tag and are then matched by MPI message ordering
+  for(int mode=0; mode<4; mode++) {
+    for(auto& r : tile.recv_data(grid.comm, orig, mode, tile.cid)) reqs.push_back(r);
+  }
+
+  incoming.push_back({&tile, orig});
+}
+
+
+template<size_t D>
+void pic::TileMigrator<D>::wait(corgi::Grid<D>& grid)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  // fields and first particle packets
+  mpi::wait_all(reqs.begin(), reqs.end());
+  reqs.clear();
+
+  // size of the extra packet is known only after the first packet has arrived
+  for(auto& [tile, orig] : incoming) {
+    for(auto& r : tile->recv_data(grid.comm, orig, 4, tile->cid)) reqs.push_back(r);
+  }
+  mpi::wait_all(reqs.begin(), reqs.end());
+  reqs.clear();
+
+  for(auto& [tile, orig] : incoming) tile->unpack_incoming_particles();
+
+  for(auto& [tile, dest] : outgoing) {
+    tile->delete_all_particles();
+    for(auto&& con : tile->containers) {
+      con.outgoing_particles.clear();
+      con.outgoing_extra_particles.clear();
+    }
+  }
+
+  incoming.clear();
+  outgoing.clear();
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+}
+
+
+template<size_t D>
+bool pic::TileMigrator<D>::remove_virtual_tile(corgi::Grid<D>& grid, uint64_t cid)
+{
+  auto it = grid.tiles.find(cid);
+  if(it == grid.tiles.end()) return false;
+
+  // only halo copies may be replaced; local tiles hold the data being migrated
+  assert(!it->second->communication.local);
+
+  grid.tiles.erase(it);
+  return true;
+}
+
+
+template<size_t D>
+size_t pic::TileMigrator<D>::remove_stale_tiles(corgi::Grid<D>& grid)
+{
+  // local tiles and their neighbors; the rest are left over from migration
+  std::unordered_set<uint64_t> keep;
+  for(auto cid : grid.get_local_tiles()) {
+    auto& tile = grid.get_tile(cid);
+    keep.insert(cid);
+
+    const int jr = D >= 2 ? 1 : 0;
+    const int kr = D >= 3 ? 1 : 0;
+    for(int in=-1;  in<=1;  in++) 
+    for(int jn=-jr; jn<=jr; jn++) 
+    for(int kn=-kr; kn<=kr; kn++) {
+      std::shared_ptr<corgi::Tile<D>> tpr;
+      if constexpr (D == 1) tpr = grid.get_tileptr( tile.neighs(in) );
+      if constexpr (D == 2) tpr = grid.get_tileptr( tile.neighs(in, jn) );
+      if constexpr (D == 3) tpr = grid.get_tileptr( tile.neighs(in, jn, kn) );
+      if(tpr) keep.insert(tpr->cid);
+    }
+  }
+
+  std::vector<uint64_t> stale;
+  for(auto cid : grid.get_tile_ids()) {
+    if(keep.count(cid) == 0) stale.push_back(cid);
+  }
+
+  for(auto cid : stale) grid.tiles.erase(cid);
+
+  return stale.size();
+}
+
+
+//--------------------------------------------------
+// explicit template instantiation
+
+template class pic::TileMigrator<1>;
+template class pic::TileMigrator<2>;
+template class pic::TileMigrator<3>;
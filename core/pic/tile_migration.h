@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <mpi4cpp/mpi.h>
+
+#include "definitions.h"
+#include "external/corgi/corgi.h"
+#include "core/pic/tile.h"
+
+
+namespace pic {
+
+using namespace mpi4cpp;
+
+/*! \brief Moves local tiles (fields and particles) between ranks
+ *
+ * Used by the dynamic load balancer. The sending rank calls send_tile
+ * for every tile that changes owner, the receiving rank removes its
+ * virtual copy of the tile (remove_virtual_tile), adds an empty,
+ * initialized tile with the same index to the grid, and calls recv_tile.
+ * wait() completes all messages and unpacks the particles.
+ *
+ * Data travels with the regular Tile::send_data/recv_data modes: the
+ * full padded j, e, b meshes (modes 0-2) and all particles packed with
+ * pack_all_particles (modes 3-4). The sent tile is marked virtual and
+ * its particles are deleted once the messages are done; it is removed
+ * from the grid by remove_stale_tiles if it is not a halo tile anymore.
+ *
+ * Messages use the per-tile tags of the halo exchange, so migration
+ * must not overlap with the lap communication.
+ */
+template<size_t D>
+class TileMigrator
+{
+  /// tiles being sent or received and their peer rank
+  std::vector<std::pair<pic::Tile<D>*, int>> outgoing, incoming;
+
+  std::vector<mpi::request> reqs;
+
+  public:
+
+  /// post sends of local tile cid to rank dest
+  void send_tile(corgi::Grid<D>& grid, uint64_t cid, int dest);
+
+  /// post receives of tile cid from rank orig
+  void recv_tile(corgi::Grid<D>& grid, uint64_t cid, int orig);
+
+  /// complete all posted transfers
+  void wait(corgi::Grid<D>& grid);
+
+  /// remove the virtual copy of tile cid before a local tile is added in its place; returns true if one existed
+  bool remove_virtual_tile(corgi::Grid<D>& grid, uint64_t cid);
+
+  /// remove non-local tiles that are not neighbors of local tiles; returns their number
+  //
+  // Sent tiles stay in the grid as virtual tiles. Call after
+  // analyze_boundaries to drop the ones no longer needed as halos.
+  size_t remove_stale_tiles(corgi::Grid<D>& grid);
+
+  /// number of tiles sent and received since last wait
+  size_t num_outgoing() const { return outgoing.size(); }
+  size_t num_incoming() const { return incoming.size(); }
+};
+
+} // end of namespace pic
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+#include "definitions.h"
+#include "core/pic/tile.h"
+#include "core/qed/species.h"
+
+
+namespace qed {
+
+
+// Spatial pairing cells of a tile for the binary interactions.
+//
+// The tile is divided into cubes of cbin^D grid cells. The containers are
+// reordered with a counting sort by pairing cell followed by a reverse energy
+// sort inside each cell, so that every pairing cell holds a contiguous,
+// energy-sorted range of particles (and eneArr is filled as in
+// sort_in_rev_energy). The pairing routines can then restrict the targets of
+// an incident to its own cell. Sorting the small cells separately is cheaper
+// than the tile-wide energy sort.
+template<size_t D>
+struct PairingCells
+{
+  int nc[3] = {1,1,1}; // number of pairing cells per dimension
+  size_t ncells = 0;   // total number of pairing cells; 0 if not built
+
+  // volume of each pairing cell relative to the tile; edge cells are smaller
+  // if cbin does not divide the tile
+  std::vector<float> vfrac;
+
+  // particles of species s in cell c are in [offs[s][c], offs[s][c+1])
+  std::array<std::vector<size_t>, n_species> offs;
+
+  size_t begin(int s, size_t c) const { return offs[s][c]; }
+  size_t end(  int s, size_t c) const { return offs[s][c+1]; }
+
+  void build(pic::Tile<D>& tile, const SpeciesRegistry<D>& cons, int cbin)
+  {
+    assert(cbin > 0);
+
+    // tile size in grid cells
+    int nl[3] = {1,1,1};
+    for(size_t i=0; i<D; i++) {
+      nl[i] = std::max(1, tile.mesh_lengths[i]);
+      nc[i] = (nl[i] + cbin - 1)/cbin;
+    }
+    ncells = size_t(nc[0])*nc[1]*nc[2];
+
+    auto width = [&](int i, int c) {
+      return static_cast<float>( std::min(cbin, nl[i] - c*cbin) )/nl[i];
+    };
+
+    vfrac.resize(ncells);
+    for(int k=0; k<nc[2]; k++)
+    for(int j=0; j<nc[1]; j++)
+    for(int i=0; i<nc[0]; i++) {
+      vfrac[i + nc[0]*(j + nc[1]*k)] = width(0,i)*( D>=2 ? width(1,j) : 1.0f )*( D>=3 ? width(2,k) : 1.0f );
+    }
+
+    //--------------------------------------------------
+    // counting sort of every QED container by cell; particles outside the tile are clamped to the edge cells
+    std::vector<size_t> cells, pos;
+    ManVec<size_t> indices;
+
+    for(int s=0; s<n_species; s++) {
+      auto& off = offs[s];
+      off.assign(ncells + 1, 0);
+
+      auto con = cons[s];
+      if(con == nullptr) continue;
+      const size_t N = con->size();
+
+      con->eneArr.resize(N);
+      cells.resize(N);
+      for(size_t n=0; n<N; n++) {
+        con->eneArr[n] = con->get_prtcl_ene(n);
+
+        int ijk[3] = {0,0,0};
+        for(size_t i=0; i<D; i++) {
+          int c = static_cast<int>( std::floor(con->loc(i,n) - tile.mins[i]) );
+          ijk[i] = std::min(std::max(c, 0), nl[i]-1)/cbin;
+        }
+        cells[n] = ijk[0] + nc[0]*( ijk[1] + nc[1]*ijk[2] );
+        off[cells[n] + 1]++;
+      }
+      for(size_t c=0; c<ncells; c++) off[c+1] += off[c];
+
+      if(N < 2) continue;
+
+      // indices[new location] = old location
+      pos.assign(off.begin(), off.end()-1);
+      indices.resize(N);
+      for(size_t n=0; n<N; n++) indices[ pos[cells[n]]++ ] = n;
+
+      // reverse energy order inside the cells
+      const auto& ene = con->eneArr;
+      for(size_t c=0; c<ncells; c++) {
+        std::sort(indices.data() + off[c], indices.data() + off[c+1],
+            [&](size_t a, size_t b) { return ene[a] > ene[b]; } );
+      }
+
+      con->apply_permutation(indices);
+    }
+  }
+};
+
+
+} // end of namespace qed
@@ -25,7 +25,47 @@ namespace qed {
   using toolbox::inv;
 
 
-tuple<float, float> Compton::get_minmax_ene( string /*t1*/, string /*t2*/, double /*ene*/)
+// Klein-Nishina cross section in units of sigma_T as a function of s = x*gam*(1 - beta mu)/2
+inline float klein_nishina(float s)
+{
+  //# Approximate Taylor expansion for Compton total 
+  // cross-section if xi<0.01, error about 5e-6
+  float s0 = 0.0; 
+  if(s < 0.01) {
+    s0 = 1.0 - 2.0*s + 5.2*s*s - 9.1*s*s*s;
+
+    //# higher-order terms, not needed if xi<0.01 
+    //# + 1144.0 * xi**4 / 35.0  - 544.0 * xi**5 / 7. 
+    //#+ 1892.0 * xi**6 / 21.0   
+  } else {
+    // Exact formula for Klein-Nishina cross section in units of sigma_T
+    s0 = (1.0/(s*s))*(4.0 + (s - 2.0 - 2.0/s)*log(1.0 + 2.0*s) + 2.0*s*s*(1.0 + s)/pow(1.0 + 2.0*s, 2) );
+    s0 *= 3.0/8.0;  //change from \sigma_0 to \sigma_T
+  }
+
+  return s0;
+}
+
+// pdf of the scattering angle variable v = ln(1 + x0(1-mu))/ln(1 + 2 x0) in the electron rest frame;
+// angle-dependent part of the KN differential cross section times |dmu/dv| (up to a constant)
+inline double compton_angle_pdf(double v, float x0f)
+{
+  double x0 = x0f;
+  double w  = v*std::log1p(2.0*x0);
+  double mu = 1.0 - std::expm1(w)/x0;
+  double r  = std::exp(-w); // x1/x0
+
+  return 0.5*r*r*(-1.0 + r + 1.0/r + mu*mu)*std::exp(w);
+}
+
+// map v back to the scattering angle cosine
+inline float compton_angle(float v, float x0)
+{
+  return 1.0f - std::expm1(v*std::log1p(2.0f*x0))/x0;
+}
+
+
+tuple<float, float> Compton::get_minmax_ene( int /*t1*/, int /*t2*/, double /*ene*/)
 {
   return {0.0f, INF};
 
@@ -43,15 +83,15 @@ tuple<float, float> Compton::get_minmax_ene( string /*t1*/, string /*t2*/, doubl
 }
 
 Compton::pair_float Compton::comp_cross_section(
-    string t1, float ux1, float uy1, float uz1,
-    string t2, float ux2, float uy2, float uz2)
+    int t1, float ux1, float uy1, float uz1,
+    int t2, float ux2, float uy2, float uz2)
 {
 
   Vec3<float> zv, xv;
-  if( (t1 == "e-" || t1 == "e+") && (t2 == "ph") ) {
+  if( is_lepton(t1) && (t2 == sp_ph) ) {
     zv.set(ux1, uy1, uz1); 
     xv.set(ux2, uy2, uz2); 
-  } else if( (t2 == "e-" || t2 == "e+") && (t1 == "ph") ) {
+  } else if( is_lepton(t2) && (t1 == sp_ph) ) {
     zv.set(ux2, uy2, uz2); 
     xv.set(ux1, uy1, uz1); 
   } else {
@@ -68,20 +108,8 @@ Compton::pair_float Compton::comp_cross_section(
   float s = 0.5*x*gam*(1.0 - beta0*mu); // relativistic invariant
 
 
-  //# Approximate Taylor expansion for Compton total 
-  // cross-section if xi<0.01, error about 5e-6
-  float s0 = 0.0; 
-  if(s < 0.01) {
-    s0 = 1.0 - 2.0*s + 5.2*s*s - 9.1*s*s*s;
-
-    //# higher-order terms, not needed if xi<0.01 
-    //# + 1144.0 * xi**4 / 35.0  - 544.0 * xi**5 / 7. 
-    //#+ 1892.0 * xi**6 / 21.0   
-  } else {
-    // Exact formula for Klein-Nishina cross section in units of sigma_T
-    s0 = (1.0/(s*s))*(4.0 + (s - 2.0 - 2.0/s)*log(1.0 + 2.0*s) + 2.0*s*s*(1.0 + s)/pow(1.0 + 2.0*s, 2) );
-    s0 *= 3.0/8.0;  //change from \sigma_0 to \sigma_T
-  }
+  // total cross section; tabulated only above the Taylor expansion region
+  float s0 = (use_tables && cs_table.inside(s)) ? cs_table(s) : klein_nishina(s);
 
   // compton scattering of two particles will have relative velocity:
   //# vrel = 1-zeta = 1 - \beta mu so that dP/dtau ~ s_0 *(1-beta mu)/2
@@ -95,10 +123,10 @@ Compton::pair_float Compton::comp_cross_section(
 
 
 tuple<float, float> Compton::accumulate(
-    string t1, float e1, string t2, float e2)
+    int t1, float e1, int t2, float e2)
 {
-  if( (t1 == "e-" || t1 == "e+") && e1 > ming) return {1.0f, 1.0f}; // do not accumulate rel prtcl
-  if( (t2 == "e-" || t2 == "e+") && e2 > ming) return {1.0f, 1.0f}; // do not accumulate rel prtcl
+  if( is_lepton(t1) && e1 > ming) return {1.0f, 1.0f}; // do not accumulate rel prtcl
+  if( is_lepton(t2) && e2 > ming) return {1.0f, 1.0f}; // do not accumulate rel prtcl
 
 
   // accumulation factor; forces electron energy changes to be ~0.1
@@ -106,23 +134,23 @@ tuple<float, float> Compton::accumulate(
 
   f = std::min(1.0e3f, f); // cap f 
 
-  float f1 = t1 == "ph" ? f : 1.0f;
-  float f2 = t2 == "ph" ? f : 1.0f;
+  float f1 = t1 == sp_ph ? f : 1.0f;
+  float f2 = t2 == sp_ph ? f : 1.0f;
 
   return {f1,f2};
 }
   
 void Compton::interact(
-  string& t1, float& ux1, float& uy1, float& uz1,
-  string& t2, float& ux2, float& uy2, float& uz2) 
+  int& t1, float& ux1, float& uy1, float& uz1,
+  int& t2, float& ux2, float& uy2, float& uz2) 
 {
 
   //--------------------------------------------------
   Vec3<float> zv, xv;
-  if( (t1 == "e-" || t1 == "e+") && (t2 == "ph") ) {
+  if( is_lepton(t1) && (t2 == sp_ph) ) {
     zv.set(ux1, uy1, uz1); 
     xv.set(ux2, uy2, uz2); 
-  } else if( (t2 == "e-" || t2 == "e+") && (t1 == "ph") ) {
+  } else if( is_lepton(t2) && (t1 == sp_ph) ) {
     zv.set(ux2, uy2, uz2); 
     xv.set(ux1, uy1, uz1); 
   } else {
@@ -191,18 +219,27 @@ void Compton::interact(
   //scatter until physically realistic event is found
   int niter = 0;
   float phi_R, mu_R, x1_R, F;
-  while(true) {
-    phi_R = 2.0f*PI*rand(); // candidate symmetry/azimuth angle in R frame
-    mu_R = -1.0f + 2.0f*rand(); // candidate latitude/scattering angle between incident and outg photon
+  if(use_tables && !ang_table.empty() && x0_R <= ang_table.pmax) {
+    // sample the angle directly from the tabulated inverse CDF; 
+    // below the table range the distribution is Thomson and p is clamped
+    phi_R = 2.0f*PI*rand(); 
+    mu_R = compton_angle( ang_table.sample(x0_R, rand()), x0_R );
+    mu_R = std::max(-1.0f, std::min(1.0f, mu_R));
+    x1_R = x0_R/(1.0f + x0_R*(1.0f - mu_R)); 
+  } else {
+    while(true) {
+      phi_R = 2.0f*PI*rand(); // candidate symmetry/azimuth angle in R frame
+      mu_R = -1.0f + 2.0f*rand(); // candidate latitude/scattering angle between incident and outg photon
 
-    x1_R = x0_R/(1.0f + x0_R*(1.0f - mu_R)); // scattered photon energy in R frame
+      x1_R = x0_R/(1.0f + x0_R*(1.0f - mu_R)); // scattered photon energy in R frame
 
-    // angle dependent part of differential cross section
-    F = 0.5f*pow(x1_R/x0_R, 2)*(-1.0f + (x1_R/x0_R) + (x0_R/x1_R) + mu_R*mu_R );
+      // angle dependent part of differential cross section
+      F = 0.5f*pow(x1_R/x0_R, 2)*(-1.0f + (x1_R/x0_R) + (x0_R/x1_R) + mu_R*mu_R );
 
-    if( F > rand() ) break;   // accept angles
-    if( niter > n_max ) break; // too many iterations
-    niter += 1;
+      if( F > rand() ) break;   // accept angles
+      if( niter > n_max ) break; // too many iterations
+      niter += 1;
+    }
   }
         
   if(niter > n_max) std::cerr << "COMPTON WARNING: too many iterations" << std::endl;
@@ -247,7 +284,7 @@ void Compton::interact(
   auto [facc1, facc2] = accumulate(t1, gam0, t2, x0);
   facc1 = do_accumulate ? facc1 : 1.0f;
   facc2 = do_accumulate ? facc2 : 1.0f;
-  float facc_in = t1 == "ph" ? facc1 : facc2; // pick photon as the accumulated quantity
+  float facc_in = t1 == sp_ph ? facc1 : facc2; // pick photon as the accumulated quantity
   //facc = 1.0f; // FIXME never accumulate losses
 
   // every energy transcation is is enhanced by this factor
@@ -290,7 +327,7 @@ void Compton::interact(
   //for(size_t i=0; i<3; i++) beta1(i) = (gam0*beta0(i) + (x0*om0(i) - x1*om1(i)) )/gam1;
 
 
-  if( (t1 == "e-" || t1 == "e+") && (t2 == "ph") ) {
+  if( is_lepton(t1) && (t2 == sp_ph) ) {
 
     if(! no_electron_update) {
       ux1 = gam1*beta1(0);
@@ -304,7 +341,7 @@ void Compton::interact(
       uz2 = x1*om1(2);
     }
 
-  } else if( (t2 == "e-" || t2 == "e+") && (t1 == "ph") ) {
+  } else if( is_lepton(t2) && (t1 == sp_ph) ) {
 
     if(! no_photon_update) {
       ux1 = x1*om1(0);
@@ -374,6 +411,24 @@ void Compton::interact(
 }
 
 
+void Compton::build_tables()
+{
+  if(!cs_table.empty()) return; // already built
+
+  cs_table.build(1.0e-2f, 1.0e8f, 1024, klein_nishina);
+  ang_table.build(1.0e-4f, 1.0e6f, 128, 128, compton_angle_pdf);
+}
+
+
+Compton::pair_float Compton::table_accuracy()
+{
+  if(cs_table.empty()) return {0.0f, 0.0f};
+
+  return { table_error(cs_table, klein_nishina), 
+           table_error(ang_table, compton_angle_pdf) };
+}
+
+
 } // end of namespace qed
 
 #pragma GCC diagnostic pop
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/tables.h"
 
 
 namespace qed {
@@ -8,7 +9,7 @@ namespace qed {
   using std::tuple;
 
 
-class Compton :
+class Compton final :
   public Interaction
 {
 public:
@@ -17,6 +18,7 @@ public:
     Interaction(t1, t2)
   {
     name = "compton";
+    kind = InteractionKind::compton;
     //cross_section = 1.0;  // maximum cross section 
                           // for head-on collisions its x2 (in units of sigma_T)
   }
@@ -30,17 +32,25 @@ public:
   double ming = 1.1;      // minimumjj electron energy to classify it "non-relativistic"
   double minx2z = 1.0e-2; // minimum ph energy needs to be > minx2z*gam 
 
-  tuple<float, float> get_minmax_ene( string t1, string t2, double ene) override final;
+  // lookup tables (used if use_tables is set)
+  LogTable cs_table;     // total cross section vs s = x*gam*(1-beta*mu)/2 
+  InvCDFTable ang_table; // scattering angle vs photon energy in electron rest frame
+
+  tuple<float, float> get_minmax_ene( int t1, int t2, double ene) override final;
 
   pair_float comp_cross_section(
-    string t1, float ux1, float uy1, float uz1,
-    string t2, float ux2, float uy2, float uz2) override;
+    int t1, float ux1, float uy1, float uz1,
+    int t2, float ux2, float uy2, float uz2) override;
 
-  pair_float accumulate(string t1, float e1, string t2, float e2) override;
+  pair_float accumulate(int t1, float e1, int t2, float e2) override;
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override;
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override;
+
+  void build_tables() override;
+
+  pair_float table_accuracy() override;
 
 
 }; // end of Compton class
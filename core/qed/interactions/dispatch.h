@@ -0,0 +1,60 @@
+#pragma once
+
+#include <memory>
+
+#include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/compton.h"
+#include "core/qed/interactions/pair_ann.h"
+#include "core/qed/interactions/phot_ann.h"
+#include "core/qed/interactions/synchrotron.h"
+#include "core/qed/interactions/multi_phot_ann.h"
+
+
+namespace qed {
+
+
+// Static dispatch of the interaction kernels.
+//
+// Calls f with the interaction cast to its concrete (final) type so that the
+// member functions are resolved at compile time instead of through the vtable.
+// Interactions of unknown kind (e.g., defined in python) are passed as the
+// base class and go through the virtual interface.
+
+template<typename F>
+inline decltype(auto) dispatch_binary(Interaction& intr, F&& f)
+{
+  switch(intr.kind) {
+    case InteractionKind::compton:  return f(static_cast<Compton&>(intr));
+    case InteractionKind::pair_ann: return f(static_cast<PairAnn&>(intr));
+    case InteractionKind::phot_ann: return f(static_cast<PhotAnn&>(intr));
+    default:                        return f(intr);
+  }
+}
+
+template<typename F>
+inline decltype(auto) dispatch_single(Interaction& intr, F&& f)
+{
+  switch(intr.kind) {
+    case InteractionKind::synchrotron:    return f(static_cast<Synchrotron&>(intr));
+    case InteractionKind::multi_phot_ann: return f(static_cast<MultiPhotAnn&>(intr));
+    default:                              return f(intr);
+  }
+}
+
+
+// Private copy of a single-body interaction.
+//
+// Single-body interactions store the quantum parameter of the particle between
+// comp_optical_depth and interact so threads need their own copies. Binary
+// interactions and interactions of unknown kind are returned as is.
+inline std::shared_ptr<Interaction> clone_single(const std::shared_ptr<Interaction>& iptr)
+{
+  switch(iptr->kind) {
+    case InteractionKind::synchrotron:    return std::make_shared<Synchrotron>( static_cast<const Synchrotron&>(*iptr) );
+    case InteractionKind::multi_phot_ann: return std::make_shared<MultiPhotAnn>( static_cast<const MultiPhotAnn&>(*iptr) );
+    default:                              return iptr;
+  }
+}
+
+
+} // end of namespace qed
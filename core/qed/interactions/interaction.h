@@ -2,9 +2,10 @@
 
 #include <string>
 #include <tuple>
-#include <random>
 
 #include "definitions.h"
+#include "core/qed/species.h"
+#include "tools/rng.h"
 
 // TODO turning compiler warnings off temporarily in this file since 
 //      for symmetry, there are lots of unused variables in the qed API
@@ -78,15 +79,23 @@ namespace qed {
 
 
 
+// concrete interaction types; used by the pairing kernels for static dispatch
+enum class InteractionKind : int {
+  generic,
+  compton,
+  pair_ann,
+  phot_ann,
+  synchrotron,
+  multi_phot_ann
+};
+
+
 // Base class for a generic two-body QED interaction
+//
+// Particle types are passed as species ids (see species.h); the string
+// versions are kept only for the python interface.
 class Interaction
 {
-private:
-
-  std::random_device rd;
-  std::mt19937 gen;
-  std::uniform_real_distribution<float> uni_dis;
-
 public:
 
   // constants used in calculations
@@ -99,6 +108,8 @@ public:
 
   int interaction_order = 2; // default interaction is 2-body
 
+  InteractionKind kind = InteractionKind::generic;
+
   using pair_float = std::tuple<float, float>;
     
   const float cross_section = 1.0; // maximum cross section (in units of sigma_T)
@@ -108,6 +119,9 @@ public:
   string t1; // incident particle type
   string t2; // target particle type
 
+  int s1; // incident species id
+  int s2; // target species id
+
   // use accumulation technique (calls accumulate() function to get facc
   bool do_accumulate = false;
 
@@ -120,34 +134,41 @@ public:
   // maximum Monte Carlo iterations of the differential cross section
   const int n_max = 10000;
 
+  // use precomputed lookup tables (see tables.h) for the cross section and 
+  // for sampling the differential cross section; the tables are built by 
+  // build_tables() when the interaction is added to a solver
+  bool use_tables = false;
+
   // constructor with incident/target types
   Interaction(string t1, string t2) :
-    gen(42), // gen(rd() ) 
-    uni_dis(0.0, 1.0),
     t1(t1),
-    t2(t2) 
+    t2(t2),
+    s1(species_id(t1)),
+    s2(species_id(t2))
   { }
 
+  virtual ~Interaction() = default;
+
   // minimum and maximum particle energies required to participate in the interaction
-  virtual pair_float get_minmax_ene( string /*t1*/, string /*t2*/, double /*ene*/) { return {0.0f, 1.0f}; };
+  virtual pair_float get_minmax_ene( int /*t1*/, int /*t2*/, double /*ene*/) { return {0.0f, 1.0f}; };
 
   // interaction cross section given incident/target particle four-velocities
   // NOTE: used in binary interactions
   virtual pair_float comp_cross_section(
-    string /*t1*/, float /*ux1*/, float /*uy1*/, float /*uz1*/,
-    string /*t2*/, float /*ux2*/, float /*uy2*/, float /*uz2*/)
+    int /*t1*/, float /*ux1*/, float /*uy1*/, float /*uz1*/,
+    int /*t2*/, float /*ux2*/, float /*uy2*/, float /*uz2*/)
     { return {cross_section, 1.0f}; }
 
   // NOTE: used in single interactions
   virtual float comp_optical_depth( 
-      string /*t1*/, 
+      int /*t1*/, 
       float /*ux1*/, float /*uy1*/, float /*uz1*/,
       float /*ex*/,  float /*ey*/,  float /*ez*/,
       float /*bx*/,  float /*by*/,  float /*bz*/)
   { return 1.0f; };
 
   // interaction accumulation factor
-  virtual pair_float accumulate(string /*t1*/, float /*e1*/, string /*t2*/, float /*e2*/) {return {1.0f,1.0f}; };
+  virtual pair_float accumulate(int /*t1*/, float /*e1*/, int /*t2*/, float /*e2*/) {return {1.0f,1.0f}; };
 
   // main interaction routine; 
   //
@@ -160,12 +181,20 @@ public:
   //  particle4: type, ux, uy, uz
   //
   virtual void interact(
-        string& /*t1*/, float& /*ux1*/, float& /*uy1*/, float& /*uz1*/,
-        string& /*t2*/, float& /*ux2*/, float& /*uy2*/, float& /*uz2*/)
+        int& /*t1*/, float& /*ux1*/, float& /*uy1*/, float& /*uz1*/,
+        int& /*t2*/, float& /*ux2*/, float& /*uy2*/, float& /*uz2*/)
       { return; }
 
-  // random numbers between [0, 1[
-  float rand() { return uni_dis(gen); };
+  // build the lookup tables; no-op if already built or not supported by the interaction
+  virtual void build_tables() { return; }
+
+  // accuracy of the tables against the analytic path: 
+  // max relative error of the cross section and max CDF error of the angle sampling
+  virtual pair_float table_accuracy() { return {0.0f, 0.0f}; }
+
+  // random numbers between [0, 1[; 
+  // drawn from the stream of the calling thread that the solver keys by tile and lap
+  float rand() { return toolbox::thread_stream().uniform(); };
 
   // random numbers between [a, b[
   float rand_ab(float a, float b) { 
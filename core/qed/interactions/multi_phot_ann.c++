@@ -31,7 +31,7 @@ namespace qed {
 
 
 
-tuple<float, float> MultiPhotAnn::get_minmax_ene( string /*t1*/, string /*t2*/, double /*ene*/)
+tuple<float, float> MultiPhotAnn::get_minmax_ene( int /*t1*/, int /*t2*/, double /*ene*/)
 {
   // only x>2 can participate
   return {2.0f, INF};
@@ -84,7 +84,7 @@ float MultiPhotAnn::comp_chi(
 
 
 float MultiPhotAnn::comp_optical_depth(
-    string /*t1*/, 
+    int /*t1*/, 
     float ux1, float uy1, float uz1,
     float ex,  float ey,  float ez,
     float bx,  float by,  float bz)
@@ -123,8 +123,8 @@ float MultiPhotAnn::comp_optical_depth(
 
 
 void MultiPhotAnn::interact(
-  string& t1, float& ux1, float& uy1, float& uz1,
-  string& t2, float& ux2, float& uy2, float& uz2) 
+  int& t1, float& ux1, float& uy1, float& uz1,
+  int& t2, float& ux2, float& uy2, float& uz2) 
 {
 
   //--------------------------------------------------
@@ -238,13 +238,13 @@ void MultiPhotAnn::interact(
 
   float inv_cx = ( x0 - 2.0 )/chi_x; // available energy / chi_x
     
-  t1 = "e-";
+  t1 = sp_em;
   float pe = sqrt( pow( 1.0 + chi_e*inv_cx, 2 ) - 1.0 );
   ux1 = pe*xv(0)/x0; 
   uy1 = pe*xv(1)/x0; 
   uz1 = pe*xv(2)/x0; 
 
-  t2 = "e+";
+  t2 = sp_ep;
   float pp = sqrt( pow( 1.0 + chi_p*inv_cx, 2 ) - 1.0 );
   ux2 = pp*xv(0)/x0; 
   uy2 = pp*xv(1)/x0; 
@@ -13,7 +13,7 @@ namespace qed {
  //
  // Refs Duclous et al. 2011 implementation
  //
-class MultiPhotAnn :
+class MultiPhotAnn final :
   public Interaction
 {
 
@@ -62,6 +62,7 @@ public:
     Interaction(t1, "")
   {
     name = "multi-phot-ann";
+    kind = InteractionKind::multi_phot_ann;
     interaction_order = 1; // set as single prtcl interaction
   }
 
@@ -72,7 +73,7 @@ public:
   float chi_x = 0.0; 
 
   // NOTE no override since input arguments are different
-  pair_float get_minmax_ene( string t1, string t2, double ene) override final;
+  pair_float get_minmax_ene( int t1, int t2, double ene) override final;
 
   // calculate quantum parameter
   float comp_chi( 
@@ -81,15 +82,15 @@ public:
       float bx,  float by,  float bz);
 
   // calculate optical depth for the process 
-  float comp_optical_depth( string t1, 
+  float comp_optical_depth( int t1, 
       float ux1, float uy1, float uz1,
       float ex,  float ey,  float ez,
       float bx,  float by,  float bz
       ) override final;
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override final;
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override final;
 
   //pair_float accumulate(string t1, float e1 ) override;
 
@@ -26,15 +26,34 @@ namespace qed {
   using toolbox::inv;
 
 
-tuple<float, float> PairAnn::get_minmax_ene( string /*t1*/, string /*t2*/, double /*ene*/)
+// pair annihilation cross section in units of sigma_T; Svensson 1982
+template<typename T>
+inline T pair_ann_cs(T bcm, T gcm)
+{
+  T s0 = (0.25f/(bcm*gcm*gcm))*( (1.0f/bcm)*(2.0f + 2.0f/gcm/gcm - 1.0f/pow(gcm,4))*log( (1.0f+bcm)/(1.0f-bcm) ) - 2.0f - 2.0f/gcm/gcm);
+  s0 *= 3.0f/8.0f; //# normalization to rates; mathches with Coppi & Blandford eq 3.1
+  return s0;
+}
+
+// cross section as a function of w = q_e - 1; used to build the tables
+inline float pair_ann_cs_w(float wf)
+{
+  double w = wf;
+  double bcm = std::sqrt(w/(w + 2.0));
+  double gcm = std::sqrt(0.5*(w + 2.0));
+  return static_cast<float>( pair_ann_cs(bcm, gcm) );
+}
+
+
+tuple<float, float> PairAnn::get_minmax_ene( int /*t1*/, int /*t2*/, double /*ene*/)
 {
   return {0.0f, INF}; 
 }
 
 
 PairAnn::pair_float PairAnn::comp_cross_section(
-    string /*t1*/, float ux1, float uy1, float uz1,
-    string /*t2*/, float ux2, float uy2, float uz2)
+    int /*t1*/, float ux1, float uy1, float uz1,
+    int /*t2*/, float ux2, float uy2, float uz2)
 {
 
   float zp = norm(ux1, uy1, uz1); // z_+
@@ -46,9 +65,6 @@ PairAnn::pair_float PairAnn::comp_cross_section(
   
   //qe = max(1+EPS, gamp*gamm - zp*zm*zeta) 
   float qe =  gamp*gamm - zp*zm*zeta; //# product of 4-moms; q_e = z_- . z_+; = 2gamma_cm^2 - 1 = gamma_r
-  float q = qe + 1.0f;          //# q_e = q + 1
-  float bcm = sqrt( (q - 2.0f)/q ); //# \beta_cm; matches beta' in Coppi & Blandford
-  float gcm = 1.0f/sqrt(1.0f - bcm*bcm); //# gamma_cm
 
   //# expression via relativistic invariant x = sqrt( p_- . p_+ )
   //float x = bcm;                  //# free variable
@@ -57,9 +73,17 @@ PairAnn::pair_float PairAnn::comp_cross_section(
 
   //s0 *= 2.0; // FIXME ????
 
-  //# ver2; Svensson 1992
-  float s0 = (0.25f/(bcm*gcm*gcm))*( (1.0f/bcm)*(2.0f + 2.0f/gcm/gcm - 1.0f/pow(gcm,4))*log( (1.0f+bcm)/(1.0f-bcm) ) - 2.0f - 2.0f/gcm/gcm);
-  s0 *= 3.0f/8.0f; //# normalization to rates; mathches with Coppi & Blandford eq 3.1
+  float s0 = 0.0f;
+  if(use_tables && cs_table.inside(qe - 1.0f)) {
+    s0 = cs_table(qe - 1.0f);
+  } else {
+    float q = qe + 1.0f;          //# q_e = q + 1
+    float bcm = sqrt( (q - 2.0f)/q ); //# \beta_cm; matches beta' in Coppi & Blandford
+    float gcm = 1.0f/sqrt(1.0f - bcm*bcm); //# gamma_cm
+
+    //# ver2; Svensson 1992
+    s0 = pair_ann_cs(bcm, gcm);
+  }
      
   //std::cout << " PAIR-ANN:" << s0 << " " << s1 << std::endl;
 
@@ -107,8 +131,8 @@ PairAnn::pair_float PairAnn::comp_cross_section(
 //}
   
 void PairAnn::interact(
-  string& t1, float& ux1, float& uy1, float& uz1,
-  string& t2, float& ux2, float& uy2, float& uz2) 
+  int& t1, float& ux1, float& uy1, float& uz1,
+  int& t2, float& ux2, float& uy2, float& uz2) 
 {
   Vec3<float> zmvec(ux1, uy1, uz1);
   Vec3<float> zpvec(ux2, uy2, uz2);
@@ -161,33 +185,51 @@ void PairAnn::interact(
   int niter = 0;
 
   float cosz, phi, xang, z1, z2, F; // temp variables
-  while(true) {
-    phi = 2.0*PI*rand(); // azimuthal symmetry angle
-    cosz= -1.0 + 2.0*rand(); //# angle between k_cm and b_c; photon and CoM
+  Vec3<float> omrR; // new photon direction in CoM frame
+  float pcm = sqrt( std::max(0.0f, 0.5f*q - 1.0f) ); // lepton CoM momentum
 
-    //# angle between k_cm and b_cm; photon and electron
-    xang = y*cosz + sqrt(1.0 - y*y)*sqrt(1.0 - cosz*cosz)*cos(phi);
+  if(use_tables && !ang_table.empty() && pcm <= ang_table.pmax) {
+    // sample the photon-electron angle from the tabulated inverse CDF and 
+    // rotate the photon around the CoM electron direction e = (sqrt(1-y^2), 0, y)
+    float ey = std::max(-1.0f, std::min(1.0f, y));
+    float ex = sqrt(1.0f - ey*ey);
 
-    //# four product scalar between electron/positron and primary/secondary photon
-    z1 = (gcm*gcm)*(1.0 - vcm*xang);
-    z2 = (gcm*gcm)*(1.0 + vcm*xang);
+    phi  = 2.0f*PI*rand(); // azimuth around e
+    xang = ann_angle( ang_table.sample(pcm, rand()), pcm );
+    float sinx = sqrt( std::max(0.0f, 1.0f - xang*xang) );
 
-    //# differential cross section angle part; F function 
-    F = 0.5*( (z1/z2) + (z2/z1) + 2.0*( (1.0/z1) + (1.0/z2) ) - pow( (1.0/z1) + (1.0/z2), 2)  );
-    F *= 1.0/((1.0 + vcm)*gcm*gcm); //# normalize to [0,1]
+    // omrR = xang e + sinx (cos(phi) a + sin(phi) b); a = (-ey, 0, ex), b = (0, 1, 0)
+    omrR.set( xang*ex - sinx*cos(phi)*ey, sinx*sin(phi), xang*ey + sinx*cos(phi)*ex );
+    cosz = omrR(2);
 
-    if( F > rand() ) break;   // accept angles
-    if( niter > n_max ) break; // too many iterations
-    niter += 1;
+  } else {
+    while(true) {
+      phi = 2.0*PI*rand(); // azimuthal symmetry angle
+      cosz= -1.0 + 2.0*rand(); //# angle between k_cm and b_c; photon and CoM
 
-  }
+      //# angle between k_cm and b_cm; photon and electron
+      xang = y*cosz + sqrt(1.0 - y*y)*sqrt(1.0 - cosz*cosz)*cos(phi);
+
+      //# four product scalar between electron/positron and primary/secondary photon
+      z1 = (gcm*gcm)*(1.0 - vcm*xang);
+      z2 = (gcm*gcm)*(1.0 + vcm*xang);
 
-  if(niter > n_max) std::cerr << "PAIR-ANN WARNING: too many iterations" << std::endl;
+      //# differential cross section angle part; F function 
+      F = 0.5*( (z1/z2) + (z2/z1) + 2.0*( (1.0/z1) + (1.0/z2) ) - pow( (1.0/z1) + (1.0/z2), 2)  );
+      F *= 1.0/((1.0 + vcm)*gcm*gcm); //# normalize to [0,1]
 
+      if( F > rand() ) break;   // accept angles
+      if( niter > n_max ) break; // too many iterations
+      niter += 1;
 
-  //# new photon vectors in CoM frame
-  float sinz = sqrt(1.0 - cosz*cosz); 
-  Vec3<float> omrR( sinz*cos(phi), sinz*sin(phi), cosz );
+    }
+
+    if(niter > n_max) std::cerr << "PAIR-ANN WARNING: too many iterations" << std::endl;
+
+    //# new photon vectors in CoM frame
+    float sinz = sqrt(1.0 - cosz*cosz); 
+    omrR.set( sinz*cos(phi), sinz*sin(phi), cosz );
+  }
 
   //# rotate back to lab frame angles
   Mat3<float> Minv = inv( M );
@@ -278,12 +320,12 @@ void PairAnn::interact(
   //#    x, x1  = x1,x
   //#    om,om1 = om1, om
 
-  t1 = "ph";
+  t1 = sp_ph;
   ux1 = xpp0(1);
   uy1 = xpp0(2);
   uz1 = xpp0(3);
 
-  t2 = "ph";
+  t2 = sp_ph;
   ux2 = xpp1(1);
   uy2 = xpp1(2);
   uz2 = xpp1(3);
@@ -292,6 +334,24 @@ void PairAnn::interact(
 }
 
 
+void PairAnn::build_tables()
+{
+  if(!cs_table.empty()) return; // already built
+
+  cs_table.build(1.0e-4f, 1.0e8f, 1024, pair_ann_cs_w);
+  ang_table.build(1.0e-3f, 1.0e6f, 128, 128, ann_angle_pdf);
+}
+
+
+PairAnn::pair_float PairAnn::table_accuracy()
+{
+  if(cs_table.empty()) return {0.0f, 0.0f};
+
+  return { table_error(cs_table, pair_ann_cs_w), 
+           table_error(ang_table, ann_angle_pdf) };
+}
+
+
 } // end of namespace qed
 
 #pragma GCC diagnostic pop
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/tables.h"
 
 
 namespace qed {
@@ -8,7 +9,7 @@ namespace qed {
   using std::tuple;
 
 
-class PairAnn :
+class PairAnn final :
   public Interaction
 {
 public:
@@ -17,16 +18,21 @@ public:
     Interaction(t1, t2)
   {
     name = "pair-ann";
+    kind = InteractionKind::pair_ann;
     //cross_section = 0.256; // 0.206 measured
   }
 
   const float cross_section = 0.256; // 0.206 measured
 
-  tuple<float, float> get_minmax_ene( string t1, string t2, double ene) override final;
+  // lookup tables (used if use_tables is set)
+  LogTable cs_table;     // total cross section vs q_e - 1 = z_- . z_+ - 1
+  InvCDFTable ang_table; // photon-lepton angle vs lepton CoM momentum (see ann_angle)
+
+  tuple<float, float> get_minmax_ene( int t1, int t2, double ene) override final;
 
   pair_float comp_cross_section(
-    string t1, float ux1, float uy1, float uz1,
-    string t2, float ux2, float uy2, float uz2) override;
+    int t1, float ux1, float uy1, float uz1,
+    int t2, float ux2, float uy2, float uz2) override;
 
   //tuple<
   //  string, float, float, float,
@@ -36,8 +42,12 @@ public:
   //      string t2, float ux2, float uy2, float uz2) override;
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override;
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override;
+
+  void build_tables() override;
+
+  pair_float table_accuracy() override;
 
 
 }; // end of PairAnn class
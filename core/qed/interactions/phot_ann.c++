@@ -25,7 +25,24 @@ namespace qed {
   using toolbox::inv;
 
 
-tuple<float, float> PhotAnn::get_minmax_ene( string /*t1*/, string /*t2*/, double ene)
+// Breit-Wheeler cross section in units of sigma_T as a function of x = \beta_cm; N99 eq 64 and 59
+template<typename T>
+inline T phot_ann_cs(T x)
+{
+  T s0 = x*(1.0 - x*x)*( ( (3.0 - x*x*x*x)/(2.0*x) )*log((1.0 + x)/(1.0 - x)) - (2.0 - x*x)); 
+  s0 *= 3.0/8.0; //# normalization factor
+  return s0;
+}
+
+// cross section as a function of w = x_cm^2 - 1; used to build the tables
+inline float phot_ann_cs_w(float wf)
+{
+  double w = wf;
+  return static_cast<float>( phot_ann_cs( std::sqrt(w/(1.0 + w)) ) );
+}
+
+
+tuple<float, float> PhotAnn::get_minmax_ene( int /*t1*/, int /*t2*/, double ene)
 {
   if(ene > 0.0){
 
@@ -51,8 +68,8 @@ tuple<float, float> PhotAnn::get_minmax_ene( string /*t1*/, string /*t2*/, doubl
 // Exact formula for Breit-Wheeler cross section in units of sigma_T
 // NOTE: sigma_T = 8 pi r2/3; this is in units of \pi r_e^2
 PhotAnn::pair_float PhotAnn::comp_cross_section(
-    string /*t1*/, float ux1, float uy1, float uz1,
-    string /*t2*/, float ux2, float uy2, float uz2)
+    int /*t1*/, float ux1, float uy1, float uz1,
+    int /*t2*/, float ux2, float uy2, float uz2)
 {
 
   Vec3 x1v(ux1, uy1, uz1);
@@ -86,8 +103,13 @@ PhotAnn::pair_float PhotAnn::comp_cross_section(
   //             = \beta_cm
 
   // cross section from N99; eq 64 and 59
-  float x = sqrt(1.0 - 1.0/(xcm*xcm)); // \beta_cm
-  float s0 = x*(1.0 - x*x)*( ( (3.0 - x*x*x*x)/(2.0*x) )*log((1.0 + x)/(1.0 - x)) - (2.0 - x*x)); 
+  float s0 = 0.0f;
+  if(use_tables && cs_table.inside(xcm*xcm - 1.0f)) {
+    s0 = cs_table(xcm*xcm - 1.0f);
+  } else {
+    float x = sqrt(1.0 - 1.0/(xcm*xcm)); // \beta_cm
+    s0 = phot_ann_cs(x);
+  }
 
   //s0ann = (0.25*(1/x**2)*(1-x**2))*( (3-x**4)*log((1+x)/(1-x)) + 2*x*(x**2 - 2)) #
   //s01 = 2*x*x*s0ann # eq 64 in N99; \sigma_bth = 2\beta_cm^2 \sigma_ann
@@ -95,7 +117,6 @@ PhotAnn::pair_float PhotAnn::comp_cross_section(
   //# expression with a substitution as done by A&B book 
   //#s0 = (1/2)     *(1-x**2)* ( (3-x**4)*log( (1+x)/(1-x) ) + 2*x*(x**2-2))
 
-  s0 *= 3.0/8.0; //# normalization factor
   //--------------------------------------------------
 
   //# pair creation probability dP/dtau = s_gg (1-cosa)
@@ -107,8 +128,8 @@ PhotAnn::pair_float PhotAnn::comp_cross_section(
 
 
 void PhotAnn::interact(
-  string& t1, float& ux1, float& uy1, float& uz1,
-  string& t2, float& ux2, float& uy2, float& uz2) 
+  int& t1, float& ux1, float& uy1, float& uz1,
+  int& t2, float& ux2, float& uy2, float& uz2) 
 {
 
   Vec3 x1v(ux1, uy1, uz1); // four-vector of photon1
@@ -173,42 +194,69 @@ void PhotAnn::interact(
   //  draw angles
   int niter = 0;
   float phi, xang, y, z1, z2, F;
-  while(true) {
-    phi = 2.0*PI*rand(); // azimuthal symmetry angle
-    y = rand_ab(ymin, ymax); // # angle between b_c and lepton; lepton and CoM
+  float siny; 
+  Vec3<float> omr1R; // lepton unit vector in CM frame
+  float pcm = sqrt( std::max(0.0f, 0.5f*q - 1.0f) ); // lepton CoM momentum
+
+  if(use_tables && !ang_table.empty() && pcm <= ang_table.pmax) {
+    // sample the photon-lepton angle from the tabulated inverse CDF and rotate the 
+    // lepton around the CoM photon direction p = (sqrt(1-cosz^2), 0, cosz); 
+    // reject leptons outside of [ymin, ymax] as in the analytic path
+    float sinz = sqrt( std::max(0.0f, 1.0f - cosz*cosz) );
+    while(true) {
+      phi  = 2.0f*PI*rand(); // azimuth around p
+      xang = ann_angle( ang_table.sample(pcm, rand()), pcm );
+      float sinx = sqrt( std::max(0.0f, 1.0f - xang*xang) );
+
+      // omr1R = xang p + sinx (cos(phi) a + sin(phi) b); a = (-cosz, 0, sinz), b = (0, 1, 0)
+      omr1R.set( xang*sinz - sinx*cos(phi)*cosz, sinx*sin(phi), xang*cosz + sinx*cos(phi)*sinz );
+      y = omr1R(2);
+
+      if( y >= ymin && y <= ymax ) break; 
+      if( niter > n_max ) break; // too many iterations
+      niter += 1;
+    }
+    if(niter > n_max) std::cerr << "PHOT-ANN WARNING: too many iterations" << std::endl;
+    siny = sqrt( std::max(0.0f, 1.0f - y*y) );
+
+  } else {
+    while(true) {
+      phi = 2.0*PI*rand(); // azimuthal symmetry angle
+      y = rand_ab(ymin, ymax); // # angle between b_c and lepton; lepton and CoM
                            
-    // TODO mumax limit for x angle or z angle?
-    // z = -1 + 2*random.rand() # angle between b_c and photon
-    // y = -1 + 2*random.rand() # angle between 
-    // #y = randU(-1, ymax) # angle between b_c and lepton
-    //y = -1.0 + 2.0*rand(); // # angle between b_c and lepton
-    xang = y*cosz + sqrt(1.0 - y*y)*sqrt(1.0 - cosz*cosz)*cos(phi); // scattering angle between photon and lepton; eq 15 in aharonyan 83
-
-    //# DONE + or - for x experssion? DONE - according to aharonyan; + according Bottcher
-    // four product scalar between electron/positron and primary/secondary photon
-    z1 = (gcm*gcm)*(1.0 - vcm*xang);
-    z2 = (gcm*gcm)*(1.0 + vcm*xang);
-
-    // differential cross section angle part; F function 
-    F = 0.5*( (z1/z2) + (z2/z1) + 2.0*( (1.0/z1) + (1.0/z2) ) - pow( (1.0/z1) + (1.0/z2) , 2)  );
-    F *= 1.0/((1.0 + vcm)*gcm*gcm); //# normalize to [0,1]
-
-    //# beta = vcm in N99
-
-    //#print(z1,z2,F, x,y,z,phi)
-    if( F > rand() ) break;   // accept angles
-    if( niter > n_max ) break; // too many iterations
-    niter += 1;
-  }
-  if(niter > n_max) std::cerr << "PHOT-ANN WARNING: too many iterations" << std::endl;
+      // TODO mumax limit for x angle or z angle?
+      // z = -1 + 2*random.rand() # angle between b_c and photon
+      // y = -1 + 2*random.rand() # angle between 
+      // #y = randU(-1, ymax) # angle between b_c and lepton
+      //y = -1.0 + 2.0*rand(); // # angle between b_c and lepton
+      xang = y*cosz + sqrt(1.0 - y*y)*sqrt(1.0 - cosz*cosz)*cos(phi); // scattering angle between photon and lepton; eq 15 in aharonyan 83
+
+      //# DONE + or - for x experssion? DONE - according to aharonyan; + according Bottcher
+      // four product scalar between electron/positron and primary/secondary photon
+      z1 = (gcm*gcm)*(1.0 - vcm*xang);
+      z2 = (gcm*gcm)*(1.0 + vcm*xang);
+
+      // differential cross section angle part; F function 
+      F = 0.5*( (z1/z2) + (z2/z1) + 2.0*( (1.0/z1) + (1.0/z2) ) - pow( (1.0/z1) + (1.0/z2) , 2)  );
+      F *= 1.0/((1.0 + vcm)*gcm*gcm); //# normalize to [0,1]
+
+      //# beta = vcm in N99
+
+      //#print(z1,z2,F, x,y,z,phi)
+      if( F > rand() ) break;   // accept angles
+      if( niter > n_max ) break; // too many iterations
+      niter += 1;
+    }
+    if(niter > n_max) std::cerr << "PHOT-ANN WARNING: too many iterations" << std::endl;
 
 
-  // new primary lepton vectors in CoM frame
-  //      #sinz = sqrt(1-z**2) # sin z
-  //      #omr1R = array([ sinz*cos(phi), sinz*sin(phi), z ])
+    // new primary lepton vectors in CoM frame
+    //      #sinz = sqrt(1-z**2) # sin z
+    //      #omr1R = array([ sinz*cos(phi), sinz*sin(phi), z ])
 
-  float siny = sqrt(1.0 - y*y); //# sin z
-  Vec3<float> omr1R( siny*cos(phi), siny*sin(phi), y ); // photon univ vector in CM frame
+    siny = sqrt(1.0 - y*y); //# sin z
+    omr1R.set( siny*cos(phi), siny*sin(phi), y ); // photon univ vector in CM frame
+  }
 
   //# rotate back to lab frame angles
   Mat3<float> Minv = inv( M );
@@ -287,11 +335,11 @@ void PhotAnn::interact(
 
   // is this flip needed? seems so; makes routine independent of e-/e+
   if(rand() < 0.5) {
-    t1 = "e-";
-    t2 = "e+";
+    t1 = sp_em;
+    t2 = sp_ep;
   } else {
-    t1 = "e+";
-    t2 = "e-";
+    t1 = sp_ep;
+    t2 = sp_em;
   }
 
   ux1 = zpp1(1);
@@ -305,6 +353,24 @@ void PhotAnn::interact(
   return;
 }
 
+void PhotAnn::build_tables()
+{
+  if(!cs_table.empty()) return; // already built
+
+  cs_table.build(1.0e-4f, 1.0e8f, 1024, phot_ann_cs_w);
+  ang_table.build(1.0e-3f, 1.0e6f, 128, 128, ann_angle_pdf);
+}
+
+
+PhotAnn::pair_float PhotAnn::table_accuracy()
+{
+  if(cs_table.empty()) return {0.0f, 0.0f};
+
+  return { table_error(cs_table, phot_ann_cs_w), 
+           table_error(ang_table, ann_angle_pdf) };
+}
+
+
 } // end of namespace qed
 
 #pragma GCC diagnostic pop
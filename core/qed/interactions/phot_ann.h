@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/tables.h"
 
 
 namespace qed {
@@ -8,7 +9,7 @@ namespace qed {
   using std::tuple;
 
 
-class PhotAnn :
+class PhotAnn final :
   public Interaction
 {
 public:
@@ -17,6 +18,7 @@ public:
     Interaction(t1, t2)
   {
     name = "phot-ann";
+    kind = InteractionKind::phot_ann;
     //cross_section = 0.256; // 0.682; //0.51375; // 1.37*(3/8)*sigma_T // FIXME
     //                       // 0.25564 measured
   }
@@ -24,15 +26,23 @@ public:
   // maximum cross section
   const float cross_section = 0.256; // 1.37*(3/8)*sigma_T 
 
-  tuple<float, float> get_minmax_ene( string t1, string t2, double ene) override final;
+  // lookup tables (used if use_tables is set)
+  LogTable cs_table;     // total cross section vs x_cm^2 - 1
+  InvCDFTable ang_table; // photon-lepton angle vs lepton CoM momentum (see ann_angle)
+
+  tuple<float, float> get_minmax_ene( int t1, int t2, double ene) override final;
 
   pair_float comp_cross_section(
-    string t1, float ux1, float uy1, float uz1,
-    string t2, float ux2, float uy2, float uz2) override;
+    int t1, float ux1, float uy1, float uz1,
+    int t2, float ux2, float uy2, float uz2) override;
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override;
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override;
+
+  void build_tables() override;
+
+  pair_float table_accuracy() override;
 
 
 }; // end of PhotAnn class
@@ -30,7 +30,7 @@ namespace qed {
   using toolbox::find_sorted_nearest_algo2; // binary search for sorted arrays
 
 
-tuple<float, float> Synchrotron::get_minmax_ene( string /*t1*/, string /*t2*/, double /*ene*/)
+tuple<float, float> Synchrotron::get_minmax_ene( int /*t1*/, int /*t2*/, double /*ene*/)
 {
   // only gam >1.5 emits
   return {3.0f, INF};
@@ -109,7 +109,7 @@ float Synchrotron::comp_chi(
 
 
 float Synchrotron::comp_optical_depth(
-    string /*t1*/, 
+    int /*t1*/, 
     float ux1, float uy1, float uz1,
     float ex,  float ey,  float ez,
     float bx,  float by,  float bz)
@@ -143,8 +143,8 @@ float Synchrotron::comp_optical_depth(
 
 
 tuple<float, float> Synchrotron::accumulate(
-    string /*t3*/, float /*e3*/, 
-    string /*t4*/, float e4)
+    int /*t3*/, float /*e3*/, 
+    int /*t4*/, float e4)
 {
 
   //if( (t1 == "e-" || t1 == "e+") && e1 > ming) return {1.0f, 1.0f}; // do not accumulate rel prtcl
@@ -163,8 +163,8 @@ tuple<float, float> Synchrotron::accumulate(
 
 
 void Synchrotron::interact(
-  string& /*t1*/, float& ux1, float& uy1, float& uz1,
-  string& t2,     float& ux2, float& uy2, float& uz2) 
+  int& /*t1*/, float& ux1, float& uy1, float& uz1,
+  int& t2,     float& ux2, float& uy2, float& uz2) 
 {
 
   //--------------------------------------------------
@@ -276,7 +276,7 @@ void Synchrotron::interact(
   float z0 = norm(zv); // length of the electron velocity vector
 
   // photon to the direction of the electron 
-  t2 = "ph";
+  t2 = sp_ph;
   ux2 = x*zv(0)/z0;
   uy2 = x*zv(1)/z0;
   uz2 = x*zv(2)/z0;
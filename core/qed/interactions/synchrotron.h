@@ -8,7 +8,7 @@ namespace qed {
   using std::tuple;
 
 
-class Synchrotron :
+class Synchrotron final :
   public Interaction
 {
 
@@ -58,6 +58,7 @@ public:
     Interaction(t1, "")
   {
     name = "synchrotron";
+    kind = InteractionKind::synchrotron;
     interaction_order = 1; // set as single prtcl interaction
   }
 
@@ -68,7 +69,7 @@ public:
   float chi_e = 0.0; 
 
   // NOTE no override since input arguments are different
-  pair_float get_minmax_ene( string t1, string t2, double ene) override final;
+  pair_float get_minmax_ene( int t1, int t2, double ene) override final;
 
   // calculate quantum parameter
   float comp_chi( 
@@ -77,17 +78,17 @@ public:
       float bx,  float by,  float bz);
 
   // calculate optical depth for synchrotron photon emission
-  float comp_optical_depth( string t1, 
+  float comp_optical_depth( int t1, 
       float ux1, float uy1, float uz1,
       float ex,  float ey,  float ez,
       float bx,  float by,  float bz
       ) override final;
 
-  pair_float accumulate(string t3, float e3, string t4, float e4) override;
+  pair_float accumulate(int t3, float e3, int t4, float e4) override;
 
   void interact(
-        string& t1, float& ux1, float& uy1, float& uz1,
-        string& t2, float& ux2, float& uy2, float& uz2) override final;
+        int& t1, float& ux1, float& uy1, float& uz1,
+        int& t2, float& ux2, float& uy2, float& uz2) override final;
 
 
 }; // end of Synchrotron class
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#include "tools/fastlog.h"
+#include "tools/linlogspace.h"
+
+
+namespace qed {
+
+
+// Lookup tables for the QED interactions.
+//
+// Tables are built once at solver setup (see Interaction::build_tables) and
+// replace the analytic cross sections and the rejection sampling of the
+// differential cross sections inside their range. Outside of the range the
+// interactions fall back to the analytic path.
+
+
+// 1D table of f(x) on a log-spaced grid; linear interpolation in log2(x)
+struct LogTable
+{
+  float xmin = 1.0f, xmax = 0.0f; // range; empty table has xmin > xmax
+  float lxmin = 0.0f;             // log2(xmin)
+  float idx = 0.0f;               // inverse grid spacing in log2(x)
+  std::vector<float> ys;
+
+  template<typename F>
+  void build(float xmin_in, float xmax_in, int n, F&& f)
+  {
+    ManVec<float> xs;
+    toolbox::logspace(std::log10(xmin_in), std::log10(xmax_in), n, xs);
+
+    ys.resize(n);
+    for(int i=0; i<n; i++) ys[i] = f(xs[i]);
+
+    xmin  = xmin_in;
+    xmax  = xmax_in;
+    lxmin = std::log2(xmin);
+    idx   = static_cast<float>(n-1)/(std::log2(xmax) - lxmin);
+  }
+
+  bool empty() const { return ys.empty(); }
+
+  bool inside(float x) const { return x >= xmin && x <= xmax; }
+
+  // x of node i
+  float node(float i) const { return std::exp2(lxmin + i/idx); }
+
+  float operator()(float x) const
+  {
+    float s = (fastlog2f(x) - lxmin)*idx;
+    int i = std::min( std::max(static_cast<int>(s), 0), static_cast<int>(ys.size()) - 2);
+    float w = s - i;
+    return ys[i] + w*(ys[i+1] - ys[i]);
+  }
+};
+
+
+// 2D table of the inverse CDF v(p, u) in [0,1] of a pdf(v; p) defined on v in [0,1].
+//
+// Parameter p is log-spaced and u uniform; values are interpolated bilinearly.
+// p is clamped to the table range.
+struct InvCDFTable
+{
+  float pmin = 1.0f, pmax = 0.0f;
+  float lpmin = 0.0f, idp = 0.0f;
+  int np = 0, nu = 0;
+  std::vector<float> vs; // np x nu values
+
+  template<typename F>
+  void build(float pmin_in, float pmax_in, int np_in, int nu_in, F&& pdf, int nfine = 4096)
+  {
+    np = np_in;
+    nu = nu_in;
+    pmin  = pmin_in;
+    pmax  = pmax_in;
+    lpmin = std::log2(pmin);
+    idp   = static_cast<float>(np-1)/(std::log2(pmax) - lpmin);
+
+    vs.resize(np*nu);
+    std::vector<double> cdf;
+    for(int i=0; i<np; i++) {
+      cumulative(node(i), nfine, pdf, cdf);
+
+      // invert; cdf is piecewise linear between the fine nodes
+      int k = 0;
+      for(int j=0; j<nu; j++) {
+        double u = static_cast<double>(j)/(nu-1);
+        while(k < nfine-2 && cdf[k+1] < u) k++;
+        double dc = cdf[k+1] - cdf[k];
+        double w = dc > 0.0 ? std::min(1.0, std::max(0.0, (u - cdf[k])/dc)) : 0.0;
+        vs[i*nu + j] = static_cast<float>( (k + w)/(nfine-1) );
+      }
+    }
+  }
+
+  // normalized cumulative integral of pdf(v; p) on nfine uniform nodes in [0,1]
+  template<typename F>
+  static void cumulative(float p, int nfine, F&& pdf, std::vector<double>& cdf)
+  {
+    cdf.resize(nfine);
+    double dv = 1.0/(nfine-1);
+    double fprev = pdf(0.0, p);
+    cdf[0] = 0.0;
+    for(int k=1; k<nfine; k++) {
+      double f = pdf(k*dv, p);
+      cdf[k] = cdf[k-1] + 0.5*(f + fprev)*dv; // trapezoid
+      fprev = f;
+    }
+    for(int k=0; k<nfine; k++) cdf[k] /= cdf[nfine-1];
+  }
+
+  bool empty() const { return vs.empty(); }
+
+  // p of node i
+  float node(float i) const { return std::exp2(lpmin + i/idp); }
+
+  // inverse CDF at parameter p for a uniform random number u in [0,1[
+  float sample(float p, float u) const
+  {
+    p = std::min(std::max(p, pmin), pmax);
+    float sp = (fastlog2f(p) - lpmin)*idp;
+    int i = std::min( std::max(static_cast<int>(sp), 0), np - 2);
+    float wp = sp - i;
+
+    float su = u*(nu - 1);
+    int j = std::min( std::max(static_cast<int>(su), 0), nu - 2);
+    float wu = su - j;
+
+    const float* v0 = &vs[i*nu + j];
+    const float* v1 = v0 + nu;
+    float a = v0[0] + wu*(v0[1] - v0[0]);
+    float b = v1[0] + wu*(v1[1] - v1[0]);
+    return a + wp*(b - a);
+  }
+};
+
+
+//--------------------------------------------------
+// accuracy of the tables against the analytic functions
+
+// max relative error of the table at the geometric midpoints of the nodes
+template<typename F>
+float table_error(const LogTable& tab, F&& f)
+{
+  float err = 0.0f;
+  for(size_t i=0; i+1<tab.ys.size(); i++) {
+    float x = tab.node(i + 0.5f);
+    float fa = f(x);
+    if(fa == 0.0f) continue;
+    err = std::max(err, std::abs(tab(x) - fa)/std::abs(fa));
+  }
+  return err;
+}
+
+// max deviation |CDF(v(p,u)) - u| of the inverse CDF table; evaluated at the
+// midpoints of the nodes, i.e., where the interpolation error is largest
+template<typename F>
+float table_error(const InvCDFTable& tab, F&& pdf, int nfine = 4096)
+{
+  float err = 0.0f;
+  std::vector<double> cdf;
+  for(int i=0; i<tab.np-1; i++) {
+    float p = tab.node(i + 0.5f);
+    InvCDFTable::cumulative(p, nfine, pdf, cdf);
+
+    for(int j=0; j<tab.nu-1; j++) {
+      float u = (j + 0.5f)/(tab.nu - 1);
+      float v = tab.sample(p, u);
+
+      double s = v*(nfine - 1);
+      int k = std::min( static_cast<int>(s), nfine - 2);
+      double c = cdf[k] + (s - k)*(cdf[k+1] - cdf[k]);
+      err = std::max(err, static_cast<float>(std::abs(c - u)));
+    }
+  }
+  return err;
+}
+
+
+//--------------------------------------------------
+// angular distribution of pair annihilation and photon annihilation (F function)
+//
+// x is the cosine of the angle between the photon and the lepton in the CoM frame
+// and pcm = gcm*vcm the lepton CoM momentum. The tables are built in the rapidity
+// variable v in [0,1] with vcm*x = tanh( (2v - 1) atanh(vcm) ) so that the
+// strongly forward/backward peaked distribution of relativistic leptons is flat in v.
+
+// map v to the angle cosine x
+inline float ann_angle(float v, float pcm)
+{
+  float gcm = std::sqrt(1.0f + pcm*pcm);
+  float vcm = pcm/gcm;
+  if(vcm < 1.0e-4f) return 2.0f*v - 1.0f; // non-relativistic limit
+
+  return std::tanh( (2.0f*v - 1.0f)*std::asinh(pcm) )/vcm; // atanh(vcm) = asinh(pcm)
+}
+
+// pdf of v; F(x) dx/dv up to a constant
+inline double ann_angle_pdf(double v, float p)
+{
+  double pcm = p;
+  double g2  = 1.0 + pcm*pcm;
+  double vcm = pcm/std::sqrt(g2);
+  double vx  = vcm < 1.0e-4 ? vcm*(2.0*v - 1.0) : std::tanh( (2.0*v - 1.0)*std::asinh(pcm) );
+
+  double z1 = g2*(1.0 - vx);
+  double z2 = g2*(1.0 + vx);
+  double F = 0.5*( (z1/z2) + (z2/z1) + 2.0*( (1.0/z1) + (1.0/z2) ) - std::pow( (1.0/z1) + (1.0/z2), 2) );
+
+  return F*(1.0 - vx*vx);
+}
+
+
+} // end of namespace qed
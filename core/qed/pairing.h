@@ -3,21 +3,28 @@
 #include <algorithm>
 #include <string>
 #include <tuple>
-#include <random>
 #include <memory>
 #include <map>
 #include <functional>
 #include <cmath>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "definitions.h"
 #include "core/pic/tile.h"
 #include "tools/sample_arrays.h"
 #include "tools/linlogspace.h"
+#include "tools/rng.h"
 
 #define USE_INTERNAL_TIMER // comment this out to remove the profiler
-#include "external/timer/timer.h"
+#include "tools/perf_counters.h"
 
 #include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/dispatch.h"
+#include "core/qed/species.h"
+#include "core/qed/cell_bins.h"
 
 
 namespace qed {
@@ -30,8 +37,8 @@ namespace qed {
 
 // duplicate particle info into fresh variables
 inline auto duplicate_prtcl(
-    string t1, float ux1, float uy1, float uz1, float w1
-    ) -> std::tuple<string, float, float, float, float>
+    int t1, float ux1, float uy1, float uz1, float w1
+    ) -> std::tuple<int, float, float, float, float>
 {
   return {t1, ux1, uy1, uz1, w1};
 }
@@ -64,9 +71,6 @@ template<size_t D>
 class Pairing
 {
 private:
-  std::random_device rd;
-  std::mt19937 gen;
-  std::uniform_real_distribution<float> uni_dis;
 
   using InteractionPtr = std::shared_ptr<qed::Interaction>;
 
@@ -78,18 +82,45 @@ private:
 
 public:
 
-  Timer timer; // internal timer for profiling
+  /// profiling counter ids; registered in this order in the constructor
+  enum Counter : int {
+    c_twobody, c_onebody,
+    c_sort_ene, c_sort_cells, c_upd_cum_arr, c_comp_pmax, c_draw_proc, c_sample_prob, c_comp_cs, c_acc,
+    c_dupl_prtcl, c_interact, c_weight_funs,
+    c_add_sc_prtcl1, c_add_sc_prtcl2, c_add_prtcl1, c_add_prtcl2, c_del_parent1, c_del_parent2,
+    c_del, c_optical_depth, c_add_ems_prtcls, c_add_ann_prtcls, c_del_parent,
+    c_num_counters
+  };
+
+  static constexpr const char* counter_names[c_num_counters] = {
+    "twobody", "onebody",
+    "sort_ene", "sort_cells", "upd_cum_arr", "comp_pmax", "draw_proc", "sample_prob", "comp_cs", "acc",
+    "dupl_prtcl", "interact", "weight_funs",
+    "add_sc_prtcl1", "add_sc_prtcl2", "add_prtcl1", "add_prtcl2", "del_parent1", "del_parent2",
+    "del", "optical_depth", "add_ems_prtcls", "add_ann_prtcls", "del_parent",
+  };
+
+  /// internal counters for profiling; off by default
+  toolbox::PerfCounters counters;
 
   // constructor with incident/target types
-  Pairing() :
-    gen(42), // gen(rd() ) 
-    uni_dis(0.0, 1.0),
-    timer("qed pairing")
+  Pairing()
   { 
     update_hist_lims(hist_emin, hist_emax, hist_nbin);
 
-    timer.do_print = true;
-    timer.verbose = 0;
+    for(int i=0; i<c_num_counters; i++) {
+      [[maybe_unused]] const int id = counters.add_counter(counter_names[i]);
+      assert(id == i);
+    }
+    counters.enabled = false;
+  }
+
+  /// number of particles in tile; work measure of the solve_* counters
+  static size_t count_prtcls(pic::Tile<D>& tile)
+  {
+    size_t n = 0;
+    for(auto&& con : tile.containers) n += con.size();
+    return n;
   }
 
   //using Tile_map = std::unordered_map<TileID_t, Tileptr>;
@@ -110,6 +141,13 @@ public:
   // force e- e+ to have unit weights irrespective of weighting functions
   bool force_ep_uni_w = true; 
 
+  // edge length (in grid cells) of the pairing cells of the binary interactions;
+  // targets are sampled only inside the incident's cell. 0 pairs over the whole tile.
+  int cell_bin = 0;
+
+  // pairing cells of the tile being solved
+  PairingCells<D> cells;
+
   //--------------------------------------------------
   //histogram for the leaking/escaping photons
   double hist_emin = -4.0; // log10(emin)
@@ -183,22 +221,48 @@ public:
   std::vector<size_t> 
       ids;     // internal id of the interaction in the storage
 
-  std::map<std::string, double> info_max_int_cs; // maximum cross s measured
+  // indexed as binary_interactions
+  std::vector<double> info_max_int_cs; // maximum cross s measured
                  
-  std::map<std::string, double> info_int_nums; // number of interactions performed
+  std::vector<double> info_int_nums; // number of interactions performed
 
   //--------------------------------------------------
   //--------------------------------------------------
   //--------------------------------------------------
     
   // random numbers between [0, 1[
-  float rand() { return uni_dis(gen); };
+  float rand() { return toolbox::thread_stream().uniform(); };
+
+  // seed of the random streams; streams are keyed by (seed, tile, routine, species, lap)
+  // so every routine takes the lap explicitly; reusing a lap replays the same draws
+  uint64_t seed = 42;
+
+  // routines that draw random numbers; separate streams within a tile and lap
+  enum RngRoutine : uint64_t { 
+    rng_twobody = 0, 
+    rng_onebody, 
+    rng_rescale, 
+    rng_inject_ph, 
+    rng_inject_ep, 
+    rng_leak 
+  };
+
+  // key the random stream of the calling thread; also used by the interactions
+  void reset_stream(const pic::Tile<D>& tile, uint64_t routine, int lap, int species = sp_none)
+  {
+    const uint64_t slot = (routine << 8) | static_cast<uint64_t>(species + 1);
+    toolbox::thread_stream().reset(seed, toolbox::stream_id(tile.cid, slot, lap));
+  }
   
   // add interactions to internal memory of the class; 
   // done via pointers to handle pybind interface w/ python
   void add_interaction(InteractionPtr iptr)
   {
     assert(iptr); // check that we are not appending nullptr
+    assert(iptr->s1 != sp_none); // incident type must be known to the QED module (see species.h)
+
+    // precompute the lookup tables at solver setup
+    if(iptr->use_tables) iptr->build_tables();
 
     //-------------------------------------------------- 
     if( iptr->interaction_order == 1 ){ // single-body interactions
@@ -218,11 +282,12 @@ public:
       auto long_name = name + "_" + t1 + "_" + t2;
 
       //std::cout << " adding: " << name << " of t1/t2 " << t1 << " " << t2 << std::endl;
+      assert(iptr->s2 != sp_none);
       binary_interactions.push_back(iptr);
 
       // additionall arrays
-      info_max_int_cs[name] = 0.0;
-      info_int_nums[long_name] = 0.0;
+      info_max_int_cs.push_back(0.0);
+      info_int_nums.push_back(0.0);
     }
 
   }
@@ -230,20 +295,20 @@ public:
   //--------------------------------------------------
   // check if interaction list is empty for type t1
 
-  bool is_empty_single_int(string& t1) 
+  bool is_empty_single_int(int t1) 
   {
     int i=0;
-    for(auto iptr : single_interactions){
-      if(t1 == iptr->t1) i += 1;
+    for(auto& iptr : single_interactions){
+      if(t1 == iptr->s1) i += 1;
     }
     return (i > 0) ? false : true; 
   }
 
-  bool is_empty_binary_int(string& t1) 
+  bool is_empty_binary_int(int t1) 
   {
     int i=0;
-    for(auto iptr : binary_interactions){
-      if(t1 == iptr->t1) i += 1;
+    for(auto& iptr : binary_interactions){
+      if(t1 == iptr->s1) i += 1;
     }
     return (i > 0) ? false : true; 
   }
@@ -251,8 +316,8 @@ public:
 
   // compute maximum partial interaction rates for each process 
   // that LP of type t1 and energy of e1 can experience.
-  void comp_pmax(string t1, float e1, 
-                 std::map<std::string, pic::ParticleContainer<D>*>& cons)
+  // Targets are searched from the pairing cell if cell >= 0 and from the whole tile otherwise.
+  void comp_pmax(int t1, float e1, const SpeciesRegistry<D>& cons, int cell = -1)
   {
 
     //size_t n_ints = interactions.size(); // get number of interactions
@@ -273,16 +338,21 @@ public:
 
 
     size_t id = 0;
-    for(auto iptr : binary_interactions){
+    for(auto& iptr : binary_interactions){
 
-      if(t1 == iptr->t1)
+      if(t1 == iptr->s1)
       {
-        const auto& t2 = iptr->t2;      // get target
-        const auto  con_tar = cons[t2]; // target container
+        const int  t2 = iptr->s2;       // get target
+        const auto con_tar = cons[t2];  // target container
         //const size_t N2 = con_tar->size(); // total number of particles
 
-        // skip containers with zero targets
-        if(con_tar->eneArr.size() == 0) continue;
+        // skip missing containers and containers with zero targets
+        if(con_tar == nullptr || con_tar->eneArr.size() == 0) { id++; continue; }
+
+        // range of target indices; reverse energy sorted also inside the pairing cells
+        const size_t j0 = cell >= 0 ? cells.begin(t2, cell) : 0;
+        const size_t j1 = cell >= 0 ? cells.end(  t2, cell) : con_tar->eneArr.size();
+        if(j0 == j1) { id++; continue; }
 
         const float cross_max = iptr->cross_section; // maximum cross section (including x2 for head-on collisions)
 
@@ -291,7 +361,9 @@ public:
         // This assumption is valid in the limit of small time step dt << mean time between interactions
 
         //#find the min/max interaction energies and the corresponding array indices jmin/jmax
-        auto [emin, emax] = iptr->get_minmax_ene(t1, t2, e1);
+        auto [emin, emax] = dispatch_binary(*iptr, [&](auto& intr) { 
+            return intr.get_minmax_ene(t1, t2, e1); 
+            });
 
         //--------------------------------------------------
         // double counting prevention since we only consider targets with energy more than incident particle
@@ -328,8 +400,8 @@ public:
         //size_t jmax = toolbox::revfind_rev_sorted_nearest( con_tar->eneArr, emin );
 
         // profiled to be fastest
-        size_t jmin = toolbox::find_rev_sorted_nearest_algo2( con_tar->eneArr, emax );
-        size_t jmax = toolbox::find_rev_sorted_nearest_algo2( con_tar->eneArr, emin );
+        size_t jmin = toolbox::find_rev_sorted_nearest_algo2( con_tar->eneArr, emax, j0, j1 );
+        size_t jmax = toolbox::find_rev_sorted_nearest_algo2( con_tar->eneArr, emin, j0, j1 );
 
         //std::cout << " efirst last: " << con_tar->eneArr[0] << " " << con_tar->eneArr[N2] << std::endl;
         //std::cout << "jminjmax " << jmin << " " << jmin2 << " _ " << jmax << " " << jmax2 << " s " << con_tar->eneArr.size() << " e " << emax << " " << emin << std::endl;
@@ -359,26 +431,30 @@ public:
         if(! iptr->do_accumulate ){ // normal mode; no accumulation
 
           if(jmin < jmax) { // in the opposite case arrays dont span a range and so wsum2 = 0
-            float wsum_min = jmin == 0 ? 0.0f : con_tar->wgtCumArr[jmin];
+            float wsum_min = jmin == 0 ? 0.0f : con_tar->wgtCumArr[jmin-1];
             wsum2 = con_tar->wgtCumArr[jmax-1] - wsum_min;
           }
 
         //--------------------------------------------------
         } else { // accumulate interactions; effectively reduces weight
-          float wprev = jmin == 0 ? 0.0 : con_tar->wgtCumArr[jmin-1];
-          for(size_t j=jmin; j<jmax; j++) {
-            
-            // weight between [j-1, j]
-            //w = con_tar->wgt(j); // real weight
-            float w = con_tar->wgtCumArr[j] - wprev; // calc via cum array 
-            wprev = con_tar->wgtCumArr[j];
-
-            float e2 = con_tar->eneArr[j];
-            auto [f1,f2] = iptr->accumulate(t1, e1, t2, e2);
-            float f = f1*f2; //std::max(f1,f2);  // TODO is max ok here? or product?
-
-            wsum2 += w/f; 
-          }
+          wsum2 = dispatch_binary(*iptr, [&](auto& intr) {
+            float ws = 0.0f;
+            float wprev = jmin == 0 ? 0.0 : con_tar->wgtCumArr[jmin-1];
+            for(size_t j=jmin; j<jmax; j++) {
+              
+              // weight between [j-1, j]
+              //w = con_tar->wgt(j); // real weight
+              float w = con_tar->wgtCumArr[j] - wprev; // calc via cum array 
+              wprev = con_tar->wgtCumArr[j];
+
+              float e2 = con_tar->eneArr[j];
+              auto [f1,f2] = intr.accumulate(t1, e1, t2, e2);
+              float f = f1*f2; //std::max(f1,f2);  // TODO is max ok here? or product?
+
+              ws += w/f; 
+            }
+            return ws;
+          });
         }
 
         //--------------------------------------------------
@@ -503,25 +579,25 @@ public:
   //
   // value corresponds to number of particles (of type t) produced with given energy x
   // e.g., constant value means that every interactions splits the particle into that many pieces
-  float ene_weight_funs(std::string t, float x) 
+  float ene_weight_funs(int t, float x) 
   {
 
     // standard unit weights
-    //if(       t == "ph") { return 1.0; 
-    //} else if(t == "e-") { return 1.0; 
-    //} else if(t == "e+") { return 1.0; 
+    //if(       t == sp_ph) { return 1.0; 
+    //} else if(t == sp_em) { return 1.0; 
+    //} else if(t == sp_ep) { return 1.0; 
     //}
       
     //// photon emphasis
-    //if(       t == "ph") { return std::pow(x/0.01f, 0.1f); 
-    //} else if(t == "e-") { return 1.0; 
-    //} else if(t == "e+") { return 1.0; 
+    //if(       t == sp_ph) { return std::pow(x/0.01f, 0.1f); 
+    //} else if(t == sp_em) { return 1.0; 
+    //} else if(t == sp_ep) { return 1.0; 
     //}
 
     //// photon emphasis
-    if(       t == "ph") { return std::pow(x/0.01f, 0.04f); 
-    } else if(t == "e-") { return 1.0; 
-    } else if(t == "e+") { return 1.0; 
+    if(       t == sp_ph) { return std::pow(x/0.01f, 0.04f); 
+    } else if(t == sp_em) { return 1.0; 
+    } else if(t == sp_ep) { return 1.0; 
     }
 
     assert(false);
@@ -529,15 +605,16 @@ public:
 
 
   //--------------------------------------------------
-  void solve_twobody(pic::Tile<D>& tile)
+  void solve_twobody(pic::Tile<D>& tile, int lap)
   {
+    reset_stream(tile, rng_twobody, lap);
 
-    timer.start(); // start profiling block
+    counters.start(c_twobody); // start profiling block
+    const size_t nprtcls = count_prtcls(tile);
 
 
-    // build pointer map of types to containers; used as a helper to access particle tyeps
-    std::map<std::string, ConPtr> cons;
-    for(auto&& con : tile.containers) cons.emplace(con.type, &con );
+    // table of containers indexed by species id; used as a helper to access particle types
+    const SpeciesRegistry<D> cons(tile);
 
     //--------------------------------------------------
     // call pre-iteration functions to update internal arrays 
@@ -547,20 +624,25 @@ public:
 
     // keep this ordering; initialization of arrays assumes this way of calling the functions
     // NOTE: cannot move this inside the loop because particle removal assumes that indices remain static
-    timer.start_comp("sort_ene");
-    for(auto&& con : tile.containers) con.sort_in_rev_energy();
-    timer.stop_comp("sort_ene");
+    if(cell_bin > 0) {
+      counters.start(c_sort_cells);
+      cells.build(tile, cons, cell_bin); // reverse energy order inside the pairing cells
+      counters.stop(c_sort_cells);
+    } else {
+      counters.start(c_sort_ene);
+      for(auto&& con : tile.containers) con.sort_in_rev_energy();
+      counters.stop(c_sort_ene);
+    }
 
-    timer.start_comp("upd_cum_arr");
+    counters.start(c_upd_cum_arr);
     for(auto&& con : tile.containers) con.update_cumulative_arrays();
-    timer.stop_comp("upd_cum_arr");
+    counters.stop(c_upd_cum_arr);
 
     //--------------------------------------------------
     // collect statistics for bookkeeping
-    std::map<std::string, int> info_prtcl_num;
-    for(auto&& con : tile.containers) {
-      auto t1 = con.type;
-      info_prtcl_num[t1] = con.size();
+    std::array<int, n_species> info_prtcl_num;
+    for(int t1=0; t1<n_species; t1++) {
+      info_prtcl_num[t1] = cons[t1] ? cons[t1]->size() : 0;
     }
 
     const auto mins = tile.mins;
@@ -587,13 +669,16 @@ public:
     // ver1: ordered iteration over prtcls
     for(auto&& con1 : tile.containers) 
     {
-      auto t1 = con1.type;
+      const int t1 = species_id(con1.type);
+      if(t1 == sp_none) continue; // not a QED species
       if(is_empty_binary_int(t1)) continue; // no interactions with incident type t1
 
       //size_t Ntot1 = con1.size();
       size_t Ntot1 = info_prtcl_num[t1]; // read particle number from here; 
                                          // it changes adaptively and routines assume non-evolving arrays
 
+      size_t c1 = 0; // pairing cell of the incident
+
       // ver2
       // create randomized order for particle access
       //std::vector<size_t> inds(Ntot1);
@@ -608,6 +693,9 @@ public:
       for(size_t n1=0; n1<Ntot1; n1++) {
       //for(int n1=con1.size()-1; n1>=0; n1--) { // reverse iteration
 
+        // container is sorted by cell so the cell index only increases
+        if(cell_bin > 0) while(n1 >= cells.end(t1, c1)) c1++;
+
         //unpack incident 
         auto lx1 = con1.loc(0,n1);
         auto ly1 = con1.loc(1,n1);
@@ -623,9 +711,9 @@ public:
         if(w1 < EPS) continue; // omit zero-w incidents
 
         //pre-calculate maximum partial interaction rates
-        timer.start_comp("comp_pmax");
-        comp_pmax(t1, e1, cons); 
-        timer.stop_comp("comp_pmax");
+        counters.start(c_comp_pmax);
+        comp_pmax(t1, e1, cons, cell_bin > 0 ? static_cast<int>(c1) : -1); 
+        counters.stop(c_comp_pmax);
 
         if(ids.size() == 0) continue; // no targets to interact with 
 
@@ -644,8 +732,11 @@ public:
         //  //assert(false);
         //}
 
+        // target density is normalized to the volume of the pairing cell
+        const float norm = cell_bin > 0 ? prob_norm*cells.vfrac[c1] : prob_norm;
+
         // exponential waiting time between interactions
-        float t_free = -log( rand() )*prob_norm/(prob_vir_max*w1); //NOTE w1 here
+        float t_free = -log( rand() )*norm/(prob_vir_max*w1); //NOTE w1 here
                                                                     //
         //if( t_free > 1.0) {
         //if( true ) {
@@ -664,9 +755,9 @@ public:
         { 
           // get random interaction
           // NOTE: incident type t1 must be the same as what comp_pmax was called with
-          timer.start_comp("draw_proc");
+          counters.start(c_draw_proc);
           int i = draw_rand_proc(); // i:th interaction in probs array
-          timer.stop_comp("draw_proc");
+          counters.stop(c_draw_proc);
 
           // NOTE i = ids[i]; we do not factor this out because in theory ids array could change in size and then this is needed.
           
@@ -678,19 +769,19 @@ public:
           //auto wsum = wsums[i];
           //auto facc_max = faccs[i];
 
-          auto int_id = ids[i];                    // id in global array
-          auto iptr = binary_interactions[int_id]; // pointer to interaction 
-          auto t2   = iptr->t2;                    // target type
-          auto con2 = cons[t2];                    // target container
+          auto int_id = ids[i];                     // id in global array
+          auto& iptr = binary_interactions[int_id]; // pointer to interaction 
+          auto t2   = iptr->s2;                     // target type
+          auto con2 = cons[t2];                     // target container
 
           //--------------------------------------------------
           // get random target with energy between jmin/jmax
           // propability is proptional to weight of LPs
 
-          timer.start_comp("sample_prob");
+          counters.start(c_sample_prob);
           //size_t n2 = toolbox::sample_prob_between(     con2->wgtCumArr, rand(), jmin, jmax);
           size_t n2 = toolbox::sample_prob_between_algo(con2->wgtCumArr, rand(), jmin, jmax);
-          timer.stop_comp("sample_prob");
+          counters.stop(c_sample_prob);
 
           //std::cout << "n2/3" << n2 << " " << n3 << std::endl;
           //assert(n2 == n3);
@@ -834,31 +925,32 @@ public:
 #endif
           
           //--------------------------------------------------
+          // rest of the event is evaluated with the concrete interaction type
+          dispatch_binary(*iptr, [&](auto& intr) {
           
           // real probablity of interaction
-          timer.start_comp("comp_cs");
-          auto [cm, vrel] = iptr->comp_cross_section(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2 );
-          timer.stop_comp("comp_cs");
+          counters.start(c_comp_cs);
+          auto [cm, vrel] = intr.comp_cross_section(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2 );
+          counters.stop(c_comp_cs);
 
           // collect max cross section
-          float cm_cur = info_max_int_cs[iptr->name];
-          info_max_int_cs[iptr->name] = std::max( cm_cur, cm*vrel/2.0f);
+          info_max_int_cs[int_id] = std::max( info_max_int_cs[int_id], double(cm*vrel/2.0f) );
 
           // comparison of interaction to max interaction 
           float prob_vir = cm*vrel/(2.0*cmax);
 
           // correct average accumulation factor with the real value
-          timer.start_comp("acc");
-          auto [facc3, facc4] = iptr->accumulate(t1, e1, t2, e2);
-          facc3 = iptr->do_accumulate ? facc3 : 1.0f;
-          facc4 = iptr->do_accumulate ? facc4 : 1.0f;
-          timer.stop_comp("acc");
+          counters.start(c_acc);
+          auto [facc3, facc4] = intr.accumulate(t1, e1, t2, e2);
+          facc3 = intr.do_accumulate ? facc3 : 1.0f;
+          facc4 = intr.do_accumulate ? facc4 : 1.0f;
+          counters.stop(c_acc);
 
 
           // FIXME remove check if sure this works
           if(prob_vir >= 1.0){
             std::cout << " prob_vir > 1: " << prob_vir << std::endl;
-            std::cout << " int  " << iptr->name << std::endl;
+            std::cout << " int  " << intr.name << std::endl;
             std::cout << " cm   " << cm << std::endl;
             std::cout << " vrel " << vrel << std::endl;
             std::cout << " cmax " << cmax << std::endl;
@@ -870,23 +962,22 @@ public:
 
           if(rand() < prob_vir)  // check if this interaction is chosen among the sampled ones
           {
-            auto long_name = iptr->name + "_" + t1 + "_" + t2;
-            info_int_nums[long_name] += 1;
+            info_int_nums[int_id] += 1;
 
             // particle values after interaction
-            timer.start_comp("dupl_prtcl");
+            counters.start(c_dupl_prtcl);
             auto [t3, ux3, uy3, uz3, w3] = duplicate_prtcl(t1, ux1, uy1, uz1, w1);
             auto [t4, ux4, uy4, uz4, w4] = duplicate_prtcl(t2, ux2, uy2, uz2, w2);
-            timer.stop_comp("dupl_prtcl");
+            counters.stop(c_dupl_prtcl);
 
             // interact and udpate variables in-place
-            timer.start_comp("interact");
-            iptr->interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4 );
-            timer.stop_comp("interact");
+            counters.start(c_interact);
+            intr.interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4 );
+            counters.stop(c_interact);
 
             // new energies; NOTE: could use container.m to get the mass
-            float m3 = (t3 == "ph") ? 0.0f : 1.0f; // particle mass; zero if photon
-            float m4 = (t4 == "ph") ? 0.0f : 1.0f; // particle mass; zero if photon
+            float m3 = species_mass(t3); // particle mass; zero if photon
+            float m4 = species_mass(t4); // particle mass; zero if photon
             float e3 = std::sqrt( m3*m3 + ux3*ux3 + uy3*uy3 + uz3*uz3 );
             float e4 = std::sqrt( m4*m4 + ux4*ux4 + uy4*uy4 + uz4*uz4 );
 
@@ -895,10 +986,10 @@ public:
             //float fw4 = (e4/e2)*ene_weight_funs(t2, e2)/ene_weight_funs(t4, e4); 
 
             // more intuitive version (flipped)
-            timer.start_comp("weight_funs");
+            counters.start(c_weight_funs);
             float fw3 = ene_weight_funs(t3, e3)/ene_weight_funs(t1, e1);
             float fw4 = ene_weight_funs(t4, e4)/ene_weight_funs(t2, e2);
-            timer.stop_comp("weight_funs");
+            counters.stop(c_weight_funs);
 
             // limit explosive particle creation
             float n3 = std::min( fw3, 32.0f );
@@ -963,14 +1054,14 @@ public:
             if(t1 == t3 && t2 == t4) { // scattering interactions
 
               // t3
-              if(force_ep_uni_w && (t3 == "e-" || t3 == "e+") ){ 
+              if(force_ep_uni_w && is_lepton(t3) ){ 
                 w3 = 1.0f;
                 n3 = facc3*w1/w3; // remembering to increase prtcl num w/ facc
                 facc3 = 1.0f; // restore facc (since it is taken care of by n3)
               }
                 
               //4
-              if(force_ep_uni_w && (t4 == "e-" || t4 == "e+") ){
+              if(force_ep_uni_w && is_lepton(t4) ){
                 w4 = 1.0f;
                 n4 = facc4*w2/w4; // remembering to increase prtcl num w/ facc
                 facc4 = 1.0f; // restore facc
@@ -984,13 +1075,13 @@ public:
             } else { // annihilation interactions
                        
               // t3
-              if(force_ep_uni_w && (t3 == "e-" || t3 == "e+") ){
+              if(force_ep_uni_w && is_lepton(t3) ){
                 w3 = 1.0;
                 n3 = wmin/w3;
               }
 
               // t4
-              if(force_ep_uni_w && ( t4 == "e-" || t4 == "e+") ){
+              if(force_ep_uni_w && is_lepton(t4) ){
                 w4 = 1.0;
                 n4 = wmin/w4;
               }
@@ -1066,7 +1157,7 @@ public:
               assert(prob_upd4 >= 0.0f);
 
 
-              timer.start_comp("add_sc_prtcl1");
+              counters.start(c_add_sc_prtcl1);
               double z1 = rand();
               while(n3 > z1 + ncop) {
 
@@ -1112,15 +1203,15 @@ public:
 
                 ncop += 1.0;
               } // end of while
-              timer.stop_comp("add_sc_prtcl1");
+              counters.stop(c_add_sc_prtcl1);
 
-              timer.start_comp("del_parent1");
+              counters.start(c_del_parent1);
               // remove parent prtcl if nothing was added
               if( ncop < EPS ) {
                 cons[t1]->to_other_tiles.push_back( {1,1,1,n1} ); // NOTE: CPU version
                 cons[t1]->wgt(n1) = 0.0f; // make zero wgt so its omitted from loop
               }
-              timer.stop_comp("del_parent1");
+              counters.stop(c_del_parent1);
 
             //--------------------------------------------------
             } else { //# different before/after type; kill parent with a prob_upd
@@ -1134,22 +1225,22 @@ public:
               // TODO are these independent or same draw for prob_kill3
               // i.e., kill parent and create copies or let parent live and no copies?
 
-              timer.start_comp("add_prtcl1");
+              counters.start(c_add_prtcl1);
               double z1 = rand();
               while( n3 > z1 + ncop ){
                 // TODO NOTE lx3 here not lx1
                 cons[t3]->add_particle( {{lx3, ly3, lz3}}, {{ux3, uy3, uz3}}, w3); // new ene & w
                 ncop += 1.0;
               }
-              timer.stop_comp("add_prtcl1");
+              counters.stop(c_add_prtcl1);
 
-              timer.start_comp("del_parent1");
+              counters.start(c_del_parent1);
               // kill parent
               if( prob_kill3 > rand() ) {
                 cons[t1]->to_other_tiles.push_back( {1,1,1,n1} ); // NOTE: CPU version
                 cons[t1]->wgt(n1) = 0.0f; // make zero wgt so its omitted from loop
               }
-              timer.stop_comp("del_parent1");
+              counters.stop(c_del_parent1);
 
             } // end of prtcl t1/t3 addition
 
@@ -1163,7 +1254,7 @@ public:
 
               // scattering interactions go here
 
-              timer.start_comp("add_sc_prtcl2");
+              counters.start(c_add_sc_prtcl2);
               double z1 = rand();
               while(n4 > z1 + ncop) {
 
@@ -1189,22 +1280,22 @@ public:
 
                 ncop += 1.0;
               } // end of while
-              timer.stop_comp("add_sc_prtcl2");
+              counters.stop(c_add_sc_prtcl2);
 
-              timer.start_comp("del_parent2");
+              counters.start(c_del_parent2);
               // remove parent prtcl if nothing was added
               if( ncop < EPS ) {
                 cons[t2]->to_other_tiles.push_back( {1,1,1,n2} ); // NOTE: CPU version
                 cons[t2]->wgt(n2) = 0.0f; // make zero wgt so its omitted from loop
               }
-              timer.stop_comp("del_parent2");
+              counters.stop(c_del_parent2);
 
             //--------------------------------------------------
             } else { //# different before/after type; kill parent with a prob_upd
                        
               // annihilation interactions go her
                 
-              timer.start_comp("add_prtcl2");
+              counters.start(c_add_prtcl2);
               double z1 = rand();
               while( n4 > z1 + ncop ){
                 //cons[t4]->add_particle( {{lx2, ly2, lz2}}, {{ux4, uy4, uz4}}, w4); // new ene & w
@@ -1212,20 +1303,21 @@ public:
                 cons[t4]->add_particle( {{lx4, ly4, lz4}}, {{ux4, uy4, uz4}}, w4); // new ene & w
                 ncop += 1.0;
               }
-              timer.stop_comp("add_prtcl2");
+              counters.stop(c_add_prtcl2);
 
-              timer.start_comp("del_parent2");
+              counters.start(c_del_parent2);
               // kill parent
               if( prob_kill4 > rand() ) {
                 cons[t2]->to_other_tiles.push_back( {1,1,1,n2} ); // NOTE: CPU version
                 cons[t2]->wgt(n2) = 0.0f; // make zero wgt so its omitted from loop
               }
-              timer.stop_comp("del_parent2");
+              counters.stop(c_del_parent2);
 
             } // end of prtcl t1/t3 addition
 
             //-------------------------------------------------- 
           }
+          }); // end of dispatch
         }
       } // end of loop over con1 particles
       //}, con.size(), con);
@@ -1235,63 +1327,62 @@ public:
 
     //--------------------------------------------------
     // info for bookkeeping
-    for(auto&& con : tile.containers) {
-      auto t1 = con.type;
-      info_prtcl_num[t1] = con.size() - info_prtcl_num[t1]; // change in prtcl num
+    for(int t1=0; t1<n_species; t1++) {
+      if(cons[t1]) info_prtcl_num[t1] = cons[t1]->size() - info_prtcl_num[t1]; // change in prtcl num
     }
 
 
     // calculate how many will be killed
-    std::map<std::string, int> info_prtcl_kill;
-    for(auto&& con : tile.containers) {
-      auto t1 = con.type;
-      info_prtcl_kill[t1] = cons[t1]->to_other_tiles.size();
+    std::array<int, n_species> info_prtcl_kill;
+    for(int t1=0; t1<n_species; t1++) {
+      info_prtcl_kill[t1] = cons[t1] ? cons[t1]->to_other_tiles.size() : 0;
     }
 
 
     // print
     //std::cout << "-------prtcl statistics----------\n";
-    //for(auto const& [key, val] : info_prtcl_num){
-    //  int n_kill = info_prtcl_kill[key];
-    //  std::cout << "    " << key << " Delta N_p: " << val << " N_kill: " << n_kill << std::endl;
+    //for(int t1=0; t1<n_species; t1++){
+    //  std::cout << "    " << species_name(t1) << " Delta N_p: " << info_prtcl_num[t1] << " N_kill: " << info_prtcl_kill[t1] << std::endl;
     //}
 
-    //int n_tot = info_prtcl_num["ph"] - (info_prtcl_kill["e-"] + info_prtcl_kill["e+"]);
+    //int n_tot = info_prtcl_num[sp_ph] - (info_prtcl_kill[sp_em] + info_prtcl_kill[sp_ep]);
     //assert(n_tot == 0);
 
     //--------------------------------------------------
     //std::cout << " max cross sections:" << std::endl;
-    //for(auto const& [key, val] : info_max_int_cs) std::cout << "   " << key << " : " << val << std::endl;
+    //for(size_t i=0; i<binary_interactions.size(); i++) std::cout << "   " << binary_interactions[i]->name << " : " << info_max_int_cs[i] << std::endl;
       
     //--------------------------------------------------
     //std::cout << " interaction evaluations:" << std::endl;
-    //for(auto const& [key, val] : info_int_nums) std::cout << "   " << key << " : " << val << std::endl;
+    //for(size_t i=0; i<binary_interactions.size(); i++) std::cout << "   " << binary_interactions[i]->name << " : " << info_int_nums[i] << std::endl;
 
     //--------------------------------------------------
     // final book keeping routines
-    timer.start_comp("del");
+    counters.start(c_del);
     for(auto&& con : tile.containers)
     {
       con.delete_transferred_particles(); // remove annihilated prtcls; this transfer storage 
                                           // is used as a tmp container for storing the indices
     }
-    timer.stop_comp("del");
+    counters.stop(c_del);
 
 
-    timer.stop();
+    counters.stop(c_twobody, nprtcls);
     return;
   }
 
 
   //--------------------------------------------------
   // one-body single particle interactions
-  void solve_onebody(pic::Tile<D>& tile)
+  void solve_onebody(pic::Tile<D>& tile, int lap)
   {
-    timer.start(); // start profiling block
+    reset_stream(tile, rng_onebody, lap);
 
-    // build pointer map of types to containers; used as a helper to access particle tyeps
-    std::map<std::string, ConPtr> cons;
-    for(auto&& con : tile.containers) cons.emplace(con.type, &con );
+    counters.start(c_onebody); // start profiling block
+    const size_t nprtcls = count_prtcls(tile);
+
+    // table of containers indexed by species id; used as a helper to access particle types
+    const SpeciesRegistry<D> cons(tile);
 
     //--------------------------------------------------
     // call pre-iteration functions to update internal arrays 
@@ -1302,10 +1393,9 @@ public:
 
     //--------------------------------------------------
     // collect statistics for bookkeeping
-    std::map<std::string, int> info_prtcl_num;
-    for(auto&& con : tile.containers) {
-      auto t1 = con.type;
-      info_prtcl_num[t1] = con.size();
+    std::array<int, n_species> info_prtcl_num;
+    for(int t1=0; t1<n_species; t1++) {
+      info_prtcl_num[t1] = cons[t1] ? cons[t1]->size() : 0;
     }
 
     const auto mins = tile.mins;
@@ -1316,14 +1406,14 @@ public:
     //--------------------------------------------------
     // initialize temp variable storages
     float ux4, uy4, uz4, w4=0.0; // empty particle created in p1 -> p3 + p4 splitting
-    std::string t4;  // type variable for secondary prtcl;
+    int t4 = sp_none;  // type variable for secondary prtcl;
 
 
     // ver1: ordered iteration over prtcls
     for(auto&& con1 : tile.containers) 
     {
-      auto t1 = con1.type;
-
+      const int t1 = species_id(con1.type);
+      if(t1 == sp_none) continue; // not a QED species
       if(is_empty_single_int(t1)) continue; // no interactions with incident type t1
 
 
@@ -1333,17 +1423,18 @@ public:
       //      in a more general case, we could use the same virtual channel as in binary interactions
 
       size_t id = 0;
-      for(auto iptr : single_interactions)
+      for(auto& iptr : single_interactions)
       {
-        if(t1 == iptr->t1) break; // assume only one target
+        if(t1 == iptr->s1) break; // assume only one target
         id += 1;
       }
-      auto iptr = single_interactions[id]; // interaction
+      auto& iptr = single_interactions[id]; // interaction
 
 
       //--------------------------------------------------
-      // loop over 
+      // loop over; kernel is compiled separately for each interaction type
       size_t Ntot1 = info_prtcl_num[t1]; // read particle number 
+      dispatch_single(*iptr, [&](auto& intr) {
       for(size_t n1=0; n1<Ntot1; n1++) {
 
         //unpack incident 
@@ -1360,7 +1451,7 @@ public:
 
         if(w1 < EPS) continue; // omit zero-w incidents
 
-        const auto [emin, emax] = iptr->get_minmax_ene(t1, "", e1);
+        const auto [emin, emax] = intr.get_minmax_ene(t1, sp_none, e1);
 
         //std::cout << "emin/emax " << e1 << " " << emin << " " << emax << "\n";
 
@@ -1405,13 +1496,13 @@ public:
 
         // local optical depth; 
         // NOTE: em field is stored during this call and does not need to be called again in interact()
-        timer.start_comp("optical_depth");
-        const float tau_int = iptr->comp_optical_depth(
+        counters.start(c_optical_depth);
+        const float tau_int = intr.comp_optical_depth(
                                   t1, 
                                   ux1, uy1, uz1, 
                                   ex, ey, ez, 
                                   bx, by, bz);
-        timer.stop_comp("optical_depth");
+        counters.stop(c_optical_depth);
 
         // exponential waiting time between interactions
         const float t_free = -log( rand() )*prob_norm_onebody/tau_int; //NOTE w1 here
@@ -1424,21 +1515,21 @@ public:
           // particle values after interaction
           auto [t3, ux3, uy3, uz3, w3] = duplicate_prtcl(t1, ux1, uy1, uz1, w1);
 
-          timer.start_comp("interact");
-          iptr->interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4);
-          timer.stop_comp("interact");
+          counters.start(c_interact);
+          intr.interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4);
+          counters.stop(c_interact);
 
           // new energies; NOTE: could use container.m to get the mass
-          const float m3 = (t3 == "ph") ? 0.0f : 1.0f; // particle mass; zero if photon
-          const float m4 = (t4 == "ph") ? 0.0f : 1.0f; // particle mass; zero if photon
+          const float m3 = species_mass(t3); // particle mass; zero if photon
+          const float m4 = species_mass(t4); // particle mass; zero if photon
           const float e3 = std::sqrt( m3*m3 + ux3*ux3 + uy3*uy3 + uz3*uz3 );
           const float e4 = std::sqrt( m4*m4 + ux4*ux4 + uy4*uy4 + uz4*uz4 );
 
-          timer.start_comp("weight_funs");
+          counters.start(c_weight_funs);
           // NOTE both are compared to the same parent t1 
           float fw3 = ene_weight_funs(t3, e3)/ene_weight_funs(t1, e1); // possible re-weighting of the parent particle 
           float fw4 = ene_weight_funs(t4, e4)/ene_weight_funs(t1, e1); // re-weighting of the secondary particle 
-          timer.stop_comp("weight_funs");
+          counters.stop(c_weight_funs);
 
           // limit explosive particle creation
           float n3 = std::min( fw3, 32.0f );
@@ -1451,11 +1542,11 @@ public:
           //       the probability of the process is reduced and the process itself never occurs if accumulated.
           //       The way accumulation is done here is better for pruning the low-energy synchrotorn photons.
 
-          timer.start_comp("acc");
-          auto [facc3, facc4] = iptr->accumulate(t3, e3, t4, e4); // updated parent and emitted prtcl
-          facc3 = iptr->do_accumulate ? facc3 : 1.0f;
-          facc4 = iptr->do_accumulate ? facc4 : 1.0f;
-          timer.stop_comp("acc");
+          counters.start(c_acc);
+          auto [facc3, facc4] = intr.accumulate(t3, e3, t4, e4); // updated parent and emitted prtcl
+          facc3 = intr.do_accumulate ? facc3 : 1.0f;
+          facc4 = intr.do_accumulate ? facc4 : 1.0f;
+          counters.stop(c_acc);
 
           //n3 = n4/facc3; // NOTE never modify the parent; could be implemented but then need to change also the 
                            //      parent update below.
@@ -1479,30 +1570,30 @@ public:
             //      needs re-updating.
 
             // add prtcl 4
-            timer.start_comp("add_ems_prtcls");
+            counters.start(c_add_ems_prtcls);
             float ncop = 0.0;
             float z1 = rand();
             while(n4 > z1 + ncop) {
               cons[t4]->add_particle( {{lx1, ly1, lz1}}, {{ux4, uy4, uz4}}, w4); 
               ncop += 1.0;
             }
-            timer.stop_comp("add_ems_prtcls");
+            counters.stop(c_add_ems_prtcls);
 
           //--------------------------------------------------
           } else { // single-body annihilation into t3 and t4 pair
 
-              if(force_ep_uni_w && (t3 == "e-" || t3 == "e+") ){ 
+              if(force_ep_uni_w && is_lepton(t3) ){ 
                 w3 = 1.0f;
                 n3 = w1/w3; // remembering to increase prtcl num w/ facc
               }
 
-              if(force_ep_uni_w && (t4 == "e-" || t4 == "e+") ){
+              if(force_ep_uni_w && is_lepton(t4) ){
                 w4 = 1.0f;
                 n4 = w1/w4; // NOTE w1 here since parent is same for both t3 and t4
               }
 
               // add new particle t3 and t4; particles are assumed to be identical
-              timer.start_comp("add_ann_prtcls");
+              counters.start(c_add_ann_prtcls);
               float ncop = 0.0;
               float z1 = rand();
               while(n4 > z1 + ncop) {
@@ -1510,32 +1601,33 @@ public:
                 cons[t4]->add_particle( {{lx1, ly1, lz1}}, {{ux4, uy4, uz4}}, w4); 
                 ncop += 1.0;
               }
-              timer.stop_comp("add_ann_prtcls");
+              counters.stop(c_add_ann_prtcls);
 
               // remove old parent particle t1
-              timer.start_comp("del_parent");
+              counters.start(c_del_parent);
               cons[t1]->to_other_tiles.push_back( {1,1,1,n1} ); // NOTE: CPU version
               cons[t1]->wgt(n1) = 0.0f; // make zero wgt so its omitted from loop
-              timer.stop_comp("del_parent");
+              counters.stop(c_del_parent);
           }
 
         } // if interact
       } // end over n1 prtcl loop
+      }); // end of dispatch
     } // end of con1 loop
 
 
     //--------------------------------------------------
       
-    timer.start_comp("del");
+    counters.start(c_del);
     for(auto&& con : tile.containers)
     {
       con.delete_transferred_particles(); // remove annihilated prtcls; this transfer storage 
                                           // is used as a tmp container for storing the indices
     }
-    timer.stop_comp("del");
+    counters.stop(c_del);
 
 
-    timer.stop(); // start profiling block
+    counters.stop(c_onebody, nprtcls); // end of profiling block
   }
 
 
@@ -1543,8 +1635,9 @@ public:
 
   //--------------------------------------------------
   // normalize container of type t1
-  void rescale(pic::Tile<D>& tile, string& t1, double f_kill)
+  void rescale(pic::Tile<D>& tile, string& t1, double f_kill, int lap)
   {
+    reset_stream(tile, rng_rescale, lap, species_id(t1));
 
     // build pointer map of types to containers; used as a helper to access particle tyeps
     std::map<std::string, ConPtr> cons;
@@ -1586,8 +1679,11 @@ public:
   void inject_photons(pic::Tile<D>& tile, 
       float temp_inj, 
       float wph_inj,
-      float Nph_inj) 
+      float Nph_inj,
+      int lap) 
   {
+    reset_stream(tile, rng_inject_ph, lap);
+
     std::map<std::string, ConPtr> cons;
     for(auto&& con : tile.containers) cons.emplace(con.type, &con );
 
@@ -1667,8 +1763,10 @@ public:
       float pmin,
       float pmax,
       float w_inj,
-      float N_inj) 
+      float N_inj,
+      int lap) 
   {
+    reset_stream(tile, rng_inject_ep, lap);
 
     //const float pmin = 10.0f;
     //const float pmax = 100.0f;
@@ -1803,9 +1901,11 @@ public:
   void leak_photons(
       pic::Tile<D>& tile, 
       double tc_per_dt,
-      double tau_ext
+      double tau_ext,
+      int lap
       )
   {
+    reset_stream(tile, rng_leak, lap);
 
     // build pointer map of types to containers; used as a helper to access particle tyeps
     std::map<std::string, ConPtr> cons;
@@ -1895,6 +1995,82 @@ public:
   }
 
 
+  //--------------------------------------------------
+  // tile-parallel solve
+
+  // zero the statistics that the solve routines accumulate; tau_global is an input of
+  // leak_photons and is kept
+  void clear_stats()
+  {
+    clear_hist();
+    std::fill(info_max_int_cs.begin(), info_max_int_cs.end(), 0.0);
+    std::fill(info_int_nums.begin(),   info_int_nums.end(),   0.0);
+    counters.clear();
+  }
+
+  // add the statistics of a (cleared) copy of this object
+  void merge_stats(const Pairing& other)
+  {
+    for(int i=0; i<hist_nbin; i++) hist[i] += other.hist[i];
+
+    leaked_ene  += other.leaked_ene;
+    leaked_wsum += other.leaked_wsum;
+    leaked_pnum += other.leaked_pnum;
+    inj_ene_ph  += other.inj_ene_ph;
+    inj_ene_ep  += other.inj_ene_ep;
+
+    for(size_t i=0; i<info_int_nums.size(); i++) {
+      info_max_int_cs[i] = std::max(info_max_int_cs[i], other.info_max_int_cs[i]);
+      info_int_nums[i]  += other.info_int_nums[i];
+    }
+
+    counters.merge(other.counters);
+  }
+
+  // Solve the binary and single-body interactions (and the photon escape if tc_per_dt > 0)
+  // of many tiles concurrently.
+  //
+  // Every thread solves whole tiles with a private copy of this object; i.e., with private
+  // scratch arrays, pairing cells, statistics, histogram, and single-body interactions.
+  // Random streams are keyed by tile, so the result equals calling the routines tile by tile.
+  // A tile is only touched by the thread solving it, so new particles are added directly to
+  // its containers. Statistics of the copies are merged into this object at the end.
+  //
+  // Interactions defined in python are not thread safe; tiles are then solved serially.
+  void solve_tiles(
+      std::vector<pic::Tile<D>*>& tiles, 
+      int lap,
+      double tc_per_dt = 0.0,
+      double tau_ext = 0.0)
+  {
+    bool threaded = true;
+    for(auto& iptr : single_interactions) if(iptr->kind == InteractionKind::generic) threaded = false;
+    for(auto& iptr : binary_interactions) if(iptr->kind == InteractionKind::generic) threaded = false;
+
+#ifdef _OPENMP
+    counters.reserve_threads(omp_get_max_threads()); // copies need the same counter layout
+#endif
+
+    #pragma omp parallel if(threaded)
+    {
+      Pairing<D> worker(*this);
+      worker.clear_stats();
+      for(auto& iptr : worker.single_interactions) iptr = clone_single(iptr);
+
+      #pragma omp for schedule(dynamic, 1)
+      for(size_t i=0; i<tiles.size(); i++) {
+        auto& tile = *tiles[i];
+        if(!binary_interactions.empty()) worker.solve_twobody(tile, lap);
+        if(!single_interactions.empty()) worker.solve_onebody(tile, lap);
+        if(tc_per_dt > 0.0) worker.leak_photons(tile, tc_per_dt, tau_ext, lap);
+      }
+
+      #pragma omp critical
+      merge_stats(worker);
+    }
+  }
+
+
 };
 
 
@@ -3,7 +3,6 @@
 #include <algorithm>
 #include <string>
 #include <tuple>
-#include <random>
 #include <memory>
 #include <map>
 #include <functional>
@@ -13,8 +12,12 @@
 #include "core/pic/tile.h"
 #include "tools/sample_arrays.h"
 #include "tools/linlogspace.h"
+#include "tools/rng.h"
 
 #include "core/qed/interactions/interaction.h"
+#include "core/qed/interactions/dispatch.h"
+#include "core/qed/species.h"
+#include "core/qed/cell_bins.h"
 
 
 namespace qed {
@@ -39,9 +42,6 @@ template<size_t D>
 class PairingAll2All
 {
 private:
-  std::random_device rd;
-  std::mt19937 gen;
-  std::uniform_real_distribution<float> uni_dis;
 
   using InteractionPtr = std::shared_ptr<qed::Interaction>;
 
@@ -54,9 +54,7 @@ private:
 public:
 
   // constructor with incident/target types
-  PairingAll2All() :
-    gen(42), // gen(rd() ) 
-    uni_dis(0.0, 1.0)
+  PairingAll2All()
   { 
     update_hist_lims(hist_emin, hist_emax, hist_nbin);
   }
@@ -79,6 +77,13 @@ public:
   // force e- e+ to have unit weights irrespective of weighting functions
   bool force_ep_uni_w = true; 
 
+  // edge length (in grid cells) of the pairing cells; only particles in the same
+  // cell are compared. 0 compares all particles of the tile.
+  int cell_bin = 0;
+
+  // pairing cells of the tile being solved
+  PairingCells<D> cells;
+
   //--------------------------------------------------
   //histogram for the leaking/escaping photons
   double hist_emin = -4.0; // log10(emin)
@@ -142,7 +147,28 @@ public:
   //--------------------------------------------------
     
   // random numbers between [0, 1[
-  float rand() { return uni_dis(gen); };
+  float rand() { return toolbox::thread_stream().uniform(); };
+
+  // seed of the random streams; streams are keyed by (seed, tile, routine, species, lap)
+  // so every routine takes the lap explicitly; reusing a lap replays the same draws
+  uint64_t seed = 42;
+
+  // routines that draw random numbers; separate streams within a tile and lap
+  enum RngRoutine : uint64_t { 
+    rng_twobody = 0, 
+    rng_onebody, 
+    rng_rescale, 
+    rng_inject_ph, 
+    rng_inject_ep, 
+    rng_leak 
+  };
+
+  // key the random stream of the calling thread; also used by the interactions
+  void reset_stream(const pic::Tile<D>& tile, uint64_t routine, int lap, int species = sp_none)
+  {
+    const uint64_t slot = (routine << 8) | static_cast<uint64_t>(species + 1);
+    toolbox::thread_stream().reset(seed, toolbox::stream_id(tile.cid, slot, lap));
+  }
   
   // add interactions to internal memory of the class; 
   // done via pointers to handle pybind interface w/ python
@@ -150,6 +176,9 @@ public:
   {
     assert(iptr); // check that we are not appending nullptr
 
+    // precompute the lookup tables at solver setup
+    if(iptr->use_tables) iptr->build_tables();
+
     //-------------------------------------------------- 
     if( iptr->interaction_order == 1 ){ // single-body interactions
                                         
@@ -187,19 +216,19 @@ public:
   //  return (i > 0) ? false : true; 
   //}
 
-  bool is_empty_binary_int(string& t1) 
+  bool is_empty_binary_int(int t1) 
   {
     int i=0;
-    for(auto iptr : binary_interactions){
-      if(t1 == iptr->t1) i += 1;
+    for(auto& iptr : binary_interactions){
+      if(t1 == iptr->s1) i += 1;
     }
     return (i > 0) ? false : true; 
   }
 
   // duplicate particle info into fresh variables
   inline auto duplicate_prtcl(
-      string t1, float ux1, float uy1, float uz1, float w1
-      ) -> std::tuple<string, float, float, float, float>
+      int t1, float ux1, float uy1, float uz1, float w1
+      ) -> std::tuple<int, float, float, float, float>
   {
     return {t1, ux1, uy1, uz1, w1};
   }
@@ -208,174 +237,183 @@ public:
   //--------------------------------------------------
   //all-to-all binary comparison of particles and all processes
   // NOTE: this is very expensive...
-  void solve_twobody(pic::Tile<D>& tile)
+  void solve_twobody(pic::Tile<D>& tile, int lap)
   {
+    reset_stream(tile, rng_twobody, lap);
+
       
-    // build pointer map of types to containers; used as a helper to access particle tyeps
-    std::map<std::string, ConPtr> cons;
-    for(auto&& con : tile.containers) cons.emplace(con.type, &con );
+    // table of containers indexed by species id; used as a helper to access particle types
+    const SpeciesRegistry<D> cons(tile);
 
     //--------------------------------------------------
     // call pre-iteration functions to update internal arrays 
+    const bool binned = cell_bin > 0;
     for(auto&& con : tile.containers)
     {
-      con.sort_in_rev_energy();
+      if(!binned) con.sort_in_rev_energy();
       //con.update_cumulative_arrays();
       con.to_other_tiles.clear(); // empty tmp container; we store killed particles here
     }
 
+    // reverse energy order inside the pairing cells
+    if(binned) cells.build(tile, cons, cell_bin);
+
     //--------------------------------------------------
     // loop over interactions
-    for(auto iptr : binary_interactions){
+    for(auto& iptr : binary_interactions){
 
-      //--------------------------------------------------
-      // loop over incident types
-      for(auto&& con1 : tile.containers)
-      {
-        auto t1 = con1.type;
-        if(is_empty_binary_int(t1)) continue; // no interactions with incident type t1
-
-        //std::cout << "container type:" << t1 << std::endl;
-
-        // loop over target types
-        for(auto&& con2 : tile.containers)
-        {
-          auto t2 = con2.type;
-
-          // do type matching of containers and interactions
-          if( (t1 == iptr->t1) && (t2 == iptr->t2) ){
-
-            // loop over incident particles
-            //UniIter::iterate([=] DEVCALLABLE (
-            //          size_t n, 
-            //          pic::ParticleContainer<D>& con
-            //          ){
-            //for(int n1=con1.size()-1; n1>=0; n1--) {
-            for(size_t n1=0; n1<con1.size(); n1++) { 
-
-              // loop over targets
-              //for(int n2=con2.size()-1; n2>=0; n2--) {
-              for(size_t n2=0; n2<con2.size(); n2++) { 
-
-                // NOTE: incident needs to be unpacked in the innermost loop, since 
-                // some interactions modify its value during the iteration
-                  
-                //unpack incident 
-                auto lx1 = con1.loc(0,n1);
-                auto ly1 = con1.loc(1,n1);
-                auto lz1 = con1.loc(2,n1);
-
-                auto ux1 = con1.vel(0,n1);
-                auto uy1 = con1.vel(1,n1);
-                auto uz1 = con1.vel(2,n1);
-                auto w1  = con1.wgt(n1);
-
-                //e1  = con1.eneArr[n1]; 
-                //auto e1  = con1.get_prtcl_ene(n1);
-
-                if(w1 < EPS) continue; // omit zero-w incidents
-
-                // unpack target
-                auto lx2 = con2.loc(0,n2);
-                auto ly2 = con2.loc(1,n2);
-                auto lz2 = con2.loc(2,n2);
-
-                auto ux2 = con2.vel(0,n2);
-                auto uy2 = con2.vel(1,n2);
-                auto uz2 = con2.vel(2,n2);
-                auto w2  = con2.wgt(  n2);
-
-                //auto e2 = con2.get_prtcl_ene(n2);
-
-                if(w2 < EPS) continue; // omit zero-w targets
-                                         
-
-                //--------------------------------------------------
-                //avoid double counting by considering only e1 < e2 cases
-                //if(e1 > e2) continue;
-
-                // interaction cross section
-                auto [cm, vrel] = iptr->comp_cross_section(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2 );
-                
-                // interaction probability
-                //auto wmin = min(w1, w2);
-                auto wmax = max(w1, w2);
-                auto prob = cm*vrel*w1*w2;
-                // NOTE: difference of all2all scheme is here where prob depends on w1*w2
-
-                // exponential waiting time between interactions
-                float t_free = -log( rand() )*prob_norm/prob;
-
-                //-------------------------------------------------- 
-                if(t_free < 1.0){
-
-                  // particle values after interaction
-                  auto [t3, ux3, uy3, uz3, w3] = duplicate_prtcl(t1, ux1, uy1, uz1, w1);
-                  auto [t4, ux4, uy4, uz4, w4] = duplicate_prtcl(t2, ux2, uy2, uz2, w2);
-
-                  // interact and udpate variables in-place
-                  iptr->interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4);
-
-                  auto p_ini = w2/wmax;
-                  auto p_tar = w1/wmax;
-
-                  //std::cout << " interacting:" << prob << " pini/tar" << p_ini << " " << p_tar << std::endl;
-
-                  //-------------------------------------------------- 
-                  if(rand() < p_ini){
-                    if(t1 == t3){ // if type is conserved only update the prtcl info
-                                    
-                      // NOTE: we keep location the same
-                      con1.vel(0,n1) = ux3;
-                      con1.vel(1,n1) = uy3;
-                      con1.vel(2,n1) = uz3;
-                    } else { // else destroy previous and add new 
-
-                      // destroy current
-                      con1.to_other_tiles.push_back( {1,1,1,n1} ); // NOTE: CPU version
-                      con1.wgt(n1) = 0.0f; // make zero wgt so its omitted from loop
-
-                      // add new
-                      cons[t3]->add_particle( {{lx1, ly1, lz1}}, {{ux3, uy3, uz3}}, w1);
-
-                      //std::cout << "killing t1" << t1 << std::endl;
-                      //std::cout << "adding t3" << t3 << std::endl;
-                    }
-                  }
-                  //-------------------------------------------------- 
-
-                  //-------------------------------------------------- 
-                  if(rand() < p_tar){
-                    if(t2 == t4){ // if type is conserved only update the prtcl info
-
-                      // NOTE: we keep location the same
-                      con2.vel(0,n2) = ux4;
-                      con2.vel(1,n2) = uy4;
-                      con2.vel(2,n2) = uz4;
-                    } else { // else destroy previous and add new 
-
-                      // destroy current
-                      con2.to_other_tiles.push_back( {1,1,1,n2} ); // NOTE: CPU version
-                      con2.wgt(n2) = 0.0f; // make zero wgt so its omitted from loop
-
-                      // add_particle
-                      cons[t4]->add_particle( {{lx2, ly2, lz2}}, {{ux4, uy4, uz4}}, w2);
-
-                      //std::cout << "killing t2" << t2 << std::endl;
-                      //std::cout << "adding t4" << t4 << std::endl;
-                    }
-                  }
-                  //-------------------------------------------------- 
-
-                } // end of if prob
-                //-------------------------------------------------- 
-              } // end of loop over con2 particles
-            } // end of loop over con1 particles
-            //}, con.size(), con);
-            //UniIter::sync();
-          } // con types match interaction
-        }//con2
-      } // con1
+      // incident and target types of the interaction
+      const int t1 = iptr->s1;
+      const int t2 = iptr->s2;
+
+      // skip interactions with types that are not present in the tile
+      if(cons[t1] == nullptr || cons[t2] == nullptr) continue; 
+
+      auto& con1 = *cons[t1];
+      auto& con2 = *cons[t2];
+
+      // kernel is compiled separately for each interaction type
+      dispatch_binary(*iptr, [&](auto& intr) {
+
+        // loop over incident particles
+        //UniIter::iterate([=] DEVCALLABLE (
+        //          size_t n, 
+        //          pic::ParticleContainer<D>& con
+        //          ){
+        // NOTE: without binning the loops also visit the particles added during the loop
+        //for(int n1=con1.size()-1; n1>=0; n1--) {
+        size_t c1 = 0; // pairing cell of the incident
+        for(size_t n1=0; n1<(binned ? cells.offs[t1].back() : con1.size()); n1++) { 
+
+          // container is sorted by cell so the cell index only increases
+          if(binned) while(n1 >= cells.end(t1, c1)) c1++;
+
+          // targets in the same cell; density normalized to the cell volume
+          const size_t n2_beg = binned ? cells.begin(t2, c1) : 0;
+          const size_t n2_end = binned ? cells.end(  t2, c1) : 0;
+          const float norm = binned ? prob_norm*cells.vfrac[c1] : prob_norm;
+
+          // loop over targets
+          //for(int n2=con2.size()-1; n2>=0; n2--) {
+          for(size_t n2=n2_beg; n2<(binned ? n2_end : con2.size()); n2++) { 
+
+            // NOTE: incident needs to be unpacked in the innermost loop, since 
+            // some interactions modify its value during the iteration
+              
+            //unpack incident 
+            auto lx1 = con1.loc(0,n1);
+            auto ly1 = con1.loc(1,n1);
+            auto lz1 = con1.loc(2,n1);
+
+            auto ux1 = con1.vel(0,n1);
+            auto uy1 = con1.vel(1,n1);
+            auto uz1 = con1.vel(2,n1);
+            auto w1  = con1.wgt(n1);
+
+            //e1  = con1.eneArr[n1]; 
+            //auto e1  = con1.get_prtcl_ene(n1);
+
+            if(w1 < EPS) continue; // omit zero-w incidents
+
+            // unpack target
+            auto lx2 = con2.loc(0,n2);
+            auto ly2 = con2.loc(1,n2);
+            auto lz2 = con2.loc(2,n2);
+
+            auto ux2 = con2.vel(0,n2);
+            auto uy2 = con2.vel(1,n2);
+            auto uz2 = con2.vel(2,n2);
+            auto w2  = con2.wgt(  n2);
+
+            //auto e2 = con2.get_prtcl_ene(n2);
+
+            if(w2 < EPS) continue; // omit zero-w targets
+                                     
+
+            //--------------------------------------------------
+            //avoid double counting by considering only e1 < e2 cases
+            //if(e1 > e2) continue;
+
+            // interaction cross section
+            auto [cm, vrel] = intr.comp_cross_section(t1, ux1, uy1, uz1,  t2, ux2, uy2, uz2 );
+            
+            // interaction probability
+            //auto wmin = min(w1, w2);
+            auto wmax = max(w1, w2);
+            auto prob = cm*vrel*w1*w2;
+            // NOTE: difference of all2all scheme is here where prob depends on w1*w2
+
+            // exponential waiting time between interactions
+            float t_free = -log( rand() )*norm/prob;
+
+            //-------------------------------------------------- 
+            if(t_free < 1.0){
+
+              // particle values after interaction
+              auto [t3, ux3, uy3, uz3, w3] = duplicate_prtcl(t1, ux1, uy1, uz1, w1);
+              auto [t4, ux4, uy4, uz4, w4] = duplicate_prtcl(t2, ux2, uy2, uz2, w2);
+
+              // interact and udpate variables in-place
+              intr.interact( t3, ux3, uy3, uz3,  t4, ux4, uy4, uz4);
+
+              auto p_ini = w2/wmax;
+              auto p_tar = w1/wmax;
+
+              //std::cout << " interacting:" << prob << " pini/tar" << p_ini << " " << p_tar << std::endl;
+
+              //-------------------------------------------------- 
+              if(rand() < p_ini){
+                if(t1 == t3){ // if type is conserved only update the prtcl info
+                                
+                  // NOTE: we keep location the same
+                  con1.vel(0,n1) = ux3;
+                  con1.vel(1,n1) = uy3;
+                  con1.vel(2,n1) = uz3;
+                } else { // else destroy previous and add new 
+
+                  // destroy current
+                  con1.to_other_tiles.push_back( {1,1,1,n1} ); // NOTE: CPU version
+                  con1.wgt(n1) = 0.0f; // make zero wgt so its omitted from loop
+
+                  // add new
+                  cons[t3]->add_particle( {{lx1, ly1, lz1}}, {{ux3, uy3, uz3}}, w1);
+
+                  //std::cout << "killing t1" << t1 << std::endl;
+                  //std::cout << "adding t3" << t3 << std::endl;
+                }
+              }
+              //-------------------------------------------------- 
+
+              //-------------------------------------------------- 
+              if(rand() < p_tar){
+                if(t2 == t4){ // if type is conserved only update the prtcl info
+
+                  // NOTE: we keep location the same
+                  con2.vel(0,n2) = ux4;
+                  con2.vel(1,n2) = uy4;
+                  con2.vel(2,n2) = uz4;
+                } else { // else destroy previous and add new 
+
+                  // destroy current
+                  con2.to_other_tiles.push_back( {1,1,1,n2} ); // NOTE: CPU version
+                  con2.wgt(n2) = 0.0f; // make zero wgt so its omitted from loop
+
+                  // add_particle
+                  cons[t4]->add_particle( {{lx2, ly2, lz2}}, {{ux4, uy4, uz4}}, w2);
+
+                  //std::cout << "killing t2" << t2 << std::endl;
+                  //std::cout << "adding t4" << t4 << std::endl;
+                }
+              }
+              //-------------------------------------------------- 
+
+            } // end of if prob
+            //-------------------------------------------------- 
+          } // end of loop over con2 particles
+        } // end of loop over con1 particles
+        //}, con.size(), con);
+        //UniIter::sync();
+      }); // end of dispatch
     }//end of loop over types
 
 
@@ -393,8 +431,9 @@ public:
 
   //--------------------------------------------------
   // normalize container of type t1
-  void rescale(pic::Tile<D>& tile, string& t1, double f_kill)
+  void rescale(pic::Tile<D>& tile, string& t1, double f_kill, int lap)
   {
+    reset_stream(tile, rng_rescale, lap, species_id(t1));
 
     // build pointer map of types to containers; used as a helper to access particle tyeps
     std::map<std::string, ConPtr> cons;
@@ -436,8 +475,11 @@ public:
   void inject_photons(pic::Tile<D>& tile, 
       float temp_inj, 
       float wph_inj,
-      float Nph_inj) 
+      float Nph_inj,
+      int lap) 
   {
+    reset_stream(tile, rng_inject_ph, lap);
+
     std::map<std::string, ConPtr> cons;
     for(auto&& con : tile.containers) cons.emplace(con.type, &con );
 
@@ -517,8 +559,10 @@ public:
       float pmin,
       float pmax,
       float w_inj,
-      float N_inj) 
+      float N_inj,
+      int lap) 
   {
+    reset_stream(tile, rng_inject_ep, lap);
 
     //const float pmin = 10.0f;
     //const float pmax = 100.0f;
@@ -653,9 +697,11 @@ public:
   void leak_photons(
       pic::Tile<D>& tile, 
       double tc_per_dt,
-      double tau_ext
+      double tau_ext,
+      int lap
       )
   {
+    reset_stream(tile, rng_leak, lap);
 
     // build pointer map of types to containers; used as a helper to access particle tyeps
     std::map<std::string, ConPtr> cons;
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace pic {
+  template<std::size_t D> class Tile;
+  template<std::size_t D> class ParticleContainer;
+}
+
+
+namespace qed {
+
+
+// Compact integer ids of the particle species known to the QED module.
+//
+// Interactions and the pairing kernels operate on these ids instead of the
+// container type strings; the strings are only used at the python interface.
+enum Species : int {
+  sp_none = -1, // container type not known to the QED module
+  sp_ph   = 0,  // photon
+  sp_em   = 1,  // electron
+  sp_ep   = 2,  // positron
+  n_species
+};
+
+// map container type to species id
+inline int species_id(const std::string& t)
+{
+  if(t == "ph") return sp_ph;
+  if(t == "e-") return sp_em;
+  if(t == "e+") return sp_ep;
+  return sp_none;
+}
+
+// map species id back to container type
+inline std::string species_name(int s)
+{
+  switch(s) {
+    case sp_ph: return "ph";
+    case sp_em: return "e-";
+    case sp_ep: return "e+";
+    default:    return "";
+  }
+}
+
+inline bool is_lepton(int s) { return s == sp_em || s == sp_ep; }
+
+// particle mass; zero if photon
+inline float species_mass(int s) { return s == sp_ph ? 0.0f : 1.0f; }
+
+
+// Table of the tile containers indexed by species id; built once per tile
+// so that the Monte Carlo loops do not look up containers by type.
+// NOTE: requires core/pic/tile.h at the point of use
+template<std::size_t D>
+struct SpeciesRegistry
+{
+  using ConPtr = pic::ParticleContainer<D>*;
+
+  std::array<ConPtr, n_species> cons;
+
+  explicit SpeciesRegistry(pic::Tile<D>& tile)
+  {
+    cons.fill(nullptr);
+    for(auto&& con : tile.containers) {
+      int s = species_id(con.type);
+      if(s != sp_none && cons[s] == nullptr) cons[s] = &con;
+    }
+  }
+
+  // nullptr if the tile has no container of the species
+  ConPtr operator[](int s) const { return (s >= 0 && s < n_species) ? cons[s] : nullptr; }
+};
+
+
+} // end of namespace qed
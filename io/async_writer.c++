@@ -0,0 +1,88 @@
+#include <exception>
+#include <iostream>
+
+#include "io/async_writer.h"
+
+
+h5io::AsyncWriter::AsyncWriter(size_t max_in_flight) :
+  max_in_flight{max_in_flight == 0 ? 1 : max_in_flight}
+{
+  worker = std::thread(&AsyncWriter::run, this);
+}
+
+
+h5io::AsyncWriter::~AsyncWriter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  cv_jobs.notify_all();
+
+  // worker drains the queue before exiting
+  if(worker.joinable()) worker.join();
+}
+
+
+void h5io::AsyncWriter::run()
+{
+  while(true) {
+    std::function<void()> job;
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cv_jobs.wait(lock, [this]{ return stopping || !jobs.empty(); });
+
+      if(jobs.empty()) return; // stopping and nothing left
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    // errors are reported but do not stop the simulation
+    bool ok = true;
+    try {
+      job();
+    } catch(const std::exception& e) {
+      std::cerr << "AsyncWriter: write failed: " << e.what() << std::endl;
+      ok = false;
+    } catch(...) {
+      std::cerr << "AsyncWriter: write failed" << std::endl;
+      ok = false;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      in_flight--;
+      if(ok) num_written++; else num_failed++;
+    }
+    cv_done.notify_all();
+  }
+}
+
+
+void h5io::AsyncWriter::submit(std::function<void()> job)
+{
+  if(!job) return;
+
+  {
+    std::unique_lock<std::mutex> lock(mtx);
+    cv_done.wait(lock, [this]{ return in_flight < max_in_flight; });
+
+    jobs.push_back(std::move(job));
+    in_flight++;
+  }
+  cv_jobs.notify_one();
+}
+
+
+void h5io::AsyncWriter::wait()
+{
+  std::unique_lock<std::mutex> lock(mtx);
+  cv_done.wait(lock, [this]{ return in_flight == 0; });
+}
+
+
+size_t h5io::AsyncWriter::num_in_flight()
+{
+  std::lock_guard<std::mutex> lock(mtx);
+  return in_flight;
+}
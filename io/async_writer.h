@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+
+namespace h5io {
+
+
+/*! \brief Background I/O thread for snapshot and checkpoint writes
+ *
+ * Writers stage their data on the compute thread (after all MPI
+ * communication is done) into a self-contained job that owns a copy of
+ * the data, and submit it here. The jobs are run in submission order by
+ * one dedicated thread that does all the HDF5 calls.
+ *
+ * At most max_in_flight jobs (queued + running) are kept; submit()
+ * blocks until a slot frees up, which bounds the staging memory.
+ *
+ * NOTE: serial HDF5 is not thread-safe; no other HDF5 calls must be made
+ * while jobs are in flight. Call wait() before synchronous HDF5 I/O
+ * (readers, parallel writers) and before reading the written files.
+ */
+class AsyncWriter
+{
+  std::thread worker;
+
+  std::mutex mtx;
+  std::condition_variable cv_jobs; // new jobs or shutdown
+  std::condition_variable cv_done; // a job finished
+
+  std::deque<std::function<void()>> jobs;
+
+  /// jobs queued or being written
+  size_t in_flight = 0;
+
+  bool stopping = false;
+
+  void run();
+
+  public:
+
+  /// max number of staged snapshots in memory
+  size_t max_in_flight;
+
+  /// statistics of finished jobs; updated by the worker thread
+  std::atomic<size_t> num_written{0};
+  std::atomic<size_t> num_failed{0};
+
+  explicit AsyncWriter(size_t max_in_flight = 2);
+
+  /// finishes all pending writes
+  ~AsyncWriter();
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  /// queue a write job; blocks while max_in_flight jobs are pending
+  void submit(std::function<void()> job);
+
+  /// block until all submitted jobs are written
+  void wait();
+
+  /// number of jobs queued or being written
+  size_t num_in_flight();
+};
+
+
+} // end of namespace h5io
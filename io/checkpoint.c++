@@ -0,0 +1,704 @@
+#include <mpi4cpp/mpi.h>
+#include <hdf5.h>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <unordered_map>
+
+#include "io/checkpoint.h"
+#include "io/namer.h"
+#include "core/emf/tile.h"
+#include "core/pic/tile.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+namespace {
+
+/// hdf5 type of column element
+template<typename T> hid_t h5type();
+template<> hid_t h5type<float>()    { return H5T_NATIVE_FLOAT; }
+template<> hid_t h5type<int>()      { return H5T_NATIVE_INT; }
+template<> hid_t h5type<int64_t>()  { return H5T_NATIVE_INT64; }
+template<> hid_t h5type<uint64_t>() { return H5T_NATIVE_UINT64; }
+
+
+/// select rows [offsets[n], offsets[n]+counts[n]) of a 1D data space; adjacent ranges are merged
+void select_rows(
+    hid_t space,
+    const std::vector<int64_t>& offsets,
+    const std::vector<int64_t>& counts)
+{
+  H5Sselect_none(space);
+
+  hsize_t start = 0, count = 0;
+  bool first = true;
+  auto flush = [&]()
+  {
+    if(count == 0) return;
+    H5Sselect_hyperslab(space, first ? H5S_SELECT_SET : H5S_SELECT_OR, &start, nullptr, &count, nullptr);
+    first = false;
+  };
+
+  for(size_t n=0; n<offsets.size(); n++) {
+    if(counts[n] == 0) continue;
+    if(count > 0 && start + count == (hsize_t)offsets[n]) {
+      count += counts[n];
+    } else {
+      flush();
+      start = offsets[n];
+      count = counts[n];
+    }
+  }
+  flush();
+}
+
+
+/// 1D memory space of n elements (n=0 gives an empty selection)
+hid_t mem_space(hsize_t n)
+{
+  const hsize_t nmem = std::max<hsize_t>(n, 1);
+  hid_t space = H5Screate_simple(1, &nmem, nullptr);
+  if(n == 0) H5Sselect_none(space);
+  return space;
+}
+
+
+/// create 1D data set of N elements; chunked and compressed if requested
+void create_dataset(
+    hid_t file, const std::string& path, hid_t type,
+    hsize_t N, int compression, hsize_t chunk)
+{
+  hid_t space = H5Screate_simple(1, &N, nullptr);
+  hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+
+  if(N > 0 && compression > 0) {
+    hsize_t c = std::min(chunk, N);
+    H5Pset_chunk(dcpl, 1, &c);
+    H5Pset_shuffle(dcpl);
+    H5Pset_deflate(dcpl, (unsigned)compression);
+  }
+
+  hid_t dset = H5Dcreate2(file, path.c_str(), type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+  H5Dclose(dset);
+  H5Pclose(dcpl);
+  H5Sclose(space);
+}
+
+
+/// write full data set path from writer rank; others participate with empty selection
+template<typename T>
+bool write_full(
+    hid_t file, const std::string& path, const std::vector<T>& data,
+    hid_t dxpl, bool writer)
+{
+  const hsize_t N = data.size();
+  hid_t space = H5Screate_simple(1, &N, nullptr);
+  hid_t dset = H5Dcreate2(file, path.c_str(), h5type<T>(), space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+  hid_t mspace = mem_space(writer ? N : 0);
+  if(!writer || N == 0) H5Sselect_none(space);
+
+  herr_t err = H5Dwrite(dset, h5type<T>(), mspace, space, dxpl, data.data());
+
+  H5Sclose(mspace);
+  H5Dclose(dset);
+  H5Sclose(space);
+  return err >= 0;
+}
+
+
+/// read full data set path on rank 0 and broadcast; all ranks open it
+template<typename T>
+bool read_full(
+    hid_t file, const std::string& path, std::vector<T>& data,
+    MPI_Comm comm, MPI_Datatype mtype)
+{
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  hid_t dset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+  if(dset < 0) return false;
+
+  hid_t space = H5Dget_space(dset);
+  const hssize_t N = H5Sget_simple_extent_npoints(space);
+  data.resize(N);
+
+  // independent read by root only
+  int ok = 1;
+  if(rank == 0 && N > 0) ok = H5Dread(dset, h5type<T>(), H5S_ALL, H5S_ALL, H5P_DEFAULT, data.data()) >= 0;
+
+  H5Sclose(space);
+  H5Dclose(dset);
+
+  MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+  if(!ok) return false;
+
+  if(N > 0) MPI_Bcast(data.data(), (int)N, mtype, 0, comm);
+  return true;
+}
+
+
+/// write (or read) the local rows of one column
+template<typename T>
+bool io_column(
+    hid_t file, const std::string& path,
+    const h5io::TileTable& table, std::vector<T>& col,
+    hid_t dxpl, bool do_write)
+{
+  hid_t dset = H5Dopen2(file, path.c_str(), H5P_DEFAULT);
+  if(dset < 0) return false;
+
+  hid_t fspace = H5Dget_space(dset);
+  select_rows(fspace, table.offsets, table.counts);
+
+  hid_t mspace = mem_space(col.size());
+
+  herr_t err = do_write ?
+    H5Dwrite(dset, h5type<T>(), mspace, fspace, dxpl, col.data()) :
+    H5Dread( dset, h5type<T>(), mspace, fspace, dxpl, col.data());
+
+  H5Sclose(mspace);
+  H5Sclose(fspace);
+  H5Dclose(dset);
+  return err >= 0;
+}
+
+
+/// collective (parallel hdf5) or default transfer
+hid_t transfer_plist()
+{
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+#ifdef H5_HAVE_PARALLEL
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+#endif
+  return dxpl;
+}
+
+
+/// file access with mpi-io driver when available
+hid_t access_plist(MPI_Comm comm)
+{
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+#ifdef H5_HAVE_PARALLEL
+  H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL);
+#else
+  (void)comm;
+#endif
+  return fapl;
+}
+
+} // end of anonymous namespace
+
+
+//--------------------------------------------------
+template<size_t D>
+h5io::Checkpoint<D>::Checkpoint(std::string dir_in, int compression) :
+  dir{std::move(dir_in)},
+  compression{compression}
+{
+  if(!dir.empty() && dir.back() != '/') dir += '/';
+
+  if(compression > 0 && !H5Zfilter_avail(H5Z_FILTER_DEFLATE)) {
+    std::cerr << "Checkpoint: deflate filter not available; writing uncompressed" << std::endl;
+    this->compression = 0;
+  }
+}
+
+
+template<size_t D>
+std::string h5io::Checkpoint<D>::file_name(int lap) const
+{
+  return dir + "checkpoint_" + std::to_string(lap) + ".h5";
+}
+
+
+template<size_t D>
+bool h5io::Checkpoint<D>::write_tables(
+    const std::string& fname,
+    const TileIndex& index,
+    std::vector<TileTable>& tables,
+    MPI_Comm comm)
+{
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  const size_t nloc = index.cids.size();
+  const size_t ntab = tables.size();
+  assert(std::is_sorted(index.cids.begin(), index.cids.end()));
+
+  //--------------------------------------------------
+  // global tile index: rows of (cid, i, j, k, count of every table)
+  const size_t rowlen = 4 + ntab;
+
+  std::vector<int64_t> sendbuf;
+  sendbuf.reserve(nloc*rowlen);
+  for(size_t n=0; n<nloc; n++) {
+    sendbuf.push_back( (int64_t)index.cids[n] );
+    for(int d=0; d<3; d++) sendbuf.push_back( index.inds[n][d] );
+    for(auto& t : tables) sendbuf.push_back( t.counts[n] );
+  }
+
+  int nsend = sendbuf.size();
+  std::vector<int> nrecv(size), displs(size, 0);
+  MPI_Allgather(&nsend, 1, MPI_INT, nrecv.data(), 1, MPI_INT, comm);
+  for(int r=1; r<size; r++) displs[r] = displs[r-1] + nrecv[r-1];
+
+  std::vector<int64_t> rows( displs[size-1] + nrecv[size-1] );
+  MPI_Allgatherv(sendbuf.data(), nsend, MPI_INT64_T,
+                 rows.data(), nrecv.data(), displs.data(), MPI_INT64_T, comm);
+
+  const size_t Ntiles = rows.size()/rowlen;
+
+  // order by cid
+  std::vector<size_t> order(Ntiles);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+      [&](size_t a, size_t b){ return rows[a*rowlen] < rows[b*rowlen]; });
+
+  std::vector<uint64_t> gcid(Ntiles);
+  std::vector<int> gi(Ntiles), gj(Ntiles), gk(Ntiles);
+  std::vector<std::vector<int64_t>> goffset(ntab, std::vector<int64_t>(Ntiles)),
+                                    gcount(ntab,  std::vector<int64_t>(Ntiles));
+  std::vector<hsize_t> totals(ntab, 0);
+  std::unordered_map<uint64_t, size_t> row_of;
+
+  for(size_t m=0; m<Ntiles; m++) {
+    const int64_t* row = &rows[order[m]*rowlen];
+    gcid[m] = row[0];
+    gi[m] = row[1];
+    gj[m] = row[2];
+    gk[m] = row[3];
+    row_of[gcid[m]] = m;
+
+    for(size_t t=0; t<ntab; t++) {
+      gcount[t][m]  = row[4+t];
+      goffset[t][m] = totals[t];
+      totals[t] += row[4+t];
+    }
+  }
+
+  for(size_t t=0; t<ntab; t++) {
+    tables[t].offsets.resize(nloc);
+    for(size_t n=0; n<nloc; n++) tables[t].offsets[n] = goffset[t][ row_of[index.cids[n]] ];
+  }
+
+  //--------------------------------------------------
+  // file layout; index data is written by root
+  auto create_all = [&](hid_t file, hid_t dxpl, bool writer)
+  {
+    bool ok = true;
+
+    hid_t gr = H5Gcreate2(file, "tiles", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Gclose(gr);
+    ok &= write_full(file, "tiles/cid", gcid, dxpl, writer);
+    ok &= write_full(file, "tiles/i",   gi,   dxpl, writer);
+    ok &= write_full(file, "tiles/j",   gj,   dxpl, writer);
+    ok &= write_full(file, "tiles/k",   gk,   dxpl, writer);
+
+    for(size_t t=0; t<ntab; t++) {
+      const auto& tab = tables[t];
+      gr = H5Gcreate2(file, tab.name.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+      H5Gclose(gr);
+
+      ok &= write_full(file, tab.name + "/offset", goffset[t], dxpl, writer);
+      ok &= write_full(file, tab.name + "/count",  gcount[t],  dxpl, writer);
+
+      for(auto& col : tab.fnames)
+        create_dataset(file, tab.name + "/" + col, H5T_NATIVE_FLOAT, totals[t], compression, chunk_size);
+      for(auto& col : tab.inames)
+        create_dataset(file, tab.name + "/" + col, H5T_NATIVE_INT,   totals[t], compression, chunk_size);
+    }
+    return ok;
+  };
+
+  auto write_local = [&](hid_t file, hid_t dxpl)
+  {
+    bool ok = true;
+    for(auto& tab : tables) {
+      for(size_t c=0; c<tab.fnames.size(); c++)
+        ok &= io_column(file, tab.name + "/" + tab.fnames[c], tab, tab.fcols[c], dxpl, true);
+      for(size_t c=0; c<tab.inames.size(); c++)
+        ok &= io_column(file, tab.name + "/" + tab.inames[c], tab, tab.icols[c], dxpl, true);
+    }
+    return ok;
+  };
+
+  int ok = 1;
+
+#ifdef H5_HAVE_PARALLEL
+  // all ranks write their hyperslabs collectively
+  hid_t fapl = access_plist(comm);
+  hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+
+  if(file < 0) {
+    if(rank == 0) std::cerr << "Checkpoint: could not create " << fname << std::endl;
+    return false;
+  }
+
+  hid_t dxpl = transfer_plist();
+  ok = create_all(file, dxpl, rank == 0);
+  ok &= write_local(file, dxpl);
+  H5Pclose(dxpl);
+  H5Fclose(file);
+
+#else
+  // serial hdf5: root lays out the file, then ranks add their rows in turn
+  if(rank == 0) {
+    hid_t file = H5Fcreate(fname.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if(file < 0) {
+      std::cerr << "Checkpoint: could not create " << fname << std::endl;
+      ok = 0;
+    } else {
+      ok = create_all(file, H5P_DEFAULT, true);
+      H5Fclose(file);
+    }
+  }
+  MPI_Bcast(&ok, 1, MPI_INT, 0, comm);
+  if(!ok) return false;
+
+  for(int r=0; r<size; r++) {
+    if(rank == r) {
+      hid_t file = H5Fopen(fname.c_str(), H5F_ACC_RDWR, H5P_DEFAULT);
+      ok = file >= 0 && write_local(file, H5P_DEFAULT);
+      if(file >= 0) H5Fclose(file);
+    }
+    MPI_Barrier(comm);
+  }
+#endif
+
+  int all_ok = 0;
+  MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+  if(!all_ok && rank == 0) std::cerr << "Checkpoint: writing " << fname << " failed" << std::endl;
+
+  return all_ok;
+}
+
+
+template<size_t D>
+bool h5io::Checkpoint<D>::read_tables(
+    const std::string& fname,
+    const TileIndex& index,
+    std::vector<TileTable>& tables,
+    MPI_Comm comm)
+{
+  int rank;
+  MPI_Comm_rank(comm, &rank);
+
+  const size_t nloc = index.cids.size();
+  assert(std::is_sorted(index.cids.begin(), index.cids.end()));
+
+  hid_t fapl = access_plist(comm);
+  hid_t file = H5Fopen(fname.c_str(), H5F_ACC_RDONLY, fapl);
+  H5Pclose(fapl);
+
+  if(file < 0) {
+    if(rank == 0) std::cerr << "Checkpoint: could not open " << fname << std::endl;
+    return false;
+  }
+
+  int ok = 1;
+
+  // global tile index
+  std::vector<uint64_t> gcid;
+  std::vector<int> gi, gj, gk;
+  ok &= read_full(file, "tiles/cid", gcid, comm, MPI_UINT64_T);
+  ok &= read_full(file, "tiles/i",   gi,   comm, MPI_INT);
+  ok &= read_full(file, "tiles/j",   gj,   comm, MPI_INT);
+  ok &= read_full(file, "tiles/k",   gk,   comm, MPI_INT);
+
+  std::unordered_map<uint64_t, size_t> row_of;
+  for(size_t m=0; m<gcid.size(); m++) row_of[gcid[m]] = m;
+
+  // position of local tiles in the index
+  std::vector<size_t> rows(nloc);
+  for(size_t n=0; n<nloc && ok; n++) {
+    auto it = row_of.find(index.cids[n]);
+    if(it == row_of.end() ||
+       gi[it->second] != index.inds[n][0] ||
+       gj[it->second] != index.inds[n][1] ||
+       gk[it->second] != index.inds[n][2]) {
+      std::cerr << "Checkpoint: tile " << index.cids[n] << " not found in " << fname << std::endl;
+      ok = 0;
+      break;
+    }
+    rows[n] = it->second;
+  }
+
+  int all_ok = 0;
+  MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+  if(!all_ok) {
+    H5Fclose(file);
+    return false;
+  }
+
+  hid_t dxpl = transfer_plist();
+
+  for(auto& tab : tables) {
+    tab.counts.assign(nloc, 0);
+    tab.offsets.assign(nloc, 0);
+
+    // group missing from file (e.g., new species); leave empty
+    const bool exists = H5Lexists(file, tab.name.c_str(), H5P_DEFAULT) > 0;
+    if(!exists) {
+      if(rank == 0) std::cerr << "Checkpoint: no " << tab.name << " in " << fname << std::endl;
+      tab.fcols.assign(tab.fnames.size(), {});
+      tab.icols.assign(tab.inames.size(), {});
+      continue;
+    }
+
+    std::vector<int64_t> goffset, gcount;
+    ok &= read_full(file, tab.name + "/offset", goffset, comm, MPI_INT64_T);
+    ok &= read_full(file, tab.name + "/count",  gcount,  comm, MPI_INT64_T);
+
+    size_t nrows = 0;
+    for(size_t n=0; n<nloc; n++) {
+      tab.offsets[n] = goffset[rows[n]];
+      tab.counts[n]  = gcount[rows[n]];
+      nrows += tab.counts[n];
+    }
+
+    tab.fcols.assign(tab.fnames.size(), std::vector<float>(nrows));
+    tab.icols.assign(tab.inames.size(), std::vector<int>(nrows));
+
+    for(size_t c=0; c<tab.fnames.size(); c++)
+      ok &= io_column(file, tab.name + "/" + tab.fnames[c], tab, tab.fcols[c], dxpl, false);
+    for(size_t c=0; c<tab.inames.size(); c++)
+      ok &= io_column(file, tab.name + "/" + tab.inames[c], tab, tab.icols[c], dxpl, false);
+  }
+
+  H5Pclose(dxpl);
+  H5Fclose(file);
+
+  MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, comm);
+  if(!all_ok && rank == 0) std::cerr << "Checkpoint: reading " << fname << " failed" << std::endl;
+
+  return all_ok;
+}
+
+
+//--------------------------------------------------
+// grid <-> tables
+
+namespace {
+
+const std::vector<std::string> field_names =
+  {"ex", "ey", "ez", "bx", "by", "bz", "jx", "jy", "jz", "rho"};
+
+const std::vector<std::string> prtcl_fnames = {"x", "y", "z", "vx", "vy", "vz", "wgt"};
+const std::vector<std::string> prtcl_inames = {"id", "proc"};
+
+
+template<size_t D>
+h5io::TileIndex local_index(corgi::Grid<D>& grid)
+{
+  h5io::TileIndex index;
+  index.cids = grid.get_local_tiles();
+  std::sort(index.cids.begin(), index.cids.end());
+
+  for(auto cid : index.cids) {
+    auto ind = h5io::expand_indices( &grid.get_tile(cid) );
+    index.inds.push_back({ (int)std::get<0>(ind), (int)std::get<1>(ind), (int)std::get<2>(ind) });
+  }
+  return index;
+}
+
+
+/// meshes of Yee lattice in the order of field_names
+std::array<toolbox::Mesh<float,3>*, 10> field_meshes(emf::Grids& gs)
+{
+  return {&gs.ex, &gs.ey, &gs.ez, &gs.bx, &gs.by, &gs.bz, &gs.jx, &gs.jy, &gs.jz, &gs.rho};
+}
+
+
+/// number of species; same on all ranks
+template<size_t D>
+int num_species(corgi::Grid<D>& grid, MPI_Comm comm)
+{
+  int nsp = 0;
+  for(auto cid : grid.get_local_tiles()) {
+    auto* tile = dynamic_cast<pic::Tile<D>*>(&grid.get_tile(cid));
+    if(tile) nsp = std::max(nsp, tile->Nspecies());
+  }
+
+  int nsp_all = 0;
+  MPI_Allreduce(&nsp, &nsp_all, 1, MPI_INT, MPI_MAX, comm);
+  return nsp_all;
+}
+
+} // end of anonymous namespace
+
+
+template<size_t D>
+bool h5io::Checkpoint<D>::write(
+    corgi::Grid<D>& grid, int lap)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  MPI_Comm comm = grid.comm;
+  auto index = local_index(grid);
+  const int nsp = num_species(grid, comm);
+
+  std::vector<TileTable> tables(1 + nsp);
+
+  //--------------------------------------------------
+  // fields
+  auto& ft = tables[0];
+  ft.name = "fields";
+  ft.fnames = field_names;
+  ft.fcols.resize(field_names.size());
+
+  for(auto cid : index.cids) {
+    auto& tile = dynamic_cast<emf::Tile<D>&>(grid.get_tile(cid));
+    auto& gs = tile.get_grids();
+
+    ft.counts.push_back( (int64_t)gs.Nx*gs.Ny*gs.Nz );
+
+    auto meshes = field_meshes(gs);
+    for(size_t c=0; c<meshes.size(); c++) {
+      auto arr = meshes[c]->serialize();
+      ft.fcols[c].insert(ft.fcols[c].end(), arr.begin(), arr.end());
+    }
+  }
+
+  //--------------------------------------------------
+  // particles
+  for(int ispc=0; ispc<nsp; ispc++) {
+    auto& pt = tables[1 + ispc];
+    pt.name = "sp-" + std::to_string(ispc);
+    pt.fnames = prtcl_fnames;
+    pt.inames = prtcl_inames;
+    pt.fcols.resize(prtcl_fnames.size());
+    pt.icols.resize(prtcl_inames.size());
+
+    for(auto cid : index.cids) {
+      auto* tile = dynamic_cast<pic::Tile<D>*>(&grid.get_tile(cid));
+      if(!tile || ispc >= tile->Nspecies()) {
+        pt.counts.push_back(0);
+        continue;
+      }
+
+      const auto& con = tile->get_const_container(ispc);
+      const size_t np = con.size();
+      pt.counts.push_back(np);
+
+      for(size_t n=0; n<np; n++) {
+        for(int d=0; d<3; d++) pt.fcols[d].push_back(   con.loc(d, n) );
+        for(int d=0; d<3; d++) pt.fcols[3+d].push_back( con.vel(d, n) );
+        pt.fcols[6].push_back( con.wgt(n) );
+
+        pt.icols[0].push_back( con.id(0, n) );
+        pt.icols[1].push_back( con.id(1, n) );
+      }
+    }
+  }
+
+  bool ok = write_tables(file_name(lap), index, tables, comm);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+
+  return ok;
+}
+
+
+template<size_t D>
+bool h5io::Checkpoint<D>::read(
+    corgi::Grid<D>& grid, int lap)
+{
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  MPI_Comm comm = grid.comm;
+  auto index = local_index(grid);
+  const int nsp = num_species(grid, comm);
+
+  std::vector<TileTable> tables(1 + nsp);
+  tables[0].name = "fields";
+  tables[0].fnames = field_names;
+
+  for(int ispc=0; ispc<nsp; ispc++) {
+    tables[1 + ispc].name = "sp-" + std::to_string(ispc);
+    tables[1 + ispc].fnames = prtcl_fnames;
+    tables[1 + ispc].inames = prtcl_inames;
+  }
+
+  if(!read_tables(file_name(lap), index, tables, comm)) return false;
+
+  bool ok = true;
+
+  //--------------------------------------------------
+  // fields
+  auto& ft = tables[0];
+  size_t pos = 0;
+  for(size_t n=0; n<index.cids.size(); n++) {
+    auto& tile = dynamic_cast<emf::Tile<D>&>(grid.get_tile(index.cids[n]));
+    auto& gs = tile.get_grids();
+
+    const int64_t ncells = (int64_t)gs.Nx*gs.Ny*gs.Nz;
+    if(ft.counts[n] == 0) continue; // no fields stored
+    if(ft.counts[n] != ncells) {
+      std::cerr << "Checkpoint: tile " << index.cids[n] << " mesh size differs from file" << std::endl;
+      ok = false;
+      pos += ft.counts[n];
+      continue;
+    }
+
+    auto meshes = field_meshes(gs);
+    for(size_t c=0; c<meshes.size(); c++) {
+      std::vector<float> arr(ft.fcols[c].begin() + pos, ft.fcols[c].begin() + pos + ncells);
+      meshes[c]->unserialize(arr, gs.Nx, gs.Ny, gs.Nz);
+    }
+    pos += ncells;
+  }
+
+  //--------------------------------------------------
+  // particles
+  for(int ispc=0; ispc<nsp; ispc++) {
+    auto& pt = tables[1 + ispc];
+
+    pos = 0;
+    for(size_t n=0; n<index.cids.size(); n++) {
+      const size_t np = pt.counts[n];
+      auto* tile = dynamic_cast<pic::Tile<D>*>(&grid.get_tile(index.cids[n]));
+      if(!tile || ispc >= tile->Nspecies()) {
+        pos += np;
+        continue;
+      }
+
+      auto& con = tile->get_container(ispc);
+      con.reserve(con.size() + np);
+
+      for(size_t m=pos; m<pos+np; m++) {
+        con.add_identified_particle(
+          {pt.fcols[0][m], pt.fcols[1][m], pt.fcols[2][m]},
+          {pt.fcols[3][m], pt.fcols[4][m], pt.fcols[5][m]},
+          pt.fcols[6][m],
+          pt.icols[0][m], pt.icols[1][m]);
+      }
+      pos += np;
+    }
+  }
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+
+  return ok;
+}
+
+
+//--------------------------------------------------
+// explicit template class instantiations
+template class h5io::Checkpoint<1>;
+template class h5io::Checkpoint<2>;
+template class h5io::Checkpoint<3>;
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mpi4cpp/mpi.h>
+#include <hdf5.h>
+
+#include "external/corgi/corgi.h"
+
+
+namespace h5io {
+
+
+/// Columns of one data group (fields or one species) for the local tiles
+//
+// Rows of all local tiles are packed one tile after another in the order
+// of TileIndex::cids; counts holds the number of rows of each tile.
+struct TileTable {
+  std::string name;
+
+  std::vector<int64_t> counts;
+
+  std::vector<std::string> fnames;
+  std::vector<std::vector<float>> fcols;
+
+  std::vector<std::string> inames;
+  std::vector<std::vector<int>> icols;
+
+  /// global position of the rows of each local tile; set by the writer/reader
+  std::vector<int64_t> offsets;
+};
+
+
+/// Local tiles, in increasing cid order
+struct TileIndex {
+  std::vector<uint64_t> cids;
+  std::vector<std::array<int,3>> inds;
+};
+
+
+/*! \brief Single-file checkpoint of fields and particles
+ *
+ * Writes one file per lap for the whole grid instead of one file and
+ * one group per tile and rank. Every quantity is one contiguous 1D
+ * dataset:
+ *
+ *   tiles/{cid,i,j,k}                          all tiles, sorted by cid
+ *   fields/{ex,...,rho, offset,count}         Yee lattice, x-fastest per tile
+ *   sp-N/{x,y,z,vx,vy,vz,wgt,id,proc, offset,count}  particles of species N
+ *
+ * offset/count give the rows of each tile in the data sets, so a rank
+ * only reads the ranges of the tiles it owns; restarting with a different
+ * number of ranks (same tile grid) works without conversion.
+ *
+ * Data sets are chunked and optionally deflate-compressed. With parallel
+ * HDF5 the file is written and read collectively with MPI-IO; otherwise
+ * ranks write their parts one after another.
+ */
+template<size_t D>
+class Checkpoint
+{
+
+  public:
+
+    /// output directory
+    std::string dir;
+
+    /// deflate level 0-9; 0 is no compression
+    int compression = 0;
+
+    /// chunk length (elements) of the data sets
+    hsize_t chunk_size = 1 << 20;
+
+    Checkpoint(std::string dir, int compression = 0);
+
+    /// file name of checkpoint lap
+    std::string file_name(int lap) const;
+
+    /// write fields and particles of local tiles; collective
+    bool write(corgi::Grid<D>& grid, int lap);
+
+    /// read fields and particles of local tiles; collective
+    bool read(corgi::Grid<D>& grid, int lap);
+
+    //--------------------------------------------------
+    // tile-layout independent parts
+
+    /// write tables of local tiles into fname; collective over comm
+    bool write_tables(
+        const std::string& fname,
+        const TileIndex& index,
+        std::vector<TileTable>& tables,
+        MPI_Comm comm);
+
+    /// read tables (names and counts pre-filled) of local tiles from fname; collective over comm
+    //
+    // counts of the tables are filled from the file; column names have
+    // to be given and columns are resized to the total local rows.
+    bool read_tables(
+        const std::string& fname,
+        const TileIndex& index,
+        std::vector<TileTable>& tables,
+        MPI_Comm comm);
+};
+
+
+} // end of namespace h5io
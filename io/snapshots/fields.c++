@@ -1,3 +1,4 @@
+#include <memory>
 #include <mpi4cpp/mpi.h>
 
 #include "io/snapshots/fields.h"
@@ -232,23 +233,30 @@ inline void h5io::FieldsWriter<3>::read_tiles(
 }
 
 template<size_t D>
-inline bool h5io::FieldsWriter<D>::write(
+inline std::function<void()> h5io::FieldsWriter<D>::stage(
     corgi::Grid<D>& grid, int lap)
 {
   read_tiles(grid);
   mpi_reduce_snapshots(grid);
 
-  if( grid.comm.rank() == 0 ) {
+  if( grid.comm.rank() != 0 ) return {};
+
+  // build filename
+  std::string full_filename =
+    fname +
+    +"/"+
+    file_name +
+    "_" +
+    std::to_string(lap) +
+    extension;
+  //std::cout << "QW: " << full_filename << std::endl;
+
+  // private copy so that arrs can be reused while the file is written
+  auto data = std::make_shared<std::vector<toolbox::Mesh<float,0>>>(arrs);
 
-    // build filename
-    std::string full_filename =
-      fname +
-      +"/"+
-      file_name +
-      "_" +
-      std::to_string(lap) +
-      extension;
-    //std::cout << "QW: " << full_filename << std::endl;
+  return [data, full_filename]()
+  {
+    auto& arrs = *data;
 
     // open file and write
     File file(full_filename, H5F_ACC_TRUNC);
@@ -272,8 +280,16 @@ inline bool h5io::FieldsWriter<D>::write(
     file["jz"] = arrs[8].serialize();
 
     file["rho"]= arrs[9].serialize();
-    
-  }
+  };
+}
+
+
+template<size_t D>
+inline bool h5io::FieldsWriter<D>::write(
+    corgi::Grid<D>& grid, int lap)
+{
+  auto job = stage(grid, lap);
+  if(job) job();
 
   return true;
 }
@@ -61,6 +61,7 @@ class FieldsWriter :
       for(size_t i=0; i<10; i++) arrs.emplace_back(nx, ny, nz);
       rbuf.emplace_back(nx, ny, nz); // only one collective receive buffer
 
+      this->has_stage = true;
     }
 
     /// read tile meshes into memory
@@ -69,6 +70,9 @@ class FieldsWriter :
     /// write hdf5 file
     bool write(corgi::Grid<D>& grid, int lap) override;
 
+    /// reduce to root and return the file write as a job
+    std::function<void()> stage(corgi::Grid<D>& grid, int lap) override;
+
 };
 
 } // end of namespace h5io
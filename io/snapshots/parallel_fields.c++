@@ -0,0 +1,245 @@
+#include <mpi4cpp/mpi.h>
+#include <hdf5.h>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+#include "io/snapshots/parallel_fields.h"
+#include "core/emf/tile.h"
+
+#ifdef GPU
+#include <nvtx3/nvToolsExt.h>
+#endif
+
+
+template<size_t D>
+void h5io::ParallelFieldsWriter<D>::read_tiles(
+    corgi::Grid<D>& grid)
+{
+  const size_t Nvars = var_names.size();
+
+  /// x-run of one tile row and its location in the tile block
+  struct Run {
+    size_t offset; // position in the global 1D dataset
+    size_t len;
+    size_t tile;   // index to blocks
+    size_t src;    // position in the tile block
+  };
+
+  std::vector<Run> tile_runs;
+  std::vector<std::vector<float>> blocks; // downsampled tile data, Nvars consecutive meshes
+
+  // stride is not applied to collapsed dimensions
+  const int sy = D >= 2 ? stride : 1;
+  const int sz = D >= 3 ? stride : 1;
+
+  for(auto cid : grid.get_local_tiles() ){
+    auto& tile = dynamic_cast<emf::Tile<D>&>(grid.get_tile( cid ));
+    auto& gs = tile.get_grids();
+
+    auto index = expand_indices( &tile );
+
+    // tile limits taking into account 0 collapsing dimensions
+    int nxt = (int)gs.Nx/stride;
+    int nyt = (int)gs.Ny/stride;
+    int nzt = (int)gs.Nz/stride;
+
+    nxt = nxt == 0 ? 1 : nxt;
+    nyt = nyt == 0 ? 1 : nyt;
+    nzt = nzt == 0 ? 1 : nzt;
+
+    if(D < 2) nyt = 1;
+    if(D < 3) nzt = 1;
+
+    // starting location
+    const size_t i0 = nxt*std::get<0>(index);
+    const size_t j0 = D >= 2 ? nyt*std::get<1>(index) : 0;
+    const size_t k0 = D >= 3 ? nzt*std::get<2>(index) : 0;
+
+    const size_t nblock = nxt*nyt*nzt;
+    blocks.emplace_back(Nvars*nblock, 0.0f);
+    auto& blk = blocks.back();
+
+    for(int ks=0; ks<nzt; ks++)
+    for(int js=0; js<nyt; js++)
+    for(int is=0; is<nxt; is++) {
+      const size_t n = is + nxt*(js + nyt*ks);
+
+      // field quantities; just downsample by hopping with stride
+      blk[0*nblock + n] = gs.ex( is*stride, js*stride, ks*stride);
+      blk[1*nblock + n] = gs.ey( is*stride, js*stride, ks*stride);
+      blk[2*nblock + n] = gs.ez( is*stride, js*stride, ks*stride);
+
+      blk[3*nblock + n] = gs.bx( is*stride, js*stride, ks*stride);
+      blk[4*nblock + n] = gs.by( is*stride, js*stride, ks*stride);
+      blk[5*nblock + n] = gs.bz( is*stride, js*stride, ks*stride);
+
+      // densities; these quantities we integrate over the stride volume
+      for(int kstride=0; kstride < sz; kstride++)
+      for(int jstride=0; jstride < sy; jstride++)
+      for(int istride=0; istride < stride; istride++) {
+        blk[6*nblock + n] += gs.jx( is*stride+istride, js*stride+jstride, ks*stride+kstride);
+        blk[7*nblock + n] += gs.jy( is*stride+istride, js*stride+jstride, ks*stride+kstride);
+        blk[8*nblock + n] += gs.jz( is*stride+istride, js*stride+jstride, ks*stride+kstride);
+        blk[9*nblock + n] += gs.rho(is*stride+istride, js*stride+jstride, ks*stride+kstride);
+      }
+    }
+
+    for(int ks=0; ks<nzt; ks++)
+    for(int js=0; js<nyt; js++) {
+      const size_t offset = i0 + nx*( (j0 + js) + ny*(k0 + ks) );
+      tile_runs.push_back({offset, (size_t)nxt, blocks.size()-1, (size_t)nxt*(js + nyt*ks)});
+    }
+  } // tiles
+
+  // hdf5 maps memory elements to the file selection in increasing file offset
+  std::sort(tile_runs.begin(), tile_runs.end(),
+      [](const Run& a, const Run& b){ return a.offset < b.offset; });
+
+  size_t nloc = 0;
+  for(auto& r : tile_runs) nloc += r.len;
+
+  for(size_t v=0; v<Nvars; v++) {
+    auto& buf = bufs[v];
+    buf.resize(nloc);
+
+    size_t pos = 0;
+    for(auto& r : tile_runs) {
+      const auto& blk = blocks[r.tile];
+      const size_t nblock = blk.size()/Nvars;
+      std::copy_n(blk.begin() + v*nblock + r.src, r.len, buf.begin() + pos);
+      pos += r.len;
+    }
+  }
+
+  // file selection; runs that continue each other are merged
+  runs.clear();
+  for(auto& r : tile_runs) {
+    if(!runs.empty() && runs.back().first + runs.back().second == r.offset) {
+      runs.back().second += r.len;
+    } else {
+      runs.push_back({r.offset, r.len});
+    }
+  }
+}
+
+
+template<size_t D>
+bool h5io::ParallelFieldsWriter<D>::write(
+    corgi::Grid<D>& grid, int lap)
+{
+#ifdef H5_HAVE_PARALLEL
+
+#ifdef GPU
+  nvtxRangePush(__PRETTY_FUNCTION__);
+#endif
+
+  read_tiles(grid);
+
+  // build filename
+  std::string full_filename =
+    fname +
+    +"/"+
+    file_name +
+    "_" +
+    std::to_string(lap) +
+    extension;
+
+  const bool is_root = grid.comm.rank() == 0;
+  MPI_Comm comm = grid.comm;
+
+  // open file collectively with mpi-io driver
+  hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+  H5Pset_fapl_mpio(fapl, comm, MPI_INFO_NULL);
+  hid_t file = H5Fcreate(full_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+  H5Pclose(fapl);
+
+  if(file < 0) {
+    std::cerr << "ParallelFieldsWriter: could not create " << full_filename << std::endl;
+    return false;
+  }
+
+  hid_t dxpl = H5Pcreate(H5P_DATASET_XFER);
+  H5Pset_dxpl_mpio(dxpl, H5FD_MPIO_COLLECTIVE);
+
+  //--------------------------------------------------
+  // mesh size as scalar datasets; written by root
+  auto write_int = [&](const char* name, int val)
+  {
+    hid_t space = H5Screate(H5S_SCALAR);
+    hid_t dset = H5Dcreate2(file, name, H5T_NATIVE_INT, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(!is_root) H5Sselect_none(space);
+    H5Dwrite(dset, H5T_NATIVE_INT, space, space, dxpl, &val);
+    H5Dclose(dset);
+    H5Sclose(space);
+  };
+
+  write_int("Nx", nx);
+  write_int("Ny", ny);
+  write_int("Nz", nz);
+
+  //--------------------------------------------------
+  // quantities as 1D datasets in x-fastest order; same as Mesh::serialize
+  const hsize_t Ntot = (hsize_t)nx*ny*nz;
+  hid_t fspace = H5Screate_simple(1, &Ntot, nullptr);
+
+  if(runs.empty()) {
+    H5Sselect_none(fspace);
+  } else {
+    for(size_t r=0; r<runs.size(); r++) {
+      hsize_t start = runs[r].first;
+      hsize_t count = runs[r].second;
+      H5Sselect_hyperslab(fspace, r == 0 ? H5S_SELECT_SET : H5S_SELECT_OR, &start, nullptr, &count, nullptr);
+    }
+  }
+
+  const hsize_t nloc = bufs[0].size();
+  const hsize_t nmem = std::max<hsize_t>(nloc, 1);
+  hid_t mspace = H5Screate_simple(1, &nmem, nullptr);
+  if(nloc == 0) H5Sselect_none(mspace);
+
+  for(size_t v=0; v<var_names.size(); v++) {
+    hid_t dset = H5Dcreate2(file, var_names[v].c_str(), H5T_NATIVE_FLOAT, fspace,
+        H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    H5Dwrite(dset, H5T_NATIVE_FLOAT, mspace, fspace, dxpl, bufs[v].data());
+    H5Dclose(dset);
+  }
+
+  H5Sclose(mspace);
+  H5Sclose(fspace);
+  H5Pclose(dxpl);
+  H5Fclose(file);
+
+#ifdef GPU
+  nvtxRangePop();
+#endif
+
+  return true;
+
+#else
+  if(grid.comm.rank() == 0) {
+    std::cerr << "ParallelFieldsWriter: HDF5 is built without parallel support;"
+              << " no snapshot written for lap " << lap << std::endl;
+  }
+  return false;
+#endif
+}
+
+
+template<size_t D>
+bool h5io::ParallelFieldsWriter<D>::is_available()
+{
+#ifdef H5_HAVE_PARALLEL
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+//--------------------------------------------------
+// explicit template class instantiations
+template class h5io::ParallelFieldsWriter<1>;
+template class h5io::ParallelFieldsWriter<2>;
+template class h5io::ParallelFieldsWriter<3>;
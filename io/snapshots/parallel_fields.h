@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "io/snapshots/snapshot.h"
+#include "external/corgi/corgi.h"
+
+
+namespace h5io {
+
+
+/*! \brief Field snapshots written collectively with parallel HDF5 (MPI-IO)
+ *
+ * Produces the same file as FieldsWriter (flds_<lap>.h5 with Nx, Ny, Nz
+ * and 1D, x-fastest ex..rho datasets) but without the reduction to rank 0:
+ * every rank packs the downsampled data of its own tiles and writes it to
+ * its hyperslabs of the global datasets in one collective call per
+ * quantity. Memory use per rank is proportional to its local tiles only.
+ *
+ * Needs an HDF5 library built with parallel support (H5_HAVE_PARALLEL);
+ * otherwise write() returns false.
+ */
+template<size_t D>
+class ParallelFieldsWriter :
+  public SnapshotWriter<D>
+{
+
+  public:
+
+    using SnapshotWriter<D>::fname;
+    using SnapshotWriter<D>::extension;
+
+    /// general file name used for outputs
+    const string file_name = "flds";
+
+    /// names of the stored quantities, in the order of the packed buffers
+    const std::vector<std::string> var_names =
+      {"ex", "ey", "ez", "bx", "by", "bz", "jx", "jy", "jz", "rho"};
+
+    /// global (downsampled) mesh size
+    int nx;
+    int ny;
+    int nz;
+
+    /// data stride length
+    int stride = 1;
+
+    /// packed local data of each quantity, ordered by file offset
+    std::vector<std::vector<float>> bufs;
+
+    /// contiguous x-runs of the local tiles in the global 1D datasets (offset, length)
+    std::vector<std::pair<size_t, size_t>> runs;
+
+    ParallelFieldsWriter(
+        const std::string& prefix,
+        int Nx, int NxMesh,
+        int Ny, int NyMesh,
+        int Nz, int NzMesh,
+        int stride) :
+      SnapshotWriter<D>{prefix},
+      stride{stride}
+    {
+      nx = Nx*NxMesh/stride;
+      ny = Ny*NyMesh/stride;
+      nz = Nz*NzMesh/stride;
+
+      nx = nx == 0 ? 1 : nx;
+      ny = ny == 0 ? 1 : ny;
+      nz = nz == 0 ? 1 : nz;
+
+      bufs.resize(var_names.size());
+    }
+
+    /// downsample local tiles into the packed buffers
+    void read_tiles(corgi::Grid<D>& grid) override;
+
+    /// write hdf5 file collectively; all ranks need to call
+    bool write(corgi::Grid<D>& grid, int lap) override;
+
+    /// true if HDF5 is built with parallel support; write() fails otherwise
+    static bool is_available();
+
+};
+
+} // end of namespace h5io
@@ -1,4 +1,5 @@
 #include <cmath>
+#include <memory>
 
 #include "io/snapshots/pic_moments.h"
 #include "external/ezh5/src/ezh5.hpp"
@@ -212,22 +213,29 @@ inline void h5io::PicMomentsWriter<D>::read_tiles(
 
 
 template<size_t D>
-inline bool h5io::PicMomentsWriter<D>::write(
+inline std::function<void()> h5io::PicMomentsWriter<D>::stage(
     corgi::Grid<D>& grid, int lap)
 {
   read_tiles(grid);
   mpi_reduce_snapshots(grid);
 
-  if( grid.comm.rank() == 0 ) {
+  if( grid.comm.rank() != 0 ) return {};
+
+  // build filename
+  std::string full_filename = 
+    fname + "/" +
+    file_name + 
+    "_" +
+    std::to_string(lap) +
+    extension;
+  //std::cout << "QW: " << full_filename << std::endl;
+
+  // private copy so that arrs can be reused while the file is written
+  auto data = std::make_shared<std::vector<toolbox::Mesh<float,0>>>(arrs);
 
-    // build filename
-    std::string full_filename = 
-      fname + "/" +
-      file_name + 
-      "_" +
-      std::to_string(lap) +
-      extension;
-    //std::cout << "QW: " << full_filename << std::endl;
+  return [data, full_filename]()
+  {
+    auto& arrs = *data;
 
     // open file and write
     File file(full_filename, H5F_ACC_TRUNC);
@@ -255,8 +263,16 @@ inline bool h5io::PicMomentsWriter<D>::write(
     file["shearxy"]   = arrs[11].serialize();
     file["shearxz"]   = arrs[12].serialize();
     file["shearyz"]   = arrs[13].serialize();
+  };
+}
 
-  }
+
+template<size_t D>
+inline bool h5io::PicMomentsWriter<D>::write(
+    corgi::Grid<D>& grid, int lap)
+{
+  auto job = stage(grid, lap);
+  if(job) job();
 
   return true;
 }
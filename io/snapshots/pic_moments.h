@@ -62,6 +62,8 @@ class PicMomentsWriter :
       // add correct amount of data containers
       for(size_t i=0; i<15; i++) arrs.emplace_back(nx, ny, nz);
       rbuf.emplace_back(nx, ny, nz);
+
+      this->has_stage = true;
     }
 
     /// read tile meshes into memory
@@ -70,6 +72,9 @@ class PicMomentsWriter :
     /// write hdf5 file
     bool write(corgi::Grid<D>& grid, int lap) override;
 
+    /// reduce to root and return the file write as a job
+    std::function<void()> stage(corgi::Grid<D>& grid, int lap) override;
+
 };
 
 } // end of namespace h5io
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <mpi4cpp/mpi.h>
 #include <string>
 #include <utility>
@@ -11,6 +12,7 @@
 #include "tools/fastlog.h"
 #include "tools/mesh.h"
 #include "io/namer.h"
+#include "io/async_writer.h"
 
 
 namespace h5io { 
@@ -41,6 +43,9 @@ class SnapshotWriter {
     /// data stride length
     int stride = 1;
 
+    /// writer implements stage()
+    bool has_stage = false;
+
     /// constructor that creates a name and opens the file handle
     SnapshotWriter( std::string  prefix ) : fname{std::move(prefix)} { }
 
@@ -52,6 +57,26 @@ class SnapshotWriter {
     /// write hdf5 file
     virtual bool write(corgi::Grid<D>& grid, int lap) = 0;
 
+    /// collect and reduce data; returns a job that writes a private copy of it.
+    // Empty job means the writer has no staged version (or nothing to
+    // write on this rank). Collective like write().
+    virtual std::function<void()> stage(corgi::Grid<D>& /*grid*/, int /*lap*/) 
+    { 
+      return {}; 
+    }
+
+    /// write in the background with io; synchronous write() for writers without stage()
+    bool write_async(corgi::Grid<D>& grid, int lap, AsyncWriter& io)
+    {
+      if(!has_stage) {
+        io.wait(); // no concurrent hdf5 calls
+        return write(grid, lap);
+      }
+
+      io.submit( stage(grid, lap) );
+      return true;
+    }
+
     /// communicate snapshots with a B-tree cascade to rank 0
     // NOTE: this version communicates faster but requires n=size(arrs)
     //       number of receive buffers
@@ -1,3 +1,4 @@
+#include <memory>
 #include <mpi4cpp/mpi.h>
 
 #include "io/snapshots/test_prtcls.h"
@@ -102,6 +103,8 @@ h5io::TestPrtclWriter<D>::TestPrtclWriter(
   // int arrays
   for(size_t i=0; i<=1; i++) arrs2.emplace_back(nt, np, nr);
   for(size_t i=0; i<=1; i++) rbuf2.emplace_back(nt, np, nr);
+
+  this->has_stage = true;
 }
 
 
@@ -152,14 +155,19 @@ inline void h5io::TestPrtclWriter<D>::read_tiles(
     float* ch;
     ch = &( container.wgt(0) );
 
-    float *ex, *ey, *ez, *bx, *by, *bz;
-    ex = &( container.Epart[0*nparts] );
-    ey = &( container.Epart[1*nparts] );
-    ez = &( container.Epart[2*nparts] );
+    // particle fields are not stored by fused solvers; written as zeros
+    const bool has_fields = container.store_fields && container.Epart.size() >= 3*container.size();
+
+    float *ex = nullptr, *ey = nullptr, *ez = nullptr, *bx = nullptr, *by = nullptr, *bz = nullptr;
+    if(has_fields) {
+      ex = &( container.Epart[0*nparts] );
+      ey = &( container.Epart[1*nparts] );
+      ez = &( container.Epart[2*nparts] );
 
-    bx = &( container.Bpart[0*nparts] );
-    by = &( container.Bpart[1*nparts] );
-    bz = &( container.Bpart[2*nparts] );
+      bx = &( container.Bpart[0*nparts] );
+      by = &( container.Bpart[1*nparts] );
+      bz = &( container.Bpart[2*nparts] );
+    }
 
     // reference the ids 
     int* idn[2];
@@ -198,13 +206,13 @@ inline void h5io::TestPrtclWriter<D>::read_tiles(
         ids(  tstep, ip, ir) = idn[0][n];
         procs(tstep, ip, ir) = idn[1][n];
 
-        exp(  tstep, ip, ir) = ex[n];
-        eyp(  tstep, ip, ir) = ey[n];
-        ezp(  tstep, ip, ir) = ez[n];
+        exp(  tstep, ip, ir) = has_fields ? ex[n] : 0.0f;
+        eyp(  tstep, ip, ir) = has_fields ? ey[n] : 0.0f;
+        ezp(  tstep, ip, ir) = has_fields ? ez[n] : 0.0f;
 
-        bxp(  tstep, ip, ir) = bx[n];
-        byp(  tstep, ip, ir) = by[n];
-        bzp(  tstep, ip, ir) = bz[n];
+        bxp(  tstep, ip, ir) = has_fields ? bx[n] : 0.0f;
+        byp(  tstep, ip, ir) = has_fields ? by[n] : 0.0f;
+        bzp(  tstep, ip, ir) = has_fields ? bz[n] : 0.0f;
 
       }
     }
@@ -300,36 +308,45 @@ inline void h5io::TestPrtclWriter<D>::mpi_reduce_snapshots(
 
 
 template<size_t D>
-inline bool h5io::TestPrtclWriter<D>::write(
+inline std::function<void()> h5io::TestPrtclWriter<D>::stage(
     corgi::Grid<D>& grid, int lap)
 {
   read_tiles(grid);
   mpi_reduce_snapshots(grid);
 
-  if( grid.comm.rank() == 0 ) {
-
-    // build filename
-    std::string full_filename;
-
-    if(ispc == 0) {
-        full_filename = 
-          fname + "/" +
-          file_name + 
-          "_" +
-          std::to_string(lap) +
-          extension;
-    } else {
-        full_filename = 
-          fname + "/" +
-          file_name + 
-          "-" +
-          std::to_string(ispc) +
-          "_" +
-          std::to_string(lap) +
-          extension;
-    }
+  if( grid.comm.rank() != 0 ) return {};
+
+  // build filename
+  std::string full_filename;
+
+  if(ispc == 0) {
+      full_filename = 
+        fname + "/" +
+        file_name + 
+        "_" +
+        std::to_string(lap) +
+        extension;
+  } else {
+      full_filename = 
+        fname + "/" +
+        file_name + 
+        "-" +
+        std::to_string(ispc) +
+        "_" +
+        std::to_string(lap) +
+        extension;
+  }
+
+  //std::cout << "QW: " << full_filename << std::endl;
+
+  // private copies so that arrs/arrs2 can be reused while the file is written
+  auto data  = std::make_shared<std::vector<toolbox::Mesh<float,0>>>(arrs);
+  auto data2 = std::make_shared<std::vector<toolbox::Mesh<int,0>>>(arrs2);
 
-    //std::cout << "QW: " << full_filename << std::endl;
+  return [data, data2, full_filename]()
+  {
+    auto& arrs  = *data;
+    auto& arrs2 = *data2;
 
     // open file and write
     File file(full_filename, H5F_ACC_TRUNC);
@@ -356,8 +373,16 @@ inline bool h5io::TestPrtclWriter<D>::write(
 
     file["id"]   = arrs2[0].serialize();
     file["proc"] = arrs2[1].serialize();
+  };
+}
 
-  }
+
+template<size_t D>
+inline bool h5io::TestPrtclWriter<D>::write(
+    corgi::Grid<D>& grid, int lap)
+{
+  auto job = stage(grid, lap);
+  if(job) job();
 
   return true;
 }
@@ -72,6 +72,9 @@ class TestPrtclWriter :
     /// write hdf5 file
     bool write(corgi::Grid<D>& grid, int lap) override;
 
+    /// reduce to root and return the file write as a job
+    std::function<void()> stage(corgi::Grid<D>& grid, int lap) override;
+
     /// communicate snapshots with a B-tree cascade to rank 0
     // NOTE: this is modified to send 2 sets of arrays because we need
     // float + int separately
@@ -1,7 +1,11 @@
 #pragma once
 
 #include <string>
+#include <memory>
+#include <utility>
+#include <vector>
 
+#include "io/async_writer.h"
 #include "io/writers/writer.h"
 #include "io/readers/reader.h"
 
@@ -84,6 +88,39 @@ inline void write_grids(
 }
 
 
+/// write_grids on the background thread of io; tile lattices are copied first
+template<size_t D>
+inline void write_grids_async( 
+    corgi::Grid<D>& grid, 
+    int lap,
+    std::string dir,
+    h5io::AsyncWriter& io
+    )
+{
+  if(dir.back() != '/') dir += '/';
+
+  std::string prefix = dir + "fields-"; 
+  prefix += std::to_string(grid.comm.rank());
+
+  using Staged = std::pair<std::tuple<size_t, size_t, size_t>, emf::Grids>;
+  auto data = std::make_shared<std::vector<Staged>>();
+
+  for(auto cid : grid.get_local_tiles() ){
+    const auto& tile 
+      = dynamic_cast<emf::Tile<D>&>(grid.get_tile( cid ));
+    data->emplace_back( h5io::expand_indices(&tile), tile.get_const_grids() );
+  }
+
+  io.submit( [data, prefix, lap]() mutable
+  {
+    h5io::Writer writer(prefix, lap);
+    ezh5::File file(writer.fname.name, H5F_ACC_TRUNC);
+
+    for(auto& [ind, gs] : *data) writer.write(ind, gs, file);
+  });
+}
+
+
 //template<size_t D>
 //inline void write_analysis( 
 //    corgi::Grid<D>& grid, 
@@ -157,6 +194,43 @@ void write_particles(
 }
 
 
+/// write_particles on the background thread of io; particle containers are copied first
+template<size_t D>
+void write_particles_async( 
+    corgi::Grid<D>& grid, 
+    int lap,
+    std::string dir,
+    h5io::AsyncWriter& io
+    )
+{
+  if(dir.back() != '/') dir += '/';
+
+  std::string prefix = dir + "particles-"; 
+  prefix += std::to_string(grid.comm.rank());
+
+  using Staged = std::pair<std::tuple<size_t, size_t, size_t>, std::vector<pic::ParticleContainer<D>>>;
+  auto data = std::make_shared<std::vector<Staged>>();
+
+  for(auto cid : grid.get_local_tiles() ){
+    const auto& tile 
+      = dynamic_cast<pic::Tile<D>&>(grid.get_tile( cid ));
+
+    data->emplace_back();
+    data->back().first = h5io::expand_indices(&tile);
+    for(int ispc=0; ispc<tile.Nspecies(); ispc++) 
+      data->back().second.push_back( tile.get_const_container(ispc) );
+  }
+
+  io.submit( [data, prefix, lap]() mutable
+  {
+    h5io::Writer writer(prefix, lap);
+    ezh5::File file(writer.fname.name, H5F_ACC_TRUNC);
+
+    for(auto& [ind, containers] : *data) writer.write(ind, containers, file);
+  });
+}
+
+
 template<size_t D>
 inline void read_particles( 
     corgi::Grid<D>& grid, 
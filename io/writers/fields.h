@@ -12,10 +12,21 @@ h5io::Writer::write(
   ezh5::File& file
   )
 {
-  const auto& gs = tile.get_const_grids();
-
   // internal tile numbering 
   auto my_ind = expand_indices( &tile );
+
+  return write(my_ind, tile.get_const_grids(), file);
+}
+
+
+/// Write Yee lattice of tile at my_ind into a hdf5 data group
+inline bool 
+h5io::Writer::write( 
+  std::tuple<size_t, size_t, size_t> my_ind,
+  const emf::Grids& gs,
+  ezh5::File& file
+  )
+{
   string numbering = create_numbering(my_ind);
 
   // open individual group for the data
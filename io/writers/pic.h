@@ -12,6 +12,24 @@ h5io::Writer::write(
 {
   // internal tile numbering 
   auto my_ind = expand_indices( &tile );
+
+  // todo set back to const ref at some point...
+  std::vector<pic::ParticleContainer<D>> containers;
+  for(int ispc=0; ispc<tile.Nspecies(); ispc++) 
+    containers.push_back( tile.get_const_container(ispc) );
+
+  return write(my_ind, containers, file);
+}
+
+
+template<size_t D>
+bool
+h5io::Writer::write(
+  std::tuple<size_t, size_t, size_t> my_ind,
+  std::vector<pic::ParticleContainer<D>>& containers,
+  ezh5::File& file
+  ) 
+{
   string numbering = create_numbering(my_ind);
 
   // group for tile
@@ -22,14 +40,13 @@ h5io::Writer::write(
   gr1["k"] = static_cast<int>( std::get<2>(my_ind) );
 
   // loop over different particle species 
-  for(int ispc=0; ispc<tile.Nspecies(); ispc++) {
+  for(int ispc=0; ispc<(int)containers.size(); ispc++) {
 
     // group for species + tile metainfo
     auto gr = gr1["sp-" + std::to_string(ispc)];
     gr["sp"] = static_cast<int>( ispc );
 
-    // todo set back to const ref at some point...
-    pic::ParticleContainer<D> container = tile.get_const_container(ispc);
+    auto& container = containers[ispc];
 
     gr["x"]   = container.loc(0);
     gr["y"]   = container.loc(1);
@@ -48,4 +65,3 @@ h5io::Writer::write(
 
   return true;
 }
-
@@ -13,3 +13,6 @@ template bool h5io::Writer::write(const vlv::Tile<1>&   , ezh5::File&);
 // pic
 template bool h5io::Writer::write(const pic::Tile<2>&   , ezh5::File&); 
 template bool h5io::Writer::write(const pic::Tile<3>&   , ezh5::File&); 
+
+template bool h5io::Writer::write(std::tuple<size_t,size_t,size_t>, std::vector<pic::ParticleContainer<2>>&, ezh5::File&); 
+template bool h5io::Writer::write(std::tuple<size_t,size_t,size_t>, std::vector<pic::ParticleContainer<3>>&, ezh5::File&); 
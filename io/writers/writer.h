@@ -94,6 +94,18 @@ class Writer {
     template<size_t D>
     bool write(const pic::Tile<D>& tile, ezh5::File& file);
 
+    /// tile content staged away from the tile; used by the async checkpoints
+    bool write(
+        std::tuple<size_t, size_t, size_t> my_ind, 
+        const emf::Grids& gs, 
+        ezh5::File& file);
+
+    template<size_t D>
+    bool write(
+        std::tuple<size_t, size_t, size_t> my_ind, 
+        std::vector<pic::ParticleContainer<D>>& containers, 
+        ezh5::File& file);
+
 
 };
 
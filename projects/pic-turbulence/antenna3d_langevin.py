@@ -306,12 +306,9 @@ class Antenna:
         g = tile.get_grids(0)
         self.comp_cur(tile) # update internal array
 
-        #copy from numpy arrys into tile straight
-        for r in range(self.NzMesh):
-            for s in range(self.NyMesh):
-                for q in range(self.NxMesh):
-                    g.bx[q,s,r] += self.bx[q+1,s+1,r+1]
-                    g.by[q,s,r] += self.by[q+1,s+1,r+1]
+        #add numpy arrays into tile straight through zero-copy views
+        g.bx.view()[:,:,:] += self.bx[1:self.NxMesh+1, 1:self.NyMesh+1, 1:self.NzMesh+1]
+        g.by.view()[:,:,:] += self.by[1:self.NxMesh+1, 1:self.NyMesh+1, 1:self.NzMesh+1]
         return
 
 
@@ -319,12 +316,9 @@ class Antenna:
         g = tile.get_grids(0)
         self.comp_cur(tile) # update internal array
 
-        for r in range(self.NzMesh):
-            for s in range(self.NyMesh):
-                for q in range(self.NxMesh):
-                    g.jx[q,s,r] += self.jx[q,s,r]
-                    g.jy[q,s,r] += self.jy[q,s,r]
-                    g.jz[q,s,r] += self.jz[q,s,r]
+        g.jx.view()[:,:,:] += self.jx[:self.NxMesh, :self.NyMesh, :self.NzMesh]
+        g.jy.view()[:,:,:] += self.jy[:self.NxMesh, :self.NyMesh, :self.NzMesh]
+        g.jz.view()[:,:,:] += self.jz[:self.NxMesh, :self.NyMesh, :self.NzMesh]
 
 
         #max_cur = 0.0
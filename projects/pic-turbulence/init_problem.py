@@ -82,6 +82,44 @@ class Configuration_Turbulence(Configuration):
         self.c_corr = 1.0 # no speed of light correction
         self.use_maxwell_split = False
 
+        # particle sorting frequency in laps; off by default
+        if "sort_interval" not in self.__dict__:
+            self.sort_interval = 0
+
+        # fused interpolate-push-deposit kernel; off by default
+        if "use_fused" not in self.__dict__:
+            self.use_fused = False
+
+        # fused multi-pass current filter; off by default
+        if "fused_filter" not in self.__dict__:
+            self.fused_filter = False
+
+        # cache-blocked field solver with fused B half + E push; 3D only, off by default
+        if "blocked_fdtd" not in self.__dict__:
+            self.blocked_fdtd = False
+
+        # collective parallel-hdf5 field snapshots; needs hdf5 with mpi support
+        if "parallel_io" not in self.__dict__:
+            self.parallel_io = False
+
+        # write snapshots and checkpoints from a background thread
+        if "async_io" not in self.__dict__:
+            self.async_io = False
+
+        # restart files as one compressed file for all ranks (deflate level 0-9)
+        if "single_file_restart" not in self.__dict__:
+            self.single_file_restart = False
+        if "restart_compression" not in self.__dict__:
+            self.restart_compression = 0
+
+        # inject the plasma with the native c++ loader instead of pytools.pic.inject
+        if "native_loader" not in self.__dict__:
+            self.native_loader = False
+
+        # dynamic load balancing frequency in laps; off by default
+        if "lb_interval" not in self.__dict__:
+            self.lb_interval = 0
+
         # local variables just for easier/cleaner syntax
         me = np.abs(self.me)
         mi = np.abs(self.mi)
@@ -30,27 +30,20 @@ def insert_em_fields(grid, conf, do_initialization=True):
 
         # insert values into Yee lattices; includes halos from -3 to n+3
         if do_initialization:
-            for n in range(-3, conf.NzMesh + 3):
-                for m in range(-3, conf.NyMesh + 3):
-                    for l in range(-3, conf.NxMesh + 3):
+            if not(conf.use_maxwell_split): # if no static component
 
-                        if not(conf.use_maxwell_split): # if no static component
+                # in-place through zero-copy views of the meshes
+                g.ex.view(halo=True)[:] = 0.0
+                g.ey.view(halo=True)[:] = 0.0
+                g.ez.view(halo=True)[:] = 0.0
 
-                            # get global coordinates
-                            #iglob, jglob, kglob = pytools.ind2loc((ii, jj, kk), (l, m, n), conf)
-                            #r = np.sqrt(iglob ** 2 + jglob ** 2 + kglob ** 2)
+                g.bx.view(halo=True)[:] = 0.0
+                g.by.view(halo=True)[:] = 0.0 
+                g.bz.view(halo=True)[:] = conf.binit
 
-                            g.ex[l,m,n] = 0.0
-                            g.ey[l,m,n] = 0.0
-                            g.ez[l,m,n] = 0.0
-
-                            g.bx[l,m,n] = 0.0
-                            g.by[l,m,n] = 0.0 
-                            g.bz[l,m,n] = conf.binit
-
-                        elif conf.use_maxwell_split: # static component
-                            1
-                            # TODO
+            elif conf.use_maxwell_split: # static component
+                1
+                # TODO
     return
         
 #-------------------------------------------------- 
@@ -81,6 +74,10 @@ if __name__ == "__main__":
 
     sch.timer = timer # remember to update scheduler
 
+    # per-op performance counters; rank-aggregated report is appended to counters.json
+    import pyrunko.tools
+    sch.counters = pyrunko.tools.PerfCounters()
+
     # --------------------------------------------------
     # create output folders
     if sch.is_master: pytools.create_output_folders(conf)
@@ -139,8 +136,25 @@ if __name__ == "__main__":
         np.random.seed(rseed + rnd_seed_default)  # sync rnd generator seed for different mpi ranks
 
         # injecting plasma particles
-        if not(conf.use_injector):
+        if not(conf.use_injector) and conf.native_loader:
+            # same plasma as velocity_profile/density_profile; positrons on top of electrons
+            prtcl_stat = np.zeros(conf.Nspecies, dtype=np.int64)
+            thetas = [conf.delgam_e, conf.delgam_i, conf.delgam_x]
+            for ispcs in range(conf.Nspecies):
+                for tile in pytools.tiles_local(grid):
+                    tile.get_container(ispcs).type = conf.prtcl_types[ispcs]
+
+                loader = pypic.PlasmaLoader()
+                loader.seed = rnd_seed_default
+                loader.theta = thetas[ispcs]
+                loader.ppc = density_profile(None, ispcs, conf)
+                if ispcs == 2: loader.distribution = "blackbody"
+                prtcl_stat[ispcs] = loader.load(grid, ispcs, ref_species=0 if ispcs == 1 else -1)
+
+        elif not(conf.use_injector):
             prtcl_stat = pytools.pic.inject(grid, velocity_profile, density_profile, conf)
+
+        if not(conf.use_injector):
             if sch.is_example_worker: 
                 print("injected:")
                 print("     e- prtcls: {}".format(prtcl_stat[0]))
@@ -160,8 +174,12 @@ if __name__ == "__main__":
         insert_em_fields(grid, conf, do_initialization=False)
 
         # read restart files
-        pyfld.read_grids(grid, io_stat["read_lap"], io_stat["read_dir"])
-        pypic.read_particles(grid, io_stat["read_lap"], io_stat["read_dir"])
+        if conf.single_file_restart:
+            # any number of ranks can read the single-file checkpoint
+            pypic.Checkpoint(io_stat["read_dir"]).read(grid, io_stat["read_lap"])
+        else:
+            pyfld.read_grids(grid, io_stat["read_lap"], io_stat["read_dir"])
+            pypic.read_particles(grid, io_stat["read_lap"], io_stat["read_dir"])
 
         # set particle types
         for tile in pytools.tiles_all(grid):
@@ -223,8 +241,15 @@ if __name__ == "__main__":
     if sch.is_master: print("loading solvers..."); sys.stdout.flush()
 
 
-    sch.fldpropE = pyfld.FDTD2()
-    sch.fldpropB = pyfld.FDTD2()
+    if conf.blocked_fdtd:
+        # cache-blocked solver; 3D only
+        if not conf.threeD:
+            raise ValueError("blocked_fdtd is only available in 3D; set blocked_fdtd: False")
+        sch.fldpropE = pyfld.FDTD2Blocked()
+        sch.fldpropB = pyfld.FDTD2Blocked()
+    else:
+        sch.fldpropE = pyfld.FDTD2()
+        sch.fldpropB = pyfld.FDTD2()
     #sch.fldpropE = pyfld.FDTD4()
     #sch.fldpropB = pyfld.FDTD4()
 
@@ -240,6 +265,7 @@ if __name__ == "__main__":
     #sch.pusher = pypic.VayPusher()
     sch.pusher = pypic.HigueraCaryPusher()
     #sch.pusher  = pypic.rGCAPusher()
+    #sch.pusher = pypic.SimdHigueraCaryPusher()    # vectorized; F32 suffix for single precision
 
     #if conf.gammarad > 0:
     #    sch.pusher   = pypic.BorisDragPusher()
@@ -273,18 +299,29 @@ if __name__ == "__main__":
     #sch.currint = pypic.Esikerpov_2nd() # 3d only
     #sch.currint = pypic.Esikerpov_4th() # 3d only
 
+    # --------------------------------------------------
+    # fused interp + push + deposit in one pass; same scheme as fintp, pusher, and currint above
+    sch.fused = pypic.FusedLinearHigueraCaryZigZag()
+
     # --------------------------------------------------
     #filter
-    sch.flt = pyfld.Binomial2(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+    if conf.fused_filter:
+        sch.flt = pyfld.FusedBinomial2(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+    else:
+        sch.flt = pyfld.Binomial2(conf.NxMesh, conf.NyMesh, conf.NzMesh)
 
 
     # --------------------------------------------------
     # I/O objects
     if sch.is_master: print("loading IO objects..."); sys.stdout.flush()
 
-    # quick field snapshots
+    # background hdf5 writer; snapshots are staged in memory and written while the simulation continues
+    io = pyrunko.tools.AsyncWriter(2) if conf.async_io else None
+
+    # quick field snapshots; parallel writer stores the same file without gathering to root
     #fld_writer = pyfld.MasterFieldsWriter(
-    fld_writer = pyfld.FieldsWriter(
+    FieldsWriter = pyfld.ParallelFieldsWriter if conf.parallel_io else pyfld.FieldsWriter
+    fld_writer = FieldsWriter(
         conf.outdir,
         conf.Nx,
         conf.NxMesh,
@@ -350,6 +387,10 @@ if __name__ == "__main__":
     timer.stop("init")
     timer.stats("init")
 
+    # --------------------------------------------------
+    # dynamic load balancer; moves tiles between ranks every lb_interval laps
+    balancer = pytools.LoadBalancer(conf, interval=conf.lb_interval)
+
     if sch.is_master: print('init: starting simulation...'); sys.stdout.flush()
 
 
@@ -360,6 +401,18 @@ if __name__ == "__main__":
     time = lap * (conf.cfl / conf.c_omp)
     for lap in range(lap, conf.Nt + 1):
 
+        # --------------------------------------------------
+        # repartition tiles by measured cost
+        if balancer.rebalance(grid, lap, sch):
+            if sch.is_master:
+                print("lb  : moved {} tiles; imbalance {:.3f} -> {:.3f}".format(
+                    balancer.num_moved, balancer.imbalance_before, balancer.imbalance_after))
+
+        # --------------------------------------------------
+        # sort particles by cell for cache-friendly interpolation and deposition
+        if conf.sort_interval > 0 and lap % conf.sort_interval == 0:
+            sch.operate( dict(name='sort_prtcls', solver='tile', method='sort_particles', nhood='local', ) )
+
         # --------------------------------------------------
         # comm E and B
         sch.operate( dict(name='mpi_b0', solver='mpi', method='b', ) )
@@ -371,40 +424,64 @@ if __name__ == "__main__":
         sch.operate( dict(name='push_half_b1', solver='fldpropB', method='push_half_b', nhood='local',) )
         #sch.operate( dict(name='wall_bc',      solver='lwall',    method='field_bc',    nhood='local',) )
 
-        # comm B
-        sch.operate( dict(name='mpi_b1',  solver='mpi', method='b',                 ) )
-        sch.operate( dict(name='upd_bc ', solver='tile',method='update_boundaries',args=[grid, [2,] ], nhood='local',) )
+        # comm B; split-phase so that interior tiles are pushed while messages are in flight
+        sch.operate( dict(name='mpi_b1',  solver='mpi_post', method='b',                 ) )
+        sch.operate( dict(name='upd_bc ', solver='tile',method='update_boundaries',args=[grid, [2,] ], nhood='interior',) )
 
         # --------------------------------------------------
         # move particles (only locals tiles)
 
         # interpolate fields and push particles in x and u
-        sch.operate( dict(name='interp_em', solver='fintp',  method='solve', nhood='local', ) )
-        #sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='local', ) )
-        sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='local', args=[0]) ) # e^-
-        sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='local', args=[1]) ) # e^+
+        if conf.use_fused:
+            # fused kernel also deposits the current
+            sch.operate( dict(name='fused_push', solver='fused',  method='solve', nhood='interior', ) )
+        else:
+            sch.operate( dict(name='interp_em', solver='fintp',  method='solve', nhood='interior', ) )
+            sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='interior', args=[0]) ) # e^-
+            sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='interior', args=[1]) ) # e^+
+
+        # complete comm B and repeat for mpi boundary tiles
+        sch.operate( dict(name='mpi_b1',  solver='mpi_wait', method='b',                 ) )
+        sch.operate( dict(name='upd_bc ', solver='tile',method='update_boundaries',args=[grid, [2,] ], nhood='boundary',) )
+        if conf.use_fused:
+            sch.operate( dict(name='fused_push', solver='fused',  method='solve', nhood='boundary', ) )
+        else:
+            sch.operate( dict(name='interp_em', solver='fintp',  method='solve', nhood='boundary', ) )
+            #sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='local', ) )
+            sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='boundary', args=[0]) ) # e^-
+            sch.operate( dict(name='push',      solver='pusher', method='solve', nhood='boundary', args=[1]) ) # e^+
 
 
         # clear currents; need to call this before wall operations since they can deposit currents too 
-        sch.operate( dict(name='clear_cur', solver='tile',   method='clear_current', nhood='all', ) )
+        # fused kernel clears the currents itself before depositing
+        if not conf.use_fused:
+            sch.operate( dict(name='clear_cur', solver='tile',   method='clear_current', nhood='all', ) )
 
         # apply moving/reflecting walls
         #sch.operate( dict(name='walls',     solver='lwall', method='solve', nhood='local', ) )
 
 
         # --------------------------------------------------
-        # advance half B 
-        sch.operate( dict(name='push_half_b2', solver='fldpropB', method='push_half_b', nhood='local', ) )
-        #sch.operate( dict(name='wall_bc',      solver='lwall',    method='field_bc',    nhood='local', ) )
+        # advance half B and push E
+        if conf.blocked_fdtd:
+            # one sweep; B is also advanced on the lower halo layer so no B exchange is needed in between
+            sch.operate( dict(name='push_half_b_e', solver='fldpropE', method='push_half_b_e', nhood='local', ) )
+        else:
+            sch.operate( dict(name='push_half_b2', solver='fldpropB', method='push_half_b', nhood='local', ) )
+            #sch.operate( dict(name='wall_bc',      solver='lwall',    method='field_bc',    nhood='local', ) )
 
-        # comm B
-        sch.operate( dict(name='mpi_b2', solver='mpi', method='b',                 ) )
-        sch.operate( dict(name='upd_bc', solver='tile',method='update_boundaries', args=[grid, [2,] ], nhood='local',) )
+            # comm B; split-phase
+            sch.operate( dict(name='mpi_b2', solver='mpi_post', method='b',                 ) )
+            sch.operate( dict(name='upd_bc', solver='tile',method='update_boundaries', args=[grid, [2,] ], nhood='interior',) )
 
+            # --------------------------------------------------
+            # push E
+            sch.operate( dict(name='push_e',   solver='fldpropE', method='push_e',  nhood='interior', ) )
 
-        # --------------------------------------------------
-        # push E
-        sch.operate( dict(name='push_e',   solver='fldpropE', method='push_e',  nhood='local', ) )
+            # complete comm B and repeat for mpi boundary tiles
+            sch.operate( dict(name='mpi_b2', solver='mpi_wait', method='b',                 ) )
+            sch.operate( dict(name='upd_bc', solver='tile',method='update_boundaries', args=[grid, [2,] ], nhood='boundary',) )
+            sch.operate( dict(name='push_e',   solver='fldpropE', method='push_e',  nhood='boundary', ) )
         #sch.operate( dict(name='wall_bc',  solver='lwall',    method='field_bc',nhood='local', ) )
 
         # TODO current deposit + MPI was here
@@ -429,21 +506,34 @@ if __name__ == "__main__":
         # --------------------------------------------------
         # current calculation; charge conserving current deposition
         # clear virtual current arrays for boundary addition after mpi, send currents, and exchange between tiles
-        sch.operate( dict(name='comp_curr', solver='currint', method='solve', nhood='local', ) )
+        if not conf.use_fused:
+            sch.operate( dict(name='comp_curr', solver='currint', method='solve', nhood='local', ) )
         sch.operate( dict(name='clear_vir_cur', solver='tile',method='clear_current',     nhood='virtual', ) )
         sch.operate( dict(name='mpi_cur',       solver='mpi', method='j',                 nhood='all', ) )
         sch.operate( dict(name='cur_exchange',  solver='tile',method='exchange_currents', nhood='local', args=[grid,], ) )
 
         # --------------------------------------------------
         # filter
-        for fj in range(conf.npasses):
+        if conf.fused_filter:
+            # fused filter does up to 3 passes (the halo width) in one sweep after each halo update
+            npass = conf.npasses
+            while npass > 0:
+                sch.flt.npasses = min(npass, 3)
+                npass -= sch.flt.npasses
 
-            # flt uses halo=2 padding so only every 3rd (0,1,2) pass needs update
-            if fj % 2 == 0:
                 sch.operate( dict(name='mpi_cur_flt', solver='mpi', method='j', ) )
                 sch.operate( dict(name='upd_bc',      solver='tile',method='update_boundaries',args=[grid, [0,] ], nhood='local', ) )
-                MPI.COMM_WORLD.barrier()
-            sch.operate( dict(name='filter', solver='flt', method='solve', nhood='local', ) )
+                sch.operate( dict(name='filter', solver='flt', method='solve', nhood='local', ) )
+
+        else:
+            for fj in range(conf.npasses):
+
+                # flt uses halo=2 padding so only every 3rd (0,1,2) pass needs update
+                if fj % 2 == 0:
+                    sch.operate( dict(name='mpi_cur_flt', solver='mpi', method='j', ) )
+                    sch.operate( dict(name='upd_bc',      solver='tile',method='update_boundaries',args=[grid, [0,] ], nhood='local', ) )
+                    MPI.COMM_WORLD.barrier()
+                sch.operate( dict(name='filter', solver='flt', method='solve', nhood='local', ) )
 
 
         # --------------------------------------------------
@@ -471,6 +561,8 @@ if __name__ == "__main__":
             timer.comp_stats()
             timer.purge_comps()
 
+            pytools.write_counters(sch.counters, lap, conf.outdir + "/counters.json", MPI.COMM_WORLD)
+
             # io/analyze (independent)
             timer.start("io")
             # shrink particle arrays
@@ -482,16 +574,24 @@ if __name__ == "__main__":
 
             # shallow IO
             # NOTE: do moms before other IOs to keep rho field up-to-date
-            mom_writer.write(grid, lap)  # pic distribution moments; 
-            fld_writer.write(grid, lap)  # quick field snapshots
-
-            for pw in prtcl_writers:
-                pw.write(grid, lap)  # particle tracking
+            if io is None:
+                mom_writer.write(grid, lap)  # pic distribution moments; 
+                fld_writer.write(grid, lap)  # quick field snapshots
+
+                for pw in prtcl_writers:
+                    pw.write(grid, lap)  # particle tracking
+            else:
+                mom_writer.write_async(grid, lap, io)
+                fld_writer.write_async(grid, lap, io)
+
+                for pw in prtcl_writers:
+                    pw.write_async(grid, lap, io)
             
             #pytools.save_mpi_grid_to_disk(conf.outdir, lap, grid, conf) # MPI grid
 
             #box peripheries 
             if conf.threeD:
+                if io is not None: io.wait() # slice writers call hdf5 directly
                 slice_xy_writer.write(grid, lap)
                 slice_xz_writer.write(grid, lap)
                 slice_yz_writer.write(grid, lap)
@@ -520,8 +620,12 @@ if __name__ == "__main__":
             #--------------------------------------------------
             # deep IO
             if conf.full_interval > 0 and (lap % conf.full_interval == 0) and (lap > 0):
-                pyfld.write_grids(grid, lap, conf.outdir + "/full_output/")
-                pypic.write_particles(grid, lap, conf.outdir + "/full_output/")
+                if io is None:
+                    pyfld.write_grids(grid, lap, conf.outdir + "/full_output/")
+                    pypic.write_particles(grid, lap, conf.outdir + "/full_output/")
+                else:
+                    pyfld.write_grids_async(grid, lap, conf.outdir + "/full_output/", io)
+                    pypic.write_particles_async(grid, lap, conf.outdir + "/full_output/", io)
 
 
             # restart IO (overwrites)
@@ -530,15 +634,22 @@ if __name__ == "__main__":
                 # flip between two sets of files
                 io_stat["deep_io_switch"] = 1 if io_stat["deep_io_switch"] == 0 else 0
 
-                pyfld.write_grids(
-                    grid, io_stat["deep_io_switch"] + io_stat['restart_num'],
-                    conf.outdir + "/restart/"
-                )
+                # restart files are written synchronously so that laps.txt only lists complete files
+                if io is not None: io.wait()
 
-                pypic.write_particles(
-                    grid, io_stat["deep_io_switch"] + io_stat['restart_num'],
-                    conf.outdir + "/restart/"
-                )
+                if conf.single_file_restart:
+                    pypic.Checkpoint(conf.outdir + "/restart/", conf.restart_compression).write(
+                        grid, io_stat["deep_io_switch"] + io_stat['restart_num'])
+                else:
+                    pyfld.write_grids(
+                        grid, io_stat["deep_io_switch"] + io_stat['restart_num'],
+                        conf.outdir + "/restart/"
+                    )
+
+                    pypic.write_particles(
+                        grid, io_stat["deep_io_switch"] + io_stat['restart_num'],
+                        conf.outdir + "/restart/"
+                    )
 
                 # if successful adjust info file
                 MPI.COMM_WORLD.barrier()  # sync everybody in case of failure before write
@@ -567,6 +678,8 @@ if __name__ == "__main__":
     # --------------------------------------------------
     # end of simulation
 
+    if io is not None: io.wait() # flush pending snapshots
+
     timer.stop("total")
     timer.stats("total")
 
@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+#
+# QED pairing benchmark
+#
+# Measures the cost of the binary QED pairing on the setup of tests/test_rad.py
+# (thermal e-, e+ and photons in a 3D tile with Compton scattering, pair
+# annihilation and photon annihilation) with tile-wide pairing (cell_bin = 0)
+# and with pairing inside cubes of cell_bin^3 grid cells.
+#
+# usage:
+#   python3 qed_pairing_benchmark.py --nx 16 --ppc 20 --laps 3 --cell_bins 0 1 2
+#   python3 qed_pairing_benchmark.py --all2all --nx 4 --ppc 20
+#
+# The normalization keeps the maximum virtual interaction rate per step at ~0.1
+# so that the number of interactions can be compared between the modes.
+
+import argparse
+import time
+import numpy as np
+
+import pyrunko.pic as pypic
+import pyrunko.qed as pyqed
+
+
+def build_tile(nx, ppc, rng):
+    tile = pypic.threeD.Tile(nx, nx, nx)
+    tile.set_tile_mins([0.0, 0.0, 0.0])
+    tile.set_tile_maxs([float(nx), float(nx), float(nx)])
+
+    N = ppc*nx**3
+    for t in ['e-', 'e+', 'ph']:
+        con = pypic.threeD.ParticleContainer()
+        con.type = t
+        con.q = 0.0 if t == 'ph' else 1.0
+        con.m = 0.0 if t == 'ph' else 1.0
+        con.reserve(N)
+
+        xs = nx*rng.random((N, 3))
+        us = (3.0 if t == 'ph' else 2.0)*rng.standard_normal((N, 3))
+        for n in range(N):
+            con.add_particle(list(xs[n]), list(us[n]), 1.0)
+        tile.set_container(con)
+
+    return tile
+
+
+def build_pairing(nx, ppc, cell_bin, all2all):
+    if all2all:
+        pairing = pyqed.threeD.PairingAll2All()
+    else:
+        pairing = pyqed.threeD.Pairing()
+    pairing.cell_bin = cell_bin
+    pairing.prob_norm = 5.0*ppc*nx**3
+
+    pairing.add_interaction(pyqed.Compton('e-', 'ph'))
+    pairing.add_interaction(pyqed.Compton('e+', 'ph'))
+    pairing.add_interaction(pyqed.PairAnn('e-', 'e+'))
+    pairing.add_interaction(pyqed.PhotAnn('ph', 'ph'))
+    return pairing
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='QED pairing benchmark')
+    parser.add_argument('--nx',    type=int, default=16, help='tile size in cells per dimension')
+    parser.add_argument('--ppc',   type=int, default=20, help='particles per cell per species')
+    parser.add_argument('--laps',  type=int, default=3,  help='number of measured laps')
+    parser.add_argument('--cell_bins', type=int, nargs='+', default=[0, 1, 2], help='pairing cell sizes; 0 is tile-wide')
+    parser.add_argument('--all2all', action='store_true', help='use the all-to-all pairing')
+    args = parser.parse_args()
+
+    Ntot = 3*args.ppc*args.nx**3
+    print("qed_pairing_benchmark: tile {}^3, {} particles, {} laps".format(args.nx, Ntot, args.laps))
+
+    for cell_bin in args.cell_bins:
+        rng = np.random.default_rng(1) # same initial state for all modes
+        tile = build_tile(args.nx, args.ppc, rng)
+        pairing = build_pairing(args.nx, args.ppc, cell_bin, args.all2all)
+
+        t = 0.0
+        for lap in range(args.laps):
+            t0 = time.perf_counter()
+            pairing.solve_twobody(tile, lap=lap)
+            t += time.perf_counter() - t0
+
+        nums = [tile.get_container(i).size() for i in range(3)]
+        print("  cell_bin {:3d}  {:8.3f} s/lap  {:8.1f} ns/prtcl  N(e-, e+, ph): {}".format(
+            cell_bin, t/args.laps, t/args.laps/Ntot*1.0e9, nums))
@@ -0,0 +1,119 @@
+# -*- coding: utf-8 -*-
+#
+# Particle sorting benchmark
+#
+# Measures the throughput of the interpolate-push-deposit loop on a
+# turbulence-like setup (thermal pair plasma in a 3D tile) when particles
+# are in random order vs. sorted by cell with Tile.sort_particles().
+#
+# usage:
+#   python3 sort_benchmark.py --nx 32 --ppc 16 --laps 10
+#
+# cache misses can be compared by running both modes under perf, e.g.
+#   perf stat -e cache-misses,cache-references python3 sort_benchmark.py --mode random
+#   perf stat -e cache-misses,cache-references python3 sort_benchmark.py --mode sorted
+
+import argparse
+import time
+import numpy as np
+
+import pycorgi
+import pyrunko
+
+
+class Conf:
+    Nx = 1
+    Ny = 1
+    Nz = 1
+    NxMesh = 32
+    NyMesh = 32
+    NzMesh = 32
+    cfl = 0.45
+    qe = -0.01
+    qi = 0.01
+    delgam = 0.3 # temperature
+
+
+def build_tile(conf, ppc, rng):
+    grid = pycorgi.threeD.Grid(conf.Nx, conf.Ny, conf.Nz)
+    grid.set_grid_lims(0.0, conf.NxMesh, 0.0, conf.NyMesh, 0.0, conf.NzMesh)
+
+    tile = pyrunko.pic.threeD.Tile(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+    tile.cfl = conf.cfl
+    grid.add_tile(tile, (0,0,0))
+
+    # random fields so that interpolation reads real values
+    gs = tile.get_grids(0)
+    for arr in [gs.ex, gs.ey, gs.ez, gs.bx, gs.by, gs.bz]:
+        for k in range(conf.NzMesh):
+            for j in range(conf.NyMesh):
+                for i in range(conf.NxMesh):
+                    arr[i,j,k] = 1.0e-3*rng.standard_normal()
+
+    # particles in random order, as after the plasma has mixed
+    N = ppc*conf.NxMesh*conf.NyMesh*conf.NzMesh
+    for ispcs, q in enumerate([conf.qe, conf.qi]):
+        container = pyrunko.pic.threeD.ParticleContainer()
+        container.type = 'e-' if ispcs == 0 else 'e+'
+        container.q = q
+        container.m = 1.0
+        container.reserve(N)
+
+        xs = rng.uniform(0.0, 1.0, (N, 3))*np.array([conf.NxMesh, conf.NyMesh, conf.NzMesh])
+        us = np.sqrt(conf.delgam)*rng.standard_normal((N, 3))
+        for n in range(N):
+            container.add_particle(list(xs[n]), list(us[n]), 1.0)
+
+        tile.set_container(container)
+
+    return grid, tile
+
+
+def run(tile, laps, sort_interval):
+    fintp   = pyrunko.pic.threeD.LinearInterpolator()
+    pusher  = pyrunko.pic.threeD.BorisPusher()
+    currint = pyrunko.pic.threeD.ZigZag()
+
+    t_sort = 0.0
+    t_loop = 0.0
+    for lap in range(laps):
+        if sort_interval > 0 and lap % sort_interval == 0:
+            t0 = time.perf_counter()
+            tile.sort_particles()
+            t_sort += time.perf_counter() - t0
+
+        t0 = time.perf_counter()
+        fintp.solve(tile)
+        pusher.solve(tile)
+        tile.clear_current()
+        currint.solve(tile)
+        t_loop += time.perf_counter() - t0
+
+    return t_loop, t_sort
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Particle sorting benchmark')
+    parser.add_argument('--nx',    type=int, default=32, help='tile size in cells per dimension')
+    parser.add_argument('--ppc',   type=int, default=16, help='particles per cell per species')
+    parser.add_argument('--laps',  type=int, default=10, help='number of measured laps')
+    parser.add_argument('--sort_interval', type=int, default=10, help='sorting frequency in laps')
+    parser.add_argument('--mode',  type=str, default='both', choices=['both', 'random', 'sorted'])
+    args = parser.parse_args()
+
+    conf = Conf()
+    conf.NxMesh = conf.NyMesh = conf.NzMesh = args.nx
+
+    Ntot = 2*args.ppc*args.nx**3
+    modes = ['random', 'sorted'] if args.mode == 'both' else [args.mode]
+
+    print("sort_benchmark: tile {}^3, {} particles, {} laps".format(args.nx, Ntot, args.laps))
+    for mode in modes:
+        rng = np.random.default_rng(1) # same initial state for both modes
+        grid, tile = build_tile(conf, args.ppc, rng)
+
+        sort_interval = args.sort_interval if mode == 'sorted' else 0
+        t_loop, t_sort = run(tile, args.laps, sort_interval)
+
+        print("  {:8s}  loop: {:8.3f} s  sort: {:8.3f} s  throughput: {:8.2f} Mprtcl/s".format(
+            mode, t_loop, t_sort, Ntot*args.laps/(t_loop + t_sort)/1.0e6))
@@ -2,10 +2,11 @@
 
 # misc
 from .timer import *
+from .counters import gather_counters, write_counters
 from .cli import *
 from .conf import *
 from .load_grid import *
-from .generators import tiles_all, tiles_local, tiles_virtual, tiles_boundary
+from .generators import tiles_all, tiles_local, tiles_virtual, tiles_boundary, tiles_interior
 from .iotools import read_h5_array
 #from .pybox import box as pybox3d
 from .pic.tile_initialization import ind2loc #FIXME: this function should be defined in this level instead of pic submodule
@@ -14,6 +15,7 @@ from .sampling import sample_blackbody
 from .indices import Stagger
 from .indices import get_index
 from .scheduler import Scheduler
+from .load_balance import LoadBalancer
 from .terminal_plot import TerminalPlot
 from .string_manipulation import simplify_string, simplify_large_num
 from .banner import print_banner
@@ -0,0 +1,101 @@
+# -*- coding: utf-8 -*-
+
+import os
+import json
+
+
+# per-rank quantities aggregated with min/max/mean over ranks
+_fields = ["seconds", "max_thread_seconds", "calls", "items", "bytes", "items_per_s", "bytes_per_s"]
+
+
+def _rank_rows(counters):
+    """
+    Counter totals of this rank with throughput rates added;
+    rates use the slowest thread so they measure wall time of the stage.
+    """
+    rows = {}
+    for tot in counters.totals():
+        t = tot["max_thread_seconds"]
+        tot["items_per_s"] = tot["items"]/t if t > 0.0 else 0.0
+        tot["bytes_per_s"] = tot["bytes"]/t if t > 0.0 else 0.0
+        rows[tot["name"]] = tot
+    return rows
+
+
+def gather_counters(counters, comm=None):
+    """
+    Aggregate PerfCounters totals over MPI ranks.
+
+    Returns a dict {counter name: {field: {min, max, mean}}} on rank 0 and None elsewhere.
+    Counters missing from some rank (e.g. rank without boundary tiles) are aggregated
+    over the ranks that have them.
+    """
+
+    rows = _rank_rows(counters)
+
+    if comm is None:
+        all_rows = [rows]
+    else:
+        all_rows = comm.gather(rows, root=0)
+        if comm.rank != 0:
+            return None
+
+    names = []
+    for r in all_rows:
+        for name in r:
+            if name not in names:
+                names.append(name)
+
+    ret = {}
+    for name in names:
+        ret[name] = {}
+        for field in _fields:
+            vals = [float(r[name][field]) for r in all_rows if name in r]
+            ret[name][field] = {
+                "min": min(vals),
+                "max": max(vals),
+                "mean": sum(vals)/len(vals),
+            }
+    return ret
+
+
+def write_counters(counters, lap, fname, comm=None, fmt=None, clear=True):
+    """
+    Append rank-aggregated counters of one lap to fname.
+
+    fmt is "json" (one JSON object per line) or "csv"; by default it is taken from the file
+    suffix. Counters are cleared after writing so every record covers the laps since
+    the previous call.
+    """
+
+    stats = gather_counters(counters, comm)
+    if clear:
+        counters.clear()
+
+    if stats is None:
+        return
+
+    if fmt is None:
+        fmt = "csv" if fname.endswith(".csv") else "json"
+    nranks = 1 if comm is None else comm.size
+
+    if fmt == "json":
+        with open(fname, "a") as f:
+            f.write(json.dumps({"lap": lap, "nranks": nranks, "counters": stats}) + "\n")
+
+    elif fmt == "csv":
+        new_file = not os.path.isfile(fname)
+        with open(fname, "a") as f:
+            if new_file:
+                cols = ["lap", "nranks", "counter"]
+                for field in _fields:
+                    cols += [field + "_" + s for s in ("min", "max", "mean")]
+                f.write(",".join(cols) + "\n")
+
+            for name, st in stats.items():
+                vals = [str(lap), str(nranks), name]
+                for field in _fields:
+                    vals += ["{:.6e}".format(st[field][s]) for s in ("min", "max", "mean")]
+                f.write(",".join(vals) + "\n")
+    else:
+        raise ValueError("write_counters: unknown format {}".format(fmt))
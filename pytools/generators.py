@@ -27,6 +27,16 @@ def tiles_boundary(grid):
         tile = grid.get_tile(cid)
         yield tile
 
+# local tiles that are not mpi boundary tiles; 
+# these do not need any data from virtual tiles
+def tiles_interior(grid):
+    boundary = set(grid.get_boundary_tiles())
+    for cid in grid.get_local_tiles():
+        if cid in boundary:
+            continue
+        tile = grid.get_tile(cid)
+        yield tile
+
 
 
 
@@ -0,0 +1,235 @@
+# -*- coding: utf-8 -*-
+
+import numpy as np
+from mpi4py import MPI
+
+import pyrunko
+import pytools
+
+
+def _tile_class(conf):
+    if conf.threeD:
+        return pyrunko.pic.threeD.Tile
+    elif conf.twoD:
+        return pyrunko.pic.twoD.Tile
+    return pyrunko.pic.oneD.Tile
+
+
+def _migrator(conf):
+    if conf.threeD:
+        return pyrunko.pic.threeD.TileMigrator()
+    elif conf.twoD:
+        return pyrunko.pic.twoD.TileMigrator()
+    return pyrunko.pic.oneD.TileMigrator()
+
+
+def sfc_keys(grid, conf, indices):
+    """
+    Position of tiles along the space-filling curve.
+
+    Uses the same Hilbert curve as balance_mpi; falls back to row-major
+    order if the tile grid is not a power of 2.
+    """
+    nx, ny, nz = grid.get_Nx(), grid.get_Ny(), grid.get_Nz()
+    m = [np.log2(nx), np.log2(ny), np.log2(nz)]
+
+    if conf.twoD and m[0].is_integer() and m[1].is_integer():
+        hgen = pyrunko.tools.twoD.HilbertGen(int(m[0]), int(m[1]))
+        return [hgen.hindex(ind[0], ind[1]) for ind in indices]
+
+    if conf.threeD and all(mi.is_integer() for mi in m):
+        hgen = pyrunko.tools.threeD.HilbertGen(int(m[0]), int(m[1]), int(m[2]))
+        return [hgen.hindex(ind[0], ind[1], ind[2]) for ind in indices]
+
+    keys = []
+    for ind in indices:
+        i, j, k = (tuple(ind) + (0, 0))[0:3]
+        keys.append(i + nx*(j + ny*k))
+    return keys
+
+
+def weighted_partition(keys, costs, nranks, offset=0):
+    """
+    Cut the curve ordered by keys into nranks contiguous pieces of equal cost.
+
+    A tile goes to the rank that contains the midpoint of its cost interval.
+    Returns the rank of every tile (shifted by offset).
+    """
+    order = np.argsort(keys, kind="stable")
+    costs = np.asarray(costs, dtype=np.float64)
+
+    total = costs.sum()
+    ranks = np.zeros(len(costs), dtype=int)
+    if total <= 0.0:
+        # no cost information; equal number of tiles per rank
+        for n, i in enumerate(order):
+            ranks[i] = offset + (n*nranks)//len(order)
+        return ranks
+
+    csum = 0.0
+    for i in order:
+        mid = csum + 0.5*costs[i]
+        ranks[i] = offset + min(nranks - 1, int(mid/total*nranks))
+        csum += costs[i]
+    return ranks
+
+
+def imbalance(ranks, costs, nranks, offset=0):
+    """ max/mean of the per-rank cost """
+    loads = np.zeros(nranks)
+    for r, c in zip(ranks, costs):
+        loads[r - offset] += c
+    mean = loads.mean()
+    return loads.max()/mean if mean > 0.0 else 1.0
+
+
+class LoadBalancer:
+    """
+    Measurement-driven tile load balancing.
+
+    Every interval laps the tile costs are collected to rank 0, a weighted
+    space-filling-curve partition is computed, and tiles whose owner changes
+    are migrated with their particles and fields.
+
+    Tile cost = time_weight * tile.cost + prtcl_weight * particles + cell_weight * cells,
+    where tile.cost is the particle solver time measured by Scheduler.operate
+    and StepPipeline since the previous call. Weights of particles and cells are
+    nominal seconds per element.
+
+    Tiles are only moved if the current max/mean rank cost exceeds tolerance
+    and the new partition is better by at least min_gain.
+    """
+
+    def __init__(self, conf, interval=100, tolerance=1.1, min_gain=0.05,
+            time_weight=1.0, prtcl_weight=1.0e-8, cell_weight=1.0e-8):
+
+        self.conf = conf
+        self.interval = interval
+        self.tolerance = tolerance
+        self.min_gain = min_gain
+
+        self.time_weight = time_weight
+        self.prtcl_weight = prtcl_weight
+        self.cell_weight = cell_weight
+
+        # creates an empty local tile for index; defaults to the pytools.pic.load_tiles setup
+        self.tile_factory = None
+
+        # statistics of the last call
+        self.imbalance_before = 1.0
+        self.imbalance_after = 1.0
+        self.num_moved = 0
+
+    def tile_cost(self, tile):
+        conf = self.conf
+        ncells = conf.NxMesh*conf.NyMesh*conf.NzMesh
+        return self.time_weight*tile.cost \
+                + self.prtcl_weight*tile.num_particles() \
+                + self.cell_weight*ncells
+
+    def new_tile(self, grid, ind):
+        if self.tile_factory is not None:
+            return self.tile_factory(grid, ind)
+
+        conf = self.conf
+        tile = _tile_class(conf)(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+        pytools.pic.initialize_tile(tile, (tuple(ind) + (0, 0))[0:3], grid, conf)
+        return tile
+
+    def rebalance(self, grid, lap, sch=None):
+        """
+        Repartition and migrate tiles if lap is a balancing lap; collective over all ranks.
+        Returns True if tiles were moved.
+        """
+        if self.interval <= 0 or lap == 0 or lap % self.interval != 0:
+            return False
+
+        comm = MPI.COMM_WORLD
+        conf = self.conf
+
+        # offset by one so that the master rank stays empty in task mode
+        offset = 1 if getattr(conf, "mpi_task_mode", False) else 0
+        nranks = comm.Get_size() - offset
+
+        rows = []
+        for cid in grid.get_local_tiles():
+            tile = grid.get_tile(cid)
+            rows.append((tuple(tile.index), self.tile_cost(tile), comm.Get_rank()))
+            tile.cost = 0.0  # costs are measured over one interval
+
+        all_rows = comm.gather(rows, root=0)
+
+        moves = None
+        if comm.Get_rank() == 0:
+            rows = [r for rr in all_rows for r in rr]
+            indices = [r[0] for r in rows]
+            costs = [r[1] for r in rows]
+            owners = [r[2] for r in rows]
+
+            ranks = weighted_partition(sfc_keys(grid, conf, indices), costs, nranks, offset)
+
+            imb0 = imbalance(owners, costs, nranks, offset)
+            imb1 = imbalance(ranks, costs, nranks, offset)
+
+            moves = []
+            if imb0 > self.tolerance and imb1 < imb0*(1.0 - self.min_gain):
+                moves = [(ind, old, new) for ind, old, new in zip(indices, owners, ranks) if old != new]
+
+            moves = (imb0, imb1, moves)
+
+        imb0, imb1, moves = comm.bcast(moves, root=0)
+        self.imbalance_before = imb0
+        self.imbalance_after = imb1 if moves else imb0
+        self.num_moved = len(moves)
+
+        if not moves:
+            return False
+
+        self.migrate(grid, moves, sch)
+        return True
+
+    def migrate(self, grid, moves, sch=None):
+        """
+        Move tiles listed as (index, old rank, new rank) and rebuild virtual tiles; collective.
+        """
+        conf = self.conf
+        rank = grid.rank()
+
+        # new ownership map; identical on every rank
+        for ind, old, new in moves:
+            grid.set_mpi_grid(*ind, int(new))
+        grid.bcast_mpi_grid()
+
+        mig = _migrator(conf)
+        for ind, old, new in moves:
+            if old == rank:
+                mig.send_tile(grid, grid.id(*ind), int(new))
+
+        for ind, old, new in moves:
+            if new == rank:
+                # halo copy of the tile is replaced by an empty local tile
+                mig.remove_virtual_tile(grid, grid.id(*ind))
+                grid.add_tile(self.new_tile(grid, ind), ind)
+                mig.recv_tile(grid, grid.id(*ind), int(old))
+
+        mig.wait(grid)
+
+        # rebuild rank boundaries and virtual tiles with the corgi machinery
+        grid.analyze_boundaries()
+        grid.send_tiles()
+        grid.recv_tiles()
+        MPI.COMM_WORLD.barrier()
+
+        # tiles sent away that are not halos of local tiles anymore
+        mig.remove_stale_tiles(grid)
+
+        pytools.pic.load_virtual_tiles(grid, conf)
+
+        # new virtual tiles need current field values
+        for mode in [0, 1, 2]:
+            grid.send_data(mode)
+            grid.recv_data(mode)
+            grid.wait_data(mode)
+
+        if sch is not None and getattr(sch, "exchanger", None) is not None:
+            sch.exchanger.invalidate()
@@ -70,6 +70,9 @@ def inject(grid,
 
                         ip_mesh = 0
 
+                        # particles of the tile are collected and added in one bulk call
+                        xs, ys, zs, uxs, uys, uzs, ws = [], [], [], [], [], [], []
+
                         #tot_tiles = conf.Nx*conf.Ny*conf.Nz
                         #np.random.seed(k*conf.Nx*conf.Ny + j*conf.Nx + i + ispcs*tot_tiles) # avoid re-starting the rng cycle
 
@@ -127,9 +130,15 @@ def inject(grid,
                                         #    sys.exit()
                                         #--------------------------------------------------
 
-                                        container.add_particle(x0, u0, w)
+                                        xs.append(x0[0]); ys.append(x0[1]); zs.append(x0[2])
+                                        uxs.append(u0[0]); uys.append(u0[1]); uzs.append(u0[2])
+                                        ws.append(w)
                                         prtcl_tot[ispcs] += 1
 
+                        f32 = lambda a: np.asarray(a, dtype=np.float32)
+                        container.add_particles_bulk(
+                                f32(xs), f32(ys), f32(zs), f32(uxs), f32(uys), f32(uzs), f32(ws))
+
                         # less noisy way of injecting particles
                         #totp_per_tile = conf.NxMesh*conf.NyMesh*conf.NzMesh
                         #xloc0 = ind2loc((i, j, k), (0, 0, 0), conf)
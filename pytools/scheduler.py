@@ -1,4 +1,4 @@
-import sys, os
+import sys, os, time
 import pytools  # runko python tools
 from mpi4py import MPI
 
@@ -12,6 +12,11 @@ class Scheduler:
     def __init__(self):
         self.timer = None
         self.grid  = None
+        self.exchanger = None # optional rank-aggregated mpi communicator
+
+        # optional pyrunko.tools.PerfCounters; per-op time and particle throughput
+        self.counters = None
+        self.counter_ids = {}
 
         self.rank = MPI.COMM_WORLD.Get_rank() 
         self.mpi_comm_size = MPI.COMM_WORLD.Get_size() 
@@ -57,6 +62,23 @@ class Scheduler:
     def is_active_tile(self, tile):
         return True
 
+    # start per-op counter; ids are registered on first use
+    def counter_start(self, name):
+        if self.counters is None:
+            return -1
+
+        cid = self.counter_ids.get(name)
+        if cid is None:
+            cid = self.counters.add_counter(name)
+            self.counter_ids[name] = cid
+
+        self.counters.start(cid)
+        return cid
+
+    def counter_stop(self, cid, items=0):
+        if cid >= 0:
+            self.counters.stop(cid, items)
+
     def operate(self, op):
 
         if self.debug: # additional debug printing
@@ -87,6 +109,9 @@ class Scheduler:
             tile_iterator = pytools.tiles_virtual
         elif op['nhood'] == 'boundary':
             tile_iterator = pytools.tiles_boundary
+        elif op['nhood'] == 'interior':
+            non_boundary = True
+            tile_iterator = pytools.tiles_interior
     
         #-------------------------------------------------- 
         # operate directly to tile 
@@ -94,6 +119,7 @@ class Scheduler:
     
             # actual loop
             t1 = self.timer.start_comp(op['name'])
+            c1 = self.counter_start(op['name'])
             for tile in tile_iterator(self.grid):
     
                 # skip-non active non-boundary tiles
@@ -105,11 +131,15 @@ class Scheduler:
                 method = getattr(tile, op['method'])
                 method(*op['args'])
     
+            self.counter_stop(c1)
             self.timer.stop_comp(t1)
     
         #-------------------------------------------------- 
         # MPI
-        elif op['solver'] == 'mpi':
+        # 
+        # mpi_post only posts the non-blocking messages and mpi_wait completes them;
+        # interior tiles can be processed in between.
+        elif op['solver'] in ['mpi', 'mpi_post', 'mpi_wait']:
     
             if op['method'] == 'j': mpid = 0
             if op['method'] == 'e': mpid = 1
@@ -118,11 +148,24 @@ class Scheduler:
             if op['method'] == 'p2': mpid = 4
     
             t1 = self.timer.start_comp(op['name'])
+            c1 = self.counter_start(op['name'])
     
-            self.grid.send_data(mpid)
-            self.grid.recv_data(mpid)
-            self.grid.wait_data(mpid)
+            if self.exchanger is None:
+                if op['solver'] != 'mpi_wait':
+                    self.grid.send_data(mpid)
+                    self.grid.recv_data(mpid)
+
+                if op['solver'] != 'mpi_post':
+                    self.grid.wait_data(mpid)
+            else:
+                if op['solver'] != 'mpi_wait':
+                    self.exchanger.send_data(self.grid, mpid)
+                    self.exchanger.recv_data(self.grid, mpid)
+
+                if op['solver'] != 'mpi_post':
+                    self.exchanger.wait_data(self.grid, mpid)
     
+            self.counter_stop(c1)
             self.timer.stop_comp(t1)
     
         #-------------------------------------------------- 
@@ -132,8 +175,15 @@ class Scheduler:
             solver = getattr(self, op['solver'])
             method = getattr(solver, op['method'])
     
+            # particle solvers report particles processed and are timed per tile;
+            # tile.cost is used by the load balancer
+            prtcl_solver = op['solver'] in ['pusher', 'fintp', 'currint', 'fused']
+            count_prtcls = self.counters is not None and prtcl_solver
+            nprtcls = 0
+
             # actual loop
             t1 = self.timer.start_comp(op['name'])
+            c1 = self.counter_start(op['name'])
     
             for tile in tile_iterator(self.grid):
     
@@ -143,8 +193,17 @@ class Scheduler:
                     if not(is_active):
                         continue
     
+                if count_prtcls:
+                    nprtcls += tile.num_particles()
+
                 single_args = [tile] + op['args']
-                method(*single_args)
-    
+                if prtcl_solver:
+                    tt0 = time.perf_counter()
+                    method(*single_args)
+                    tile.cost += time.perf_counter() - tt0
+                else:
+                    method(*single_args)
+    
+            self.counter_stop(c1, nprtcls)
             self.timer.stop_comp(t1)
     
@@ -270,3 +270,55 @@ class FilterTests(unittest.TestCase):
         self.assertAlmostEqual(sumx, sumx1, places=5)
         self.assertAlmostEqual(sumy, sumy1, places=5)
         self.assertAlmostEqual(sumz, sumz1, places=5)
+
+    def test_fused_binomial(self):
+
+        # fused passes are equal to repeated single passes inside the tile
+        def random_field(x, y, z):
+            return np.sin(1.3*x + 0.7*y*y + z), np.cos(x*y - z), (x + 2*y + 3*z) % 5
+
+        def filtered(dim, npasses, fused, compensate=False):
+            conf = Conf()
+            conf.NxMesh = 7
+            conf.NyMesh = 6 if dim > 1 else 1
+            conf.NzMesh = 5 if dim > 2 else 1
+
+            mod = pyfields.twoD if dim == 2 else pyfields.threeD
+            tile = mod.Tile(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+            insert_em_tile(tile, conf, random_field)
+
+            if fused:
+                flt = mod.FusedBinomial2(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+                flt.npasses = npasses
+                if compensate:
+                    flt.compensate = True
+                flt.solve(tile)
+            else:
+                flt = mod.Binomial2(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+                for n in range(npasses):
+                    flt.solve(tile)
+                if compensate:
+                    mod.Compensator2(conf.NxMesh, conf.NyMesh, conf.NzMesh).solve(tile)
+
+            return get_js(tile, conf)
+
+        cases = [(3, 1, False), (3, 3, False), (2, 2, False), (2, 2, True)]
+        for dim, npasses, compensate in cases:
+            js1 = filtered(dim, npasses, False, compensate)
+            js2 = filtered(dim, npasses, True, compensate)
+            for j1, j2 in zip(js1, js2):
+                np.testing.assert_allclose(j1, j2, rtol=1.0e-5, atol=1.0e-6)
+
+        # stencils that do not fit into the halo are rejected
+        tile = pyfields.threeD.Tile(7, 6, 5)
+        for npasses in [0, 4]:
+            flt = pyfields.threeD.FusedBinomial2(7, 6, 5)
+            flt.npasses = npasses
+            with self.assertRaises(ValueError):
+                flt.solve(tile)
+
+        flt = pyfields.twoD.FusedBinomial2(7, 6, 1)
+        flt.npasses = 3
+        flt.compensate = True
+        with self.assertRaises(ValueError):
+            flt.solve(pyfields.twoD.Tile(7, 6, 1))
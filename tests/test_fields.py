@@ -109,6 +109,66 @@ class FLD_inits(unittest.TestCase):
         fdtd2.push_e(tile)
         fdtd2.push_half_b(tile)
 
+    def test_propagators_3d_blocked(self):
+        conf = Conf()
+        conf.threeD = True
+        conf.Nx = 1
+        conf.Ny = 1
+        conf.Nz = 1
+        conf.NxMesh = 7
+        conf.NyMesh = 6
+        conf.NzMesh = 5
+
+        comps = ['ex','ey','ez','bx','by','bz']
+
+        # single periodic tile; halos are consistent copies of the interior
+        def random_grid():
+            grid = pycorgi.threeD.Grid(conf.Nx, conf.Ny, conf.Nz)
+            grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax, conf.zmin, conf.zmax)
+            loadTiles3D(grid, conf)
+
+            tile = grid.get_tile(0,0,0)
+            tile.cfl = 0.45
+            gs = tile.get_grids()
+            rng = np.random.default_rng(3)
+            for comp in comps:
+                m = getattr(gs, comp).view()
+                m[:] = rng.uniform(-1.0, 1.0, m.shape)
+            tile.update_boundaries(grid, [1,2])
+            return grid, tile
+
+        def assert_fields_equal(tile1, tile2):
+            gs1 = tile1.get_grids()
+            gs2 = tile2.get_grids()
+            for comp in comps:
+                np.testing.assert_array_equal(getattr(gs1, comp).view(), getattr(gs2, comp).view(), err_msg=comp)
+
+        fdtd2 = pyrunko.emf.threeD.FDTD2()
+        blocked = pyrunko.emf.threeD.FDTD2Blocked()
+        blocked.brick_y = 4
+        blocked.brick_z = 2
+
+        # same update as FDTD2
+        _, tile1 = random_grid()
+        _, tile2 = random_grid()
+        for prop, tile in [(fdtd2, tile1), (blocked, tile2)]:
+            prop.push_half_b(tile)
+            prop.push_e(tile)
+            prop.push_half_b(tile)
+        assert_fields_equal(tile1, tile2)
+
+        # fused B half + E advances the lower halo B locally; equal to
+        # exchanging the advanced B before the E push
+        _, tile3 = random_grid()
+        blocked.push_half_b_e(tile3)
+
+        grid4, tile4 = random_grid()
+        fdtd2.push_half_b(tile4)
+        tile4.update_boundaries(grid4, [2])
+        fdtd2.push_e(tile4)
+
+        assert_fields_equal(tile3, tile4)
+
 
 
 
@@ -417,6 +477,35 @@ class Communications(unittest.TestCase):
         self.assertEqual(nx, (conf.NxMesh+H*2)*(conf.NyMesh+H*2)*(conf.NzMesh+H*2))
 
 
+    def test_mesh_views(self):
+
+        # numpy views share the mesh memory
+        H = 3
+        mesh = pyrunko.tools.Mesh_H3(4, 3, 2)
+        mesh[1,2,0] = 5.0
+
+        v = mesh.view()
+        self.assertEqual(v.shape, (4, 3, 2))
+        self.assertEqual(v[1,2,0], 5.0)
+
+        v[3,0,1] = 7.0
+        self.assertEqual(mesh[3,0,1], 7.0)
+
+        vh = mesh.view(halo=True)
+        self.assertEqual(vh.shape, (4+2*H, 3+2*H, 2+2*H))
+        self.assertEqual(vh[1+H,2+H,0+H], 5.0)
+        vh[0,0,0] = -1.0
+        self.assertEqual(mesh[-H,-H,-H], -1.0)
+
+        full = np.asarray(mesh)
+        self.assertEqual(full.shape, vh.shape)
+        self.assertEqual(full[3+H,0+H,1+H], 7.0)
+
+        # view keeps the mesh alive
+        del mesh
+        self.assertEqual(v[1,2,0], 5.0)
+
+
     # Captures memory bug with mesh initialization; when internal meshes in Grids
     # are too big, compiler tires to over-optimize. Then some stuff never gets allocated.
     # This is fixed now by a copy-and-swap algorithm in toolbox::Mesh.
@@ -825,6 +914,77 @@ class Communications(unittest.TestCase):
                     ind = tile.neighs(ii,jj,kk)
 
 
+    def test_halo_slab_roundtrip3D(self):
+
+        # neighbors that hold only the unpacked halo slabs give the same halos
+        # and current sums as neighbors with the full mesh
+
+        conf = Conf()
+        conf.threeD = True
+        conf.Nx = 3
+        conf.Ny = 3
+        conf.Nz = 3
+        conf.NxMesh = 4
+        conf.NyMesh = 4
+        conf.NzMesh = 4
+
+        comps = [['jx','jy','jz'], ['ex','ey','ez'], ['bx','by','bz']]
+        rng = np.random.default_rng(2)
+
+        def new_grid():
+            grid = pycorgi.threeD.Grid(conf.Nx, conf.Ny, conf.Nz)
+            grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax, conf.zmin, conf.zmax)
+            loadTiles3D(grid, conf)
+            return grid
+
+        for mode in [0, 1, 2]:
+            ref  = new_grid()
+            slab = new_grid()
+
+            for cid in ref.get_tile_ids():
+                gr = ref.get_tile(cid).get_grids()
+                gl = slab.get_tile(cid).get_grids()
+                for comp in comps[mode]:
+                    vals = rng.random(getattr(gr, comp).view(halo=True).shape)
+                    getattr(gr, comp).view(halo=True)[:] = vals
+                    getattr(gl, comp).view(halo=True)[:] = np.nan # only the slabs are filled below
+
+            center = (1,1,1)
+            gr = ref.get_tile(*center).get_grids()
+            gl = slab.get_tile(*center).get_grids()
+            for comp in comps[mode]:
+                getattr(gl, comp).view(halo=True)[:] = getattr(gr, comp).view(halo=True)
+
+            # neighbor at offset o reads the slab of direction -o
+            for i in [-1,0,1]:
+                for j in [-1,0,1]:
+                    for k in [-1,0,1]:
+                        if i == 0 and j == 0 and k == 0:
+                            continue
+                        ind = (center[0]+i, center[1]+j, center[2]+k)
+                        d = [-i, -j, -k]
+
+                        src = ref.get_tile(*ind)
+                        dst = slab.get_tile(*ind)
+
+                        buf = src.pack_halo_slab(mode, d)
+                        self.assertEqual(len(buf), src.halo_slab_size(mode, d))
+                        self.assertEqual(dst.unpack_halo_slab(mode, d, buf), len(buf))
+
+            for grid in [ref, slab]:
+                tile = grid.get_tile(*center)
+                if mode == 0:
+                    tile.exchange_currents(grid)
+                else:
+                    tile.update_boundaries(grid, [mode])
+
+            for comp in comps[mode]:
+                np.testing.assert_array_equal(
+                        getattr(gl, comp).view(halo=True), 
+                        getattr(gr, comp).view(halo=True), 
+                        err_msg="mode {} {}".format(mode, comp))
+
+
     def test_exchangeCurrents3D(self):
 
         conf = Conf()
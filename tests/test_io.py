@@ -395,6 +395,92 @@ class IO(unittest.TestCase):
                                                 places=6)
 
 
+    def test_write_fields2D_async(self):
+
+        conf = Conf()
+        conf.twoD = True
+
+        conf.Nx = 3
+        conf.Ny = 4
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 6
+        conf.NzMesh = 1 
+        conf.outdir = "io_test_2D_async/"
+
+        if not os.path.exists( conf.outdir ):
+            os.makedirs(conf.outdir)
+
+        grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny)
+        grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+
+        loadTiles2D(grid, conf)
+
+        ref = fill_ref(grid, conf)
+        fill_grids(grid, ref, conf)
+
+        io = pyrunko.tools.AsyncWriter(1)
+        pyrunko.emf.twoD.write_grids_async(grid, 0, conf.outdir, io)
+
+        # staged copy is written; not the modified tiles
+        fill_grids(grid, np.zeros_like(ref), conf)
+        io.wait()
+
+        self.assertEqual(io.num_in_flight(), 0)
+        self.assertEqual(io.num_written, 1)
+
+        arrs = combine_tiles(conf.outdir+"fields-0_0.h5", "ex", conf)
+
+        NxM = conf.NxMesh
+        NyM = conf.NyMesh
+        for i in range(conf.Nx*NxM):
+            for j in range(conf.Ny*NyM):
+                self.assertAlmostEqual( arrs[i, j, 0], ref[i, j, 0, 0], places=6)
+
+
+    @unittest.skipIf(not pyrunko.emf.twoD.ParallelFieldsWriter.is_available(),
+                     "HDF5 without parallel support")
+    def test_write_fields2D_parallel(self):
+
+        # collective writer gives the same datasets as the root-reduced FieldsWriter
+        conf = Conf()
+        conf.twoD = True
+
+        conf.Nx = 3
+        conf.Ny = 4
+        conf.Nz = 1
+        conf.NxMesh = 4
+        conf.NyMesh = 6
+        conf.NzMesh = 1
+
+        grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny)
+        grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+
+        loadTiles2D(grid, conf)
+
+        ref = fill_ref(grid, conf)
+        fill_grids(grid, ref, conf)
+
+        for stride in [1, 2]:
+            outdirs = ["io_test_2D_fields_stride{}/".format(stride),
+                       "io_test_2D_parallel_stride{}/".format(stride)]
+            for outdir in outdirs:
+                if not os.path.exists(outdir):
+                    os.makedirs(outdir)
+
+            args = (conf.Nx, conf.NxMesh, conf.Ny, conf.NyMesh, conf.Nz, conf.NzMesh, stride)
+            pyrunko.emf.twoD.FieldsWriter(outdirs[0], *args).write(grid, 0)
+            self.assertTrue( pyrunko.emf.twoD.ParallelFieldsWriter(outdirs[1], *args).write(grid, 0) )
+
+            f0 = h5py.File(outdirs[0]+"flds_0.h5", "r")
+            f1 = h5py.File(outdirs[1]+"flds_0.h5", "r")
+            self.assertEqual(sorted(f0.keys()), sorted(f1.keys()))
+            for key in f0.keys():
+                np.testing.assert_array_equal(f1[key][()], f0[key][()], err_msg="stride {} {}".format(stride, key))
+            f0.close()
+            f1.close()
+
+
     # compare two AdaptiveMesh3D objects and assert their equality
     def compareMeshes(self, vm, ref):
         cells = vm.get_cells(True)
@@ -624,12 +710,149 @@ class IO(unittest.TestCase):
 
 
 
+    def test_write_test_prtcls_fused(self):
+
+        # fused solvers free the particle fields; test particles are then written with zero fields
+
+        def test_filler(xloc, ispcs, conf):
+            x0 = [xloc[0] + 0.5, xloc[1] + 0.5, 0.5]
+            u0 = [0.01, 0.02, 0.03]
+            return x0, u0
+
+        conf = Conf()
+        conf.twoD = True
+
+        conf.Nx = 2
+        conf.Ny = 2
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1 
+        conf.outdir = "io_test_prtcls_fused/"
+        conf.ppc = 1
+        conf.Nspecies = 2
+
+        conf.me = 1
+        conf.mi = 1
+        conf.cfl = 0.45
+        conf.c_omp = 1.0
+
+        if not os.path.exists( conf.outdir ):
+            os.makedirs(conf.outdir)
+
+        grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny)
+        grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+
+        for i in range(grid.get_Nx()):
+            for j in range(grid.get_Ny()):
+                c = pyrunko.pic.twoD.Tile(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+                pytools.pic.initialize_tile(c, (i, j, 0), grid, conf)
+                grid.add_tile(c, (i,j)) 
+
+        pytools.pic.inject(grid, test_filler, density_profile, conf)
+
+        # uniform fields so that interpolated particle fields are nonzero
+        for tile in pytools.tiles_local(grid):
+            gs = tile.get_grids(0)
+            for l in range(-3, conf.NxMesh+3):
+                for m in range(-3, conf.NyMesh+3):
+                    gs.ex[l,m,0] = 0.1
+                    gs.bz[l,m,0] = 0.2
+
+        fintp = pyrunko.pic.twoD.LinearInterpolator()
+        fused = pyrunko.pic.twoD.FusedLinearBorisZigZag()
+        for tile in pytools.tiles_local(grid):
+            fintp.solve(tile)
+            self.assertTrue(tile.get_container(0).store_fields)
+            self.assertAlmostEqual(tile.get_container(0)[0, 6], 0.1, places=6)
+
+            fused.solve(tile)
+            for ispcs in range(conf.Nspecies):
+                self.assertFalse(tile.get_container(ispcs).store_fields)
+                with self.assertRaises(IndexError):
+                    tile.get_container(ispcs)[0, 6]
+
+        writer = pyrunko.pic.twoD.TestPrtclWriter(
+                conf.outdir,
+                conf.Nx, conf.NxMesh, conf.Ny, conf.NyMesh, conf.Nz, conf.NzMesh,
+                conf.ppc, len(grid.get_local_tiles()), 20)
+        writer.write(grid, 0)
+
+        f = h5py.File(conf.outdir + "/test-prtcls_0.h5", "r")
+        self.assertTrue(np.any(f['vx'][()] != 0.0)) # particles are written
+        for var in ['ex', 'ey', 'ez', 'bx', 'by', 'bz']:
+            np.testing.assert_array_equal(f[var][()], 0.0)
+        f.close()
+
+
+    def test_checkpoint_pic2D(self):
+
+        def test_filler(xloc, ispcs, conf):
+            xx = xloc[0] 
+            yy = xloc[1] 
+            zz = 0.1 if ispcs == 0 else 0.2
+            return [xx, yy, zz], [xx*100.0, yy*1000.0, -xx*yy]
+
+        conf = Conf()
+        conf.twoD = True
+
+        conf.Nx = 3
+        conf.Ny = 4
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 6
+        conf.NzMesh = 1 
+        conf.outdir = "io_test_ckpt/"
+        conf.ppc = 1
+        conf.Nspecies = 2
+        conf.Nspecies_test = 0
+
+        #tmp non-needed variables
+        conf.omp = 1
+        conf.gamma_e = 0.0
+        conf.me = 1
+        conf.mi = 1
+        conf.cfl = 1.0
+        conf.c_omp = 1.0
+
+        if not os.path.exists( conf.outdir ):
+            os.makedirs(conf.outdir)
 
+        def new_grid():
+            grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny)
+            grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+            for i in range(grid.get_Nx()):
+                for j in range(grid.get_Ny()):
+                    c = pyrunko.pic.twoD.Tile(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+                    pytools.pic.initialize_tile(c, (i, j, 0), grid, conf)
+                    grid.add_tile(c, (i,j)) 
+            return grid
 
+        grid = new_grid()
+        pytools.pic.inject(grid, test_filler, density_profile, conf)
 
+        for tile in pytools.tiles_all(grid):
+            gs = tile.get_grids(0)
+            gs.ex[1,2,0] = tile.cid + 0.5
 
+        ckpt = pyrunko.pic.twoD.Checkpoint(conf.outdir, compression=4)
+        self.assertTrue( ckpt.write(grid, 1) )
 
+        node2 = new_grid()
+        self.assertTrue( ckpt.read(node2, 1) )
 
+        for cid in node2.get_local_tiles():
+            c     = node2.get_tile(cid)
+            c_ref = grid.get_tile(cid)
 
+            self.assertAlmostEqual(c.get_grids(0).ex[1,2,0], cid + 0.5, places=6)
 
+            for ispcs in range(conf.Nspecies):
+                con1 = c.get_container(ispcs)
+                con2 = c_ref.get_container(ispcs)
 
+                self.assertEqual(con1.size(), con2.size())
+                for n in range(con1.size()):
+                    self.assertAlmostEqual(con1.loc(0)[n], con2.loc(0)[n], places=6)
+                    self.assertAlmostEqual(con1.vel(1)[n], con2.vel(1)[n], places=6)
+                    self.assertEqual(con1.id(0)[n], con2.id(0)[n])
@@ -0,0 +1,283 @@
+from mpi4py import MPI
+import unittest
+
+import numpy as np
+
+import pytools  # runko python tools
+import pycorgi
+import pyrunko
+
+# Multi-rank tests; skipped when run on a single rank. Run with, e.g.,
+#   mpirun -np 2 python -m unittest discover -s tests/ -p "test_mpi.py" -v
+
+
+class Conf:
+
+    Nx = 4
+    Ny = 2
+    Nz = 1
+
+    NxMesh = 4
+    NyMesh = 4
+    NzMesh = 1
+
+    xmin = 0.0
+    xmax = 16.0
+
+    ymin = 0.0
+    ymax = 8.0
+
+    zmin = 0.0
+    zmax = 1.0
+
+    cfl = 0.45
+    c_omp = 10.0
+    ppc = 1
+
+    me = 1
+    mi = 1
+    qe = 1.0
+    qi =-1.0
+
+    Nspecies = 1
+
+    oneD   = False
+    twoD   = True
+    threeD = False
+
+
+def new_grid(conf):
+    """ 2D pic grid split into columns of tiles between the ranks, with virtual tiles """
+
+    grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+    grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+
+    if grid.rank() == 0:
+        for j in range(conf.Ny):
+            for i in range(conf.Nx):
+                grid.set_mpi_grid(i, j, (i*grid.size())//conf.Nx)
+    grid.bcast_mpi_grid()
+
+    pytools.pic.load_tiles(grid, conf)
+
+    grid.analyze_boundaries()
+    grid.send_tiles()
+    grid.recv_tiles()
+    MPI.COMM_WORLD.barrier()
+
+    pytools.pic.load_virtual_tiles(grid, conf)
+    return grid
+
+
+def exchange(grid, exchanger, modes):
+    """ post all modes before waiting for any of them """
+    if exchanger is None:
+        for mode in modes: grid.send_data(mode)
+        for mode in modes: grid.recv_data(mode)
+        for mode in modes: grid.wait_data(mode)
+    else:
+        for mode in modes: exchanger.send_data(grid, mode)
+        for mode in modes: exchanger.recv_data(grid, mode)
+        for mode in modes: exchanger.wait_data(grid, mode)
+
+
+comps = [['jx','jy','jz'], ['ex','ey','ez'], ['bx','by','bz']]
+
+
+@unittest.skipIf(MPI.COMM_WORLD.Get_size() < 2, "needs at least 2 ranks")
+class RankExchange(unittest.TestCase):
+
+    def test_fields(self):
+
+        # aggregated buffers (full meshes and halo slabs) give the same
+        # boundaries as the per-tile messages of grid.send_data
+        conf = Conf()
+
+        ref  = new_grid(conf)
+        full = new_grid(conf)
+        halo = new_grid(conf)
+
+        ex_full = pyrunko.pic.twoD.RankExchanger()
+        ex_halo = pyrunko.pic.twoD.RankExchanger()
+        ex_halo.halo_only = True
+
+        grids = [(ref, None), (full, ex_full), (halo, ex_halo)]
+
+        # e and b are in flight at the same time
+        for modes in [[0], [1, 2]]:
+            for grid, _ in grids:
+                for cid in grid.get_local_tiles():
+                    gs = grid.get_tile(cid).get_grids()
+                    for mode in modes:
+                        rng = np.random.default_rng(cid + 100*mode)
+                        for comp in comps[mode]:
+                            m = getattr(gs, comp).view(halo=True)
+                            m[:] = rng.random(m.shape)
+
+            for grid, exchanger in grids:
+                exchange(grid, exchanger, modes)
+
+                for cid in grid.get_local_tiles():
+                    tile = grid.get_tile(cid)
+                    if modes == [0]:
+                        tile.exchange_currents(grid)
+                    else:
+                        tile.update_boundaries(grid, modes)
+
+            for grid, _ in grids[1:]:
+                for cid in ref.get_local_tiles():
+                    for mode in modes:
+                        for comp in comps[mode]:
+                            np.testing.assert_array_equal(
+                                getattr(grid.get_tile(cid).get_grids(), comp).view(halo=True),
+                                getattr(ref.get_tile(cid).get_grids(), comp).view(halo=True),
+                                err_msg="local tile {} {}".format(cid, comp))
+
+            # full meshes also keep virtual tile interiors up to date
+            for cid in ref.get_virtual_tiles():
+                for mode in modes:
+                    for comp in comps[mode]:
+                        np.testing.assert_array_equal(
+                            getattr(full.get_tile(cid).get_grids(), comp).view(halo=True),
+                            getattr(ref.get_tile(cid).get_grids(), comp).view(halo=True),
+                            err_msg="virtual tile {} {}".format(cid, comp))
+
+        if len(ref.get_local_tiles()) > 0:
+            self.assertGreater(ex_full.number_of_neighbors(), 0)
+            self.assertEqual(ex_full.number_of_neighbors(), ex_halo.number_of_neighbors())
+
+
+    def test_particles(self):
+
+        # particles leaving through rank boundaries arrive the same as with per-tile messages
+        conf = Conf()
+
+        ref  = new_grid(conf)
+        aggr = new_grid(conf)
+        exchanger = pyrunko.pic.twoD.RankExchanger()
+
+        for grid in [ref, aggr]:
+            for cid in grid.get_local_tiles():
+                tile = grid.get_tile(cid)
+                i, j = tile.index
+                x0 = pytools.ind2loc((i, j, 0), (0, 0, 0), conf)
+                container = tile.get_container(0)
+
+                # one particle inside and one in every neighbor direction
+                for dx in [-0.5, 0.5*conf.NxMesh, conf.NxMesh + 0.5]:
+                    for dy in [-0.5, 0.5*conf.NyMesh, conf.NyMesh + 0.5]:
+                        container.add_particle([x0[0] + dx, x0[1] + dy, 0.5], [0.1*i, 0.1*j, cid], 1.0)
+
+        n0 = MPI.COMM_WORLD.allreduce(
+                sum(ref.get_tile(cid).get_container(0).size() for cid in ref.get_local_tiles()))
+
+        for grid, modes in [(ref, [3, 4]), (aggr, [3])]:
+            for cid in grid.get_local_tiles():
+                grid.get_tile(cid).check_outgoing_particles()
+
+            for cid in grid.get_boundary_tiles():
+                grid.get_tile(cid).pack_outgoing_particles()
+
+            exchange(grid, exchanger if grid is aggr else None, modes)
+
+            for cid in grid.get_virtual_tiles():
+                tile = grid.get_tile(cid)
+                tile.unpack_incoming_particles()
+                tile.check_outgoing_particles()
+
+            for cid in grid.get_local_tiles():
+                grid.get_tile(cid).get_incoming_particles(grid)
+
+            for cid in grid.get_local_tiles():
+                grid.get_tile(cid).delete_transferred_particles()
+
+            for cid in grid.get_virtual_tiles():
+                grid.get_tile(cid).delete_all_particles()
+
+        for cid in ref.get_local_tiles():
+            c0 = ref.get_tile(cid).get_container(0)
+            c1 = aggr.get_tile(cid).get_container(0)
+
+            p0 = sorted(zip(c0.loc(0), c0.loc(1), c0.vel(0), c0.vel(1), c0.vel(2)))
+            p1 = sorted(zip(c1.loc(0), c1.loc(1), c1.vel(0), c1.vel(1), c1.vel(2)))
+            self.assertEqual(p0, p1)
+
+        n1 = MPI.COMM_WORLD.allreduce(
+                sum(aggr.get_tile(cid).get_container(0).size() for cid in aggr.get_local_tiles()))
+        self.assertEqual(n0, n1)
+
+
+@unittest.skipIf(MPI.COMM_WORLD.Get_size() < 2, "needs at least 2 ranks")
+class Migration(unittest.TestCase):
+
+    def test_migrate_tile(self):
+
+        # tile (0,0) of rank 0 moves to the last rank, which holds it as a
+        # virtual tile (periodic neighbor of its column) before the move
+        conf = Conf()
+        comm = MPI.COMM_WORLD
+        grid = new_grid(conf)
+
+        ind = (0, 0)
+        cid = grid.id(*ind)
+        old = grid.get_mpi_grid(*ind)
+        new = comm.Get_size() - 1
+        self.assertEqual(old, 0)
+        self.assertNotEqual(old, new)
+
+        for c in grid.get_local_tiles():
+            tile = grid.get_tile(c)
+            i, j = tile.index
+            x0 = pytools.ind2loc((i, j, 0), (0, 0, 0), conf)
+            container = tile.get_container(0)
+            for n in range(5):
+                container.add_particle([x0[0] + 0.5 + 0.6*n, x0[1] + 0.5 + 0.4*n, 0.5], [0.1*n, 0.2, c], 1.0)
+
+            rng = np.random.default_rng(c)
+            gs = tile.get_grids()
+            for comp in ['ex','ey','ez','bx','by','bz','jx','jy','jz']:
+                m = getattr(gs, comp).view()
+                m[:] = rng.random(m.shape)
+
+        if grid.rank() == new and comm.Get_size() <= conf.Nx:
+            self.assertTrue(cid in grid.get_virtual_tiles())
+
+        # contents of the moved tile as seen by its old owner
+        expected = None
+        if grid.rank() == old:
+            tile = grid.get_tile(cid)
+            c0 = tile.get_container(0)
+            gs = tile.get_grids()
+            expected = (
+                sorted(zip(c0.loc(0), c0.loc(1), c0.vel(0), c0.vel(1), c0.vel(2), c0.id(0), c0.id(1))),
+                {comp: getattr(gs, comp).view().copy() for comp in ['ex','ey','ez','bx','by','bz','jx','jy','jz']})
+        expected = comm.bcast(expected, root=old)
+
+        lb = pytools.LoadBalancer(conf)
+        lb.migrate(grid, [(ind, old, new)])
+
+        self.assertEqual(grid.get_mpi_grid(*ind), new)
+
+        if grid.rank() == new:
+            self.assertTrue(cid in grid.get_local_tiles())
+
+            tile = grid.get_tile(cid)
+            c1 = tile.get_container(0)
+            prtcls = sorted(zip(c1.loc(0), c1.loc(1), c1.vel(0), c1.vel(1), c1.vel(2), c1.id(0), c1.id(1)))
+            self.assertEqual(len(prtcls), 5)
+            self.assertEqual(prtcls, expected[0])
+
+            gs = tile.get_grids()
+            for comp, ref in expected[1].items():
+                np.testing.assert_array_equal(getattr(gs, comp).view(), ref, err_msg=comp)
+        else:
+            self.assertFalse(cid in grid.get_local_tiles())
+
+        # particles are neither lost nor duplicated
+        nprtcls = comm.allreduce(
+                sum(grid.get_tile(c).get_container(0).size() for c in grid.get_local_tiles()))
+        self.assertEqual(nprtcls, 5*conf.Nx*conf.Ny)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -1767,3 +1767,668 @@ class PIC(unittest.TestCase):
 
 
 
+
+    def test_step_pipeline(self):
+
+        # native StepPipeline should reproduce the python tile loop exactly
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 3
+        conf.Ny = 3
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 1
+        conf.vel = 0.1
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        grids = []
+        for ig in range(3):
+            np.random.seed(1) # same initial state for both grids
+            grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+            grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+            pytools.pic.load_tiles(grid, conf)
+            insert_em(grid, conf, linear_field)
+            pytools.pic.inject(grid, filler, density_profile, conf)
+            grids.append(grid)
+
+        fldprop  = pyrunko.emf.twoD.FDTD2()
+        pusher   = pyrunko.pic.twoD.BorisPusher()
+        fintp    = pyrunko.pic.twoD.LinearInterpolator()
+        currint  = pyrunko.pic.twoD.ZigZag()
+
+        ops = [
+            dict(name='push_half_b1', solver='fldpropB', method='push_half_b', nhood='local',),
+            dict(name='mpi_b1',       solver='mpi_post', method='b', ),
+            dict(name='upd_bc',       solver='tile',     method='update_boundaries', args=[grids[0], [2,]], nhood='interior',),
+            dict(name='mpi_b1',       solver='mpi_wait', method='b', ),
+            dict(name='upd_bc',       solver='tile',     method='update_boundaries', args=[grids[0], [2,]], nhood='boundary',),
+            dict(name='interp_em',    solver='fintp',    method='solve', nhood='local',),
+            dict(name='push',         solver='pusher',   method='solve', nhood='local', args=[0]),
+            dict(name='push',         solver='pusher',   method='solve', nhood='local', args=[1]),
+            dict(name='clear_cur',    solver='tile',     method='clear_current', nhood='all',),
+            dict(name='push_half_b2', solver='fldpropB', method='push_half_b', nhood='local',),
+            dict(name='push_e',       solver='fldpropE', method='push_e', nhood='local',),
+            dict(name='check_outg_prtcls',  solver='tile', method='check_outgoing_particles', nhood='local',),
+            dict(name='get_inc_prtcls',     solver='tile', method='get_incoming_particles', nhood='local', args=[grids[0],]),
+            dict(name='del_trnsfrd_prtcls', solver='tile', method='delete_transferred_particles', nhood='local',),
+            dict(name='comp_curr',    solver='currint',  method='solve', nhood='local',),
+            dict(name='cur_exchange', solver='tile',     method='exchange_currents', nhood='local', args=[grids[0],],),
+            ]
+
+        # python reference loop
+        sch = pytools.Scheduler()
+        sch.grid     = grids[0]
+        sch.timer    = pytools.Timer()
+        sch.fldpropE = fldprop
+        sch.fldpropB = fldprop
+        sch.pusher   = pusher
+        sch.fintp    = fintp
+        sch.currint  = currint
+
+        # native pipeline
+        pipe = pyrunko.pic.twoD.StepPipeline()
+        pipe.fldpropE = fldprop
+        pipe.fldpropB = fldprop
+        pipe.pusher   = pusher
+        pipe.fintp    = fintp
+        pipe.currint  = currint
+        for op in ops:
+            pipe.add_stage(op)
+        self.assertEqual(len(pipe), len(ops))
+
+        with self.assertRaises(ValueError):
+            pipe.add_stage(dict(name='bad', solver='tile', method='not_a_method'))
+
+        # same pipeline with tiles executed as OpenMP tasks
+        pipe_tasks = pyrunko.pic.twoD.StepPipeline()
+        pipe_tasks.fldpropE = fldprop
+        pipe_tasks.fldpropB = fldprop
+        pipe_tasks.pusher   = pusher
+        pipe_tasks.fintp    = fintp
+        pipe_tasks.currint  = currint
+        pipe_tasks.threaded = True
+        for op in ops:
+            pipe_tasks.add_stage(op)
+
+        # rank-aggregated mpi; single rank has no neighbors
+        exchanger = pyrunko.pic.twoD.RankExchanger()
+        pipe_tasks.exchanger = exchanger
+
+        timer = pytools.Timer()
+        for lap in range(3):
+            for op in ops:
+                sch.operate(dict(op)) # operate modifies the dict
+            pipe.run(grids[1], timer)
+            pipe_tasks.run(grids[2])
+
+        self.assertEqual(exchanger.number_of_neighbors(), 0)
+
+        # every stage is reported to the timer
+        for op in ops:
+            self.assertTrue(op['name'] in timer.components)
+
+        for cid, ig in [(cid, ig) for cid in grids[0].get_local_tiles() for ig in [1,2]]:
+            t0 = grids[0].get_tile(cid)
+            t1 = grids[ig].get_tile(cid)
+
+            for ispcs in range(conf.Nspecies):
+                c0 = t0.get_container(ispcs)
+                c1 = t1.get_container(ispcs)
+                self.assertEqual(c0.size(), c1.size())
+
+                for idim in range(3):
+                    np.testing.assert_array_equal(c0.loc(idim), c1.loc(idim))
+                    np.testing.assert_array_equal(c0.vel(idim), c1.vel(idim))
+
+            g0 = t0.get_grids(0)
+            g1 = t1.get_grids(0)
+            for l in range(conf.NxMesh):
+                for m in range(conf.NyMesh):
+                    self.assertEqual(g0.jx[l,m,0], g1.jx[l,m,0])
+                    self.assertEqual(g0.ex[l,m,0], g1.ex[l,m,0])
+                    self.assertEqual(g0.bz[l,m,0], g1.bz[l,m,0])
+
+
+    def test_sort_particles(self):
+
+        # counting sort by cell keeps all particles and orders them by cell index
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 1
+        conf.Ny = 1
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 4
+        conf.NzMesh = 1
+        conf.update_bbox()
+
+        tile = pyrunko.pic.twoD.Tile(conf.NxMesh, conf.NyMesh, conf.NzMesh)
+        tile.set_tile_mins([0.0, 0.0])
+        tile.set_tile_maxs([conf.NxMesh, conf.NyMesh])
+
+        np.random.seed(2)
+        container = pyrunko.pic.twoD.ParticleContainer()
+        for n in range(50):
+            x = np.random.uniform(0.0, conf.NxMesh)
+            y = np.random.uniform(0.0, conf.NyMesh)
+            container.add_particle([x, y, 0.0], [x, -y, float(n)], 1.0)
+        tile.set_container(container)
+
+        tile.sort_particles()
+
+        c = tile.get_container(0)
+        self.assertEqual(c.size(), 50)
+
+        xs = np.array(c.loc(0))
+        ys = np.array(c.loc(1))
+        cells = np.floor(xs).astype(int) + conf.NxMesh*np.floor(ys).astype(int)
+        self.assertTrue(np.all(np.diff(cells) >= 0))
+
+        # velocities moved together with locations
+        np.testing.assert_array_equal(np.array(c.vel(0)), xs)
+        np.testing.assert_array_equal(np.array(c.vel(1)), -ys)
+        self.assertEqual(sorted(c.vel(2)), [float(n) for n in range(50)])
+
+    def test_fused_kernel(self):
+
+        # fused interpolate-push-deposit variants should match the separate solvers
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 1
+        conf.Ny = 1
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 2
+        conf.vel = 0.1
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        pic2d = pyrunko.pic.twoD
+
+        # every exposed fused variant and its separate interpolator, pusher, and depositer
+        variants = [
+            (pic2d.FusedLinearBorisZigZag,       pic2d.LinearInterpolator,    pic2d.BorisPusher,       pic2d.ZigZag),
+            (pic2d.FusedLinearVayZigZag,         pic2d.LinearInterpolator,    pic2d.VayPusher,         pic2d.ZigZag),
+            (pic2d.FusedLinearHigueraCaryZigZag, pic2d.LinearInterpolator,    pic2d.HigueraCaryPusher, pic2d.ZigZag),
+            (pic2d.FusedQuadraticBorisZigZag,    pic2d.QuadraticInterpolator, pic2d.BorisPusher,       pic2d.ZigZag),
+            ]
+
+        for fcls, icls, pcls, dcls in variants:
+            grids = []
+            for ig in range(2):
+                np.random.seed(1) # same initial state for both grids
+                grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+                grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+                pytools.pic.load_tiles(grid, conf)
+                insert_em(grid, conf, linear_field)
+                pytools.pic.inject(grid, filler, density_profile, conf)
+                grids.append(grid)
+
+            fintp    = icls()
+            pusher   = pcls()
+            currint  = dcls()
+            fused    = fcls()
+
+            for lap in range(3):
+                for tile in pytools.tiles_local(grids[0]):
+                    fintp.solve(tile)
+                    pusher.solve(tile)
+                    tile.clear_current()
+                    currint.solve(tile)
+
+                for tile in pytools.tiles_local(grids[1]):
+                    fused.solve(tile)
+
+            for cid in grids[0].get_local_tiles():
+                t0 = grids[0].get_tile(cid)
+                t1 = grids[1].get_tile(cid)
+
+                for ispcs in range(conf.Nspecies):
+                    c0 = t0.get_container(ispcs)
+                    c1 = t1.get_container(ispcs)
+                    self.assertEqual(c0.size(), c1.size())
+
+                    for idim in range(3):
+                        np.testing.assert_array_equal(c0.loc(idim), c1.loc(idim), err_msg=fcls.__name__)
+                        np.testing.assert_array_equal(c0.vel(idim), c1.vel(idim), err_msg=fcls.__name__)
+
+                    # fused kernel keeps no particle fields
+                    self.assertTrue(c0.store_fields)
+                    self.assertFalse(c1.store_fields)
+
+                g0 = t0.get_grids(0)
+                g1 = t1.get_grids(0)
+                for l in range(conf.NxMesh):
+                    for m in range(conf.NyMesh):
+                        self.assertAlmostEqual(g0.jx[l,m,0], g1.jx[l,m,0], places=6, msg=fcls.__name__)
+                        self.assertAlmostEqual(g0.jy[l,m,0], g1.jy[l,m,0], places=6, msg=fcls.__name__)
+                        self.assertAlmostEqual(g0.jz[l,m,0], g1.jz[l,m,0], places=6, msg=fcls.__name__)
+
+    def test_simd_pushers(self):
+
+        # vectorized pushers match the scalar pushers; float mode agrees to single precision
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 1
+        conf.Ny = 1
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 3 # odd number of particles so that scalar remainder loop is used
+        conf.vel = 0.3
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        pairs = [
+            (pyrunko.pic.twoD.BorisPusher,       pyrunko.pic.twoD.SimdBorisPusher,       pyrunko.pic.twoD.SimdBorisPusherF32),
+            (pyrunko.pic.twoD.VayPusher,         pyrunko.pic.twoD.SimdVayPusher,         pyrunko.pic.twoD.SimdVayPusherF32),
+            (pyrunko.pic.twoD.HigueraCaryPusher, pyrunko.pic.twoD.SimdHigueraCaryPusher, pyrunko.pic.twoD.SimdHigueraCaryPusherF32),
+            ]
+
+        fintp = pyrunko.pic.twoD.LinearInterpolator()
+        for pushers in pairs:
+            grids = []
+            for ig in range(3):
+                np.random.seed(1) # same initial state for all grids
+                grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+                grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+                pytools.pic.load_tiles(grid, conf)
+                insert_em(grid, conf, linear_field)
+                pytools.pic.inject(grid, filler, density_profile, conf)
+                grids.append(grid)
+
+            for grid, pcls in zip(grids, pushers):
+                pusher = pcls()
+                pusher.bz_ext = 0.1
+                for tile in pytools.tiles_local(grid):
+                    fintp.solve(tile)
+                    pusher.solve(tile)
+
+            for cid in grids[0].get_local_tiles():
+                c0 = grids[0].get_tile(cid).get_container(0)
+                c1 = grids[1].get_tile(cid).get_container(0)
+                c2 = grids[2].get_tile(cid).get_container(0)
+
+                for idim in range(3):
+                    # fma contraction can differ between scalar and vector code; allow one float ulp
+                    np.testing.assert_allclose(c0.vel(idim), c1.vel(idim), rtol=2.0e-7)
+                    np.testing.assert_allclose(c0.loc(idim), c1.loc(idim), rtol=2.0e-7)
+                    np.testing.assert_allclose(c0.vel(idim), c2.vel(idim), rtol=1.0e-5, atol=1.0e-6)
+                    np.testing.assert_allclose(c0.loc(idim), c2.loc(idim), rtol=1.0e-5, atol=1.0e-6)
+
+    def test_deposit_engine_threads(self):
+
+        # thread-private current tiles give the same currents as the serial deposit
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 1
+        conf.Ny = 1
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 100 # 5000 particles vs 847 mesh cells; enough for 2 threads
+        conf.vel = 0.3
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        for dcls in [pyrunko.pic.twoD.ZigZag, pyrunko.pic.twoD.ZigZag_2nd]:
+            currents = []
+            for nthr in [1, 2]:
+                np.random.seed(1)
+                grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+                grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+                pytools.pic.load_tiles(grid, conf)
+                pytools.pic.inject(grid, filler, density_profile, conf)
+
+                currint = dcls()
+                currint.num_threads = nthr
+                self.assertEqual(currint.num_threads, nthr)
+
+                tile = list(pytools.tiles_local(grid))[0]
+                currint.solve(tile)
+                self.assertEqual(currint.last_num_threads, nthr)
+                gs = tile.get_grids(0)
+                currents.append(np.array([[[gs.jx[l,m,0], gs.jy[l,m,0], gs.jz[l,m,0]]
+                    for m in range(-3, conf.NyMesh+3)] for l in range(-3, conf.NxMesh+3)]))
+
+            np.testing.assert_allclose(currents[0], currents[1], rtol=1.0e-5, atol=1.0e-6)
+
+    def test_perf_counters(self):
+
+        # pipeline and scheduler counters report calls and particles per stage
+
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 2
+        conf.Ny = 2
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 2
+        conf.vel = 0.1
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+        grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+        pytools.pic.load_tiles(grid, conf)
+        insert_em(grid, conf, linear_field)
+        pytools.pic.inject(grid, filler, density_profile, conf)
+
+        tiles = list(pytools.tiles_local(grid))
+        nprtcls = sum(tile.num_particles() for tile in tiles)
+        self.assertEqual(nprtcls, len(tiles)*conf.NxMesh*conf.NyMesh*conf.ppc*conf.Nspecies)
+
+        pusher = pyrunko.pic.twoD.BorisPusher()
+        fintp  = pyrunko.pic.twoD.LinearInterpolator()
+
+        ops = [
+            dict(name='interp_em', solver='fintp',  method='solve', nhood='local',),
+            dict(name='push',      solver='pusher', method='solve', nhood='local',),
+            ]
+
+        pipe = pyrunko.pic.twoD.StepPipeline()
+        pipe.pusher = pusher
+        pipe.fintp  = fintp
+        for op in ops:
+            pipe.add_stage(op)
+
+        sch = pytools.Scheduler()
+        sch.grid     = grid
+        sch.timer    = pytools.Timer()
+        sch.pusher   = pusher
+        sch.fintp    = fintp
+        sch.counters = pyrunko.tools.PerfCounters()
+
+        for lap in range(2):
+            pipe.run(grid)
+            for op in ops:
+                sch.operate(op)
+
+        for counters in [pipe.counters, sch.counters]:
+            tots = {t['name']: t for t in counters.totals()}
+            self.assertEqual(sorted(tots.keys()), ['interp_em', 'push'])
+            self.assertEqual(tots['push']['calls'], 2)
+            self.assertEqual(tots['push']['items'], 2*nprtcls)
+            self.assertGreater(tots['push']['seconds'], 0.0)
+
+        # native stages also count nominal bytes
+        tots = {t['name']: t for t in pipe.counters.totals()}
+        self.assertGreater(tots['push']['bytes'], 0)
+
+        # single-rank report; counters are cleared after writing
+        import json, tempfile
+        with tempfile.TemporaryDirectory() as tmpdir:
+            fname = os.path.join(tmpdir, "counters.json")
+            pytools.write_counters(pipe.counters, 2, fname)
+            with open(fname) as f:
+                rec = json.loads(f.readline())
+            self.assertEqual(rec['lap'], 2)
+            self.assertEqual(rec['counters']['push']['items']['max'], 2*nprtcls)
+
+            fname = os.path.join(tmpdir, "counters.csv")
+            pytools.write_counters(sch.counters, 2, fname)
+            with open(fname) as f:
+                lines = f.readlines()
+            self.assertEqual(len(lines), 3)
+            self.assertTrue(lines[0].startswith("lap,nranks,counter"))
+
+        tots = {t['name']: t for t in pipe.counters.totals()}
+        self.assertEqual(tots['push']['calls'], 0)
+
+    def test_load_balance(self):
+
+        # weighted curve partition splits the cost, not the tile count
+        keys  = [3, 0, 2, 1, 4]
+        costs = [1.0, 1.0, 1.0, 1.0, 4.0]
+        ranks = pytools.load_balance.weighted_partition(keys, costs, 2)
+        self.assertEqual(list(ranks), [0, 0, 0, 0, 1])
+        self.assertAlmostEqual(pytools.load_balance.imbalance(ranks, costs, 2), 1.0)
+        self.assertAlmostEqual(pytools.load_balance.imbalance([0]*5, costs, 2), 2.0)
+
+        # task mode keeps rank 0 empty
+        ranks = pytools.load_balance.weighted_partition(keys, costs, 2, offset=1)
+        self.assertEqual(list(ranks), [1, 1, 1, 1, 2])
+
+        # particle solver time is collected to tile.cost and reset by the balancer
+        conf = Conf()
+        conf.twoD = True
+        conf.Nx = 2
+        conf.Ny = 2
+        conf.Nz = 1
+        conf.NxMesh = 5
+        conf.NyMesh = 5
+        conf.NzMesh = 1
+        conf.ppc = 2
+        conf.vel = 0.1
+        conf.Nspecies = 2
+        conf.me = -1.0
+        conf.mi =  1.0
+        conf.update_bbox()
+
+        grid = pycorgi.twoD.Grid(conf.Nx, conf.Ny, conf.Nz)
+        grid.set_grid_lims(conf.xmin, conf.xmax, conf.ymin, conf.ymax)
+        pytools.pic.load_tiles(grid, conf)
+        insert_em(grid, conf, linear_field)
+        pytools.pic.inject(grid, filler, density_profile, conf)
+
+        sch = pytools.Scheduler()
+        sch.grid   = grid
+        sch.timer  = pytools.Timer()
+        sch.pusher = pyrunko.pic.twoD.BorisPusher()
+        sch.operate( dict(name='push', solver='pusher', method='solve', nhood='local',) )
+
+        for tile in pytools.tiles_local(grid):
+            self.assertGreater(tile.cost, 0.0)
+
+        balancer = pytools.LoadBalancer(conf, interval=1)
+        self.assertFalse(balancer.rebalance(grid, 0, sch)) # lap 0 is skipped
+        self.assertFalse(balancer.rebalance(grid, 1, sch)) # single rank has nothing to move
+        self.assertEqual(balancer.num_moved, 0)
+
+        for tile in pytools.tiles_local(grid):
+            self.assertEqual(tile.cost, 0.0)
+
+        # all tiles are local on a single rank so nothing is stale
+        mig = pyrunko.pic.twoD.TileMigrator()
+        self.assertEqual(mig.remove_stale_tiles(grid), 0)
+        self.assertEqual(len(grid.get_tile_ids()), conf.Nx*conf.Ny)
+
+
+    def test_add_particles_bulk(self):
+
+        ref = pyrunko.pic.threeD.ParticleContainer()
+        con = pyrunko.pic.threeD.ParticleContainer()
+        ref.set_keygen_state(3, 1)
+        con.set_keygen_state(3, 1)
+
+        N = 20
+        x  = np.random.rand(N).astype(np.float32)
+        y  = np.random.rand(N).astype(np.float32)
+        z  = np.random.rand(N).astype(np.float32)
+        vx = np.random.rand(N).astype(np.float32)
+        vy = np.random.rand(N) # float64 is converted
+        vz = np.random.rand(N).astype(np.float32)
+        w  = np.random.rand(N).astype(np.float32)
+
+        for n in range(N):
+            ref.add_particle([x[n], y[n], z[n]], [vx[n], vy[n], vz[n]], w[n])
+        con.add_particles_bulk(x, y, z, vx, vy, vz, w)
+
+        self.assertEqual(con.size(), N)
+        for arr1, arr2 in [(con.loc(0), ref.loc(0)), (con.vel(1), ref.vel(1)), (con.wgt(), ref.wgt())]:
+            for n in range(N):
+                self.assertAlmostEqual(arr1[n], arr2[n], places=6)
+        self.assertEqual(list(con.id(0)), list(ref.id(0)))
+        self.assertEqual(list(con.id(1)), list(ref.id(1)))
+
+        # scalar weight; keys continue
+        con.add_particles_bulk(x, y, z, vx, vy, vz, 0.5)
+        self.assertEqual(con.size(), 2*N)
+        self.assertAlmostEqual(con.wgt()[2*N-1], 0.5, places=6)
+        self.assertEqual(con.id(0)[2*N-1], 3 + 2*N - 1)
+
+        with self.assertRaises(ValueError):
+            con.add_particles_bulk(x, y, z[:5], vx, vy, vz)
+
+
+    def test_plasma_loader(self):
+
+        # native loader fills tiles reproducibly and inside the tile
+        tiles = []
+        for rep in range(2):
+            tile = pyrunko.pic.twoD.Tile(6, 4, 1)
+            tile.set_tile_mins([6.0, 0.0])
+            tile.set_tile_maxs([12.0, 4.0])
+            tile.set_container(pyrunko.pic.twoD.ParticleContainer())
+            tile.set_container(pyrunko.pic.twoD.ParticleContainer())
+
+            loader = pyrunko.pic.twoD.PlasmaLoader()
+            loader.seed = 11
+            loader.ppc = 8
+            loader.theta = 0.3
+            loader.density = lambda x, y, z: 8.0 if x < 9.0 else 4.0
+            self.assertEqual(loader.load_tile(tile, 0), 6*4*8 - 3*4*4)
+
+            # second species on top of the first
+            loader.distribution = "blackbody"
+            loader.load_tile(tile, 1, ref_species=0)
+            tiles.append(tile)
+
+        c0 = tiles[0].get_container(0)
+        xs = np.array(c0.loc(0))
+        ys = np.array(c0.loc(1))
+        self.assertTrue( np.all( (xs >= 6.0) & (xs < 12.0) ) )
+        self.assertTrue( np.all( (ys >= 0.0) & (ys < 4.0) ) )
+        self.assertEqual(list(c0.id(0)), list(range(c0.size())))
+
+        self.assertEqual(list(c0.vel(0)), list(tiles[1].get_container(0).vel(0)))
+        self.assertEqual(list(c0.loc(1)), list(tiles[0].get_container(1).loc(1)))
+        self.assertNotEqual(list(c0.vel(0)), list(tiles[0].get_container(1).vel(0)))
+
+
+    def test_particle_views(self):
+
+        # views share the particle arrays of the container
+        con = pyrunko.pic.threeD.ParticleContainer()
+        con.set_keygen_state(0, 4)
+        for n in range(5):
+            con.add_particle([n, 2.0*n, 0.5], [0.1*n, 0.0, -1.0], 1.0)
+
+        xs = con.loc_view(0)
+        self.assertEqual(xs.dtype, np.float32)
+        self.assertEqual(list(xs), list(con.loc(0)))
+
+        xs += 1.0
+        con.vel_view(2)[:] = 3.0
+        con.wgt_view()[2] = 0.25
+        self.assertAlmostEqual(con.loc(0)[4], 5.0, places=6)
+        self.assertEqual(list(con.vel(2)), [3.0]*5)
+        self.assertAlmostEqual(con.wgt()[2], 0.25, places=6)
+        self.assertEqual(list(con.id_view(1)), [4]*5)
+
+        empty = pyrunko.pic.threeD.ParticleContainer()
+        self.assertEqual(len(empty.loc_view(0)), 0)
+
+
+    def test_resampler(self):
+
+        # merging and splitting conserve weight, momentum and energy
+        tile = pyrunko.pic.threeD.Tile(2, 2, 2)
+        tile.set_tile_mins([0.0, 0.0, 0.0])
+        tile.set_tile_maxs([2.0, 2.0, 2.0])
+
+        np.random.seed(3)
+        con = pyrunko.pic.threeD.ParticleContainer()
+        for n in range(800):
+            x = np.random.uniform(0.0, 2.0, 3)
+            u = np.random.normal(0.0, 2.0, 3) + [1.0, 0.0, 0.0]
+            con.add_particle(x, u, np.random.uniform(0.5, 1.5))
+        tile.set_container(con)
+
+        def moments(c):
+            w = np.array(c.wgt(), dtype=np.float64)
+            u = np.array([c.vel(i) for i in range(3)], dtype=np.float64)
+            g = np.sqrt(1.0 + np.sum(u**2, axis=0))
+            return np.array([w.sum(), *(w*u).sum(axis=1), (w*g).sum()])
+
+        c = tile.get_container(0)
+        m0 = moments(c)
+
+        rs = pyrunko.pic.threeD.Resampler()
+        removed = rs.merge(tile, 0, 40)
+        self.assertEqual(c.size(), 800 - removed)
+
+        cells = np.floor(np.array([c.loc(i) for i in range(3)])).astype(int)
+        counts = np.bincount(cells[0] + 2*(cells[1] + 2*cells[2]), minlength=8)
+        self.assertTrue( np.all(counts <= 40) )
+        np.testing.assert_allclose(moments(c), m0, rtol=1e-5)
+
+        added = rs.split(tile, 0, 60)
+        self.assertEqual(c.size(), 800 - removed + added)
+        np.testing.assert_allclose(moments(c), m0, rtol=1e-5)
+        xs = np.array([c.loc(i) for i in range(3)])
+        self.assertTrue( np.all((xs >= 0.0) & (xs < 2.0)) )
+
+
+    def test_delete_compaction(self):
+
+        # deletions interleaved with kept particles beyond the new end keep
+        # exactly the other particles, each with its own id
+        N = 20
+        dels = [1, 3, 4, 7, 10, 13, 15, 16, 18, 19]
+        keep = [n for n in range(N) if n not in dels]
+
+        def fill(con, outside=()):
+            for n in range(N):
+                x = 15.0 if n in outside else 5.0
+                con.add_particle([x, 5.0, 0.5], [float(n), 0.0, 0.0], 1.0)
+            return {int(n): (i0, i1) for n, i0, i1 in zip(con.vel(0), con.id(0), con.id(1))}
+
+        def survivors(con, ids):
+            self.assertEqual(sorted(int(v) for v in con.vel(0)), keep)
+            for n, i0, i1 in zip(con.vel(0), con.id(0), con.id(1)):
+                self.assertEqual((i0, i1), ids[int(n)])
+
+        con = pyrunko.pic.twoD.ParticleContainer()
+        ids = fill(con)
+        con.delete_particles(dels)
+        self.assertEqual(con.size(), len(keep))
+        survivors(con, ids)
+
+        # same through particles leaving the tile
+        tile = pyrunko.pic.twoD.Tile(10, 10, 1)
+        tile.set_tile_mins([0.0, 0.0])
+        tile.set_tile_maxs([10.0, 10.0])
+        tile.set_container(pyrunko.pic.twoD.ParticleContainer())
+        ids = fill(tile.get_container(0), outside=dels)
+
+        tile.check_outgoing_particles()
+        tile.delete_transferred_particles()
+
+        con = tile.get_container(0)
+        self.assertEqual(con.size(), len(keep))
+        survivors(con, ids)
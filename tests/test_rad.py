@@ -6,6 +6,7 @@ import numpy as np
 
 import pycorgi
 import pyrunko.qed as pyqed
+import pyrunko.pic as pypic
 import pytools
 
 from numpy import sqrt
@@ -548,3 +549,194 @@ class radiation(unittest.TestCase):
 
 
 
+
+
+    def test_interaction_types(self):
+
+        # species are passed as ids internally; python side still sees type strings
+        intr = pyqed.PairAnn('e-', 'e+')
+        t3, ux3, uy3, uz3, t4, ux4, uy4, uz4 = intr.interact('e-', 1.0, 1.1, 1.2, 'e+', 1.1, 2.2, 1.3)
+        self.assertEqual((t3, t4), ('ph', 'ph'))
+
+        intr = pyqed.PhotAnn('ph', 'ph')
+        t3, ux3, uy3, uz3, t4, ux4, uy4, uz4 = intr.interact('ph', 10.0, 1.1, 1.2, 'ph', 0.01, 0.26, 0.17)
+        self.assertEqual(sorted((t3, t4)), ['e+', 'e-'])
+
+        intr = pyqed.Compton('e-', 'ph')
+        t3, ux3, uy3, uz3, t4, ux4, uy4, uz4 = intr.interact('e-', 1.0, 1.1, 1.2, 'ph', 0.01, 0.26, 0.17)
+        self.assertEqual((t3, t4), ('e-', 'ph'))
+
+        # python overrides also receive type strings when called from C++
+        class PyInter(pyqed.Interaction):
+            def __init__(self):
+                pyqed.Interaction.__init__(self, 'e-', 'e+')
+                self.seen = []
+
+            def get_minmax_ene(self, t1, t2, ene):
+                self.seen.append((t1, t2))
+                return 0.0, ene
+
+            def accumulate(self, t1, e1, t2, e2):
+                self.seen.append((t1, t2))
+                return 1.0, 1.0
+
+        intr = PyInter()
+        self.assertEqual(pyqed.Interaction.get_minmax_ene(intr, 'e-', 'e+', 2.0), (0.0, 2.0))
+        self.assertEqual(pyqed.Interaction.accumulate(intr, 'ph', 1.0, 'e-', 1.0), (1.0, 1.0))
+        self.assertEqual(intr.seen, [('e-', 'e+'), ('ph', 'e-')])
+
+
+    def test_interaction_tables(self):
+
+        cases = [
+            (pyqed.Compton('e-', 'ph'), ('e-', 1.0,  1.1,  1.2, 'ph', 0.01, 0.26, 0.17)),
+            (pyqed.PairAnn('e-', 'e+'), ('e-', 1.0,  1.1,  1.2, 'e+', 1.1,  2.2,  1.3 )),
+            (pyqed.PhotAnn('ph', 'ph'), ('ph', 10.0, 1.1,  1.2, 'ph', 0.01, 0.26, 0.17)),
+            ]
+
+        for intr, args in cases:
+            cs0, vrel0 = intr.comp_cross_section(*args)
+
+            intr.use_tables = True
+            intr.build_tables()
+
+            # max rel. error of cross section and max CDF error of the angle tables
+            err_cs, err_ang = intr.table_accuracy()
+            self.assertLess(err_cs,  1.0e-3)
+            self.assertLess(err_ang, 1.0e-3)
+
+            cs1, vrel1 = intr.comp_cross_section(*args)
+            self.assertAlmostEqual(cs0, cs1, places=4)
+            self.assertEqual(vrel0, vrel1)
+
+            t3, ux3, uy3, uz3, t4, ux4, uy4, uz4 = intr.interact(*args)
+
+            # energy is conserved in the table path too
+            e0 = sqrt(args[1]**2 + args[2]**2 + args[3]**2 + (0.0 if args[0] == 'ph' else 1.0)) \
+               + sqrt(args[5]**2 + args[6]**2 + args[7]**2 + (0.0 if args[4] == 'ph' else 1.0))
+            e1 = sqrt(ux3**2 + uy3**2 + uz3**2 + (0.0 if t3 == 'ph' else 1.0)) \
+               + sqrt(ux4**2 + uy4**2 + uz4**2 + (0.0 if t4 == 'ph' else 1.0))
+            self.assertAlmostEqual(e0/e1, 1.0, places=3)
+
+
+    def test_pairing_streams(self):
+
+        # QED random streams are keyed by (seed, tile, lap); same key gives same result
+        def solve(lap, seed=42):
+            tile = pypic.threeD.Tile(2, 2, 2)
+            tile.set_tile_mins([0.0, 0.0, 0.0])
+            tile.set_tile_maxs([2.0, 2.0, 2.0])
+
+            rng = np.random.default_rng(4)
+            for t in ['e-', 'e+', 'ph']:
+                con = pypic.threeD.ParticleContainer()
+                con.type = t
+                con.q = 0.0 if t == 'ph' else 1.0
+                con.m = 0.0 if t == 'ph' else 1.0
+                for n in range(200):
+                    con.add_particle(2.0*rng.random(3), 3.0*rng.normal(size=3), 1.0)
+                tile.set_container(con)
+
+            pairing = pyqed.threeD.Pairing()
+            pairing.seed = seed
+            pairing.prob_norm = 0.02
+            pairing.add_interaction(pyqed.Compton('e-', 'ph'))
+            pairing.add_interaction(pyqed.PairAnn('e-', 'e+'))
+            pairing.add_interaction(pyqed.PhotAnn('ph', 'ph'))
+            pairing.solve_twobody(tile, lap=lap)
+
+            return [list(tile.get_container(i).vel(0)) for i in range(3)]
+
+        self.assertEqual(solve(3), solve(3))
+        self.assertNotEqual(solve(3), solve(4))
+        self.assertNotEqual(solve(3), solve(3, seed=7))
+
+
+    def test_pairing_cells(self):
+
+        # pairing within cells; a pairing cell covering the whole tile is the tile-wide pairing
+        def solve(cell_bin):
+            tile = pypic.threeD.Tile(2, 2, 2)
+            tile.set_tile_mins([0.0, 0.0, 0.0])
+            tile.set_tile_maxs([2.0, 2.0, 2.0])
+
+            rng = np.random.default_rng(5)
+            for t in ['e-', 'e+', 'ph']:
+                con = pypic.threeD.ParticleContainer()
+                con.type = t
+                con.q = 0.0 if t == 'ph' else 1.0
+                con.m = 0.0 if t == 'ph' else 1.0
+                for n in range(200):
+                    con.add_particle(2.0*rng.random(3), 3.0*rng.normal(size=3), 1.0)
+                tile.set_container(con)
+
+            pairing = pyqed.threeD.Pairing()
+            pairing.cell_bin = cell_bin
+            pairing.prob_norm = 0.02
+            pairing.add_interaction(pyqed.Compton('e-', 'ph'))
+            pairing.add_interaction(pyqed.PairAnn('e-', 'e+'))
+            pairing.add_interaction(pyqed.PhotAnn('ph', 'ph'))
+            pairing.solve_twobody(tile, lap=0)
+
+            return [list(tile.get_container(i).vel(0)) for i in range(3)]
+
+        self.assertEqual(solve(0), solve(2))
+
+        vels = solve(1)
+        self.assertNotEqual(solve(0), vels)
+        for vs in vels:
+            self.assertTrue(all(np.isfinite(v) for v in vs))
+
+    def test_pairing_solve_tiles(self):
+
+        # tiles of a grid solved concurrently are equal to tiles solved one by one
+        def make_grid():
+            grid = pycorgi.threeD.Grid(2, 2, 1)
+            grid.set_grid_lims(0.0, 4.0, 0.0, 4.0, 0.0, 2.0)
+
+            rng = np.random.default_rng(7)
+            for i in range(2):
+                for j in range(2):
+                    tile = pypic.threeD.Tile(2, 2, 2)
+                    tile.set_tile_mins([2.0*i, 2.0*j, 0.0])
+                    tile.set_tile_maxs([2.0*i + 2.0, 2.0*j + 2.0, 2.0])
+
+                    for t in ['e-', 'e+', 'ph']:
+                        con = pypic.threeD.ParticleContainer()
+                        con.type = t
+                        con.q = 0.0 if t == 'ph' else 1.0
+                        con.m = 0.0 if t == 'ph' else 1.0
+                        for n in range(100):
+                            x = [2.0*i, 2.0*j, 0.0] + 2.0*rng.random(3)
+                            con.add_particle(x, 3.0*rng.normal(size=3), 1.0)
+                        tile.set_container(con)
+                    grid.add_tile(tile, (i,j,0))
+            return grid
+
+        def make_pairing():
+            pairing = pyqed.threeD.Pairing()
+            pairing.prob_norm = 0.02
+            pairing.add_interaction(pyqed.Compton('e-', 'ph'))
+            pairing.add_interaction(pyqed.PairAnn('e-', 'e+'))
+            pairing.add_interaction(pyqed.PhotAnn('ph', 'ph'))
+            return pairing
+
+        def vels(grid):
+            return [list(grid.get_tile(cid).get_container(i).vel(0))
+                    for cid in grid.get_local_tiles() for i in range(3)]
+
+        grid1 = make_grid()
+        pairing1 = make_pairing()
+        for lap in range(2):
+            for cid in grid1.get_local_tiles():
+                pairing1.solve_twobody(grid1.get_tile(cid), lap)
+                pairing1.leak_photons(grid1.get_tile(cid), 0.5, 1.0, lap)
+
+        grid2 = make_grid()
+        pairing2 = make_pairing()
+        for lap in range(2):
+            pairing2.solve_tiles(grid2, lap, tc_per_dt=0.5, tau_ext=1.0)
+
+        self.assertEqual(vels(grid1), vels(grid2))
+        self.assertEqual(pairing1.leaked_pnum, pairing2.leaked_pnum)
+        self.assertAlmostEqual(pairing1.leaked_ene, pairing2.leaked_ene)
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+
 // header
 //static int fastlog2(uint32_t v);
 
@@ -24,4 +27,23 @@ static int fastlog2(uint32_t v) {
 }
 
 
+// fast approximate log2 of a positive, normal float
+//
+// exponent is read from the bits and log2 of the mantissa m = 1 + t, t in [0,1[,
+// is approximated with a polynomial constrained to p(0) = 0 and p(1) = 1 so that
+// the result is continuous and monotonic across powers of two. 
+// Max abs error is ~2e-5.
+inline float fastlog2f(float x) {
+  uint32_t i;
+  std::memcpy(&i, &x, sizeof(i));
+
+  float e = static_cast<float>( static_cast<int>((i >> 23) & 0xff) - 127 );
 
+  i = (i & 0x007fffffu) | 0x3f800000u; // mantissa in [1,2[
+  float m;
+  std::memcpy(&m, &i, sizeof(m));
+  float t = m - 1.0f;
+
+  float p = t*(1.4417403f + t*(-0.70777018f + t*(0.412344216f + t*(-0.190319029f + t*0.04400469f))));
+  return e + p;
+}
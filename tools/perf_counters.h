@@ -0,0 +1,235 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cassert>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace toolbox {
+
+/*! \brief Per-thread performance counters with pre-registered ids
+ *
+ * Counters are registered once by name (outside of parallel regions) and
+ * then addressed with the returned integer id, so start/stop in hot loops
+ * only read the clock and update the slot of the calling thread.
+ *
+ * Every counter accumulates wall time, number of calls, processed items
+ * (particles or cells), and nominal bytes moved. Slots are padded to a
+ * cache line so threads never share them.
+ *
+ * Totals are summed over threads; seconds are thread-seconds and
+ * max_thread_seconds gives the slowest thread. Threads with an id beyond
+ * the reserved number of threads are not counted.
+ */
+class PerfCounters
+{
+  public:
+
+  using clock = std::chrono::steady_clock;
+
+  /// accumulated values of one counter in one thread
+  struct alignas(64) Slot
+  {
+    double seconds = 0.0;
+    uint64_t calls = 0;
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+    clock::time_point t0;
+  };
+
+  /// counter values summed over threads
+  struct Total
+  {
+    std::string name;
+    double seconds = 0.0;
+    double max_thread_seconds = 0.0;
+    uint64_t calls = 0;
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+  };
+
+  /// switch all counting on/off
+  bool enabled = true;
+
+  PerfCounters()
+  {
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+  }
+
+  /// register counter and return its id; existing id is returned for known names
+  int add_counter(const std::string& name)
+  {
+    const int id = get_id(name);
+    if(id >= 0) return id;
+
+    names.push_back(name);
+    relayout(num_threads, names.size() - 1);
+
+    return static_cast<int>(names.size()) - 1;
+  }
+
+  /// make room for at least nthr threads; call outside of parallel regions
+  void reserve_threads(int nthr)
+  {
+    if(nthr <= num_threads) return;
+    const int nold = num_threads;
+    num_threads = nthr;
+    relayout(nold, names.size());
+  }
+
+  /// id of a registered counter; -1 if not found
+  int get_id(const std::string& name) const
+  {
+    auto it = std::find(names.begin(), names.end(), name);
+    return it == names.end() ? -1 : static_cast<int>(it - names.begin());
+  }
+
+  /// name of counter id
+  const std::string& get_name(int id) const { return names.at(id); }
+
+  /// number of registered counters
+  size_t size() const { return names.size(); }
+
+  /// start timing counter id in calling thread
+  inline void start(int id)
+  {
+    if(!enabled) return;
+    slot(id).t0 = clock::now();
+  }
+
+  /// stop timing counter id and add processed items and bytes
+  inline void stop(int id, uint64_t items=0, uint64_t bytes=0)
+  {
+    if(!enabled) return;
+    auto& s = slot(id);
+    s.seconds += std::chrono::duration<double>(clock::now() - s.t0).count();
+    s.calls++;
+    s.items += items;
+    s.bytes += bytes;
+  }
+
+  /// add items and bytes to counter id without timing
+  inline void count(int id, uint64_t items, uint64_t bytes=0)
+  {
+    if(!enabled) return;
+    auto& s = slot(id);
+    s.items += items;
+    s.bytes += bytes;
+  }
+
+  /// zero all counters; registrations are kept
+  void clear()
+  {
+    for(auto& s : slots) s = Slot();
+  }
+
+  /// add values of another counter set with the same registrations (e.g., a cleared copy of this one)
+  void merge(const PerfCounters& other)
+  {
+    assert(other.names == names && other.num_threads == num_threads);
+    for(size_t i=0; i<slots.size(); i++) {
+      slots[i].seconds += other.slots[i].seconds;
+      slots[i].calls   += other.slots[i].calls;
+      slots[i].items   += other.slots[i].items;
+      slots[i].bytes   += other.slots[i].bytes;
+    }
+  }
+
+  /// counter values summed over threads
+  std::vector<Total> totals() const
+  {
+    std::vector<Total> ret(names.size());
+    for(size_t c=0; c<names.size(); c++) {
+      ret[c].name = names[c];
+      for(int t=0; t<num_threads; t++) {
+        const auto& s = slots[t*names.size() + c];
+        ret[c].seconds += s.seconds;
+        ret[c].max_thread_seconds = std::max(ret[c].max_thread_seconds, s.seconds);
+        ret[c].calls += s.calls;
+        ret[c].items += s.items;
+        ret[c].bytes += s.bytes;
+      }
+    }
+    return ret;
+  }
+
+  /// human-readable table of the totals
+  std::string report(const std::string& title="") const
+  {
+    std::ostringstream os;
+    os << "------------------------------------------------------------------------\n";
+    if(!title.empty()) os << " " << title << "\n";
+    os << std::left << std::setw(28) << " counter"
+       << std::right << std::setw(12) << "time (s)"
+       << std::setw(10) << "calls"
+       << std::setw(12) << "items/s"
+       << std::setw(12) << "GB/s" << "\n";
+
+    for(auto& tot : totals()) {
+      if(tot.calls == 0 && tot.items == 0) continue;
+      const double t = tot.max_thread_seconds > 0.0 ? tot.max_thread_seconds : 1.0;
+      os << " " << std::left << std::setw(27) << tot.name
+         << std::right << std::fixed << std::setprecision(5) << std::setw(12) << tot.seconds
+         << std::setw(10) << tot.calls
+         << std::scientific << std::setprecision(3)
+         << std::setw(12) << tot.items/t
+         << std::fixed << std::setprecision(3)
+         << std::setw(12) << 1.0e-9*tot.bytes/t << "\n";
+    }
+    return os.str();
+  }
+
+  void print(const std::string& title="") const { std::cout << report(title); }
+
+  private:
+
+  int num_threads = 1;
+
+  std::vector<std::string> names;
+
+  /// slots of all threads, [thread][counter]
+  std::vector<Slot> slots;
+
+  /// copy slots of nthr_old threads and Nold counters to the current [thread][counter] layout
+  void relayout(int nthr_old, size_t Nold)
+  {
+    std::vector<Slot> tmp(num_threads*names.size());
+    for(int t=0; t<nthr_old; t++) {
+      for(size_t c=0; c<Nold; c++) tmp[t*names.size() + c] = slots[t*Nold + c];
+    }
+    slots.swap(tmp);
+  }
+
+  inline Slot& slot(int id)
+  {
+    assert(id >= 0 && static_cast<size_t>(id) < names.size());
+#ifdef _OPENMP
+    const int tid = omp_get_thread_num();
+
+    // thread ids beyond reserve_threads (e.g., after the team size grew) 
+    // are not counted; they write to a private scratch slot instead
+    if(tid >= num_threads) {
+      static thread_local Slot scratch;
+      return scratch;
+    }
+#else
+    const int tid = 0;
+#endif
+    return slots[tid*names.size() + id];
+  }
+
+};
+
+} // end of namespace toolbox
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace toolbox {
+
+
+/*! \brief Philox-4x32-10 counter-based random number generator
+ *
+ * Salmon et al. 2011, "Parallel random numbers: as easy as 1, 2, 3".
+ *
+ * Output is a pure function of (key, counter); any draw can be made
+ * independently of the others so streams do not depend on the number of
+ * threads or on the evaluation order.
+ */
+struct Philox4x32 {
+
+  using ctr_type = std::array<uint32_t, 4>;
+  using key_type = std::array<uint32_t, 2>;
+
+  static inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo)
+  {
+    const uint64_t p = (uint64_t)a*(uint64_t)b;
+    hi = (uint32_t)(p >> 32);
+    lo = (uint32_t)p;
+  }
+
+  static inline ctr_type round(const ctr_type& c, const key_type& k)
+  {
+    uint32_t hi0, lo0, hi1, lo1;
+    mulhilo(0xD2511F53u, c[0], hi0, lo0);
+    mulhilo(0xCD9E8D57u, c[2], hi1, lo1);
+    return {{hi1 ^ c[1] ^ k[0], lo1, hi0 ^ c[3] ^ k[1], lo0}};
+  }
+
+  static inline ctr_type generate(ctr_type c, key_type k)
+  {
+    for(int r=0; r<10; r++) {
+      if(r > 0) {
+        k[0] += 0x9E3779B9u;
+        k[1] += 0xBB67AE85u;
+      }
+      c = round(c, k);
+    }
+    return c;
+  }
+
+  /// same as generate() on scalar words; branch-free so that loops over
+  /// counters vectorize
+  static inline void generate(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, 
+                              uint32_t k0, uint32_t k1)
+  {
+    #pragma GCC unroll 10
+    for(int r=0; r<10; r++) {
+      const uint64_t p0 = (uint64_t)0xD2511F53u*(uint64_t)c0;
+      const uint64_t p1 = (uint64_t)0xCD9E8D57u*(uint64_t)c2;
+      c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+      c1 = (uint32_t)p1;
+      c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+      c3 = (uint32_t)p0;
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+    }
+  }
+};
+
+
+/// splitmix64 finalizer; used to derive keys from seeds
+inline uint64_t splitmix64(uint64_t x)
+{
+  x += 0x9E3779B97F4A7C15ull;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+
+/// uniform float in [0,1) from the upper 24 bits
+inline float u01(uint32_t x) { return (float)(x >> 8) * 5.9604645e-8f; }
+
+/// uniform float in (0,1]; safe for logarithms
+inline float u01_open(uint32_t x) { return (float)((x >> 8) + 1u) * 5.9604645e-8f; }
+
+
+/// independent stream of counter-based random numbers
+//
+// Numbers are addressed by (n, block): element n (e.g., particle or cell
+// index) and its block-th group of 4 draws.
+class CounterRNG {
+
+  Philox4x32::key_type key;
+
+  public:
+
+  CounterRNG(uint64_t seed, uint64_t stream)
+  {
+    const uint64_t k = splitmix64(seed ^ splitmix64(stream));
+    key = {{(uint32_t)k, (uint32_t)(k >> 32)}};
+  }
+
+  /// 4 raw 32-bit draws
+  inline Philox4x32::ctr_type raw4(uint64_t n, uint32_t block) const
+  {
+    return Philox4x32::generate({{(uint32_t)n, (uint32_t)(n >> 32), block, 0u}}, key);
+  }
+
+  /// 4 uniforms in (0,1]
+  inline std::array<float, 4> uniform4(uint64_t n, uint32_t block) const
+  {
+    auto r = raw4(n, block);
+    return {{u01_open(r[0]), u01_open(r[1]), u01_open(r[2]), u01_open(r[3])}};
+  }
+
+  /// batched uniforms in [0,1); out[4i + j] is the j-th draw of element n0 + i
+  inline void uniforms(uint64_t n0, uint32_t block, size_t nelem, float* out) const
+  {
+    #pragma omp simd
+    for(size_t i=0; i<nelem; i++) {
+      const uint64_t n = n0 + i;
+      uint32_t c0 = (uint32_t)n, c1 = (uint32_t)(n >> 32), c2 = block, c3 = 0u;
+      Philox4x32::generate(c0, c1, c2, c3, key[0], key[1]);
+      out[4*i    ] = u01(c0);
+      out[4*i + 1] = u01(c1);
+      out[4*i + 2] = u01(c2);
+      out[4*i + 3] = u01(c3);
+    }
+  }
+
+  /// batched standard normals (Box-Muller); out[4i + j] as in uniforms()
+  inline void normals(uint64_t n0, uint32_t block, size_t nelem, float* out) const
+  {
+    uniforms(n0, block, nelem, out);
+
+    #pragma omp simd
+    for(size_t i=0; i<2*nelem; i++) {
+      float rad = std::sqrt(-2.0f*std::log(1.0f - out[2*i])); // 1-u in (0,1]
+      float ang = 6.2831853f*out[2*i + 1];
+      out[2*i    ] = rad*std::cos(ang);
+      out[2*i + 1] = rad*std::sin(ang);
+    }
+  }
+};
+
+
+/// stream id of a (tile, slot, lap) triplet; slot separates the species or
+/// the different consumers that draw from the same tile during a lap
+inline uint64_t stream_id(uint64_t cid, uint64_t slot, uint64_t lap)
+{
+  return splitmix64( splitmix64( splitmix64(cid) ^ slot ) ^ lap );
+}
+
+
+/*! \brief Sequential draws from a counter-based stream
+ *
+ * For Monte Carlo loops that consume a varying number of random numbers.
+ * The k-th draw after reset(seed, stream) / seek(sub) is a pure function
+ * of (seed, stream, sub, k); it does not depend on which thread makes it.
+ * Draws are generated in batches of 4*nbatch with CounterRNG::uniforms().
+ */
+class RandomStream {
+
+  static constexpr size_t nbatch = 16;
+
+  CounterRNG rng;
+  uint64_t pos = 0; // next element of the counter
+  uint32_t sub = 0; // sub-stream (block word of the counter)
+  size_t i = 4*nbatch;
+  std::array<float, 4*nbatch> buf;
+
+  public:
+
+  RandomStream(uint64_t seed = 0, uint64_t stream = 0) : rng(seed, stream) {}
+
+  /// start stream from the beginning
+  void reset(uint64_t seed, uint64_t stream)
+  {
+    rng = CounterRNG(seed, stream);
+    seek(0);
+  }
+
+  /// move to the beginning of sub-stream s (e.g., particle index)
+  void seek(uint32_t s)
+  {
+    sub = s;
+    pos = 0;
+    i = 4*nbatch;
+  }
+
+  /// uniform float in [0,1)
+  inline float uniform()
+  {
+    if(i == 4*nbatch) {
+      rng.uniforms(pos, sub, nbatch, buf.data());
+      pos += nbatch;
+      i = 0;
+    }
+    return buf[i++];
+  }
+};
+
+
+/// random stream of the calling thread
+//
+// Shared objects (e.g., QED interactions) draw from this stream; the solvers
+// reset it at the start of every tile so that results are independent of the
+// thread that processes the tile.
+inline RandomStream& thread_stream()
+{
+  static thread_local RandomStream stream;
+  return stream;
+}
+
+
+} // end of namespace toolbox
@@ -133,6 +133,28 @@ inline int find_rev_sorted_nearest_algo2(
   return base - &t[0]; // index
 }
 
+// same as above but only searches the reverse sorted subrange [imin, imax[;
+// returns an index in [imin, imax]
+template <typename T>
+inline size_t find_rev_sorted_nearest_algo2(
+    ManVec<T> & t,
+    const T x,
+    const size_t imin,
+    const size_t imax)
+{
+  if(imin >= imax) return imin;
+  if(x < t[imax-1]) return imax;
+
+  float *base = t.data() + imin;
+  size_t len = imax - imin;
+  while (len > 1) {
+        size_t half = len / 2;
+        len -= half;
+        base += (base[half - 1] >= x) * half; // will be replaced with a "cmov"
+    }
+  return base - &t[0]; // index
+}
+
 
 // Sample between [imin, imax[
 template <typename T>